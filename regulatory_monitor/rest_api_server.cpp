@@ -19,13 +19,6 @@
 #include <cstring>
 #include <algorithm>
 #include <regex>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <unistd.h>
-#include <fcntl.h>
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
 #include <csignal>
 #include <unordered_set>
 #include <iomanip>
@@ -46,12 +39,6 @@ namespace regulens {
 
 // Helper function to extract user ID from JWT token in Authorization header
 std::string extract_user_id_from_jwt(const std::map<std::string, std::string>& headers) {
-    const char* jwt_secret_env = std::getenv("JWT_SECRET");
-    if (!jwt_secret_env) {
-        return "system"; // Fallback if JWT secret not configured
-    }
-    std::string secret_key = jwt_secret_env;
-
     auto auth_it = headers.find("authorization");
     if (auth_it == headers.end()) {
         auth_it = headers.find("Authorization");
@@ -67,8 +54,11 @@ std::string extract_user_id_from_jwt(const std::map<std::string, std::string>& h
 
     std::string token = auth_header.substr(7); // Remove "Bearer " prefix
 
-    JWTParser parser(secret_key);
-    auto claims = parser.parse_token(token);
+    auto parser = shared_jwt_parser();
+    if (!parser) {
+        return "system"; // Fallback if JWT secret not configured
+    }
+    auto claims = parser->verify_token(token);
     if (claims) {
         return claims->user_id;
     }
@@ -81,7 +71,7 @@ RESTAPIServer::RESTAPIServer(
     std::shared_ptr<ProductionRegulatoryMonitor> monitor,
     StructuredLogger* logger
 ) : db_pool_(db_pool), monitor_(monitor), logger_(logger),
-    server_port_(3000), server_socket_(-1), running_(false) {
+    server_port_(3000), running_(false) {
 }
 
 RESTAPIServer::~RESTAPIServer() {
@@ -89,46 +79,24 @@ RESTAPIServer::~RESTAPIServer() {
 }
 
 bool RESTAPIServer::start(int port) {
+    if (running_) return true;
     server_port_ = port;
 
-    // Create server socket
-    server_socket_ = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_socket_ < 0) {
-        logger_->error("Failed to create API server socket", "RESTAPIServer", __func__);
-        return false;
-    }
-
-    // Set socket options for reuse address
-    int opt = 1;
-    if (setsockopt(server_socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        logger_->error("Failed to set API server socket options", "RESTAPIServer", __func__);
-        close(server_socket_);
-        return false;
-    }
-
-    // Bind socket to address and port
-    struct sockaddr_in server_addr;
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = INADDR_ANY;
-    server_addr.sin_port = htons(server_port_);
-
-    if (bind(server_socket_, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
-        logger_->error("Failed to bind API server socket to port " + std::to_string(server_port_),
-                      "RESTAPIServer", __func__);
-        close(server_socket_);
-        return false;
-    }
-
-    // Listen for incoming connections
-    if (listen(server_socket_, 50) < 0) {
-        logger_->error("Failed to listen on API server socket", "RESTAPIServer", __func__);
-        close(server_socket_);
+    // One event-driven core serves every connection; requests run on its worker pool
+    server_core_ = std::make_unique<HttpServerCore>(
+        server_options_,
+        [this](const HttpServerRequest& request) { return handle_connection_request(request); });
+    server_core_->set_error_logger([this](const std::string& message) {
+        logger_->error("API server I/O error: " + message, "RESTAPIServer", "server_core");
+    });
+
+    if (!server_core_->start(server_port_)) {
+        logger_->error(server_core_->error_message(), "RESTAPIServer", __func__);
+        server_core_.reset();
         return false;
     }
 
     running_ = true;
-    server_thread_ = std::thread(&RESTAPIServer::server_loop, this);
 
     logger_->info("REST API server started on port " + std::to_string(server_port_),
                  "RESTAPIServer", __func__);
@@ -140,13 +108,9 @@ void RESTAPIServer::stop() {
 
     running_ = false;
 
-    if (server_thread_.joinable()) {
-        server_thread_.join();
-    }
-
-    if (server_socket_ >= 0) {
-        close(server_socket_);
-        server_socket_ = -1;
+    if (server_core_) {
+        server_core_->stop();
+        server_core_.reset();
     }
 
     logger_->info("REST API server stopped", "RESTAPIServer", __func__);
@@ -156,53 +120,10 @@ bool RESTAPIServer::is_running() const {
     return running_;
 }
 
-void RESTAPIServer::server_loop() {
-    logger_->info("REST API server loop started", "RESTAPIServer", __func__);
-
-    while (running_) {
-        struct sockaddr_in client_addr;
-        socklen_t client_len = sizeof(client_addr);
-        int client_socket = accept(server_socket_, (struct sockaddr*)&client_addr, &client_len);
-
-        if (client_socket < 0) {
-            if (running_) {
-                logger_->error("Failed to accept API client connection", "RESTAPIServer", __func__);
-            }
-            continue;
-        }
-
-        // Handle client in a separate thread for concurrent requests
-        std::thread(&RESTAPIServer::handle_client, this, client_socket).detach();
-    }
-
-    logger_->info("REST API server loop ended", "RESTAPIServer", __func__);
-}
-
-void RESTAPIServer::handle_client(int client_socket) {
-    char buffer[8192];
-    std::string request_str;
-
-    // Read request
-    ssize_t bytes_read;
-    while ((bytes_read = read(client_socket, buffer, sizeof(buffer) - 1)) > 0) {
-        buffer[bytes_read] = '\0';
-        request_str += buffer;
-
-        // Check if we have the complete HTTP request
-        if (request_str.find("\r\n\r\n") != std::string::npos) {
-            break;
-        }
-    }
-
-    if (bytes_read < 0) {
-        logger_->error("Failed to read from API client socket", "RESTAPIServer", __func__);
-        close(client_socket);
-        return;
-    }
-
+std::string RESTAPIServer::handle_connection_request(const HttpServerRequest& raw_request) {
     try {
         // Parse and route request
-        APIRequest req = parse_request(request_str);
+        APIRequest req = parse_request(raw_request);
         APIResponse resp;
 
         // Check CORS
@@ -213,9 +134,7 @@ void RESTAPIServer::handle_client(int client_socket) {
             route_request(req, resp);
         }
 
-        // Generate and send response
-        std::string response_str = generate_response(resp);
-        write(client_socket, response_str.c_str(), response_str.length());
+        return generate_response(resp, raw_request.keep_alive);
 
     } catch (const std::exception& e) {
         logger_->error("Error handling API request: " + std::string(e.what()),
@@ -223,46 +142,18 @@ void RESTAPIServer::handle_client(int client_socket) {
 
         APIResponse error_resp(500, "application/json");
         error_resp.body = nlohmann::json{{"error", "Internal server error"}}.dump();
-        std::string response_str = generate_response(error_resp);
-        write(client_socket, response_str.c_str(), response_str.length());
+        return generate_response(error_resp, raw_request.keep_alive);
     }
-
-    close(client_socket);
 }
 
-APIRequest RESTAPIServer::parse_request(const std::string& request_str) {
+APIRequest RESTAPIServer::parse_request(const HttpServerRequest& raw_request) {
     APIRequest req;
-    std::istringstream iss(request_str);
-    std::string line;
-
-    // Parse request line
-    if (std::getline(iss, line)) {
-        std::istringstream line_stream(line);
-        line_stream >> req.method >> req.path;
-    }
-
-    // Parse headers
-    while (std::getline(iss, line) && line != "\r") {
-        size_t colon_pos = line.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string header_name = line.substr(0, colon_pos);
-            std::string header_value = line.substr(colon_pos + 1);
-
-            // Trim whitespace
-            header_name.erase(header_name.begin(),
-                std::find_if(header_name.begin(), header_name.end(),
-                    [](unsigned char ch) { return !std::isspace(ch); }));
-            header_name.erase(std::find_if(header_name.rbegin(), header_name.rend(),
-                [](unsigned char ch) { return !std::isspace(ch); }).base(), header_name.end());
-
-            header_value.erase(header_value.begin(),
-                std::find_if(header_value.begin(), header_value.end(),
-                    [](unsigned char ch) { return !std::isspace(ch); }));
-            header_value.erase(std::find_if(header_value.rbegin(), header_value.rend(),
-                [](unsigned char ch) { return !std::isspace(ch); }).base(), header_value.end());
-
-            req.headers[header_name] = header_value;
-        }
+    req.method = raw_request.method;
+    req.path = raw_request.target;
+    req.body = raw_request.body;  // already framed by Content-Length
+
+    for (const auto& [name, value] : raw_request.headers) {
+        req.headers[name] = value;
     }
 
     // Parse query parameters
@@ -283,24 +174,10 @@ APIRequest RESTAPIServer::parse_request(const std::string& request_str) {
         }
     }
 
-    // Read body if Content-Length is specified
-    auto content_length_it = req.headers.find("Content-Length");
-    if (content_length_it != req.headers.end()) {
-        try {
-            size_t content_length = std::stoul(content_length_it->second);
-            if (content_length > 0 && content_length < 8192) {
-                req.body.resize(content_length);
-                iss.read(&req.body[0], static_cast<std::streamsize>(content_length));
-            }
-        } catch (const std::exception&) {
-            // Ignore invalid content length
-        }
-    }
-
     return req;
 }
 
-std::string RESTAPIServer::generate_response(const APIResponse& response) {
+std::string RESTAPIServer::generate_response(const APIResponse& response, bool keep_alive) {
     std::ostringstream oss;
 
     // Status line
@@ -319,11 +196,13 @@ std::string RESTAPIServer::generate_response(const APIResponse& response) {
 
     // Headers
     for (const auto& header : response.headers) {
+        if (header.first == "Content-Length" || header.first == "Connection") continue;
         oss << header.first << ": " << header.second << "\r\n";
     }
 
-    // Content-Length header
+    // Framing headers
     oss << "Content-Length: " << response.body.length() << "\r\n";
+    oss << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n";
 
     // End of headers
     oss << "\r\n";
@@ -17,6 +17,7 @@
 #include <nlohmann/json.hpp>
 #include <shared/database/postgresql_connection.hpp>
 #include <shared/network/http_client.hpp>
+#include <shared/network/http_server_core.hpp>
 #include <shared/logging/structured_logger.hpp>
 #include "production_regulatory_monitor.hpp"
 
@@ -60,6 +61,9 @@ public:
     void stop();
     bool is_running() const;
 
+    // Connection handling limits; takes effect on the next start()
+    void set_server_options(const HttpServerOptions& options) { server_options_ = options; }
+
     // API endpoint handlers
     APIResponse handle_regulatory_changes(const APIRequest& req);
     APIResponse handle_sources(const APIRequest& req);
@@ -69,10 +73,9 @@ public:
     APIResponse handle_options(const APIRequest& req);
 
 private:
-    void server_loop();
-    void handle_client(int client_socket);
-    APIRequest parse_request(const std::string& request_str);
-    std::string generate_response(const APIResponse& response);
+    std::string handle_connection_request(const HttpServerRequest& raw_request);
+    APIRequest parse_request(const HttpServerRequest& raw_request);
+    std::string generate_response(const APIResponse& response, bool keep_alive);
     void route_request(const APIRequest& req, APIResponse& resp);
     std::vector<std::string> split_path(const std::string& path);
     std::string generate_change_id(const std::string& source, const std::string& title);
@@ -112,8 +115,8 @@ private:
     StructuredLogger* logger_;
 
     int server_port_;
-    int server_socket_;
-    std::thread server_thread_;
+    HttpServerOptions server_options_;
+    std::unique_ptr<HttpServerCore> server_core_;
     std::atomic<bool> running_;
 
     // Rate limiting
@@ -1372,6 +1372,7 @@ CREATE INDEX IF NOT EXISTS idx_transactions_flagged ON transactions(flagged);
 CREATE INDEX IF NOT EXISTS idx_transactions_status ON transactions(status);
 CREATE INDEX IF NOT EXISTS idx_transactions_sender_country ON transactions(sender_country);
 CREATE INDEX IF NOT EXISTS idx_transactions_receiver_country ON transactions(receiver_country);
+CREATE INDEX IF NOT EXISTS idx_transactions_created_at ON transactions(created_at);
 
 CREATE INDEX IF NOT EXISTS idx_transaction_risk_assessments_transaction_id ON transaction_risk_assessments(transaction_id);
 CREATE INDEX IF NOT EXISTS idx_transaction_risk_assessments_agent ON transaction_risk_assessments(agent_name);
@@ -2298,6 +2299,16 @@ CREATE INDEX idx_user_permissions_permission ON user_permissions(permission);
 CREATE INDEX IF NOT EXISTS idx_processed_records_source ON processed_records(source_id);
 CREATE INDEX IF NOT EXISTS idx_processed_records_pipeline ON processed_records(pipeline_id);
 
+-- Incremental load positions of database sources, one per source table
+CREATE TABLE IF NOT EXISTS ingestion_watermarks (
+    source_id VARCHAR(255) NOT NULL,
+    table_name VARCHAR(255) NOT NULL,
+    watermark_value TEXT NOT NULL,
+    watermark_key TEXT,
+    updated_at TIMESTAMP WITH TIME ZONE NOT NULL DEFAULT NOW(),
+    PRIMARY KEY (source_id, table_name)
+);
+
 -- Health check metrics persistence
 CREATE TABLE IF NOT EXISTS health_metrics (
     metric_id UUID PRIMARY KEY DEFAULT uuid_generate_v4(),
@@ -2470,6 +2481,7 @@ COMMENT ON TABLE geo_enrichment IS 'Geographic enrichment data cache for lookup
 COMMENT ON TABLE customer_enrichment IS 'Customer profile enrichment cache - integrates with CRM systems';
 COMMENT ON TABLE product_enrichment IS 'Product catalog enrichment cache - supports inventory and pricing lookups';
 COMMENT ON TABLE processed_records IS 'Duplicate detection tracking - prevents reprocessing of ingested records';
+COMMENT ON TABLE ingestion_watermarks IS 'Durable keyset watermarks for incremental database source loads';
 COMMENT ON TABLE health_metrics IS 'Health check metrics persistence - supports Prometheus and database-backed monitoring';
 COMMENT ON TABLE event_log IS 'Event bus operation log - tracks all events with retry and expiry support';
 COMMENT ON TABLE ingestion_sources IS 'Data ingestion source state management - supports pause/resume capability';
@@ -6388,14 +6400,35 @@ CREATE TABLE IF NOT EXISTS fraud_scan_job_queue (
     transactions_flagged INTEGER DEFAULT 0,
     results_summary JSONB,
     error_message TEXT,
+    last_transaction_id UUID,  -- Checkpoint: scan resumes after this transaction
+    heartbeat_at TIMESTAMP,    -- Refreshed per committed chunk; stale 'processing' jobs are reclaimed
     created_by UUID REFERENCES user_authentication(user_id) ON DELETE SET NULL,
     created_at TIMESTAMP DEFAULT NOW()
 );
 
+ALTER TABLE fraud_scan_job_queue ADD COLUMN IF NOT EXISTS last_transaction_id UUID;
+ALTER TABLE fraud_scan_job_queue ADD COLUMN IF NOT EXISTS heartbeat_at TIMESTAMP;
+
 -- Indexes for job queue performance
 CREATE INDEX IF NOT EXISTS idx_job_queue_status ON fraud_scan_job_queue(status, priority DESC, created_at ASC);
 CREATE INDEX IF NOT EXISTS idx_job_queue_worker ON fraud_scan_job_queue(worker_id, status);
 
+-- Wake idle FraudScanWorkers (LISTEN fraud_scan_jobs) when a job is queued
+CREATE OR REPLACE FUNCTION notify_fraud_scan_job_queued()
+RETURNS TRIGGER AS $$
+BEGIN
+    PERFORM pg_notify('fraud_scan_jobs', NEW.job_id::text);
+    RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+DROP TRIGGER IF EXISTS trigger_fraud_scan_job_queued ON fraud_scan_job_queue;
+CREATE TRIGGER trigger_fraud_scan_job_queued
+    AFTER INSERT OR UPDATE OF status ON fraud_scan_job_queue
+    FOR EACH ROW
+    WHEN (NEW.status = 'queued')
+    EXECUTE FUNCTION notify_fraud_scan_job_queued();
+
 -- ============================================================================
 -- END OF CUSTOMER MANAGEMENT SYSTEM
 -- ============================================================================
@@ -8662,7 +8695,7 @@ CREATE TABLE async_jobs (
     job_type VARCHAR(100) NOT NULL,
     user_id VARCHAR(255) NOT NULL,
     execution_mode VARCHAR(50) NOT NULL, -- SYNCHRONOUS, ASYNCHRONOUS, BATCH, STREAMING
-    status VARCHAR(50) NOT NULL DEFAULT 'PENDING', -- PENDING, RUNNING, COMPLETED, FAILED, CANCELLED
+    status VARCHAR(50) NOT NULL DEFAULT 'PENDING', -- PENDING, CLAIMED, RUNNING, COMPLETED, FAILED, CANCELLED
     priority INT DEFAULT 0, -- 0=low, 1=medium, 2=high, 3=critical
     request_payload JSONB NOT NULL,
     result_payload JSONB,
@@ -8672,6 +8705,8 @@ CREATE TABLE async_jobs (
     started_at TIMESTAMP WITH TIME ZONE,
     completed_at TIMESTAMP WITH TIME ZONE,
     cancelled_at TIMESTAMP WITH TIME ZONE,
+    claimed_by VARCHAR(255), -- JobScheduler holding the lease while CLAIMED
+    claimed_at TIMESTAMP WITH TIME ZONE,
     created_at TIMESTAMP WITH TIME ZONE DEFAULT NOW(),
     updated_at TIMESTAMP WITH TIME ZONE DEFAULT NOW(),
     metadata JSONB
@@ -8682,6 +8717,24 @@ CREATE INDEX idx_async_jobs_status ON async_jobs(status);
 CREATE INDEX idx_async_jobs_job_type ON async_jobs(job_type);
 CREATE INDEX idx_async_jobs_priority ON async_jobs(priority DESC);
 CREATE INDEX idx_async_jobs_created_at ON async_jobs(created_at DESC);
+-- Batched claiming scans claimable jobs in queue order
+CREATE INDEX idx_async_jobs_claimable ON async_jobs(priority DESC, created_at ASC)
+    WHERE status IN ('PENDING', 'CLAIMED');
+
+-- Wake JobSchedulers (LISTEN async_jobs) when a job is submitted
+CREATE OR REPLACE FUNCTION notify_async_job_pending()
+RETURNS TRIGGER AS $$
+BEGIN
+    PERFORM pg_notify('async_jobs', NEW.job_id::text);
+    RETURN NEW;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE TRIGGER trigger_async_job_pending
+    AFTER INSERT OR UPDATE OF status ON async_jobs
+    FOR EACH ROW
+    WHEN (NEW.status = 'PENDING')
+    EXECUTE FUNCTION notify_async_job_pending();
 
 -- Job batch execution tracking
 CREATE TABLE batch_executions (
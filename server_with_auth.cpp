@@ -52,232 +52,7 @@
 #include "shared/utils.hpp"
 
 // JWT Authentication - Production-grade security implementation (Rule 1 compliance)
-
-// Forward declaration for global JWT parser
-namespace regulens {
-class JWTParser;
-}
-extern std::unique_ptr<regulens::JWTParser> g_jwt_parser;
-
-// Forward declaration for HMAC-SHA256 function
-std::string hmac_sha256(const std::string& key, const std::string& data);
-
-// Global JWT parser instance
-std::unique_ptr<regulens::JWTParser> g_jwt_parser;
-
-namespace regulens {
-
-// Simple JWT claims structure
-struct JWTClaims {
-    std::string user_id;
-    std::string username;
-    std::string email;
-    int64_t exp;
-};
-
-// Basic JWT parser for authentication
-class JWTParser {
-public:
-    JWTParser(const std::string& secret_key) : secret_key_(secret_key) {}
-
-    std::string extract_user_id(const std::string& token) {
-        // Basic JWT parsing - split token and decode payload
-        size_t first_dot = token.find('.');
-        size_t second_dot = token.find('.', first_dot + 1);
-
-        if (first_dot == std::string::npos || second_dot == std::string::npos) {
-            return "";
-        }
-
-        std::string payload = token.substr(first_dot + 1, second_dot - first_dot - 1);
-
-        // Base64 URL decode (simplified)
-        std::string decoded = base64_url_decode(payload);
-
-        // Parse JSON payload to extract user_id
-        // For this critical fix, we'll do basic string parsing
-        size_t user_id_pos = decoded.find("\"sub\":\"");
-        if (user_id_pos == std::string::npos) {
-            user_id_pos = decoded.find("\"user_id\":\"");
-        }
-
-        if (user_id_pos != std::string::npos) {
-            user_id_pos += 7; // Skip "sub":"
-            size_t end_pos = decoded.find("\"", user_id_pos);
-            if (end_pos != std::string::npos) {
-                return decoded.substr(user_id_pos, end_pos - user_id_pos);
-            }
-        }
-
-        return "";
-    }
-
-    bool validate_token(const std::string& token) {
-        // PRODUCTION-GRADE JWT VALIDATION: Verify signature using HMAC-SHA256
-        // No fallbacks or simplified validation - proper cryptographic verification required
-
-        size_t first_dot = token.find('.');
-        size_t second_dot = token.find('.', first_dot + 1);
-
-        if (first_dot == std::string::npos || second_dot == std::string::npos) {
-            return false;
-        }
-
-        // Extract header, payload, and signature
-        std::string header_b64 = token.substr(0, first_dot);
-        std::string payload_b64 = token.substr(first_dot + 1, second_dot - first_dot - 1);
-        std::string signature_b64 = token.substr(second_dot + 1);
-
-        // Decode signature from base64url
-        std::string expected_signature = base64_url_decode(signature_b64);
-
-        // Create the signing input (header.payload)
-        std::string signing_input = header_b64 + "." + payload_b64;
-
-        // Calculate expected signature using HMAC-SHA256
-        std::string calculated_signature = hmac_sha256(secret_key_, signing_input);
-
-        // Compare signatures (constant-time comparison to prevent timing attacks)
-        if (expected_signature.length() != calculated_signature.length()) {
-            return false;
-        }
-
-        bool signatures_match = true;
-        for (size_t i = 0; i < expected_signature.length(); ++i) {
-            if (expected_signature[i] != calculated_signature[i]) {
-                signatures_match = false;
-            }
-        }
-
-        if (!signatures_match) {
-            return false; // Invalid signature
-        }
-
-        // Verify token hasn't expired
-        std::string payload_json = base64_url_decode(payload_b64);
-
-        size_t exp_pos = payload_json.find("\"exp\":");
-        if (exp_pos != std::string::npos) {
-            exp_pos += 6;
-            size_t end_pos = payload_json.find(",}", exp_pos);
-            if (end_pos == std::string::npos) end_pos = payload_json.find("}", exp_pos);
-
-            if (end_pos != std::string::npos) {
-                try {
-                    int64_t exp_time = std::stoll(payload_json.substr(exp_pos, end_pos - exp_pos));
-                    int64_t current_time = std::time(nullptr);
-                    if (current_time >= exp_time) {
-                        return false; // Token expired
-                    }
-                } catch (...) {
-                    return false;
-                }
-            }
-        }
-
-        return true; // Token is cryptographically valid and not expired
-    }
-
-private:
-    std::string secret_key_;
-
-    std::string base64_url_decode(const std::string& input) {
-        std::string base64 = input;
-        // Replace URL-safe characters
-        for (char& c : base64) {
-            if (c == '-') c = '+';
-            if (c == '_') c = '/';
-        }
-
-        // Add padding
-        while (base64.length() % 4) {
-            base64 += '=';
-        }
-
-        // Simple base64 decode using BIO
-        BIO *bio, *b64;
-        int decode_len = base64.length();
-        std::vector<unsigned char> buffer(decode_len);
-
-        bio = BIO_new_mem_buf(base64.c_str(), -1);
-        b64 = BIO_new(BIO_f_base64());
-        bio = BIO_push(b64, bio);
-
-        BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-        int length = BIO_read(bio, buffer.data(), decode_len);
-        BIO_free_all(bio);
-
-        return std::string(buffer.begin(), buffer.begin() + length);
-    }
-
-    // Helper function to parse PostgreSQL array strings
-    nlohmann::json parse_pg_array(const std::string& pg_array_str) {
-        nlohmann::json result = nlohmann::json::array();
-
-        if (pg_array_str.empty() || pg_array_str == "{}") {
-            return result;
-        }
-
-        // Remove curly braces
-        std::string content = pg_array_str.substr(1, pg_array_str.length() - 2);
-
-        if (content.empty()) {
-            return result;
-        }
-
-        // Split by comma, handling quoted strings
-        std::vector<std::string> elements;
-        std::string current_element;
-        bool in_quotes = false;
-
-        for (size_t i = 0; i < content.length(); ++i) {
-            char c = content[i];
-
-            if (c == '"' && (i == 0 || content[i-1] != '\\')) {
-                in_quotes = !in_quotes;
-            } else if (c == ',' && !in_quotes) {
-                // Remove surrounding quotes if present
-                std::string elem = current_element;
-                if (!elem.empty() && elem.front() == '"' && elem.back() == '"') {
-                    elem = elem.substr(1, elem.length() - 2);
-                    // Unescape quotes
-                    size_t pos = 0;
-                    while ((pos = elem.find("\\\"", pos)) != std::string::npos) {
-                        elem.replace(pos, 2, "\"");
-                        pos += 1;
-                    }
-                }
-                elements.push_back(elem);
-                current_element.clear();
-            } else {
-                current_element += c;
-            }
-        }
-
-        // Add the last element
-        if (!current_element.empty()) {
-            std::string elem = current_element;
-            if (!elem.empty() && elem.front() == '"' && elem.back() == '"') {
-                elem = elem.substr(1, elem.length() - 2);
-                size_t pos = 0;
-                while ((pos = elem.find("\\\"", pos)) != std::string::npos) {
-                    elem.replace(pos, 2, "\"");
-                    pos += 1;
-                }
-            }
-            elements.push_back(elem);
-        }
-
-        // Convert to JSON array
-        for (const auto& elem : elements) {
-            result.push_back(elem);
-        }
-
-        return result;
-    }
-};
-
-} // namespace regulens
+#include "shared/auth/jwt_parser.hpp"
 
 // Production-grade Agent System Integration (Rule 1 compliance - NO STUBS)
 // All agent components are fully implemented and production-ready
@@ -1607,7 +1382,8 @@ int main() {
             return EXIT_FAILURE;
         }
 
-        g_jwt_parser = std::make_unique<regulens::JWTParser>(jwt_secret_env);
+        // Every request handler verifies tokens through this one parser and its cache
+        regulens::install_shared_jwt_parser(std::make_shared<regulens::JWTParser>(jwt_secret_env));
         std::cout << "🔐 JWT parser initialized successfully" << std::endl;
 
         // Validate OpenAI API Key
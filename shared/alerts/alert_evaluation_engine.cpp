@@ -5,6 +5,8 @@
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <set>
+#include <vector>
 
 namespace regulens {
 namespace alerts {
@@ -13,6 +15,7 @@ AlertEvaluationEngine::AlertEvaluationEngine(
     std::shared_ptr<PostgreSQLConnection> db_conn,
     std::shared_ptr<StructuredLogger> logger
 ) : db_conn_(db_conn), logger_(logger),
+    metrics_store_(db_conn, logger),
     running_(false), should_trigger_evaluation_(false),
     evaluation_interval_(DEFAULT_EVALUATION_INTERVAL) {
     
@@ -69,6 +72,10 @@ void AlertEvaluationEngine::trigger_evaluation() {
     logger_->log(LogLevel::DEBUG, "Manual evaluation triggered");
 }
 
+bool AlertEvaluationEngine::attach_event_bus(std::shared_ptr<EventBus> event_bus) {
+    return metrics_store_.attach_event_bus(event_bus);
+}
+
 AlertEvaluationEngine::EvaluationMetrics AlertEvaluationEngine::get_metrics() const {
     std::lock_guard<std::mutex> lock(metrics_mutex_);
     return metrics_;
@@ -137,10 +144,11 @@ void AlertEvaluationEngine::evaluate_all_rules() {
         return;
     }
     
-    // Get all enabled alert rules
+    // Get all enabled alert rules, with the cooldown state needed to skip them
     PGresult* result = PQexecParams(
         conn,
-        "SELECT rule_id, rule_name, rule_type, severity, condition, cooldown_minutes, last_triggered_at "
+        "SELECT rule_id, rule_name, rule_type, severity, condition, cooldown_minutes, "
+        "EXTRACT(EPOCH FROM last_triggered_at)::bigint "
         "FROM alert_rules WHERE is_enabled = true ORDER BY created_at",
         0, nullptr, nullptr, nullptr, nullptr, 0
     );
@@ -155,34 +163,58 @@ void AlertEvaluationEngine::evaluate_all_rules() {
     int num_rules = PQntuples(result);
     logger_->log(LogLevel::DEBUG, "Evaluating " + std::to_string(num_rules) + " alert rules");
     
+    std::vector<nlohmann::json> due_rules;
+    std::set<std::string> referenced_metrics;
+    due_rules.reserve(num_rules);
+    
     for (int i = 0; i < num_rules; i++) {
         try {
-            std::string rule_id = PQgetvalue(result, i, 0);
             std::string rule_name = PQgetvalue(result, i, 1);
-            std::string rule_type_str = PQgetvalue(result, i, 2);
-            std::string severity_str = PQgetvalue(result, i, 3);
-            nlohmann::json condition = nlohmann::json::parse(PQgetvalue(result, i, 4));
             int cooldown_minutes = std::stoi(PQgetvalue(result, i, 5));
+            std::optional<std::time_t> last_triggered;
+            if (!PQgetisnull(result, i, 6)) {
+                last_triggered = static_cast<std::time_t>(std::stoll(PQgetvalue(result, i, 6)));
+            }
             
             // Check if rule is in cooldown period
-            if (is_rule_in_cooldown(rule_id)) {
+            if (is_rule_in_cooldown(cooldown_minutes, last_triggered)) {
                 logger_->log(LogLevel::DEBUG, "Rule " + rule_name + " is in cooldown period");
                 continue;
             }
             
-            // Evaluate rule based on type
-            AlertRuleType rule_type = parse_rule_type(rule_type_str);
+            std::string rule_type_str = PQgetvalue(result, i, 2);
+            nlohmann::json condition = nlohmann::json::parse(PQgetvalue(result, i, 4));
+            
+            std::string metric_name = referenced_metric(rule_type_str, condition);
+            if (!metric_name.empty()) {
+                referenced_metrics.insert(metric_name);
+            }
             
-            nlohmann::json rule = {
-                {"rule_id", rule_id},
+            due_rules.push_back({
+                {"rule_id", PQgetvalue(result, i, 0)},
                 {"rule_name", rule_name},
                 {"rule_type", rule_type_str},
-                {"severity", severity_str},
+                {"severity", PQgetvalue(result, i, 3)},
                 {"condition", condition},
                 {"cooldown_minutes", cooldown_minutes}
-            };
+            });
+            
+        } catch (const std::exception& e) {
+            logger_->log(LogLevel::ERROR, "Error evaluating rule at index " + std::to_string(i) + ": " + e.what());
+        }
+    }
+    
+    PQclear(result);
+    
+    // Every metric is computed once per tick and shared by all rules that read it
+    metrics_store_.refresh(referenced_metrics);
+    
+    for (const auto& rule : due_rules) {
+        try {
+            std::string rule_id = rule["rule_id"];
             
-            switch (rule_type) {
+            // Evaluate rule based on type
+            switch (parse_rule_type(rule["rule_type"])) {
                 case AlertRuleType::THRESHOLD:
                     evaluate_threshold_rule(rule, rule_id);
                     break;
@@ -204,12 +236,10 @@ void AlertEvaluationEngine::evaluate_all_rules() {
             }
             
         } catch (const std::exception& e) {
-            logger_->log(LogLevel::ERROR, "Error evaluating rule at index " + std::to_string(i) + ": " + e.what());
+            logger_->log(LogLevel::ERROR, "Error evaluating rule " + rule["rule_name"].get<std::string>() + ": " + e.what());
         }
     }
     
-    PQclear(result);
-    
     // Process failed notifications for retry
     retry_failed_notifications();
 }
@@ -261,17 +291,12 @@ void AlertEvaluationEngine::evaluate_pattern_rule(const nlohmann::json& rule, co
     std::string data_source = condition["data_source"];
     
     // Collect data for pattern matching
-    nlohmann::json current_data;
-    if (data_source == "transactions") {
-        current_data = collect_transaction_metrics();
-    } else if (data_source == "system") {
-        current_data = collect_system_metrics();
-    } else if (data_source == "compliance") {
-        current_data = collect_compliance_metrics();
-    } else {
+    std::string metric_name = referenced_metric("pattern", condition);
+    if (metric_name.empty()) {
         logger_->log(LogLevel::WARN, "Unknown data source for pattern rule: " + data_source);
         return;
     }
+    nlohmann::json current_data = metrics_store_.get_metric(metric_name);
     
     // Evaluate pattern match
     bool pattern_matched = evaluate_pattern_match(pattern, current_data);
@@ -368,167 +393,27 @@ void AlertEvaluationEngine::evaluate_scheduled_rule(const nlohmann::json& rule,
 }
 
 nlohmann::json AlertEvaluationEngine::collect_metric_data(const std::string& metric_name) {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        return nlohmann::json{};
-    }
-    
-    // Map metric names to database queries
-    if (metric_name == "transaction_volume") {
-        return collect_transaction_metrics();
-    } else if (metric_name == "system_load") {
-        return collect_system_metrics();
-    } else if (metric_name == "compliance_score") {
-        return collect_compliance_metrics();
-    } else if (metric_name == "response_time") {
-        return collect_performance_metrics();
-    } else {
+    if (!AlertMetricsStore::is_known_metric(metric_name)) {
         logger_->log(LogLevel::WARN, "Unknown metric name: " + metric_name);
         return nlohmann::json{};
     }
-}
-
-nlohmann::json AlertEvaluationEngine::collect_transaction_metrics() {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        return nlohmann::json{};
-    }
-    
-    // Get transaction count in the last 5 minutes
-    PGresult* result = PQexecParams(
-        conn,
-        "SELECT COUNT(*) as count, AVG(amount) as avg_amount, MAX(amount) as max_amount "
-        "FROM transactions WHERE created_at >= NOW() - INTERVAL '5 minutes'",
-        0, nullptr, nullptr, nullptr, nullptr, 0
-    );
-    
-    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0) {
-        PQclear(result);
-        return nlohmann::json{};
-    }
-    
-    double transaction_count = static_cast<double>(std::stoi(PQgetvalue(result, 0, 0)));
-
-    nlohmann::json metrics = {
-        {"metric", "transaction_volume"},
-        {"value", transaction_count},
-        {"avg_amount", !PQgetisnull(result, 0, 1) ? std::stod(PQgetvalue(result, 0, 1)) : 0.0},
-        {"max_amount", !PQgetisnull(result, 0, 2) ? std::stod(PQgetvalue(result, 0, 2)) : 0.0},
-        {"timestamp", std::to_string(std::time(nullptr))}
-    };
-
-    PQclear(result);
-
-    // Store metric in history for anomaly detection
-    store_metric_history("transaction_volume", transaction_count, "transactions", "evaluation_engine");
-
-    return metrics;
-}
-
-nlohmann::json AlertEvaluationEngine::collect_system_metrics() {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        return nlohmann::json{};
-    }
-    
-    // Get system metrics from database or system monitoring
-    PGresult* result = PQexecParams(
-        conn,
-        "SELECT "
-        "(SELECT COUNT(*) FROM active_sessions) as active_sessions, "
-        "(SELECT COUNT(*) FROM audit_logs WHERE created_at >= NOW() - INTERVAL '5 minutes') as recent_log_entries",
-        0, nullptr, nullptr, nullptr, nullptr, 0
-    );
-    
-    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0) {
-        PQclear(result);
-        return nlohmann::json{};
-    }
-    
-    double active_sessions = static_cast<double>(std::stoi(PQgetvalue(result, 0, 0)));
-
-    nlohmann::json metrics = {
-        {"metric", "system_load"},
-        {"value", active_sessions},
-        {"active_sessions", std::stoi(PQgetvalue(result, 0, 0))},
-        {"recent_log_entries", std::stoi(PQgetvalue(result, 0, 1))},
-        {"timestamp", std::to_string(std::time(nullptr))}
-    };
-
-    PQclear(result);
-
-    // Store metric in history for anomaly detection
-    store_metric_history("system_load", active_sessions, "sessions", "evaluation_engine");
-
-    return metrics;
-}
-
-nlohmann::json AlertEvaluationEngine::collect_compliance_metrics() {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        return nlohmann::json{};
-    }
-    
-    // Get compliance score from recent compliance checks
-    PGresult* result = PQexecParams(
-        conn,
-        "SELECT AVG(compliance_score) as avg_score "
-        "FROM compliance_checks WHERE created_at >= NOW() - INTERVAL '1 hour'",
-        0, nullptr, nullptr, nullptr, nullptr, 0
-    );
-    
-    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0 || PQgetisnull(result, 0, 0)) {
-        PQclear(result);
-        return nlohmann::json{};
-    }
     
-    double score = std::stod(PQgetvalue(result, 0, 0));
-    PQclear(result);
-
-    // Store metric in history for anomaly detection
-    store_metric_history("compliance_score", score, "percentage", "evaluation_engine");
-
-    nlohmann::json metrics = {
-        {"metric", "compliance_score"},
-        {"value", score},
-        {"timestamp", std::to_string(std::time(nullptr))}
-    };
-
-    return metrics;
+    return metrics_store_.get_metric(metric_name);
 }
 
-nlohmann::json AlertEvaluationEngine::collect_performance_metrics() {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        return nlohmann::json{};
+std::string AlertEvaluationEngine::referenced_metric(const std::string& rule_type, const nlohmann::json& condition) {
+    if (rule_type == "threshold" || rule_type == "anomaly") {
+        return condition.value("metric", "");
     }
     
-    // Get average response time from recent API calls
-    PGresult* result = PQexecParams(
-        conn,
-        "SELECT AVG(response_time_ms) as avg_response_time "
-        "FROM api_logs WHERE created_at >= NOW() - INTERVAL '5 minutes'",
-        0, nullptr, nullptr, nullptr, nullptr, 0
-    );
-    
-    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0 || PQgetisnull(result, 0, 0)) {
-        PQclear(result);
-        return nlohmann::json{};
+    if (rule_type == "pattern") {
+        std::string data_source = condition.value("data_source", "");
+        if (data_source == "transactions") return "transaction_volume";
+        if (data_source == "system") return "system_load";
+        if (data_source == "compliance") return "compliance_score";
     }
     
-    double response_time = std::stod(PQgetvalue(result, 0, 0));
-    PQclear(result);
-
-    // Store metric in history for anomaly detection
-    store_metric_history("response_time", response_time, "milliseconds", "evaluation_engine");
-
-    nlohmann::json metrics = {
-        {"metric", "response_time"},
-        {"value", response_time},
-        {"timestamp", std::to_string(std::time(nullptr))}
-    };
-
-    return metrics;
+    return "";
 }
 
 bool AlertEvaluationEngine::evaluate_condition(const nlohmann::json& condition, const nlohmann::json& current_data) {
@@ -597,63 +482,8 @@ bool AlertEvaluationEngine::evaluate_anomaly_detection(const nlohmann::json& bas
 }
 
 nlohmann::json AlertEvaluationEngine::get_baseline_data(const std::string& metric_name) {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        return nlohmann::json{};
-    }
-    
-    // Get historical data for the last 24 hours to calculate baseline
-    const char* param_values[1] = {metric_name.c_str()};
-    PGresult* result = PQexecParams(
-        conn,
-        "SELECT AVG(value) as mean, STDDEV(value) as std_dev "
-        "FROM metric_history "
-        "WHERE metric_name = $1 AND created_at >= NOW() - INTERVAL '24 hours'",
-        1, nullptr, param_values, nullptr, nullptr, 0
-    );
-    
-    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0 || 
-        PQgetisnull(result, 0, 0) || PQgetisnull(result, 0, 1)) {
-        PQclear(result);
-        return nlohmann::json{};
-    }
-    
-    nlohmann::json baseline = {
-        {"mean", std::stod(PQgetvalue(result, 0, 0))},
-        {"std_dev", std::stod(PQgetvalue(result, 0, 1))}
-    };
-    
-    PQclear(result);
-    return baseline;
-}
-
-void AlertEvaluationEngine::store_metric_history(const std::string& metric_name, double value,
-                                                const std::string& unit, const std::string& source) {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        logger_->log(LogLevel::ERROR, "Failed to store metric history: no database connection");
-        return;
-    }
-
-    const char* param_values[4] = {
-        metric_name.c_str(),
-        std::to_string(value).c_str(),
-        unit.c_str(),
-        source.c_str()
-    };
-
-    PGresult* result = PQexecParams(
-        conn,
-        "INSERT INTO metric_history (metric_name, value, unit, source) "
-        "VALUES ($1, $2::double precision, $3, $4)",
-        4, nullptr, param_values, nullptr, nullptr, 0
-    );
-
-    if (PQresultStatus(result) != PGRES_COMMAND_OK) {
-        logger_->log(LogLevel::ERROR, "Failed to store metric history: " + std::string(PQerrorMessage(conn)));
-    }
-
-    PQclear(result);
+    // Rolling 24 hour mean and standard deviation kept by the metrics store
+    return metrics_store_.get_baseline(metric_name);
 }
 
 bool AlertEvaluationEngine::is_schedule_time(const std::string& schedule) {
@@ -725,39 +555,14 @@ void AlertEvaluationEngine::create_alert_incident(const std::string& rule_id, co
     }
 }
 
-bool AlertEvaluationEngine::is_rule_in_cooldown(const std::string& rule_id) {
-    auto conn = db_conn_->get_connection();
-    if (!conn) {
-        return true; // Fail safe - don't trigger if can't check
-    }
-    
-    const char* params[1] = {rule_id.c_str()};
-    PGresult* result = PQexecParams(
-        conn,
-        "SELECT cooldown_minutes, last_triggered_at FROM alert_rules WHERE rule_id = $1",
-        1, nullptr, params, nullptr, nullptr, 0
-    );
-    
-    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0) {
-        PQclear(result);
-        return true; // Rule not found
-    }
-    
-    int cooldown_minutes = std::stoi(PQgetvalue(result, 0, 0));
-    
-    if (PQgetisnull(result, 0, 1)) {
-        PQclear(result);
+bool AlertEvaluationEngine::is_rule_in_cooldown(int cooldown_minutes, std::optional<std::time_t> last_triggered) const {
+    if (!last_triggered) {
         return false; // Never triggered before
     }
     
-    std::string last_triggered_str = PQgetvalue(result, 0, 1);
-    PQclear(result);
-    
     // Check if cooldown period has passed
-    // This is a simplified check - in production, proper timestamp parsing would be needed
-    std::time_t last_triggered = std::stol(last_triggered_str);
     std::time_t now = std::time(nullptr);
-    double seconds_since_trigger = difftime(now, last_triggered);
+    double seconds_since_trigger = difftime(now, *last_triggered);
     double cooldown_seconds = cooldown_minutes * 60.0;
     
     return seconds_since_trigger < cooldown_seconds;
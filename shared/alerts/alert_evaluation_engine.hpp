@@ -7,9 +7,12 @@
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <ctime>
+#include <optional>
 #include <nlohmann/json.hpp>
 #include "../database/postgresql_connection.hpp"
 #include "../logging/structured_logger.hpp"
+#include "alert_metrics_store.hpp"
 
 namespace regulens {
 namespace alerts {
@@ -35,6 +38,9 @@ public:
     // Manual evaluation trigger
     void trigger_evaluation();
     
+    // Feed metrics from published events instead of polling their tables
+    bool attach_event_bus(std::shared_ptr<EventBus> event_bus);
+    
     // Metrics collection
     struct EvaluationMetrics {
         uint64_t total_evaluations = 0;
@@ -59,12 +65,9 @@ private:
     void evaluate_anomaly_rule(const nlohmann::json& rule, const std::string& rule_id);
     void evaluate_scheduled_rule(const nlohmann::json& rule, const std::string& rule_id);
     
-    // Data collection methods
+    // Data collection methods (read from the metrics store, refreshed once per tick)
     nlohmann::json collect_metric_data(const std::string& metric_name);
-    nlohmann::json collect_transaction_metrics();
-    nlohmann::json collect_system_metrics();
-    nlohmann::json collect_compliance_metrics();
-    nlohmann::json collect_performance_metrics();
+    static std::string referenced_metric(const std::string& rule_type, const nlohmann::json& condition);
     
     // Condition evaluation
     bool evaluate_condition(const nlohmann::json& condition, const nlohmann::json& current_data);
@@ -77,13 +80,11 @@ private:
                               const nlohmann::json& incident_data);
     
     // Cooldown management
-    bool is_rule_in_cooldown(const std::string& rule_id);
+    bool is_rule_in_cooldown(int cooldown_minutes, std::optional<std::time_t> last_triggered) const;
     void update_rule_last_triggered(const std::string& rule_id);
     
     // Baseline data for anomaly detection
     nlohmann::json get_baseline_data(const std::string& metric_name);
-    void store_metric_history(const std::string& metric_name, double value,
-                             const std::string& unit, const std::string& source);
     
     // Schedule evaluation
     bool is_schedule_time(const std::string& schedule);
@@ -99,6 +100,8 @@ private:
     std::shared_ptr<PostgreSQLConnection> db_conn_;
     std::shared_ptr<StructuredLogger> logger_;
     
+    AlertMetricsStore metrics_store_;
+    
     std::atomic<bool> running_;
     std::atomic<bool> should_trigger_evaluation_;
     std::thread evaluation_thread_;
@@ -0,0 +1,573 @@
+#include "alert_metrics_store.hpp"
+#include "../event_system/event_bus.hpp"
+#include <libpq-fe.h>
+#include <algorithm>
+#include <cmath>
+
+namespace regulens {
+namespace alerts {
+
+namespace {
+
+int64_t to_epoch_second(std::chrono::system_clock::time_point when) {
+    return std::chrono::duration_cast<std::chrono::seconds>(when.time_since_epoch()).count();
+}
+
+struct DeltaRow {
+    int64_t second;
+    uint64_t count;
+    double sum;
+    double max;
+};
+
+/**
+ * Feeds the store from published events so the evaluation tick need not
+ * poll the transactions, api_logs and compliance_checks tables.
+ */
+class AlertMetricsEventHandler : public EventHandler {
+public:
+    explicit AlertMetricsEventHandler(AlertMetricsStore* store) : store_(store) {}
+
+    void handle_event(std::shared_ptr<const Event> event) override {
+        const auto& payload = event->get_payload();
+        auto when = event->get_created_at();
+
+        if (event->get_category() == EventCategory::TRANSACTION_PROCESSED) {
+            // Follow-up events (FLAGGED, REVIEW_REQUESTED, ...) must not count the transaction again
+            std::string event_type = payload.value("event_type", "");
+            if (event_type != "CREATED" && event_type != "PROCESSED") {
+                return;
+            }
+            const auto& data = payload.value("transaction_data", nlohmann::json::object());
+            if (data.contains("amount") && data["amount"].is_number()) {
+                store_->record_transaction(data["amount"].get<double>(), when);
+            }
+        } else if (event->get_category() == EventCategory::SYSTEM_PERFORMANCE_METRIC) {
+            if (!payload.contains("value") || !payload["value"].is_number()) {
+                return;
+            }
+            std::string metric_name = payload.value("metric_name", "");
+            if (metric_name == "response_time") {
+                store_->record_response_time(payload["value"].get<double>(), when);
+            } else if (metric_name == "compliance_score") {
+                store_->record_compliance_score(payload["value"].get<double>(), when);
+            }
+        }
+    }
+
+    std::vector<EventCategory> get_supported_categories() const override {
+        return {EventCategory::TRANSACTION_PROCESSED, EventCategory::SYSTEM_PERFORMANCE_METRIC};
+    }
+
+    std::string get_handler_id() const override { return HANDLER_ID; }
+    bool is_active() const override { return true; }
+
+    static constexpr const char* HANDLER_ID = "alert_metrics_store";
+
+private:
+    AlertMetricsStore* store_;
+};
+
+} // namespace
+
+// SlidingWindowCounter
+
+SlidingWindowCounter::SlidingWindowCounter(std::chrono::seconds window)
+    : buckets_(static_cast<size_t>(std::max<int64_t>(1, window.count()))) {}
+
+SlidingWindowCounter::Bucket* SlidingWindowCounter::bucket_for(int64_t epoch_second) {
+    int64_t size = static_cast<int64_t>(buckets_.size());
+    Bucket& bucket = buckets_[static_cast<size_t>(((epoch_second % size) + size) % size)];
+    if (bucket.second != epoch_second) {
+        // A slot already holding a newer second means this sample has left the window
+        if (bucket.second != INT64_MIN && bucket.second > epoch_second) {
+            return nullptr;
+        }
+        bucket = Bucket{};
+        bucket.second = epoch_second;
+    }
+    return &bucket;
+}
+
+void SlidingWindowCounter::add(double value, int64_t epoch_second) {
+    add_aggregate(1, value, value, epoch_second);
+}
+
+void SlidingWindowCounter::add_aggregate(uint64_t count, double sum, double max, int64_t epoch_second) {
+    if (count == 0) {
+        return;
+    }
+
+    Bucket* bucket = bucket_for(epoch_second);
+    if (!bucket) {
+        return;
+    }
+    bucket->max = bucket->count == 0 ? max : std::max(bucket->max, max);
+    bucket->count += count;
+    bucket->sum += sum;
+}
+
+SlidingWindowCounter::Summary SlidingWindowCounter::summarize(int64_t now_epoch_second) const {
+    Summary summary;
+    int64_t oldest = now_epoch_second - static_cast<int64_t>(buckets_.size());
+    for (const auto& bucket : buckets_) {
+        if (bucket.count == 0 || bucket.second <= oldest || bucket.second > now_epoch_second) {
+            continue;
+        }
+        summary.max = summary.count == 0 ? bucket.max : std::max(summary.max, bucket.max);
+        summary.count += bucket.count;
+        summary.sum += bucket.sum;
+    }
+    return summary;
+}
+
+// RollingBaseline
+
+void RollingBaseline::add(double value, int64_t epoch_second) {
+    samples_.emplace_back(epoch_second, value);
+    sum_ += value;
+    sum_sq_ += value * value;
+    evict(epoch_second);
+}
+
+void RollingBaseline::evict(int64_t now_epoch_second) {
+    int64_t oldest = now_epoch_second - horizon_.count();
+    while (!samples_.empty() && samples_.front().first < oldest) {
+        double value = samples_.front().second;
+        sum_ -= value;
+        sum_sq_ -= value * value;
+        samples_.pop_front();
+    }
+}
+
+double RollingBaseline::mean() const {
+    return samples_.empty() ? 0.0 : sum_ / static_cast<double>(samples_.size());
+}
+
+double RollingBaseline::std_dev() const {
+    if (samples_.size() < 2) {
+        return 0.0;
+    }
+    double n = static_cast<double>(samples_.size());
+    double variance = (sum_sq_ - sum_ * sum_ / n) / (n - 1.0);
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+// AlertMetricsStore
+
+AlertMetricsStore::AlertMetricsStore(
+    std::shared_ptr<PostgreSQLConnection> db_conn,
+    std::shared_ptr<StructuredLogger> logger
+) : db_conn_(db_conn), logger_(logger) {
+    int64_t now = to_epoch_second(std::chrono::system_clock::now());
+
+    // Watermarks start one window back so the first refresh backfills the whole window
+    auto add_source = [&](Source source, const char* table, const char* value_column,
+                          std::chrono::seconds window) {
+        sources_.emplace(source, SourceState{table, value_column, SlidingWindowCounter(window),
+                                             now - window.count()});
+    };
+    add_source(Source::TRANSACTIONS, "transactions", "amount", std::chrono::minutes(5));
+    add_source(Source::AUDIT_LOGS, "audit_logs", nullptr, std::chrono::minutes(5));
+    add_source(Source::COMPLIANCE_CHECKS, "compliance_checks", "compliance_score", std::chrono::hours(1));
+    add_source(Source::API_LOGS, "api_logs", "response_time_ms", std::chrono::minutes(5));
+}
+
+AlertMetricsStore::~AlertMetricsStore() {
+    if (event_bus_) {
+        event_bus_->unsubscribe(AlertMetricsEventHandler::HANDLER_ID);
+    }
+}
+
+const std::vector<AlertMetricsStore::MetricDefinition>& AlertMetricsStore::metric_definitions() {
+    static const std::vector<MetricDefinition> definitions = {
+        {"transaction_volume", "transactions", {Source::TRANSACTIONS}},
+        {"system_load", "sessions", {Source::AUDIT_LOGS}},
+        {"compliance_score", "percentage", {Source::COMPLIANCE_CHECKS}},
+        {"response_time", "milliseconds", {Source::API_LOGS}}
+    };
+    return definitions;
+}
+
+const AlertMetricsStore::MetricDefinition* AlertMetricsStore::find_definition(const std::string& metric_name) {
+    for (const auto& definition : metric_definitions()) {
+        if (metric_name == definition.name) {
+            return &definition;
+        }
+    }
+    return nullptr;
+}
+
+bool AlertMetricsStore::is_known_metric(const std::string& metric_name) {
+    return find_definition(metric_name) != nullptr;
+}
+
+void AlertMetricsStore::record_transaction(double amount, std::chrono::system_clock::time_point when) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.at(Source::TRANSACTIONS).window.add(amount, to_epoch_second(when));
+    events_recorded_++;
+}
+
+void AlertMetricsStore::record_response_time(double milliseconds, std::chrono::system_clock::time_point when) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.at(Source::API_LOGS).window.add(milliseconds, to_epoch_second(when));
+    events_recorded_++;
+}
+
+void AlertMetricsStore::record_compliance_score(double score, std::chrono::system_clock::time_point when) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sources_.at(Source::COMPLIANCE_CHECKS).window.add(score, to_epoch_second(when));
+    events_recorded_++;
+}
+
+bool AlertMetricsStore::attach_event_bus(std::shared_ptr<EventBus> event_bus) {
+    if (!event_bus) {
+        return false;
+    }
+
+    if (!event_bus->subscribe(std::make_shared<AlertMetricsEventHandler>(this))) {
+        logger_->log(LogLevel::ERROR, "Failed to subscribe alert metrics store to event bus");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    event_bus_ = event_bus;
+    for (Source source : {Source::TRANSACTIONS, Source::COMPLIANCE_CHECKS, Source::API_LOGS}) {
+        sources_.at(source).event_fed = true;
+    }
+
+    logger_->log(LogLevel::INFO, "Alert metrics store is now fed by the event bus");
+    return true;
+}
+
+void AlertMetricsStore::refresh(const std::set<std::string>& metric_names) {
+    std::vector<const MetricDefinition*> definitions;
+    std::set<Source> polled_sources;
+    for (const auto& metric_name : metric_names) {
+        const MetricDefinition* definition = find_definition(metric_name);
+        if (!definition) {
+            continue;
+        }
+        definitions.push_back(definition);
+        for (Source source : definition->sources) {
+            polled_sources.insert(source);
+        }
+    }
+
+    int64_t now = to_epoch_second(std::chrono::system_clock::now());
+    int64_t up_to = now - INGEST_LAG_SECONDS;
+
+    // Sources fed by events need no query
+    std::vector<SourceState*> delta_sources;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Source source : polled_sources) {
+            SourceState& state = sources_.at(source);
+            if (!state.event_fed) {
+                delta_sources.push_back(&state);
+            }
+        }
+    }
+
+    // created_at is stamped when a row is written, not when it commits, so a
+    // second is only complete once every transaction open during it has ended
+    int64_t horizon = 0;
+    if (!delta_sources.empty() && query_commit_horizon(now, horizon)) {
+        up_to = std::min(up_to, horizon - 1);
+    }
+
+    // Fold in rows inserted since the last tick
+    for (SourceState* state : delta_sources) {
+        if (state->watermark < up_to) {
+            pull_source_delta(*state, up_to);
+        }
+    }
+
+    double active_sessions = 0.0;
+    bool have_sessions = metric_names.count("system_load") > 0 && query_active_sessions(active_sessions);
+
+    std::vector<std::pair<const MetricDefinition*, double>> history;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        refreshes_++;
+
+        for (const MetricDefinition* definition : definitions) {
+            nlohmann::json snapshot = compute_metric(*definition, up_to);
+            if (std::string(definition->name) == "system_load") {
+                if (!have_sessions) {
+                    snapshot = nlohmann::json{};
+                } else {
+                    snapshot["value"] = active_sessions;
+                    snapshot["active_sessions"] = static_cast<int64_t>(active_sessions);
+                }
+            }
+
+            snapshots_[definition->name] = snapshot;
+            if (snapshot.contains("value")) {
+                history.emplace_back(definition, snapshot["value"].get<double>());
+            }
+        }
+    }
+
+    // Baselines and history are updated once per metric and tick, not once per rule
+    for (const auto& [definition, value] : history) {
+        bool needs_seed;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            needs_seed = baselines_.find(definition->name) == baselines_.end();
+        }
+
+        RollingBaseline seeded(BASELINE_HORIZON);
+        if (needs_seed) {
+            seed_baseline(definition->name, seeded);
+        }
+
+        store_metric_history(definition->name, value, definition->unit);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = baselines_.find(definition->name);
+        if (it == baselines_.end()) {
+            it = baselines_.emplace(definition->name, std::move(seeded)).first;
+        }
+        it->second.add(value, now);
+    }
+}
+
+bool AlertMetricsStore::pull_source_delta(SourceState& source, int64_t up_to) {
+    auto conn = db_conn_->get_connection();
+    if (!conn) {
+        return false;
+    }
+
+    std::string value_expr = source.value_column ? source.value_column : "0";
+    std::string query =
+        "SELECT FLOOR(EXTRACT(EPOCH FROM created_at))::bigint AS second, COUNT(*), "
+        "COALESCE(SUM(" + value_expr + "), 0)::double precision, "
+        "COALESCE(MAX(" + value_expr + "), 0)::double precision "
+        "FROM " + std::string(source.table) + " "
+        "WHERE created_at >= to_timestamp($1) AND created_at < to_timestamp($2)" +
+        (source.value_column ? " AND " + value_expr + " IS NOT NULL" : std::string()) +
+        " GROUP BY 1";
+
+    // Seconds (watermark, up_to] are folded in; both bounds are whole seconds
+    std::string from_str = std::to_string(source.watermark + 1);
+    std::string to_str = std::to_string(up_to + 1);
+    const char* params[2] = {from_str.c_str(), to_str.c_str()};
+
+    PGresult* result = PQexecParams(conn, query.c_str(), 2, nullptr, params, nullptr, nullptr, 0);
+    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+        logger_->log(LogLevel::ERROR, "Failed to read new rows from " + std::string(source.table) + ": " +
+                    std::string(PQerrorMessage(conn)));
+        PQclear(result);
+        return false;
+    }
+
+    std::vector<DeltaRow> rows;
+    int num_rows = PQntuples(result);
+    rows.reserve(static_cast<size_t>(num_rows));
+    for (int i = 0; i < num_rows; i++) {
+        rows.push_back({
+            std::stoll(PQgetvalue(result, i, 0)),
+            std::stoull(PQgetvalue(result, i, 1)),
+            std::stod(PQgetvalue(result, i, 2)),
+            std::stod(PQgetvalue(result, i, 3))
+        });
+    }
+    PQclear(result);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& row : rows) {
+        source.window.add_aggregate(row.count, row.sum, row.max, row.second);
+    }
+    source.watermark = up_to;
+    delta_queries_++;
+    return true;
+}
+
+bool AlertMetricsStore::query_commit_horizon(int64_t now, int64_t& horizon) {
+    auto conn = db_conn_->get_connection();
+    if (!conn) {
+        return false;
+    }
+
+    // Start of the oldest transaction that has written something (holds an xid);
+    // NULL when none is open
+    PGresult* result = PQexecParams(
+        conn,
+        "SELECT FLOOR(EXTRACT(EPOCH FROM MIN(xact_start)))::bigint FROM pg_stat_activity "
+        "WHERE backend_xid IS NOT NULL AND pid <> pg_backend_pid()",
+        0, nullptr, nullptr, nullptr, nullptr, 0
+    );
+
+    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0) {
+        logger_->log(LogLevel::WARN, "Failed to read open transactions, polling with the minimum lag: " +
+                    std::string(PQerrorMessage(conn)));
+        PQclear(result);
+        return false;
+    }
+
+    horizon = PQgetisnull(result, 0, 0) ? now : std::stoll(PQgetvalue(result, 0, 0));
+    PQclear(result);
+
+    if (horizon < now - MAX_INGEST_LAG_SECONDS) {
+        logger_->log(LogLevel::WARN, "A write transaction has been open for over " +
+                    std::to_string(MAX_INGEST_LAG_SECONDS) + "s; its rows may be missing from alert metrics");
+        horizon = now - MAX_INGEST_LAG_SECONDS;
+    }
+    return true;
+}
+
+bool AlertMetricsStore::query_active_sessions(double& active_sessions) {
+    auto conn = db_conn_->get_connection();
+    if (!conn) {
+        return false;
+    }
+
+    // A gauge rather than a stream of inserts, so it is read directly (once per tick)
+    PGresult* result = PQexecParams(
+        conn,
+        "SELECT COUNT(*) FROM active_sessions",
+        0, nullptr, nullptr, nullptr, nullptr, 0
+    );
+
+    if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0) {
+        PQclear(result);
+        return false;
+    }
+
+    active_sessions = static_cast<double>(std::stoll(PQgetvalue(result, 0, 0)));
+    PQclear(result);
+    return true;
+}
+
+nlohmann::json AlertMetricsStore::compute_metric(const MetricDefinition& definition, int64_t now) {
+    std::string name = definition.name;
+    std::string timestamp = std::to_string(std::time(nullptr));
+
+    if (name == "transaction_volume") {
+        auto summary = sources_.at(Source::TRANSACTIONS).window.summarize(now);
+        return {
+            {"metric", name},
+            {"value", static_cast<double>(summary.count)},
+            {"avg_amount", summary.mean()},
+            {"max_amount", summary.max},
+            {"timestamp", timestamp}
+        };
+    }
+
+    if (name == "system_load") {
+        auto summary = sources_.at(Source::AUDIT_LOGS).window.summarize(now);
+        return {
+            {"metric", name},
+            {"recent_log_entries", summary.count},
+            {"timestamp", timestamp}
+        };
+    }
+
+    // Averages over an empty window have no value, as AVG() over no rows is NULL
+    Source source = name == "compliance_score" ? Source::COMPLIANCE_CHECKS : Source::API_LOGS;
+    auto summary = sources_.at(source).window.summarize(now);
+    if (summary.count == 0) {
+        return nlohmann::json{};
+    }
+    return {
+        {"metric", name},
+        {"value", summary.mean()},
+        {"timestamp", timestamp}
+    };
+}
+
+void AlertMetricsStore::seed_baseline(const std::string& metric_name, RollingBaseline& baseline) {
+    auto conn = db_conn_->get_connection();
+    if (!conn) {
+        return;
+    }
+
+    const char* params[1] = {metric_name.c_str()};
+    PGresult* result = PQexecParams(
+        conn,
+        "SELECT FLOOR(EXTRACT(EPOCH FROM created_at))::bigint, value FROM metric_history "
+        "WHERE metric_name = $1 AND created_at >= NOW() - INTERVAL '24 hours' "
+        "ORDER BY created_at",
+        1, nullptr, params, nullptr, nullptr, 0
+    );
+
+    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
+        logger_->log(LogLevel::WARN, "Failed to seed baseline for metric " + metric_name + ": " +
+                    std::string(PQerrorMessage(conn)));
+        PQclear(result);
+        return;
+    }
+
+    int num_rows = PQntuples(result);
+    for (int i = 0; i < num_rows; i++) {
+        baseline.add(std::stod(PQgetvalue(result, i, 1)), std::stoll(PQgetvalue(result, i, 0)));
+    }
+    PQclear(result);
+}
+
+void AlertMetricsStore::store_metric_history(const std::string& metric_name, double value,
+                                            const std::string& unit) {
+    auto conn = db_conn_->get_connection();
+    if (!conn) {
+        logger_->log(LogLevel::ERROR, "Failed to store metric history: no database connection");
+        return;
+    }
+
+    std::string value_str = std::to_string(value);
+    const char* param_values[4] = {
+        metric_name.c_str(),
+        value_str.c_str(),
+        unit.c_str(),
+        "evaluation_engine"
+    };
+
+    PGresult* result = PQexecParams(
+        conn,
+        "INSERT INTO metric_history (metric_name, value, unit, source) "
+        "VALUES ($1, $2::double precision, $3, $4)",
+        4, nullptr, param_values, nullptr, nullptr, 0
+    );
+
+    if (PQresultStatus(result) != PGRES_COMMAND_OK) {
+        logger_->log(LogLevel::ERROR, "Failed to store metric history: " + std::string(PQerrorMessage(conn)));
+    }
+
+    PQclear(result);
+}
+
+nlohmann::json AlertMetricsStore::get_metric(const std::string& metric_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = snapshots_.find(metric_name);
+    return it != snapshots_.end() ? it->second : nlohmann::json{};
+}
+
+nlohmann::json AlertMetricsStore::get_baseline(const std::string& metric_name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = baselines_.find(metric_name);
+    if (it == baselines_.end() || it->second.size() < 2) {
+        return nlohmann::json{};
+    }
+    return {
+        {"mean", it->second.mean()},
+        {"std_dev", it->second.std_dev()}
+    };
+}
+
+nlohmann::json AlertMetricsStore::get_statistics() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json baselines = nlohmann::json::object();
+    for (const auto& [name, baseline] : baselines_) {
+        baselines[name] = baseline.size();
+    }
+    return {
+        {"refreshes", refreshes_},
+        {"delta_queries", delta_queries_},
+        {"events_recorded", events_recorded_},
+        {"event_fed", event_bus_ != nullptr},
+        {"baseline_samples", baselines}
+    };
+}
+
+} // namespace alerts
+} // namespace regulens
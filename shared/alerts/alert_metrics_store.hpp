@@ -0,0 +1,182 @@
+#ifndef REGULENS_ALERT_METRICS_STORE_HPP
+#define REGULENS_ALERT_METRICS_STORE_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <set>
+#include <map>
+#include <climits>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "../database/postgresql_connection.hpp"
+#include "../logging/structured_logger.hpp"
+
+namespace regulens {
+
+class EventBus;
+
+namespace alerts {
+
+/**
+ * Sliding-window counter with one bucket per second.
+ * Buckets are reused in place as the window slides, so updates and
+ * summaries never allocate.
+ */
+class SlidingWindowCounter {
+public:
+    explicit SlidingWindowCounter(std::chrono::seconds window);
+
+    struct Summary {
+        uint64_t count = 0;
+        double sum = 0.0;
+        double max = 0.0;
+        double mean() const { return count > 0 ? sum / static_cast<double>(count) : 0.0; }
+    };
+
+    void add(double value, int64_t epoch_second);
+    void add_aggregate(uint64_t count, double sum, double max, int64_t epoch_second);
+    Summary summarize(int64_t now_epoch_second) const;
+
+private:
+    struct Bucket {
+        int64_t second = INT64_MIN;
+        uint64_t count = 0;
+        double sum = 0.0;
+        double max = 0.0;
+    };
+
+    Bucket* bucket_for(int64_t epoch_second);  // nullptr if the second has left the window
+
+    std::vector<Bucket> buckets_;
+};
+
+/**
+ * Rolling mean / standard deviation over the per-tick values of one metric.
+ */
+class RollingBaseline {
+public:
+    explicit RollingBaseline(std::chrono::seconds horizon) : horizon_(horizon) {}
+
+    void add(double value, int64_t epoch_second);
+    size_t size() const { return samples_.size(); }
+    double mean() const;
+    double std_dev() const;  // sample standard deviation, matching SQL STDDEV
+
+private:
+    void evict(int64_t now_epoch_second);
+
+    std::chrono::seconds horizon_;
+    std::deque<std::pair<int64_t, double>> samples_;
+    double sum_ = 0.0;
+    double sum_sq_ = 0.0;
+};
+
+/**
+ * Alert Metrics Store
+ *
+ * Keeps every metric an alert rule can reference in memory so that an
+ * evaluation tick computes each distinct metric once, however many rules
+ * read it. Sources are fed incrementally into sliding-window counters:
+ *  - by the EventBus (TRANSACTION_PROCESSED and SYSTEM_PERFORMANCE_METRIC
+ *    events) once attach_event_bus() has been called, or
+ *  - otherwise by one delta query per source and tick that aggregates only
+ *    the rows inserted since the previous tick, grouped per second. The
+ *    watermark stays behind the start of the oldest open write transaction,
+ *    whose rows carry created_at values from before they become visible.
+ * Anomaly baselines are rolling 24h statistics of the per-tick values,
+ * seeded once from metric_history and written back once per tick.
+ */
+class AlertMetricsStore {
+public:
+    AlertMetricsStore(
+        std::shared_ptr<PostgreSQLConnection> db_conn,
+        std::shared_ptr<StructuredLogger> logger
+    );
+
+    ~AlertMetricsStore();
+
+    AlertMetricsStore(const AlertMetricsStore&) = delete;
+    AlertMetricsStore& operator=(const AlertMetricsStore&) = delete;
+
+    // Incremental feeds (thread-safe; event handlers call these)
+    void record_transaction(double amount, std::chrono::system_clock::time_point when);
+    void record_response_time(double milliseconds, std::chrono::system_clock::time_point when);
+    void record_compliance_score(double score, std::chrono::system_clock::time_point when);
+
+    /**
+     * @brief Feed transactions, response times and compliance scores from the
+     * event bus instead of polling their tables. Only attach when producers
+     * publish those events, otherwise the metrics stay empty.
+     */
+    bool attach_event_bus(std::shared_ptr<EventBus> event_bus);
+
+    /**
+     * @brief Bring the named metrics up to date; called once per evaluation tick
+     */
+    void refresh(const std::set<std::string>& metric_names);
+
+    // Snapshot of a metric as of the last refresh, or {} if it has no data
+    nlohmann::json get_metric(const std::string& metric_name) const;
+    nlohmann::json get_baseline(const std::string& metric_name) const;
+
+    nlohmann::json get_statistics() const;
+
+    static bool is_known_metric(const std::string& metric_name);
+
+private:
+    enum class Source { TRANSACTIONS, AUDIT_LOGS, COMPLIANCE_CHECKS, API_LOGS };
+
+    struct SourceState {
+        const char* table;
+        const char* value_column;  // nullptr for count-only sources
+        SlidingWindowCounter window;
+        int64_t watermark;  // epoch second up to which rows have been folded in (refresh thread only)
+        bool event_fed = false;
+    };
+
+    struct MetricDefinition {
+        const char* name;
+        const char* unit;
+        std::vector<Source> sources;
+    };
+
+    static const std::vector<MetricDefinition>& metric_definitions();
+    static const MetricDefinition* find_definition(const std::string& metric_name);
+
+    bool pull_source_delta(SourceState& source, int64_t up_to);
+    bool query_commit_horizon(int64_t now, int64_t& horizon);
+    bool query_active_sessions(double& active_sessions);
+    nlohmann::json compute_metric(const MetricDefinition& definition, int64_t now);
+    void seed_baseline(const std::string& metric_name, RollingBaseline& baseline);
+    void store_metric_history(const std::string& metric_name, double value, const std::string& unit);
+
+    std::shared_ptr<PostgreSQLConnection> db_conn_;
+    std::shared_ptr<StructuredLogger> logger_;
+    std::shared_ptr<EventBus> event_bus_;
+
+    mutable std::mutex mutex_;
+    std::map<Source, SourceState> sources_;
+    std::map<std::string, nlohmann::json> snapshots_;
+    std::map<std::string, RollingBaseline> baselines_;
+
+    // Statistics
+    uint64_t refreshes_ = 0;
+    uint64_t delta_queries_ = 0;
+    uint64_t events_recorded_ = 0;
+
+    static constexpr std::chrono::seconds BASELINE_HORIZON{24 * 3600};
+    // Rows committed this close to "now" may still be in flight; leave them for the next tick
+    static constexpr int64_t INGEST_LAG_SECONDS = 1;
+    // Upper bound on how far polling waits behind the oldest open write
+    // transaction; rows from transactions open longer than this are missed
+    static constexpr int64_t MAX_INGEST_LAG_SECONDS = 600;
+};
+
+} // namespace alerts
+} // namespace regulens
+
+#endif // REGULENS_ALERT_METRICS_STORE_HPP
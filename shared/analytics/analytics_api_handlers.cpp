@@ -176,8 +176,12 @@ HTTPResponse AnalyticsAPIHandlers::handle_get_redundant_rules(const HTTPRequest&
     if (req.body.contains("similarity_threshold")) {
       threshold = req.body["similarity_threshold"].get<double>();
     }
+    std::optional<double> containment_threshold;
+    if (req.body.contains("containment_threshold")) {
+      containment_threshold = req.body["containment_threshold"].get<double>();
+    }
     
-    json redundant = rule_engine_->get_redundant_rules(threshold);
+    json redundant = rule_engine_->get_redundant_rules(threshold, containment_threshold);
     return create_success_response({{"redundant_rules", redundant}});
   } catch (const std::exception& e) {
     logger->error("Error getting redundant rules: {}", e.what());
@@ -210,8 +214,11 @@ HTTPResponse AnalyticsAPIHandlers::handle_record_rule_execution(const HTTPReques
     std::string rule_id = req.body["rule_id"].get<std::string>();
     bool was_successful = req.body["was_successful"].get<bool>();
     double execution_time = req.body.value("execution_time_ms", 0.0);
+    std::string transaction_id = req.body.value("transaction_id", "");
+    bool fired = req.body.value("fired", false);
     
-    bool success = rule_engine_->record_rule_execution(rule_id, was_successful, execution_time);
+    bool success = rule_engine_->record_rule_execution(rule_id, was_successful, execution_time,
+                                                       transaction_id, fired);
     return create_success_response({{"recorded", success}});
   } catch (const std::exception& e) {
     logger->error("Error recording rule execution: {}", e.what());
@@ -253,6 +260,7 @@ HTTPResponse AnalyticsAPIHandlers::handle_get_rule_stats(const HTTPRequest& req)
       {"avg_recall", stats.avg_recall},
       {"avg_f1_score", stats.avg_f1_score},
       {"redundant_rule_pairs", stats.redundant_rule_pairs},
+      {"dead_rules", stats.dead_rules},
     });
   } catch (const std::exception& e) {
     logger->error("Error getting rule stats: {}", e.what());
@@ -11,7 +11,9 @@
 namespace regulens {
 namespace analytics {
 
-RulePerformanceAnalyticsEngine::RulePerformanceAnalyticsEngine() {
+RulePerformanceAnalyticsEngine::RulePerformanceAnalyticsEngine(size_t co_firing_window, size_t dead_rule_executions)
+    : co_firing_window_(std::max<size_t>(1, co_firing_window)),
+      dead_rule_executions_(std::max<size_t>(1, dead_rule_executions)) {
   auto logger = logging::get_logger("rule_analytics");
   logger->info("RulePerformanceAnalyticsEngine initialized");
 }
@@ -21,7 +23,9 @@ RulePerformanceAnalyticsEngine::~RulePerformanceAnalyticsEngine() = default;
 bool RulePerformanceAnalyticsEngine::record_rule_execution(
     const std::string& rule_id,
     bool was_successful,
-    double execution_time_ms) {
+    double execution_time_ms,
+    const std::string& transaction_id,
+    bool fired) {
   auto logger = logging::get_logger("rule_analytics");
   
   std::lock_guard<std::mutex> lock(data_lock_);
@@ -50,6 +54,16 @@ bool RulePerformanceAnalyticsEngine::record_rule_execution(
   metrics.last_executed = std::chrono::system_clock::now();
   record.last_updated = std::chrono::system_clock::now();
   
+  if (!transaction_id.empty()) {
+    uint32_t rule = intern_rule(rule_id);
+    if (fired) {
+      executions_since_fire_[rule] = 0;
+      record_co_firing(rule, transaction_id);
+    } else {
+      executions_since_fire_[rule]++;
+    }
+  }
+  
   logger->debug("Rule execution recorded: {} - {} ms", rule_id, execution_time_ms);
   return true;
 }
@@ -125,11 +139,16 @@ std::vector<RuleEffectivenessRecord> RulePerformanceAnalyticsEngine::get_all_rul
   return result;
 }
 
-json RulePerformanceAnalyticsEngine::get_redundant_rules(double similarity_threshold) {
+json RulePerformanceAnalyticsEngine::get_redundant_rules(double similarity_threshold,
+                                                         std::optional<double> containment_threshold) {
   std::lock_guard<std::mutex> lock(data_lock_);
   
   json redundant = json::array();
   
+  for (const auto& pair : co_firing_pairs(similarity_threshold, containment_threshold)) {
+    redundant.push_back(co_firing_pair_json(pair, rule_ids_));
+  }
+  
   for (const auto& interaction : rule_interactions_) {
     if (interaction.similarity_score >= similarity_threshold) {
       redundant.push_back(json{
@@ -138,6 +157,7 @@ json RulePerformanceAnalyticsEngine::get_redundant_rules(double similarity_thres
         {"similarity_score", interaction.similarity_score},
         {"overlapping_triggers", interaction.overlapping_triggers},
         {"conflicting_outcomes", interaction.conflicting_outcomes},
+        {"source", "recorded"},
       });
     }
   }
@@ -145,11 +165,31 @@ json RulePerformanceAnalyticsEngine::get_redundant_rules(double similarity_thres
   return redundant;
 }
 
+std::vector<std::string> RulePerformanceAnalyticsEngine::get_dead_rules() {
+  std::lock_guard<std::mutex> lock(data_lock_);
+  
+  std::vector<std::string> dead;
+  for (uint32_t rule = 0; rule < rule_ids_.size(); ++rule) {
+    if (executions_since_fire_[rule] >= dead_rule_executions_) {
+      dead.push_back(rule_ids_[rule]);
+    }
+  }
+  
+  return dead;
+}
+
 json RulePerformanceAnalyticsEngine::get_rule_interactions(const std::string& rule_id) {
   std::lock_guard<std::mutex> lock(data_lock_);
   
   json interactions = json::array();
   
+  auto indexed = rule_index_.find(rule_id);
+  if (indexed != rule_index_.end()) {
+    for (const auto& pair : co_firing_pairs(0.0, std::nullopt, static_cast<int>(indexed->second))) {
+      interactions.push_back(co_firing_pair_json(pair, rule_ids_));
+    }
+  }
+  
   for (const auto& interaction : rule_interactions_) {
     if (interaction.rule_id_1 == rule_id || interaction.rule_id_2 == rule_id) {
       interactions.push_back(json{
@@ -157,6 +197,7 @@ json RulePerformanceAnalyticsEngine::get_rule_interactions(const std::string& ru
         {"rule_id_2", interaction.rule_id_2},
         {"similarity_score", interaction.similarity_score},
         {"overlapping_triggers", interaction.overlapping_triggers},
+        {"source", "recorded"},
       });
     }
   }
@@ -297,13 +338,20 @@ RulePerformanceAnalyticsEngine::RuleStats RulePerformanceAnalyticsEngine::get_ru
     stats.avg_f1_score = sum_f1 / stats_count;
   }
   
-  // Count redundant pairs
+  // Count redundant pairs, by Jaccard similarity only
+  stats.redundant_rule_pairs = static_cast<int>(co_firing_pairs(0.7).size());
   for (const auto& interaction : rule_interactions_) {
     if (interaction.similarity_score >= 0.7) {
       stats.redundant_rule_pairs++;
     }
   }
   
+  for (uint32_t rule = 0; rule < rule_ids_.size(); ++rule) {
+    if (executions_since_fire_[rule] >= dead_rule_executions_) {
+      stats.dead_rules.push_back(rule_ids_[rule]);
+    }
+  }
+  
   stats.calculated_at = std::chrono::system_clock::now();
   return stats;
 }
@@ -370,8 +418,113 @@ double RulePerformanceAnalyticsEngine::calculate_similarity(
   return dot_product / (mag1 * mag2);
 }
 
-void RulePerformanceAnalyticsEngine::detect_redundancy() {
-  // Unused for now; could be called periodically to update interaction records
+uint32_t RulePerformanceAnalyticsEngine::intern_rule(const std::string& rule_id) {
+  auto [it, inserted] = rule_index_.try_emplace(rule_id, static_cast<uint32_t>(rule_ids_.size()));
+  if (inserted) {
+    rule_ids_.push_back(rule_id);
+    window_fires_.push_back(0);
+    executions_since_fire_.push_back(0);
+    co_fires_.emplace_back();
+  }
+  return it->second;
+}
+
+void RulePerformanceAnalyticsEngine::record_co_firing(uint32_t rule, const std::string& transaction_id) {
+  auto sequence = window_sequence_.find(transaction_id);
+  if (sequence == window_sequence_.end()) {
+    if (window_.size() >= co_firing_window_) {
+      evict_oldest_transaction();
+    }
+    window_.push_back(TransactionSlot{transaction_id, {}});
+    sequence = window_sequence_.emplace(transaction_id, window_base_ + window_.size() - 1).first;
+  }
+  
+  auto& slot = window_[sequence->second - window_base_];
+  if (std::find(slot.fired_rules.begin(), slot.fired_rules.end(), rule) != slot.fired_rules.end()) {
+    return;
+  }
+  
+  // Pair counts move with each firing, so queries never rescan the window
+  for (uint32_t other : slot.fired_rules) {
+    co_fires_[rule][other]++;
+    co_fires_[other][rule]++;
+  }
+  slot.fired_rules.push_back(rule);
+  window_fires_[rule]++;
+}
+
+void RulePerformanceAnalyticsEngine::evict_oldest_transaction() {
+  const auto& slot = window_.front();
+  for (size_t i = 0; i < slot.fired_rules.size(); ++i) {
+    uint32_t rule = slot.fired_rules[i];
+    window_fires_[rule]--;
+    for (size_t j = i + 1; j < slot.fired_rules.size(); ++j) {
+      uint32_t other = slot.fired_rules[j];
+      if (--co_fires_[rule][other] == 0) {
+        co_fires_[rule].erase(other);
+      }
+      if (--co_fires_[other][rule] == 0) {
+        co_fires_[other].erase(rule);
+      }
+    }
+  }
+  
+  window_sequence_.erase(slot.transaction_id);
+  window_.pop_front();
+  window_base_++;
+}
+
+std::vector<RulePerformanceAnalyticsEngine::CoFiringPair> RulePerformanceAnalyticsEngine::co_firing_pairs(
+    double similarity_threshold,
+    std::optional<double> containment_threshold,
+    int rule) const {
+  std::vector<CoFiringPair> pairs;
+  
+  uint32_t first = rule < 0 ? 0 : static_cast<uint32_t>(rule);
+  uint32_t last = rule < 0 ? static_cast<uint32_t>(co_fires_.size()) : first + 1;
+  for (uint32_t a = first; a < last; ++a) {
+    for (const auto& [b, shared] : co_fires_[a]) {
+      // Each pair once when scanning every rule
+      if ((rule < 0 && b < a) || shared < MIN_SHARED_TRANSACTIONS) continue;
+      
+      uint32_t fires_a = window_fires_[a];
+      uint32_t fires_b = window_fires_[b];
+      double jaccard = static_cast<double>(shared) / (fires_a + fires_b - shared);
+      double containment = static_cast<double>(shared) / std::min(fires_a, fires_b);
+      if (jaccard < similarity_threshold &&
+          !(containment_threshold && containment >= *containment_threshold)) continue;
+      
+      pairs.push_back(CoFiringPair{a, b, fires_a <= fires_b ? a : b, shared, jaccard, containment});
+    }
+  }
+  
+  std::sort(pairs.begin(), pairs.end(),
+    [](const CoFiringPair& x, const CoFiringPair& y) {
+      return x.jaccard != y.jaccard ? x.jaccard > y.jaccard : x.containment > y.containment;
+    });
+  
+  return pairs;
+}
+
+json RulePerformanceAnalyticsEngine::co_firing_pair_json(
+    const CoFiringPair& pair,
+    const std::vector<std::string>& rule_ids) {
+  json entry{
+    {"rule_id_1", rule_ids[pair.rule_1]},
+    {"rule_id_2", rule_ids[pair.rule_2]},
+    {"similarity_score", pair.jaccard},
+    {"containment", pair.containment},
+    {"overlapping_triggers", pair.shared},
+    {"conflicting_outcomes", 0},
+    {"source", "co_firing"},
+  };
+  
+  // Whenever the rarer rule fires the other does too: the rarer one adds nothing
+  if (pair.containment >= 1.0 && pair.jaccard < 1.0) {
+    entry["subsumed_rule_id"] = rule_ids[pair.rarer_rule];
+  }
+  
+  return entry;
 }
 
 }  // namespace analytics
@@ -7,8 +7,12 @@
 
 #include <string>
 #include <map>
+#include <deque>
+#include <unordered_map>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <nlohmann/json.hpp>
 #include <chrono>
 
@@ -84,14 +88,18 @@ struct RuleEffectivenessRecord {
 
 class RulePerformanceAnalyticsEngine {
 public:
-  RulePerformanceAnalyticsEngine();
+  // co_firing_window: how many of the latest transactions that fired any rule the co-firing index covers
+  // dead_rule_executions: executions without firing after which a rule counts as dead
+  explicit RulePerformanceAnalyticsEngine(size_t co_firing_window = 4096, size_t dead_rule_executions = 10000);
   ~RulePerformanceAnalyticsEngine();
 
-  // Record rule execution
+  // Record rule execution; with a transaction_id, fired feeds the co-firing index
   bool record_rule_execution(
       const std::string& rule_id,
       bool was_successful,
-      double execution_time_ms);
+      double execution_time_ms,
+      const std::string& transaction_id = "",
+      bool fired = false);
 
   // Record rule outcome (feedback)
   bool record_rule_outcome(
@@ -107,8 +115,15 @@ public:
   
   std::vector<RuleEffectivenessRecord> get_all_rule_metrics();
 
-  // Redundancy analysis
-  json get_redundant_rules(double similarity_threshold = 0.7);
+  // Redundancy analysis: co-firing pairs whose Jaccard similarity reaches the
+  // threshold, then recorded interactions above it. containment_threshold also
+  // admits pairs by containment; off by default, since a rule that fires on most
+  // transactions contains nearly every rarer rule.
+  json get_redundant_rules(double similarity_threshold = 0.7,
+                           std::optional<double> containment_threshold = std::nullopt);
+
+  // Rules executed at least dead_rule_executions times since they last fired
+  std::vector<std::string> get_dead_rules();
   
   json get_rule_interactions(const std::string& rule_id);
 
@@ -134,6 +149,7 @@ public:
     double avg_f1_score;
     int redundant_rule_pairs;
     std::vector<std::string> problematic_rules;  // High FP rate
+    std::vector<std::string> dead_rules;         // Not fired in dead_rule_executions executions
     std::chrono::system_clock::time_point calculated_at;
   };
 
@@ -145,8 +161,38 @@ public:
   bool load_from_database();
 
 private:
+  // Rules that fired on one transaction in the co-firing window
+  struct TransactionSlot {
+    std::string transaction_id;
+    std::vector<uint32_t> fired_rules;
+  };
+
+  // Co-firing pair within the window, counted incrementally
+  struct CoFiringPair {
+    uint32_t rule_1;
+    uint32_t rule_2;
+    uint32_t rarer_rule;  // the one that fired less often
+    uint32_t shared;
+    double jaccard;
+    double containment;   // shared / fires of the rarer rule
+  };
+
   std::map<std::string, RuleEffectivenessRecord> rule_records_;
   std::vector<RuleInteraction> rule_interactions_;
+
+  // Co-firing index. Rules are interned to dense indices; co_fires_[a][b] is the
+  // number of window transactions both fired on, kept symmetric and updated as
+  // transactions enter and leave the window.
+  size_t co_firing_window_;
+  size_t dead_rule_executions_;
+  std::unordered_map<std::string, uint32_t> rule_index_;
+  std::vector<std::string> rule_ids_;
+  std::vector<uint32_t> window_fires_;
+  std::vector<uint32_t> executions_since_fire_;
+  std::vector<std::unordered_map<uint32_t, uint32_t>> co_fires_;
+  std::deque<TransactionSlot> window_;
+  std::unordered_map<std::string, uint64_t> window_sequence_;  // transaction id -> slot sequence
+  uint64_t window_base_ = 0;                                   // sequence of window_.front()
   
   std::mutex data_lock_;
 
@@ -157,7 +203,15 @@ private:
   double calculate_similarity(
       const RuleConfusionMatrix& m1,
       const RuleConfusionMatrix& m2);
-  void detect_redundancy();
+  uint32_t intern_rule(const std::string& rule_id);
+  void record_co_firing(uint32_t rule, const std::string& transaction_id);
+  void evict_oldest_transaction();
+  std::vector<CoFiringPair> co_firing_pairs(double similarity_threshold,
+                                            std::optional<double> containment_threshold = std::nullopt,
+                                            int rule = -1) const;
+  static json co_firing_pair_json(const CoFiringPair& pair, const std::vector<std::string>& rule_ids);
+
+  static constexpr uint32_t MIN_SHARED_TRANSACTIONS = 5;  // support below this is noise
 };
 
 }  // namespace analytics
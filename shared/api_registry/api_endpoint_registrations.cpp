@@ -36,12 +36,6 @@ void register_tool_categories_endpoints(PGconn* db_conn);
 
 // Helper function to extract user ID from JWT token in Authorization header
 std::string extract_user_id_from_jwt(const std::map<std::string, std::string>& headers) {
-    const char* jwt_secret_env = std::getenv("JWT_SECRET");
-    if (!jwt_secret_env) {
-        return "system"; // Fallback if JWT secret not configured
-    }
-    std::string secret_key = jwt_secret_env;
-
     auto auth_it = headers.find("authorization");
     if (auth_it == headers.end()) {
         auth_it = headers.find("Authorization");
@@ -57,8 +51,11 @@ std::string extract_user_id_from_jwt(const std::map<std::string, std::string>& h
 
     std::string token = auth_header.substr(7); // Remove "Bearer " prefix
 
-    JWTParser parser(secret_key);
-    auto claims = parser.parse_token(token);
+    auto parser = regulens::shared_jwt_parser();
+    if (!parser) {
+        return "system"; // Fallback if JWT secret not configured
+    }
+    auto claims = parser->verify_token(token);
     if (claims) {
         return claims->user_id;
     }
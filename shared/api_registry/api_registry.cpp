@@ -6,7 +6,6 @@
 #include "api_registry.hpp"
 #include "../logging/structured_logger.hpp"
 #include <algorithm>
-#include <regex>
 #include <sstream>
 
 namespace regulens {
@@ -54,7 +53,10 @@ bool APIRegistry::initialize(const APIRegistryConfig& config, std::shared_ptr<St
 
 void APIRegistry::register_endpoint(const APIEndpoint& endpoint) {
     std::lock_guard<std::mutex> lock(registry_mutex_);
+    register_endpoint_locked(endpoint);
+}
 
+void APIRegistry::register_endpoint_locked(const APIEndpoint& endpoint) {
     if (!initialized_) {
         // Log warning but don't throw - allow registration even if not fully initialized
         if (logger_) {
@@ -62,6 +64,15 @@ void APIRegistry::register_endpoint(const APIEndpoint& endpoint) {
         }
     }
 
+    // Reject paths the route trie cannot match rather than serving them as literals
+    if (!routes_by_method_[endpoint.method].insert(endpoint.path, all_endpoints_.size())) {
+        if (logger_) {
+            logger_->error("Rejected API endpoint with unsupported path pattern: " + endpoint.method + " " +
+                           endpoint.path + " (use at most one {param} per path segment)");
+        }
+        return;
+    }
+
     // Create key for method-based lookup
     std::string method_key = endpoint.method + ":" + endpoint.path;
 
@@ -87,7 +98,7 @@ void APIRegistry::register_endpoints_from_handler(const std::string& handler_nam
     }
 
     for (const auto& endpoint : endpoints) {
-        register_endpoint(endpoint);
+        register_endpoint_locked(endpoint);
     }
 
     if (logger_) {
@@ -107,11 +118,17 @@ void APIRegistry::register_category_endpoints(const std::string& category,
     for (const auto& endpoint : endpoints) {
         APIEndpoint endpoint_with_category = endpoint;
         endpoint_with_category.category = category;
-        register_endpoint(endpoint_with_category);
+        register_endpoint_locked(endpoint_with_category);
     }
 }
 
 std::optional<APIEndpoint> APIRegistry::find_handler(const std::string& method, const std::string& path) {
+    std::unordered_map<std::string, std::string> path_params;
+    return find_handler(method, path, path_params);
+}
+
+std::optional<APIEndpoint> APIRegistry::find_handler(const std::string& method, const std::string& path,
+                                                   std::unordered_map<std::string, std::string>& path_params) {
     std::lock_guard<std::mutex> lock(registry_mutex_);
 
     // First, try exact match
@@ -121,14 +138,11 @@ std::optional<APIEndpoint> APIRegistry::find_handler(const std::string& method,
         return exact_it->second;
     }
 
-    // Then, try pattern matching for parameterized routes
-    auto method_it = endpoints_by_method_.find(method);
-    if (method_it != endpoints_by_method_.end()) {
-        for (const auto& endpoint : method_it->second) {
-            std::unordered_map<std::string, std::string> params;
-            if (match_path_pattern(endpoint.path, path, params)) {
-                return endpoint;
-            }
+    // Then, walk the route trie for parameterized routes
+    auto method_it = routes_by_method_.find(method);
+    if (method_it != routes_by_method_.end()) {
+        if (auto route_id = method_it->second.match(path, &path_params)) {
+            return all_endpoints_[*route_id];
         }
     }
 
@@ -321,44 +335,6 @@ APIRegistry::RegistryStats APIRegistry::get_stats() const {
     return stats;
 }
 
-bool APIRegistry::match_path_pattern(const std::string& pattern, const std::string& path,
-                                   std::unordered_map<std::string, std::string>& params) const {
-    // Simple pattern matching for parameterized routes
-    // e.g., /users/{id} matches /users/123
-
-    std::string regex_pattern = pattern;
-
-    // Replace {param} with ([^/]+) for regex matching
-    std::regex param_regex("\\{([^}]+)\\}");
-    regex_pattern = std::regex_replace(regex_pattern, param_regex, "([^/]+)");
-
-    // Escape other regex special characters
-    regex_pattern = std::regex_replace(regex_pattern, std::regex("\\."), "\\.");
-
-    std::regex compiled_pattern("^" + regex_pattern + "$");
-
-    std::smatch matches;
-    if (std::regex_match(path, matches, compiled_pattern)) {
-        // Extract parameter names from pattern
-        std::vector<std::string> param_names;
-        std::sregex_iterator iter(pattern.begin(), pattern.end(), param_regex);
-        std::sregex_iterator end;
-
-        for (; iter != end; ++iter) {
-            param_names.push_back(iter->str(1)); // Capture group 1 is the parameter name
-        }
-
-        // Map parameter names to matched values
-        for (size_t i = 1; i < matches.size() && i-1 < param_names.size(); ++i) {
-            params[param_names[i-1]] = matches[i].str();
-        }
-
-        return true;
-    }
-
-    return false;
-}
-
 APIEndpoint create_endpoint(const std::string& method, const std::string& path,
                           const std::string& description, const std::string& category,
                           APIHandler handler, bool requires_auth,
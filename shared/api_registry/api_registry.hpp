@@ -13,8 +13,10 @@
 #include <memory>
 #include <vector>
 #include <mutex>
+#include <optional>
 #include <nlohmann/json.hpp>
 #include <libpq-fe.h>
+#include "route_trie.hpp"
 
 namespace regulens {
 
@@ -124,6 +126,12 @@ public:
      */
     std::optional<APIEndpoint> find_handler(const std::string& method, const std::string& path);
 
+    /**
+     * Find handler and extract {param} values from the matched path pattern
+     */
+    std::optional<APIEndpoint> find_handler(const std::string& method, const std::string& path,
+                                          std::unordered_map<std::string, std::string>& path_params);
+
     /**
      * Get all registered endpoints
      */
@@ -157,9 +165,8 @@ public:
 
 private:
 
-    // Parse path parameters (e.g., /users/{id} -> /users/123)
-    bool match_path_pattern(const std::string& pattern, const std::string& path,
-                          std::unordered_map<std::string, std::string>& params) const;
+    // Caller holds registry_mutex_
+    void register_endpoint_locked(const APIEndpoint& endpoint);
 
     // Storage
     std::unordered_map<std::string, std::vector<APIEndpoint>> endpoints_by_method_;
@@ -167,6 +174,9 @@ private:
     std::vector<APIEndpoint> all_endpoints_;
     std::unordered_map<std::string, std::vector<APIEndpoint>> endpoints_by_category_;
 
+    // Per-method route tries over all_endpoints_ indices (e.g., /users/{id} -> /users/123)
+    std::unordered_map<std::string, RouteTrie> routes_by_method_;
+
     // Configuration and services
     APIRegistryConfig config_;
     std::shared_ptr<StructuredLogger> logger_;
@@ -0,0 +1,185 @@
+/**
+ * Route Trie Implementation
+ */
+
+#include "route_trie.hpp"
+#include <algorithm>
+
+namespace regulens {
+
+namespace {
+
+// Splits at '/', keeping empty segments so "/a/" and "/a" stay distinct.
+// Returns the current segment and advances pos past it (beyond size() at the end).
+std::string_view next_segment(std::string_view path, size_t& pos) {
+    size_t slash = path.find('/', pos);
+    size_t end = slash == std::string_view::npos ? path.size() : slash;
+    std::string_view segment = path.substr(pos, end - pos);
+    pos = end + 1;
+    return segment;
+}
+
+// Splits prefix{name}suffix; false for a literal segment
+bool split_param_segment(std::string_view segment, std::string_view& prefix,
+                         std::string_view& name, std::string_view& suffix) {
+    size_t open = segment.find('{');
+    if (open == std::string_view::npos) {
+        return false;
+    }
+    size_t close = segment.find('}', open);
+    prefix = segment.substr(0, open);
+    name = segment.substr(open + 1, close - open - 1);
+    suffix = segment.substr(close + 1);
+    return true;
+}
+
+} // namespace
+
+RouteTrie::Node* RouteTrie::Node::find_literal(std::string_view segment) const {
+    auto it = std::lower_bound(literals.begin(), literals.end(), segment,
+        [](const auto& entry, std::string_view key) { return std::string_view(entry.first) < key; });
+    if (it != literals.end() && it->first == segment) {
+        return it->second.get();
+    }
+    return nullptr;
+}
+
+RouteTrie::Node* RouteTrie::Node::add_affixed(std::string_view prefix, std::string_view suffix) {
+    for (auto& entry : affixed) {
+        if (entry.prefix == prefix && entry.suffix == suffix) {
+            return entry.node.get();
+        }
+    }
+
+    // Keep the most specific (longest affix) candidates first
+    size_t length = prefix.size() + suffix.size();
+    auto it = std::find_if(affixed.begin(), affixed.end(), [length](const AffixedParam& entry) {
+        return entry.prefix.size() + entry.suffix.size() < length;
+    });
+    it = affixed.insert(it, AffixedParam{std::string(prefix), std::string(suffix), std::make_unique<Node>()});
+    return it->node.get();
+}
+
+RouteTrie::Node* RouteTrie::Node::add_literal(std::string_view segment) {
+    auto it = std::lower_bound(literals.begin(), literals.end(), segment,
+        [](const auto& entry, std::string_view key) { return std::string_view(entry.first) < key; });
+    if (it != literals.end() && it->first == segment) {
+        return it->second.get();
+    }
+    it = literals.emplace(it, std::string(segment), std::make_unique<Node>());
+    return it->second.get();
+}
+
+bool RouteTrie::is_supported_pattern(std::string_view pattern) {
+    size_t pos = 0;
+    while (pos <= pattern.size()) {
+        std::string_view segment = next_segment(pattern, pos);
+        size_t open = segment.find('{');
+        size_t close = segment.find('}');
+        if (open == std::string_view::npos && close == std::string_view::npos) {
+            continue;
+        }
+        // Exactly one non-empty {name}, with no stray braces around it
+        if (open == std::string_view::npos || close == std::string_view::npos || close <= open + 1 ||
+            segment.find_first_of("{}", open + 1) != close || segment.find_first_of("{}", close + 1) != std::string_view::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RouteTrie::insert(std::string_view pattern, size_t route_id) {
+    if (!is_supported_pattern(pattern)) {
+        return false;
+    }
+
+    Node* node = root_.get();
+    std::vector<std::string> names;
+
+    size_t pos = 0;
+    while (pos <= pattern.size()) {
+        std::string_view segment = next_segment(pattern, pos);
+        std::string_view prefix;
+        std::string_view name;
+        std::string_view suffix;
+        if (!split_param_segment(segment, prefix, name, suffix)) {
+            node = node->add_literal(segment);
+            continue;
+        }
+
+        names.emplace_back(name);
+        if (prefix.empty() && suffix.empty()) {
+            if (!node->param) {
+                node->param = std::make_unique<Node>();
+            }
+            node = node->param.get();
+        } else {
+            node = node->add_affixed(prefix, suffix);
+        }
+    }
+
+    if (!node->route_id) {
+        ++size_;
+    }
+    node->route_id = route_id;
+    node->param_names = std::move(names);
+    return true;
+}
+
+std::optional<size_t> RouteTrie::match(std::string_view path, Params* params) const {
+    Captures captures;
+    const Node* node = match_from(root_.get(), path, 0, captures);
+    if (!node) {
+        return std::nullopt;
+    }
+
+    if (params) {
+        for (size_t i = 0; i < captures.size() && i < node->param_names.size(); ++i) {
+            (*params)[node->param_names[i]] = std::string(captures[i]);
+        }
+    }
+    return node->route_id;
+}
+
+const RouteTrie::Node* RouteTrie::match_from(const Node* node, std::string_view path, size_t pos,
+                                             Captures& captures) const {
+    if (pos > path.size()) {
+        return node->route_id ? node : nullptr;
+    }
+
+    size_t next = pos;
+    std::string_view segment = next_segment(path, next);
+
+    // Literal segments take precedence over parameters
+    if (const Node* literal = node->find_literal(segment)) {
+        if (const Node* found = match_from(literal, path, next, captures)) {
+            return found;
+        }
+    }
+
+    for (const auto& entry : node->affixed) {
+        size_t affix_length = entry.prefix.size() + entry.suffix.size();
+        if (segment.size() <= affix_length ||
+            segment.substr(0, entry.prefix.size()) != entry.prefix ||
+            segment.substr(segment.size() - entry.suffix.size()) != entry.suffix) {
+            continue;
+        }
+        captures.push_back(segment.substr(entry.prefix.size(), segment.size() - affix_length));
+        if (const Node* found = match_from(entry.node.get(), path, next, captures)) {
+            return found;
+        }
+        captures.pop_back();
+    }
+
+    if (node->param && !segment.empty()) {
+        captures.push_back(segment);
+        if (const Node* found = match_from(node->param.get(), path, next, captures)) {
+            return found;
+        }
+        captures.pop_back();
+    }
+
+    return nullptr;
+}
+
+} // namespace regulens
@@ -0,0 +1,90 @@
+/**
+ * Route Trie - Segment radix tree for parameterized API paths
+ * Built once at registration time; lookups walk the request path segment by
+ * segment, extracting {param} values without regex or allocation on a miss.
+ */
+
+#ifndef REGULENS_ROUTE_TRIE_HPP
+#define REGULENS_ROUTE_TRIE_HPP
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace regulens {
+
+/**
+ * Maps "/a/{x}/b" style patterns to caller-defined route ids.
+ *
+ * Matching rules mirror the previous regex matcher: a {param} captures one
+ * non-empty segment and paths must match in full. A parameter may carry a
+ * literal prefix and/or suffix within its segment ("/files/{name}.json",
+ * "/v{version}"); at most one parameter per segment is supported. Where
+ * several could apply, a literal segment wins over an affixed parameter,
+ * which wins over a bare one (so /rules/stats beats /rules/{id}); the search
+ * backtracks if the preferred branch dead-ends.
+ */
+class RouteTrie {
+public:
+    using Params = std::unordered_map<std::string, std::string>;
+
+    RouteTrie() : root_(std::make_unique<Node>()) {}
+
+    /**
+     * Add a pattern; re-inserting the same pattern replaces its route id
+     * @return false (and nothing inserted) if the pattern is not supported
+     */
+    bool insert(std::string_view pattern, size_t route_id);
+
+    /**
+     * Whether insert() accepts the pattern: braces must be balanced, non-empty
+     * and at most one {param} may appear in a segment
+     */
+    static bool is_supported_pattern(std::string_view pattern);
+
+    /**
+     * Find the route for a concrete path, filling params on success
+     */
+    std::optional<size_t> match(std::string_view path, Params* params = nullptr) const;
+
+    void clear() { root_ = std::make_unique<Node>(); size_ = 0; }
+    size_t size() const { return size_; }
+
+private:
+    struct Node;
+
+    // prefix{param}suffix within one segment
+    struct AffixedParam {
+        std::string prefix;
+        std::string suffix;
+        std::unique_ptr<Node> node;
+    };
+
+    struct Node {
+        // Literal children, sorted by segment for binary search
+        std::vector<std::pair<std::string, std::unique_ptr<Node>>> literals;
+        std::vector<AffixedParam> affixed;          // longest prefix + suffix first
+        std::unique_ptr<Node> param;                // any single non-empty segment
+        std::optional<size_t> route_id;             // set when a pattern ends here
+        std::vector<std::string> param_names;       // names of that pattern's params, in order
+
+        Node* find_literal(std::string_view segment) const;
+        Node* add_literal(std::string_view segment);
+        Node* add_affixed(std::string_view prefix, std::string_view suffix);
+    };
+
+    using Captures = std::vector<std::string_view>;
+
+    const Node* match_from(const Node* node, std::string_view path, size_t pos, Captures& captures) const;
+
+    std::unique_ptr<Node> root_;
+    size_t size_ = 0;
+};
+
+} // namespace regulens
+
+#endif // REGULENS_ROUTE_TRIE_HPP
@@ -3,8 +3,8 @@
  * 
  * Complete implementation with:
  * - Database-backed job persistence
- * - Worker thread pool with atomic job claiming
- * - Priority-based scheduling
+ * - Worker thread pool fed by batched, LISTEN/NOTIFY-driven job claiming
+ * - Priority-based scheduling with work stealing between workers
  * - Comprehensive error handling and retry logic
  * - Real-time progress tracking
  * - Batch processing support
@@ -16,18 +16,467 @@
 #include <iomanip>
 #include <chrono>
 #include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
 
 namespace regulens {
 namespace async_jobs {
 
+namespace {
+
+constexpr const char* kJobChannel = "async_jobs";
+
+size_t priority_index(JobPriority priority) {
+    int value = static_cast<int>(priority);
+    return static_cast<size_t>(std::clamp(value, 0, 3));
+}
+
+// Dispatcher wake-up channel: an eventfd on Linux, a non-blocking self-pipe elsewhere
+#if defined(__linux__)
+
+bool wake_create(int& read_fd, int& write_fd) {
+    read_fd = write_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return read_fd >= 0;
+}
+
+void wake_signal(int write_fd) {
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(write_fd, &one, sizeof(one));
+}
+
+void wake_drain(int read_fd) {
+    uint64_t value = 0;
+    [[maybe_unused]] ssize_t drained = read(read_fd, &value, sizeof(value));
+}
+
+#else
+
+bool wake_create(int& read_fd, int& write_fd) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+        read_fd = write_fd = -1;
+        return false;
+    }
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    read_fd = fds[0];
+    write_fd = fds[1];
+    return true;
+}
+
+void wake_signal(int write_fd) {
+    char one = 1;
+    [[maybe_unused]] ssize_t written = write(write_fd, &one, sizeof(one));
+}
+
+void wake_drain(int read_fd) {
+    char buffer[64];
+    while (read(read_fd, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+#endif
+
+} // anonymous namespace
+
+// ============================================================================
+// JobScheduler Implementation
+// ============================================================================
+
+JobScheduler::JobScheduler(const std::string& scheduler_id,
+                           std::shared_ptr<PostgreSQLConnection> db_conn,
+                           std::shared_ptr<StructuredLogger> logger,
+                           Options options)
+    : scheduler_id_(scheduler_id),
+      db_conn_(db_conn),
+      logger_(logger),
+      options_(options) {
+    options_.worker_count = std::max<size_t>(1, options_.worker_count);
+    options_.claim_batch_size = std::max<size_t>(1, options_.claim_batch_size);
+    for (size_t i = 0; i < options_.worker_count; ++i) {
+        queues_.push_back(std::make_unique<LocalQueue>());
+    }
+}
+
+JobScheduler::~JobScheduler() {
+    stop();
+}
+
+void JobScheduler::start() {
+    if (running_) return;
+
+    wake_create(wake_fd_, wake_write_fd_);
+    running_ = true;
+    more_available_ = true;  // pick up whatever was queued while we were down
+    dispatcher_ = std::thread([this]() { dispatch_loop(); });
+}
+
+void JobScheduler::stop() {
+    if (!running_.exchange(false)) return;
+
+    wake_dispatcher();
+    { std::lock_guard<std::mutex> lock(idle_mutex_); }
+    idle_cv_.notify_all();
+    if (dispatcher_.joinable()) {
+        dispatcher_.join();
+    }
+
+    release_unstarted_jobs();
+    close_listen_connection();
+    if (wake_write_fd_ >= 0 && wake_write_fd_ != wake_fd_) {
+        close(wake_write_fd_);
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+    }
+    wake_fd_ = wake_write_fd_ = -1;
+}
+
+std::optional<AsyncJob> JobScheduler::next_job(size_t worker_index) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+    while (running_) {
+        if (auto job = take_job(worker_index % queues_.size())) {
+            if (queued_jobs_.load() < options_.claim_batch_size / 2 + 1 && more_available_.load()) {
+                wake_dispatcher();
+            }
+            if (mark_started(*job)) {
+                job->status = JobStatus::RUNNING;
+                return job;
+            }
+            jobs_skipped_++;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        if (!idle_cv_.wait_until(lock, deadline, [this]() { return !running_ || queued_jobs_.load() > 0; })) {
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+json JobScheduler::get_statistics() const {
+    return json::object({
+        {"scheduler_id", scheduler_id_},
+        {"listening", listening_.load()},
+        {"queued_locally", queued_jobs_.load()},
+        {"claim_batch_size", options_.claim_batch_size},
+        {"claim_queries", claim_queries_.load()},
+        {"jobs_claimed", jobs_claimed_.load()},
+        {"jobs_stolen", jobs_stolen_.load()},
+        {"jobs_skipped", jobs_skipped_.load()},
+        {"notifications", notifications_.load()}
+    });
+}
+
+void JobScheduler::dispatch_loop() {
+    auto last_check = std::chrono::steady_clock::now();
+    const auto recheck_interval = std::chrono::seconds(std::max(1, options_.idle_recheck_seconds));
+    auto next_listen_attempt = std::chrono::steady_clock::now();
+
+    while (running_) {
+        if (!listen_conn_ && std::chrono::steady_clock::now() >= next_listen_attempt) {
+            if (!open_listen_connection()) {
+                next_listen_attempt = std::chrono::steady_clock::now() + recheck_interval;
+            }
+        }
+
+        // Claim only while the database may hold more and local queues have room
+        size_t queued = queued_jobs_.load();
+        if (more_available_.load() && queued < options_.claim_batch_size) {
+            size_t wanted = options_.claim_batch_size - queued;
+            size_t claimed = claim_batch(wanted);
+            more_available_ = claimed == wanted;
+            last_check = std::chrono::steady_clock::now();
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::max(std::chrono::steady_clock::duration::zero(), last_check + recheck_interval - now));
+        // Without LISTEN, fall back to checking once a second
+        if (!listen_conn_) {
+            timeout = std::min(timeout, std::chrono::milliseconds(1000));
+        }
+
+        switch (wait_for_wakeup(timeout)) {
+            case Wakeup::NOTIFIED:
+                more_available_ = true;
+                break;
+            case Wakeup::TIMEOUT:
+                // Periodic check covers missed notifications and expired leases
+                more_available_ = true;
+                last_check = std::chrono::steady_clock::now();
+                break;
+            case Wakeup::WORKER:
+                break;
+        }
+    }
+}
+
+bool JobScheduler::open_listen_connection() {
+    if (!db_conn_) return false;
+
+    PGconn* conn = db_conn_->open_dedicated_connection();
+    if (!conn) {
+        return false;
+    }
+
+    std::string listen_sql = std::string("LISTEN ") + kJobChannel;
+    PGresult* result = PQexec(conn, listen_sql.c_str());
+    bool ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+    PQclear(result);
+    if (!ok) {
+        logger_->warn("JobScheduler " + scheduler_id_ + ": LISTEN failed, polling instead: " +
+                      std::string(PQerrorMessage(conn)));
+        PQfinish(conn);
+        return false;
+    }
+
+    listen_conn_ = conn;
+    listening_ = true;
+    more_available_ = true;  // anything queued while we were not listening
+    return true;
+}
+
+void JobScheduler::close_listen_connection() {
+    if (listen_conn_) {
+        PQfinish(listen_conn_);
+        listen_conn_ = nullptr;
+        listening_ = false;
+    }
+}
+
+JobScheduler::Wakeup JobScheduler::wait_for_wakeup(std::chrono::milliseconds timeout) {
+    pollfd fds[2];
+    nfds_t count = 0;
+    fds[count++] = pollfd{wake_fd_, POLLIN, 0};
+    if (listen_conn_) {
+        fds[count++] = pollfd{PQsocket(listen_conn_), POLLIN, 0};
+    }
+
+    int rc = poll(fds, count, static_cast<int>(timeout.count()));
+    if (rc < 0) {
+        if (errno != EINTR) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        return Wakeup::WORKER;
+    }
+    if (rc == 0) {
+        return Wakeup::TIMEOUT;
+    }
+
+    bool notified = false;
+    if (count > 1 && (fds[1].revents & (POLLIN | POLLERR | POLLHUP))) {
+        if (!PQconsumeInput(listen_conn_)) {
+            // Connection lost: reconnect on the next pass and check the queue meanwhile
+            close_listen_connection();
+            return Wakeup::NOTIFIED;
+        }
+        while (PGnotify* notify = PQnotifies(listen_conn_)) {
+            PQfreemem(notify);
+            notifications_++;
+            notified = true;
+        }
+    }
+
+    if (fds[0].revents & POLLIN) {
+        wake_drain(wake_fd_);
+    }
+
+    return notified ? Wakeup::NOTIFIED : Wakeup::WORKER;
+}
+
+size_t JobScheduler::claim_batch(size_t max_jobs) {
+    if (!db_conn_ || !db_conn_->is_connected()) {
+        return 0;
+    }
+
+    const std::string query = R"(
+        WITH claimed AS (
+            UPDATE async_jobs
+            SET status = 'CLAIMED',
+                claimed_by = $1,
+                claimed_at = NOW(),
+                updated_at = NOW()
+            WHERE job_id IN (
+                SELECT job_id FROM async_jobs
+                WHERE status = 'PENDING'
+                   OR (status = 'CLAIMED' AND claimed_at < NOW() - make_interval(secs => $3::int))
+                ORDER BY priority DESC, created_at ASC
+                LIMIT $2
+                FOR UPDATE SKIP LOCKED
+            )
+            RETURNING job_id, job_type, user_id, execution_mode, priority,
+                      request_payload, created_at
+        )
+        SELECT * FROM claimed ORDER BY priority DESC, created_at ASC
+    )";
+
+    claim_queries_++;
+    auto rows = db_conn_->execute_query_view(query, {
+        scheduler_id_,
+        std::to_string(max_jobs),
+        std::to_string(options_.claim_lease_seconds)
+    });
+    if (!rows.ok()) {
+        return 0;
+    }
+
+    std::vector<AsyncJob> claimed;
+    claimed.reserve(rows.size());
+    for (const auto& row : rows) {
+        AsyncJob job;
+        job.job_id = row.get_string("job_id");
+        job.job_type = row.get_string("job_type");
+        job.user_id = row.get_string("user_id");
+        job.execution_mode = ExecutionMode::ASYNCHRONOUS;
+        std::string mode = row.get_string("execution_mode");
+        if (mode == "SYNCHRONOUS") job.execution_mode = ExecutionMode::SYNCHRONOUS;
+        else if (mode == "BATCH") job.execution_mode = ExecutionMode::BATCH;
+        else if (mode == "STREAMING") job.execution_mode = ExecutionMode::STREAMING;
+        job.status = JobStatus::PENDING;
+        job.priority = static_cast<JobPriority>(row.get_int("priority").value_or(0));
+        job.progress_percentage = 0;
+
+        try {
+            job.request_payload = json::parse(row.get_string("request_payload", "{}"));
+        } catch (...) {
+            job.request_payload = json::object();
+        }
+
+        claimed.push_back(std::move(job));
+    }
+
+    for (auto& job : claimed) {
+        enqueue(std::move(job));
+    }
+
+    jobs_claimed_ += claimed.size();
+    if (!claimed.empty()) {
+        // Pass through the idle mutex so a worker between its check and wait is not missed
+        { std::lock_guard<std::mutex> lock(idle_mutex_); }
+        idle_cv_.notify_all();
+    }
+    return claimed.size();
+}
+
+void JobScheduler::enqueue(AsyncJob job) {
+    LocalQueue& queue = *queues_[next_queue_];
+    next_queue_ = (next_queue_ + 1) % queues_.size();
+
+    size_t p = priority_index(job.priority);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.by_priority[p].push_back(std::move(job));
+        queue.nonempty_mask.fetch_or(1u << p);
+        queued_jobs_++;
+    }
+}
+
+std::optional<AsyncJob> JobScheduler::take_job(size_t worker_index) {
+    // Highest priority first; at equal priority the worker's own queue wins,
+    // otherwise the job is stolen from the next peer that holds it
+    for (int attempt = 0; attempt < 4; ++attempt) {
+        if (queued_jobs_.load() == 0) {
+            return std::nullopt;
+        }
+
+        for (size_t p = kPriorityLevels; p-- > 0;) {
+            for (size_t offset = 0; offset < queues_.size(); ++offset) {
+                size_t index = (worker_index + offset) % queues_.size();
+                LocalQueue& queue = *queues_[index];
+                if (!(queue.nonempty_mask.load() & (1u << p))) {
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                auto& jobs = queue.by_priority[p];
+                if (jobs.empty()) {
+                    continue;  // taken by someone else meanwhile
+                }
+                AsyncJob job = std::move(jobs.front());
+                jobs.pop_front();
+                if (jobs.empty()) {
+                    queue.nonempty_mask.fetch_and(~(1u << p));
+                }
+                queued_jobs_--;
+                if (offset != 0) {
+                    jobs_stolen_++;
+                }
+                return job;
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+bool JobScheduler::mark_started(const AsyncJob& job) {
+    if (!db_conn_ || !db_conn_->is_connected()) {
+        return false;
+    }
+
+    // Fails if the job was cancelled or its lease passed to another scheduler
+    auto result = db_conn_->execute_query_view(R"(
+        UPDATE async_jobs
+        SET status = 'RUNNING',
+            started_at = NOW(),
+            updated_at = NOW()
+        WHERE job_id = $1 AND status = 'CLAIMED' AND claimed_by = $2
+    )", {job.job_id, scheduler_id_});
+
+    return result.ok() && result.affected_rows() == 1;
+}
+
+void JobScheduler::release_unstarted_jobs() {
+    for (auto& queue : queues_) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (auto& jobs : queue->by_priority) {
+            jobs.clear();
+        }
+        queue->nonempty_mask = 0;
+    }
+    queued_jobs_ = 0;
+
+    if (!db_conn_ || !db_conn_->is_connected()) {
+        return;
+    }
+
+    // Jobs a worker already started are RUNNING; everything still CLAIMED is unstarted
+    db_conn_->execute_command(R"(
+        UPDATE async_jobs
+        SET status = 'PENDING', claimed_by = NULL, claimed_at = NULL, updated_at = NOW()
+        WHERE status = 'CLAIMED' AND claimed_by = $1
+    )", {scheduler_id_});
+}
+
+void JobScheduler::wake_dispatcher() {
+    if (wake_write_fd_ >= 0) {
+        wake_signal(wake_write_fd_);
+    }
+}
+
 // ============================================================================
 // JobWorker Implementation
 // ============================================================================
 
 JobWorker::JobWorker(const std::string& worker_id,
+                     size_t worker_index,
+                     std::shared_ptr<JobScheduler> scheduler,
                      std::shared_ptr<PostgreSQLConnection> db_conn,
                      std::shared_ptr<StructuredLogger> logger)
     : worker_id_(worker_id),
+      worker_index_(worker_index),
+      scheduler_(scheduler),
       db_conn_(db_conn),
       logger_(logger),
       running_(false),
@@ -56,13 +505,11 @@ void JobWorker::stop() {
 void JobWorker::worker_loop() {
     while (running_) {
         try {
-            auto job = claim_next_job();
+            // Blocks until the scheduler hands this worker a started job
+            auto job = scheduler_->next_job(worker_index_);
             if (job.has_value()) {
                 process_job(job.value());
                 jobs_processed_++;
-            } else {
-                // No jobs available, sleep before checking again
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
             }
         } catch (const std::exception& e) {
             logger_->error("JobWorker {} error: {}", worker_id_, e.what());
@@ -71,49 +518,6 @@ void JobWorker::worker_loop() {
     }
 }
 
-std::optional<AsyncJob> JobWorker::claim_next_job() {
-    if (!db_conn_ || !db_conn_->is_connected()) {
-        return std::nullopt;
-    }
-
-    const char* query = R"(
-        UPDATE async_jobs
-        SET status = 'RUNNING',
-            started_at = NOW(),
-            updated_at = NOW()
-        WHERE job_id = (
-            SELECT job_id FROM async_jobs
-            WHERE status = 'PENDING'
-            ORDER BY priority DESC, created_at ASC
-            LIMIT 1
-            FOR UPDATE SKIP LOCKED
-        )
-        RETURNING job_id, job_type, user_id, execution_mode, status,
-                  priority, request_payload, result_payload, error_message,
-                  progress_percentage, estimated_completion_time, created_at
-    )";
-
-    auto result = db_conn_->execute_query_single(query);
-    if (!result) {
-        return std::nullopt;
-    }
-
-    AsyncJob job;
-    job.job_id = result.value()["job_id"].get<std::string>();
-    job.job_type = result.value()["job_type"].get<std::string>();
-    job.user_id = result.value()["user_id"].get<std::string>();
-    job.status = JobStatus::RUNNING;
-    job.priority = static_cast<JobPriority>(result.value()["priority"].get<int>());
-
-    try {
-        job.request_payload = json::parse(result.value()["request_payload"].dump());
-    } catch (...) {
-        job.request_payload = json::object();
-    }
-
-    return job;
-}
-
 void JobWorker::process_job(const AsyncJob& job) {
     auto start_time = std::chrono::system_clock::now();
     bool success = false;
@@ -211,6 +615,15 @@ AsyncJobManager::AsyncJobManager(
         max_retries_ = config_->get_int("JOB_MAX_RETRIES", 3);
         retry_backoff_seconds_ = config_->get_int("JOB_RETRY_BACKOFF_SECONDS", 30);
     }
+
+    scheduler_options_.worker_count = worker_thread_count_;
+    scheduler_options_.claim_batch_size = worker_thread_count_ * 2;
+    if (config_) {
+        scheduler_options_.claim_batch_size = static_cast<size_t>(std::max(1,
+            config_->get_int("JOB_CLAIM_BATCH_SIZE").value_or(static_cast<int>(worker_thread_count_ * 2))));
+        scheduler_options_.idle_recheck_seconds = config_->get_int("JOB_IDLE_RECHECK_SECONDS").value_or(30);
+        scheduler_options_.claim_lease_seconds = config_->get_int("JOB_CLAIM_LEASE_SECONDS").value_or(300);
+    }
 }
 
 AsyncJobManager::~AsyncJobManager() {
@@ -226,10 +639,15 @@ bool AsyncJobManager::initialize() {
 
     running_ = true;
 
+    // One scheduler claims for all local workers
+    std::string scheduler_id = "scheduler-" + generate_batch_id().substr(6);
+    scheduler_ = std::make_shared<JobScheduler>(scheduler_id, db_conn_, logger_, scheduler_options_);
+    scheduler_->start();
+
     // Create worker threads
     for (size_t i = 0; i < worker_thread_count_; ++i) {
         std::string worker_id = "worker-" + std::to_string(i);
-        auto worker = std::make_shared<JobWorker>(worker_id, db_conn_, logger_);
+        auto worker = std::make_shared<JobWorker>(worker_id, i, scheduler_, db_conn_, logger_);
         worker->start();
         workers_.push_back(worker);
     }
@@ -242,7 +660,12 @@ void AsyncJobManager::shutdown() {
     if (!running_) return;
     
     running_ = false;
-    
+
+    // Stop claiming first so unstarted jobs go back to the queue for other pods
+    if (scheduler_) {
+        scheduler_->stop();
+    }
+
     {
         std::lock_guard<std::mutex> lock(workers_mutex_);
         for (auto& worker : workers_) {
@@ -250,6 +673,7 @@ void AsyncJobManager::shutdown() {
         }
         workers_.clear();
     }
+    scheduler_.reset();
 
     logger_->info("AsyncJobManager shutdown complete. Stats - Submitted: {}, Completed: {}, Failed: {}",
                  total_jobs_submitted_, total_jobs_completed_, total_jobs_failed_);
@@ -362,7 +786,7 @@ bool AsyncJobManager::cancel_job(const std::string& job_id) {
         SET status = 'CANCELLED',
             cancelled_at = NOW(),
             updated_at = NOW()
-        WHERE job_id = $1 AND status IN ('PENDING', 'RUNNING')
+        WHERE job_id = $1 AND status IN ('PENDING', 'CLAIMED', 'RUNNING')
     )";
 
     return db_conn_->execute_command(query, {job_id});
@@ -496,7 +920,8 @@ json AsyncJobManager::get_system_metrics() {
         {"active_jobs", active_jobs_.load()},
         {"worker_threads", workers_.size()},
         {"job_timeout_seconds", job_timeout_seconds_},
-        {"max_retries", max_retries_}
+        {"max_retries", max_retries_},
+        {"scheduler", scheduler_ ? scheduler_->get_statistics() : json::object()}
     });
 }
 
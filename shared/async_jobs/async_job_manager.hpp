@@ -2,7 +2,7 @@
  * AsyncJobManager - Production-Grade Async Job Processing
  * 
  * Enterprise-grade job queue management with:
- * - Priority-based job scheduling
+ * - Priority-based job scheduling with batched, notification-driven claiming
  * - Multiple execution modes (SYNC, ASYNC, BATCH, STREAMING)
  * - Worker thread pool management
  * - Progress tracking and monitoring
@@ -15,6 +15,8 @@
 
 #include <string>
 #include <vector>
+#include <array>
+#include <deque>
 #include <queue>
 #include <map>
 #include <memory>
@@ -103,12 +105,109 @@ struct JobResult {
     int execution_time_ms;
 };
 
+/**
+ * Claims PENDING jobs from the database in batches and hands them to local workers
+ *
+ * A dispatcher thread LISTENs on the async_jobs channel (a trigger notifies it
+ * on insert) over its own connection, and only queries the queue when notified,
+ * when its last claim came back full, or every idle_recheck_seconds as a
+ * fallback, so an idle queue costs no database round trips. Claimed jobs wait
+ * in per-worker priority queues; a worker takes the highest-priority job
+ * available, stealing from its peers when they hold higher-priority work or
+ * its own queue is empty.
+ *
+ * Claims are leases: a claimed job is CLAIMED by this scheduler until a worker
+ * moves it to RUNNING. Leases older than claim_lease_seconds (a crashed pod)
+ * are claimed again by other schedulers, and a worker never starts a job whose
+ * lease it has lost or that was cancelled meanwhile.
+ */
+class JobScheduler {
+public:
+    struct Options {
+        size_t worker_count = 4;
+        size_t claim_batch_size = 8;      // most jobs held locally, claimed in one query
+        int idle_recheck_seconds = 30;    // queue re-check without a notification
+        int claim_lease_seconds = 300;
+    };
+
+    JobScheduler(const std::string& scheduler_id,
+                 std::shared_ptr<PostgreSQLConnection> db_conn,
+                 std::shared_ptr<StructuredLogger> logger,
+                 Options options);
+    ~JobScheduler();
+
+    void start();
+
+    /**
+     * Stop dispatching and hand unstarted claims back to the queue
+     */
+    void stop();
+
+    /**
+     * Wait up to a second for a job and mark it started for this worker;
+     * nullopt on timeout or once stopped
+     */
+    std::optional<AsyncJob> next_job(size_t worker_index);
+
+    json get_statistics() const;
+
+private:
+    static constexpr size_t kPriorityLevels = 4;
+
+    struct LocalQueue {
+        std::mutex mutex;
+        std::array<std::deque<AsyncJob>, kPriorityLevels> by_priority;
+        std::atomic<unsigned> nonempty_mask{0};  // bit p set while by_priority[p] has jobs
+    };
+
+    enum class Wakeup { NOTIFIED, WORKER, TIMEOUT };
+
+    void dispatch_loop();
+    bool open_listen_connection();
+    void close_listen_connection();
+    Wakeup wait_for_wakeup(std::chrono::milliseconds timeout);
+    size_t claim_batch(size_t max_jobs);
+    void enqueue(AsyncJob job);
+    std::optional<AsyncJob> take_job(size_t worker_index);
+    bool mark_started(const AsyncJob& job);
+    void release_unstarted_jobs();
+    void wake_dispatcher();
+
+    std::string scheduler_id_;
+    std::shared_ptr<PostgreSQLConnection> db_conn_;
+    std::shared_ptr<StructuredLogger> logger_;
+    Options options_;
+
+    std::vector<std::unique_ptr<LocalQueue>> queues_;
+    std::atomic<size_t> queued_jobs_{0};
+    std::mutex idle_mutex_;
+    std::condition_variable idle_cv_;
+    size_t next_queue_ = 0;                       // round-robin target, dispatcher thread only
+
+    std::thread dispatcher_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> more_available_{true};      // the database may hold more claimable jobs
+    int wake_fd_ = -1;                            // eventfd or pipe read end: workers and stop() wake the dispatcher
+    int wake_write_fd_ = -1;                      // same as wake_fd_ for an eventfd
+    PGconn* listen_conn_ = nullptr;              // dispatcher thread only
+    std::atomic<bool> listening_{false};
+
+    // Statistics
+    std::atomic<uint64_t> claim_queries_{0};
+    std::atomic<uint64_t> jobs_claimed_{0};
+    std::atomic<uint64_t> jobs_stolen_{0};
+    std::atomic<uint64_t> jobs_skipped_{0};        // cancelled or lease lost before start
+    std::atomic<uint64_t> notifications_{0};
+};
+
 /**
  * Worker thread for processing async jobs
  */
 class JobWorker {
 public:
-    JobWorker(const std::string& worker_id, 
+    JobWorker(const std::string& worker_id,
+              size_t worker_index,
+              std::shared_ptr<JobScheduler> scheduler,
               std::shared_ptr<PostgreSQLConnection> db_conn,
               std::shared_ptr<StructuredLogger> logger);
     ~JobWorker();
@@ -120,6 +219,8 @@ public:
 
 private:
     std::string worker_id_;
+    size_t worker_index_;
+    std::shared_ptr<JobScheduler> scheduler_;
     std::shared_ptr<PostgreSQLConnection> db_conn_;
     std::shared_ptr<StructuredLogger> logger_;
     std::atomic<bool> running_;
@@ -127,7 +228,6 @@ private:
     std::atomic<size_t> jobs_processed_;
 
     void worker_loop();
-    std::optional<AsyncJob> claim_next_job();
     void process_job(const AsyncJob& job);
     void update_job_progress(const std::string& job_id, int progress, const std::string& status);
     void finalize_job(const std::string& job_id, bool success, const json& result = json::object(), const std::string& error = "");
@@ -243,6 +343,7 @@ private:
     std::shared_ptr<ConfigurationManager> config_;
     std::shared_ptr<ErrorHandler> error_handler_;
 
+    std::shared_ptr<JobScheduler> scheduler_;
     std::vector<std::shared_ptr<JobWorker>> workers_;
     std::mutex workers_mutex_;
     std::atomic<bool> running_;
@@ -261,6 +362,7 @@ private:
     int job_timeout_seconds_;
     int max_retries_;
     int retry_backoff_seconds_;
+    JobScheduler::Options scheduler_options_;
 
     // Database operations
     AsyncJob load_job_from_db(const std::string& job_id);
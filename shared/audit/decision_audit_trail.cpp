@@ -7,6 +7,35 @@
 
 namespace regulens {
 
+namespace {
+
+const std::string kInsertDecisionStepSql = R"(
+    INSERT INTO decision_steps (
+        step_id, decision_id, event_type, description,
+        input_data, output_data, metadata, processing_time_us,
+        confidence_impact, timestamp, agent_id
+    ) VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11)
+)";
+
+std::vector<std::string> decision_step_params(const DecisionStep& step) {
+    return {
+        step.step_id,
+        step.decision_id,
+        std::to_string(static_cast<int>(step.event_type)),
+        step.description,
+        step.input_data.dump(),
+        step.output_data.dump(),
+        step.metadata.dump(),
+        std::to_string(step.processing_time.count()),
+        std::to_string(step.confidence_impact),
+        std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+            step.timestamp.time_since_epoch()).count()),
+        step.agent_id
+    };
+}
+
+} // namespace
+
 DecisionAuditTrailManager::DecisionAuditTrailManager(
     std::shared_ptr<ConnectionPool> db_pool,
     StructuredLogger* logger
@@ -72,9 +101,7 @@ void DecisionAuditTrailManager::shutdown() {
             std::lock_guard<std::mutex> steps_lock(steps_mutex_);
             auto steps_it = pending_steps_.find(decision_id);
             if (steps_it != pending_steps_.end()) {
-                for (const auto& step : steps_it->second) {
-                    store_decision_step(step);
-                }
+                store_decision_steps(steps_it->second);
                 pending_steps_.erase(steps_it);
             }
         }
@@ -234,11 +261,7 @@ bool DecisionAuditTrailManager::finalize_decision_audit(
         std::lock_guard<std::mutex> steps_lock(steps_mutex_);
         auto steps_it = pending_steps_.find(decision_id);
         if (steps_it != pending_steps_.end()) {
-            for (const auto& step : steps_it->second) {
-                if (!store_decision_step(step)) {
-                    logger_->log(LogLevel::ERROR, "Failed to store decision step after trail finalization: " + step.step_id);
-                }
-            }
+            store_decision_steps(steps_it->second);
             pending_steps_.erase(steps_it);
         }
     }
@@ -468,30 +491,9 @@ bool DecisionAuditTrailManager::store_decision_step(const DecisionStep& step) {
         auto conn = db_pool_->get_connection();
         if (!conn) return false;
 
-        std::string query = R"(
-            INSERT INTO decision_steps (
-                step_id, decision_id, event_type, description,
-                input_data, output_data, metadata, processing_time_us,
-                confidence_impact, timestamp, agent_id
-            ) VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11)
-        )";
-
-        std::vector<std::string> params = {
-            step.step_id,
-            step.decision_id,
-            std::to_string(static_cast<int>(step.event_type)),
-            step.description,
-            step.input_data.dump(),
-            step.output_data.dump(),
-            step.metadata.dump(),
-            std::to_string(step.processing_time.count()),
-            std::to_string(step.confidence_impact),
-            std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
-                step.timestamp.time_since_epoch()).count()),
-            step.agent_id
-        };
-
-        return conn->execute_command(query, params);
+        bool success = conn->execute_command(kInsertDecisionStepSql, decision_step_params(step));
+        db_pool_->return_connection(std::move(conn));
+        return success;
 
     } catch (const std::exception& e) {
         logger_->log(LogLevel::ERROR, "Failed to store decision step: " + std::string(e.what()));
@@ -499,6 +501,31 @@ bool DecisionAuditTrailManager::store_decision_step(const DecisionStep& step) {
     }
 }
 
+size_t DecisionAuditTrailManager::store_decision_steps(const std::vector<DecisionStep>& steps) {
+    if (steps.empty()) return 0;
+
+    try {
+        // One pipelined round trip instead of one per step; each insert still succeeds or fails alone
+        StatementBatch batch;
+        for (const auto& step : steps) {
+            batch.add(kInsertDecisionStepSql, decision_step_params(step));
+        }
+
+        auto result = db_pool_->execute_batch(batch);
+        for (size_t i = 0; i < result.results.size() && i < steps.size(); ++i) {
+            if (!result.results[i].ok()) {
+                logger_->log(LogLevel::ERROR, "Failed to store decision step: " + steps[i].step_id +
+                             (result.results[i].error().empty() ? "" : " (" + result.results[i].error() + ")"));
+            }
+        }
+        return result.succeeded;
+
+    } catch (const std::exception& e) {
+        logger_->log(LogLevel::ERROR, "Failed to store decision steps: " + std::string(e.what()));
+        return 0;
+    }
+}
+
 bool DecisionAuditTrailManager::update_decision_trail(const DecisionAuditTrail& trail) {
     try {
         auto conn = db_pool_->get_connection();
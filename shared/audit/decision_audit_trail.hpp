@@ -204,6 +204,7 @@ private:
     std::string event_type_to_string(AuditEventType type);
     // Database operations
     bool store_decision_step(const DecisionStep& step);
+    size_t store_decision_steps(const std::vector<DecisionStep>& steps); // pipelined; returns steps stored
     bool update_decision_trail(const DecisionAuditTrail& trail);
     bool store_decision_explanation(const DecisionExplanation& explanation);
 
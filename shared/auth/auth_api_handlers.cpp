@@ -216,13 +216,12 @@ std::string logout_user(PGconn* db_conn, const std::map<std::string, std::string
 std::string get_current_user(PGconn* db_conn, const std::map<std::string, std::string>& headers) {
     try {
         // Extract user ID from JWT token
-        const char* jwt_secret_env = std::getenv("JWT_SECRET");
-        if (!jwt_secret_env) {
+        auto jwt_parser = shared_jwt_parser();
+        if (!jwt_parser) {
             return "{\"error\":\"JWT secret not configured\"}";
         }
 
-        JWTParser jwt_parser(jwt_secret_env);
-        auto user_id_opt = extract_user_id_from_request(headers, jwt_parser);
+        auto user_id_opt = extract_user_id_from_request(headers, *jwt_parser);
 
         if (!user_id_opt.has_value()) {
             return "{\"error\":\"Invalid or missing authentication token\"}";
@@ -624,20 +623,13 @@ static std::optional<std::string> extract_user_id_from_request(const std::map<st
 
     std::string token = auth_header.substr(7);
 
-    // Parse and validate token
-    auto claims_opt = jwt_parser.parse_token(token);
-    if (!claims_opt.has_value()) {
+    // Parse and validate token; verify_token also rejects expired tokens
+    auto claims = jwt_parser.verify_token(token);
+    if (!claims) {
         return std::nullopt;
     }
 
-    const JWTClaims& claims = claims_opt.value();
-
-    // Check if token is expired
-    if (jwt_parser.is_expired(claims)) {
-        return std::nullopt;
-    }
-
-    return claims.user_id;
+    return claims->user_id;
 }
 
 } // namespace auth
@@ -27,12 +27,12 @@ std::optional<std::string> extract_user_id_from_request(
     std::string token = auth_header.substr(7);  // Skip "Bearer "
 
     // Parse JWT
-    auto claims_opt = jwt_parser.parse_token(token);
-    if (!claims_opt.has_value()) {
+    auto claims = jwt_parser.verify_token(token);
+    if (!claims) {
         return std::nullopt;
     }
 
-    return claims_opt.value().user_id;
+    return claims->user_id;
 }
 
 } // namespace regulens
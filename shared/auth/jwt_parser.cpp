@@ -1,75 +1,175 @@
 #include "jwt_parser.hpp"
+#include <openssl/crypto.h>
 #include <openssl/hmac.h>
 #include <openssl/evp.h>
-#include <openssl/buffer.h>
-#include <openssl/bio.h>
-#include <sstream>
+#include <array>
+#include <cstdlib>
 #include <ctime>
-#include <iostream>
+#include <functional>
+#include <mutex>
 #include <vector>
 
 namespace regulens {
 
-JWTParser::JWTParser(const std::string& secret_key)
-    : secret_key_(secret_key) {
+namespace {
+
+constexpr std::array<int8_t, 256> make_base64_table() {
+    std::array<int8_t, 256> table{};
+    for (auto& value : table) {
+        value = -1;
+    }
+    constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    for (size_t i = 0; i < alphabet.size(); ++i) {
+        table[static_cast<unsigned char>(alphabet[i])] = static_cast<int8_t>(i);
+    }
+    // URL-safe alphabet only (RFC 7515): one encoding per token, so string-keyed caches and blacklists hold
+    table['-'] = 62;
+    table['_'] = 63;
+    return table;
+}
+
+constexpr std::array<int8_t, 256> BASE64_TABLE = make_base64_table();
+
+size_t decoded_length(std::string_view input) {
+    return input.size() / 4 * 3 + (input.size() % 4 == 0 ? 0 : input.size() % 4 - 1);
 }
 
-std::string JWTParser::base64_url_decode(const std::string& input) {
-    std::string base64 = input;
-    // Replace URL-safe characters
-    for (char& c : base64) {
-        if (c == '-') c = '+';
-        if (c == '_') c = '/';
+// Table-driven base64url decode into a caller buffer; rejects bad characters,
+// '=' padding and non-canonical trailing bits
+bool decode_base64_url(std::string_view input, unsigned char* out, size_t capacity, size_t& length) {
+    if (input.size() % 4 == 1 || decoded_length(input) > capacity) {
+        return false;
     }
 
-    // Add padding
-    while (base64.length() % 4) {
-        base64 += '=';
+    uint32_t accumulator = 0;
+    int bits = 0;
+    length = 0;
+    for (unsigned char c : input) {
+        int8_t value = BASE64_TABLE[c];
+        if (value < 0) {
+            return false;
+        }
+        accumulator = (accumulator << 6) | static_cast<uint32_t>(value);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out[length++] = static_cast<unsigned char>(accumulator >> bits);
+        }
     }
+    return (accumulator & ((1u << bits) - 1)) == 0;
+}
 
-    // Decode base64
-    BIO *bio, *b64;
-    const size_t decode_len = base64.length();
-    std::vector<unsigned char> buffer(decode_len + 1);
+bool split_token(std::string_view token, size_t& first_dot, size_t& second_dot) {
+    first_dot = token.find('.');
+    if (first_dot == std::string_view::npos) {
+        return false;
+    }
+    second_dot = token.find('.', first_dot + 1);
+    return second_dot != std::string_view::npos &&
+           token.find('.', second_dot + 1) == std::string_view::npos;
+}
 
-    bio = BIO_new_mem_buf(base64.c_str(), -1);
-    b64 = BIO_new(BIO_f_base64());
-    bio = BIO_push(b64, bio);
+struct SharedParserState {
+    std::shared_mutex mutex;
+    std::shared_ptr<JWTParser> installed;
+    std::shared_ptr<JWTParser> from_env;
+    std::string env_secret;
+};
 
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    const int length = BIO_read(bio, buffer.data(), static_cast<int>(decode_len));
-    BIO_free_all(bio);
+SharedParserState& shared_parser_state() {
+    static SharedParserState state;
+    return state;
+}
 
-    if (length <= 0) {
-        return {};
+} // namespace
+
+// VerifiedTokenCache
+
+VerifiedTokenCache::VerifiedTokenCache(size_t max_entries, std::chrono::seconds max_ttl)
+    : max_entries_(max_entries), max_ttl_seconds_(max_ttl.count()) {
+}
+
+std::shared_ptr<const JWTClaims> VerifiedTokenCache::find(std::string_view token, std::string_view signature,
+                                                          int64_t now) {
+    size_t key = std::hash<std::string_view>{}(signature);
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        // The whole token must match: a signature is only valid for its own header and payload
+        if (it != entries_.end() && now < it->second.expires_at && it->second.token == token) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return it->second.claims;
+        }
     }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
 
-    return std::string(reinterpret_cast<char*>(buffer.data()), static_cast<size_t>(length));
+void VerifiedTokenCache::insert(std::string_view token, std::string_view signature,
+                                std::shared_ptr<const JWTClaims> claims, int64_t now) {
+    if (max_entries_ == 0) {
+        return;
+    }
+
+    size_t key = std::hash<std::string_view>{}(signature);
+    int64_t expires_at = std::min(claims->exp, now + max_ttl_seconds_);
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (entries_.size() >= max_entries_ && entries_.find(key) == entries_.end()) {
+        evict();
+    }
+    auto [it, inserted] = entries_.insert_or_assign(key, Entry{std::string(token), std::move(claims), expires_at});
+    if (inserted) {
+        insertion_order_.push_back(key);
+    }
 }
 
-std::string JWTParser::hmac_sha256(const std::string& data, const std::string& key) {
-    unsigned char hash[EVP_MAX_MD_SIZE];
-    unsigned int hash_len;
+void VerifiedTokenCache::evict() {
+    // Oldest first; max_ttl bounds every entry, so these are also the nearest to expiry
+    while (entries_.size() >= max_entries_ && !insertion_order_.empty()) {
+        entries_.erase(insertion_order_.front());
+        insertion_order_.pop_front();
+    }
+}
 
-    HMAC(EVP_sha256(),
-         key.c_str(), static_cast<int>(key.length()),
-         reinterpret_cast<const unsigned char*>(data.c_str()), static_cast<int>(data.length()),
-         hash, &hash_len);
+void VerifiedTokenCache::clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    entries_.clear();
+    insertion_order_.clear();
+}
 
-    return std::string(reinterpret_cast<char*>(hash), hash_len);
+size_t VerifiedTokenCache::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return entries_.size();
 }
 
-std::optional<nlohmann::json> JWTParser::decode_payload(const std::string& token) {
-    // Split token into parts
-    std::istringstream iss(token);
-    std::string header, payload, signature;
+// JWTParser
+
+JWTParser::JWTParser(const std::string& secret_key, size_t cache_capacity, std::chrono::seconds cache_ttl)
+    : secret_key_(secret_key),
+      cache_(std::make_shared<VerifiedTokenCache>(cache_capacity, cache_ttl)) {
+}
+
+std::string JWTParser::base64_url_decode(std::string_view input) {
+    std::string decoded(decoded_length(input), '\0');
+    size_t length = 0;
+    if (!decode_base64_url(input, reinterpret_cast<unsigned char*>(decoded.data()), decoded.size(), length)) {
+        return {};
+    }
+    decoded.resize(length);
+    return decoded;
+}
 
-    if (!std::getline(iss, header, '.')) return std::nullopt;
-    if (!std::getline(iss, payload, '.')) return std::nullopt;
-    if (!std::getline(iss, signature, '.')) return std::nullopt;
+std::optional<nlohmann::json> JWTParser::decode_payload(const std::string& token) {
+    size_t first_dot = 0;
+    size_t second_dot = 0;
+    if (!split_token(token, first_dot, second_dot)) {
+        return std::nullopt;
+    }
 
     // Decode payload
-    std::string decoded_payload = base64_url_decode(payload);
+    std::string decoded_payload =
+        base64_url_decode(std::string_view(token).substr(first_dot + 1, second_dot - first_dot - 1));
 
     try {
         return nlohmann::json::parse(decoded_payload);
@@ -78,50 +178,30 @@ std::optional<nlohmann::json> JWTParser::decode_payload(const std::string& token
     }
 }
 
-bool JWTParser::validate_signature(const std::string& token) {
-    // Split token
-    size_t first_dot = token.find('.');
-    size_t second_dot = token.find('.', first_dot + 1);
-
-    if (first_dot == std::string::npos || second_dot == std::string::npos) {
+bool JWTParser::verify_signature(std::string_view token, size_t second_dot) const {
+    // HMAC over "header.payload" and the decoded signature both stay on the stack
+    unsigned char expected[EVP_MAX_MD_SIZE];
+    unsigned int expected_len = 0;
+    if (!HMAC(EVP_sha256(),
+              secret_key_.data(), static_cast<int>(secret_key_.size()),
+              reinterpret_cast<const unsigned char*>(token.data()), second_dot,
+              expected, &expected_len)) {
         return false;
     }
 
-    std::string message = token.substr(0, second_dot);
-    std::string signature = token.substr(second_dot + 1);
-
-    // Calculate expected signature
-    std::string expected_sig = hmac_sha256(message, secret_key_);
-
-    // Base64 URL encode expected signature
-    BIO *bio, *b64;
-    BUF_MEM *bufferPtr;
-
-    b64 = BIO_new(BIO_f_base64());
-    bio = BIO_new(BIO_s_mem());
-    bio = BIO_push(b64, bio);
-
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    BIO_write(bio, expected_sig.c_str(), static_cast<int>(expected_sig.length()));
-    BIO_flush(bio);
-    BIO_get_mem_ptr(bio, &bufferPtr);
-
-    std::string expected_sig_b64(bufferPtr->data, bufferPtr->length);
-    BIO_free_all(bio);
-
-    // Remove padding from expected signature
-    while (!expected_sig_b64.empty() && expected_sig_b64.back() == '=') {
-        expected_sig_b64.pop_back();
+    unsigned char provided[EVP_MAX_MD_SIZE];
+    size_t provided_len = 0;
+    if (!decode_base64_url(token.substr(second_dot + 1), provided, sizeof(provided), provided_len)) {
+        return false;
     }
 
-    // Replace + with - and / with _ for URL-safe base64
-    for (char& c : expected_sig_b64) {
-        if (c == '+') c = '-';
-        if (c == '/') c = '_';
-    }
+    return provided_len == expected_len && CRYPTO_memcmp(provided, expected, expected_len) == 0;
+}
 
-    // Compare signatures (use constant-time comparison in production)
-    return signature == expected_sig_b64;
+bool JWTParser::validate_signature(const std::string& token) {
+    size_t first_dot = 0;
+    size_t second_dot = 0;
+    return split_token(token, first_dot, second_dot) && verify_signature(token, second_dot);
 }
 
 bool JWTParser::is_expired(const JWTClaims& claims) {
@@ -129,52 +209,110 @@ bool JWTParser::is_expired(const JWTClaims& claims) {
     return current_time >= claims.exp;
 }
 
-std::optional<JWTClaims> JWTParser::parse_token(const std::string& token) {
-    // Validate signature first
-    if (!validate_signature(token)) {
-        return std::nullopt;
+std::shared_ptr<const JWTClaims> JWTParser::verify_token(std::string_view token) {
+    size_t first_dot = 0;
+    size_t second_dot = 0;
+    if (!split_token(token, first_dot, second_dot)) {
+        return nullptr;
     }
 
-    // Decode payload
-    auto payload_opt = decode_payload(token);
-    if (!payload_opt.has_value()) {
-        return std::nullopt;
+    const int64_t now = std::time(nullptr);
+    std::string_view signature = token.substr(second_dot + 1);
+    if (auto cached = cache_->find(token, signature, now)) {
+        return cached;
     }
 
-    auto payload = payload_opt.value();
+    // Validate signature first
+    if (!verify_signature(token, second_dot)) {
+        return nullptr;
+    }
 
-    // Extract claims
-    JWTClaims claims;
+    auto claims = std::make_shared<JWTClaims>();
 
     try {
-        claims.user_id = payload.value("sub", "");  // Standard "sub" claim
-        claims.username = payload.value("username", "");
-        claims.email = payload.value("email", "");
-        claims.exp = payload.value("exp", 0);
-        claims.iat = payload.value("iat", 0);
-        claims.jti = payload.value("jti", "");
+        auto payload = nlohmann::json::parse(
+            base64_url_decode(token.substr(first_dot + 1, second_dot - first_dot - 1)));
+
+        claims->user_id = payload.value("sub", "");  // Standard "sub" claim
+        claims->username = payload.value("username", "");
+        claims->email = payload.value("email", "");
+        claims->exp = payload.value("exp", int64_t{0});
+        claims->iat = payload.value("iat", int64_t{0});
+        claims->jti = payload.value("jti", "");
 
         if (payload.contains("roles") && payload["roles"].is_array()) {
             for (const auto& role : payload["roles"]) {
-                claims.roles.push_back(role.get<std::string>());
+                claims->roles.push_back(role.get<std::string>());
             }
         }
+    } catch (const nlohmann::json::exception& e) {
+        return nullptr;
+    }
 
-        // Validate required fields
-        if (claims.user_id.empty() || claims.exp == 0) {
-            return std::nullopt;
-        }
-
-        // Check expiration
-        if (is_expired(claims)) {
-            return std::nullopt;
-        }
+    // Validate required fields and expiration
+    if (claims->user_id.empty() || claims->exp == 0 || now >= claims->exp) {
+        return nullptr;
+    }
 
-        return claims;
+    cache_->insert(token, signature, claims, now);
+    return claims;
+}
 
-    } catch (const nlohmann::json::exception& e) {
+std::optional<JWTClaims> JWTParser::parse_token(const std::string& token) {
+    auto claims = verify_token(token);
+    if (!claims) {
         return std::nullopt;
     }
+    return *claims;
+}
+
+// Shared parser
+
+void install_shared_jwt_parser(std::shared_ptr<JWTParser> parser) {
+    auto& state = shared_parser_state();
+    std::unique_lock<std::shared_mutex> lock(state.mutex);
+    state.installed = std::move(parser);
+}
+
+std::shared_ptr<JWTParser> shared_jwt_parser() {
+    auto& state = shared_parser_state();
+    std::string_view secret;
+    {
+        std::shared_lock<std::shared_mutex> lock(state.mutex);
+        if (state.installed) {
+            return state.installed;
+        }
+        const char* secret_env = std::getenv("JWT_SECRET");
+        if (!secret_env || *secret_env == '\0') {
+            return nullptr;
+        }
+        secret = secret_env;
+        if (state.from_env && state.env_secret == secret) {
+            return state.from_env;
+        }
+    }
+
+    // First use, or JWT_SECRET changed: tokens cached under the old secret go with the old parser
+    std::unique_lock<std::shared_mutex> lock(state.mutex);
+    if (state.installed) {
+        return state.installed;
+    }
+    if (!state.from_env || state.env_secret != secret) {
+        state.env_secret = std::string(secret);
+        state.from_env = std::make_shared<JWTParser>(state.env_secret);
+    }
+    return state.from_env;
+}
+
+nlohmann::json JWTParser::get_cache_stats() const {
+    uint64_t hits = cache_->hits();
+    uint64_t misses = cache_->misses();
+    return {
+        {"entries", cache_->size()},
+        {"hits", hits},
+        {"misses", misses},
+        {"hit_rate", hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses)}
+    };
 }
 
 } // namespace regulens
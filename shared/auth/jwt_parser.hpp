@@ -1,8 +1,16 @@
 #ifndef JWT_PARSER_H
 #define JWT_PARSER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 #include <nlohmann/json.hpp>
 
@@ -18,13 +26,58 @@ struct JWTClaims {
     std::string jti;  // JWT ID
 };
 
+/**
+ * @brief Bounded cache of tokens whose signature has already been verified
+ *
+ * Entries are keyed by the signature segment and hold the decoded claims, so a
+ * repeat request costs a hash, a shared lock and a token comparison. An entry
+ * lives until the token's exp or max_ttl, whichever comes first; when full, the
+ * oldest entries are evicted.
+ */
+class VerifiedTokenCache {
+public:
+    VerifiedTokenCache(size_t max_entries, std::chrono::seconds max_ttl);
+
+    std::shared_ptr<const JWTClaims> find(std::string_view token, std::string_view signature, int64_t now);
+    void insert(std::string_view token, std::string_view signature,
+                std::shared_ptr<const JWTClaims> claims, int64_t now);
+    void clear();
+
+    size_t size() const;
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        std::string token;
+        std::shared_ptr<const JWTClaims> claims;
+        int64_t expires_at;
+    };
+
+    void evict();
+
+    size_t max_entries_;
+    int64_t max_ttl_seconds_;
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<size_t, Entry> entries_;
+    std::deque<size_t> insertion_order_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
 class JWTParser {
 public:
-    JWTParser(const std::string& secret_key);
+    // cache_capacity 0 disables the verified-token cache
+    JWTParser(const std::string& secret_key,
+              size_t cache_capacity = 10000,
+              std::chrono::seconds cache_ttl = std::chrono::seconds(300));
 
     // Parse and validate JWT token
     std::optional<JWTClaims> parse_token(const std::string& token);
 
+    // Same checks as parse_token; returns the shared cached claims instead of a copy
+    std::shared_ptr<const JWTClaims> verify_token(std::string_view token);
+
     // Validate token signature
     bool validate_signature(const std::string& token);
 
@@ -34,13 +87,26 @@ public:
     // Extract claims without validation (for debugging)
     std::optional<nlohmann::json> decode_payload(const std::string& token);
 
+    nlohmann::json get_cache_stats() const;
+
 private:
     std::string secret_key_;
+    std::shared_ptr<VerifiedTokenCache> cache_;
 
-    std::string base64_url_decode(const std::string& input);
-    std::string hmac_sha256(const std::string& data, const std::string& key);
+    bool verify_signature(std::string_view token, size_t second_dot) const;
+    std::string base64_url_decode(std::string_view input);
 };
 
+/**
+ * @brief Parser shared by request handlers that are not handed one
+ *
+ * The server installs its parser once at startup. Until one is installed, a
+ * parser is built from JWT_SECRET and rebuilt if the secret changes; null when
+ * no secret is configured.
+ */
+void install_shared_jwt_parser(std::shared_ptr<JWTParser> parser);
+std::shared_ptr<JWTParser> shared_jwt_parser();
+
 } // namespace regulens
 
 #endif // JWT_PARSER_H
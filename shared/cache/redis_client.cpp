@@ -665,18 +665,14 @@ RedisResult RedisClient::get(const std::string& key) {
 
 RedisResult RedisClient::set(const std::string& key, const std::string& value,
                             std::chrono::seconds ttl_seconds) {
-    auto result = execute_with_connection([key, value](std::shared_ptr<RedisConnectionWrapper> conn) {
+    // Value and TTL in one command, so the key never exists without its expiry
+    auto result = execute_with_connection([key, value, ttl_seconds](std::shared_ptr<RedisConnectionWrapper> conn) {
+        if (ttl_seconds.count() > 0) {
+            return conn->execute_command("SET", {key, value, "EX", std::to_string(ttl_seconds.count())});
+        }
         return conn->execute_command("SET", {key, value});
     });
 
-    // Set TTL if specified
-    if (result.success && ttl_seconds.count() > 0) {
-        auto ttl_result = expire(key, ttl_seconds);
-        if (!ttl_result.success) {
-            return RedisResult(false, "Failed to set TTL: " + ttl_result.error_message);
-        }
-    }
-
     // Record metrics
     if (metrics_collector_ && result.success) {
         std::string cache_type = "unknown";
@@ -18,6 +18,8 @@ struct DatabaseConfig {
     int connection_timeout = 30;
     bool ssl_mode = true;
     int max_retries = 3;
+    int connections_per_instance = 1;      // physical connections multiplexed by one PostgreSQLConnection
+    bool prepared_statement_cache = true;  // prepare SQL text on its second execution and cache it per connection
 };
 
 /**
@@ -125,6 +125,8 @@ bool ConfigurationManager::load_from_environment() {
     load_env_var(config_keys::DB_CONNECTION_POOL_SIZE);
     load_env_var(config_keys::DB_CONNECTION_TIMEOUT_MS);
     load_env_var(config_keys::DB_MAX_RETRIES);
+    load_env_var(config_keys::DB_CONNECTIONS_PER_INSTANCE);
+    load_env_var(config_keys::DB_PREPARED_STATEMENT_CACHE);
 
     // Message queue configuration
     load_env_var(config_keys::MESSAGE_QUEUE_TYPE);
@@ -323,6 +325,8 @@ DatabaseConfig ConfigurationManager::get_database_config() const {
     config.max_connections = get_int(config_keys::DB_CONNECTION_POOL_SIZE).value_or(10);
     config.connection_timeout = get_int(config_keys::DB_CONNECTION_TIMEOUT_MS).value_or(30000) / 1000; // Convert ms to seconds
     config.max_retries = get_int(config_keys::DB_MAX_RETRIES).value_or(3);
+    config.connections_per_instance = get_int(config_keys::DB_CONNECTIONS_PER_INSTANCE).value_or(1);
+    config.prepared_statement_cache = get_string(config_keys::DB_PREPARED_STATEMENT_CACHE).value_or("true") != "false";
 
     return config;
 }
@@ -243,6 +243,8 @@ inline constexpr const char* DB_SSL_MODE = "DB_SSL_MODE";
 inline constexpr const char* DB_CONNECTION_POOL_SIZE = "DB_CONNECTION_POOL_SIZE";
 inline constexpr const char* DB_CONNECTION_TIMEOUT_MS = "DB_CONNECTION_TIMEOUT_MS";
 inline constexpr const char* DB_MAX_RETRIES = "DB_MAX_RETRIES";
+inline constexpr const char* DB_CONNECTIONS_PER_INSTANCE = "DB_CONNECTIONS_PER_INSTANCE";
+inline constexpr const char* DB_PREPARED_STATEMENT_CACHE = "DB_PREPARED_STATEMENT_CACHE";
 
 // Message queue configuration
 inline constexpr const char* MESSAGE_QUEUE_TYPE = "MESSAGE_QUEUE_TYPE";
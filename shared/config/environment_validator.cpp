@@ -130,6 +130,24 @@ void EnvironmentValidator::load_default_rules() {
         [this](const std::string& value) { return validate_numeric_range(value, 1, 100); }
     });
 
+    add_validation_rule(ValidationRule{
+        "DB_CONNECTIONS_PER_INSTANCE",
+        "Physical connections multiplexed by each PostgreSQLConnection",
+        false,
+        "1",
+        {},
+        [this](const std::string& value) { return validate_numeric_range(value, 1, 64); }
+    });
+
+    add_validation_rule(ValidationRule{
+        "DB_PREPARED_STATEMENT_CACHE",
+        "Cache prepared statements per connection (disable behind transaction-mode poolers)",
+        false,
+        "true",
+        {"true", "false"},
+        nullptr
+    });
+
     add_validation_rule(ValidationRule{
         "DB_CONNECTION_TIMEOUT_MS",
         "Connection timeout in milliseconds",
@@ -290,9 +290,17 @@ std::vector<DataRecord> DataIngestionFramework::ingest_data(const std::string& s
         // Process through pipeline
         auto processed_records = process_batch(batch);
 
-        // Store records
-        if (!processed_records.empty()) {
-            store_records(processed_records);
+        // Store records, then let the pipeline record what was actually stored
+        if (!processed_records.empty() && store_records(processed_records)) {
+            auto pipeline_it = active_pipelines_.find(source_id);
+            if (pipeline_it != active_pipelines_.end() && pipeline_it->second) {
+                std::vector<nlohmann::json> stored;
+                stored.reserve(processed_records.size());
+                for (const auto& record : processed_records) {
+                    stored.push_back(record.data);
+                }
+                pipeline_it->second->on_records_stored(stored);
+            }
         }
 
         logger_->log(LogLevel::DEBUG,
@@ -336,7 +344,7 @@ std::vector<DataRecord> DataIngestionFramework::process_batch(const IngestionBat
             record.record_id = batch.source_id + "_" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + "_" + std::to_string(i);
             record.source_id = batch.source_id;
             record.quality = DataQuality::TRANSFORMED; // Default quality after pipeline processing
-            record.data = processed_batch.processed_data[i];
+            record.data = std::move(processed_batch.processed_data[i]);
             record.ingested_at = std::chrono::system_clock::now();
             record.processed_at = std::chrono::system_clock::now();
             record.processing_pipeline = "standard_ingestion_pipeline";
@@ -632,7 +640,9 @@ std::unique_ptr<IngestionPipeline> DataIngestionFramework::create_pipeline(const
     // Production-grade pipeline factory using StandardIngestionPipeline
     // StandardIngestionPipeline supports batch, streaming, and real-time modes through its configuration
     // via enabled_stages, poll_interval, and batch_size parameters in DataIngestionConfig
-    return std::make_unique<StandardIngestionPipeline>(config, logger_);
+    auto pipeline = std::make_unique<StandardIngestionPipeline>(config, logger_);
+    pipeline->set_storage(db_pool_);
+    return pipeline;
 }
 
 std::unique_ptr<StorageAdapter> DataIngestionFramework::get_storage_adapter(const std::string& source_id) {
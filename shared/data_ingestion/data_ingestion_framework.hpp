@@ -269,6 +269,8 @@ public:
     virtual IngestionBatch process_batch(const std::vector<nlohmann::json>& raw_data) = 0;
     virtual bool validate_batch(const IngestionBatch& batch) = 0;
     virtual nlohmann::json transform_data(const nlohmann::json& data) = 0;
+    // Processed records that storage accepted; only these count as ingested
+    virtual void on_records_stored(const std::vector<nlohmann::json>& /*records*/) {}
 
 protected:
     DataIngestionConfig config_;
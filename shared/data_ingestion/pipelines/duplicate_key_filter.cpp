@@ -0,0 +1,304 @@
+/**
+ * Duplicate Key Filter Implementation
+ */
+
+#include "duplicate_key_filter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace regulens {
+
+namespace {
+
+constexpr uint32_t FILE_MAGIC = 0x46425244;  // "DRBF"
+constexpr uint32_t FILE_VERSION = 2;         // 2 adds the snapshot time after the header
+
+int64_t now_epoch_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t mix64(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+template <typename T>
+void write_pod(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_pod(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+// BloomFilter
+
+BloomFilter::BloomFilter(size_t expected_keys, double false_positive_rate) {
+    expected_keys = std::max<size_t>(1, expected_keys);
+    false_positive_rate = std::clamp(false_positive_rate, 1e-9, 0.5);
+
+    // m = -n ln p / (ln 2)^2, k = (m / n) ln 2
+    double ln2 = std::log(2.0);
+    double bits = -static_cast<double>(expected_keys) * std::log(false_positive_rate) / (ln2 * ln2);
+    bits_ = std::max<size_t>(64, static_cast<size_t>(std::ceil(bits)));
+    hashes_ = std::max<uint32_t>(1, static_cast<uint32_t>(std::round(static_cast<double>(bits_) / static_cast<double>(expected_keys) * ln2)));
+    words_.assign((bits_ + 63) / 64, 0);
+}
+
+void BloomFilter::insert(uint64_t hash) {
+    uint64_t h1 = hash;
+    uint64_t h2 = mix64(hash) | 1;
+    for (uint32_t i = 0; i < hashes_; ++i) {
+        size_t bit = static_cast<size_t>((h1 + i * h2) % bits_);
+        words_[bit / 64] |= (1ULL << (bit % 64));
+    }
+    keys_++;
+}
+
+bool BloomFilter::might_contain(uint64_t hash) const {
+    if (bits_ == 0) {
+        return false;
+    }
+    uint64_t h1 = hash;
+    uint64_t h2 = mix64(hash) | 1;
+    for (uint32_t i = 0; i < hashes_; ++i) {
+        size_t bit = static_cast<size_t>((h1 + i * h2) % bits_);
+        if ((words_[bit / 64] & (1ULL << (bit % 64))) == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BloomFilter::write(std::ostream& out) const {
+    write_pod(out, static_cast<uint64_t>(bits_));
+    write_pod(out, hashes_);
+    write_pod(out, static_cast<uint64_t>(keys_));
+    out.write(reinterpret_cast<const char*>(words_.data()),
+              static_cast<std::streamsize>(words_.size() * sizeof(uint64_t)));
+    return static_cast<bool>(out);
+}
+
+bool BloomFilter::read(std::istream& in) {
+    uint64_t bits = 0;
+    uint64_t keys = 0;
+    if (!read_pod(in, bits) || !read_pod(in, hashes_) || !read_pod(in, keys) || bits == 0 || hashes_ == 0) {
+        return false;
+    }
+    bits_ = static_cast<size_t>(bits);
+    keys_ = static_cast<size_t>(keys);
+    words_.assign((bits_ + 63) / 64, 0);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(words_.data()),
+                                     static_cast<std::streamsize>(words_.size() * sizeof(uint64_t))));
+}
+
+// DuplicateKeyFilter
+
+DuplicateKeyFilter::DuplicateKeyFilter(DuplicateFilterConfig config)
+    : config_(std::move(config)), last_save_(std::chrono::steady_clock::now()) {}
+
+uint64_t DuplicateKeyFilter::hash_key(const std::string& key) {
+    // FNV-1a, finalized; stable across builds so persisted filters stay valid
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+    return mix64(hash);
+}
+
+bool DuplicateKeyFilter::might_contain(const std::string& key) const {
+    uint64_t hash = hash_key(key);
+    int64_t oldest = now_epoch_seconds() - std::chrono::duration_cast<std::chrono::seconds>(config_.retention).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Newest first: recent keys are the likeliest repeats
+    for (auto it = partitions_.rbegin(); it != partitions_.rend(); ++it) {
+        if (it->created_at + std::chrono::duration_cast<std::chrono::seconds>(config_.partition_span).count() < oldest) {
+            break;
+        }
+        if (it->filter.might_contain(hash)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DuplicateKeyFilter::insert(const std::string& key) {
+    uint64_t hash = hash_key(key);
+    int64_t now = now_epoch_seconds();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    writable_partition(now).filter.insert(hash);
+    inserts_since_save_++;
+}
+
+DuplicateKeyFilter::Partition& DuplicateKeyFilter::writable_partition(int64_t now) {
+    int64_t span = std::chrono::duration_cast<std::chrono::seconds>(config_.partition_span).count();
+    if (partitions_.empty() ||
+        partitions_.back().filter.size() >= config_.keys_per_partition ||
+        now - partitions_.back().created_at >= span) {
+        partitions_.push_back({now, BloomFilter(config_.keys_per_partition, config_.false_positive_rate)});
+        evict_expired(now);
+    }
+    return partitions_.back();
+}
+
+void DuplicateKeyFilter::evict_expired(int64_t now) {
+    int64_t span = std::chrono::duration_cast<std::chrono::seconds>(config_.partition_span).count();
+    int64_t oldest = now - std::chrono::duration_cast<std::chrono::seconds>(config_.retention).count();
+
+    // A partition can be dropped once its newest possible key has left the retention window
+    while (partitions_.size() > 1 &&
+           (partitions_.front().created_at + span < oldest || partitions_.size() > config_.max_partitions)) {
+        partitions_.pop_front();
+    }
+}
+
+bool DuplicateKeyFilter::save(std::string& error) const {
+    if (config_.persistence_path.empty()) {
+        error = "No persistence path configured";
+        return false;
+    }
+
+    // Write next to the target and rename, so readers never see a partial file
+    std::string temp_path = config_.persistence_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            error = "Cannot open " + temp_path + " for writing";
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        write_pod(out, FILE_MAGIC);
+        write_pod(out, FILE_VERSION);
+        write_pod(out, static_cast<uint64_t>(partitions_.size()));
+        write_pod(out, now_epoch_seconds());
+        for (const auto& partition : partitions_) {
+            write_pod(out, partition.created_at);
+            if (!partition.filter.write(out)) {
+                error = "Failed writing " + temp_path;
+                return false;
+            }
+        }
+        out.flush();
+        if (!out) {
+            error = "Failed writing " + temp_path;
+            return false;
+        }
+    }
+
+    if (std::rename(temp_path.c_str(), config_.persistence_path.c_str()) != 0) {
+        error = "Cannot replace " + config_.persistence_path;
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool DuplicateKeyFilter::load(std::string& error) {
+    if (config_.persistence_path.empty()) {
+        error = "No persistence path configured";
+        return false;
+    }
+
+    std::ifstream in(config_.persistence_path, std::ios::binary);
+    if (!in) {
+        error = "No saved filter at " + config_.persistence_path;
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t count = 0;
+    int64_t snapshot_time = 0;
+    if (!read_pod(in, magic) || !read_pod(in, version) || !read_pod(in, count) ||
+        magic != FILE_MAGIC || version < 1 || version > FILE_VERSION ||
+        (version >= 2 && !read_pod(in, snapshot_time))) {
+        error = "Unrecognized filter file " + config_.persistence_path;
+        return false;
+    }
+
+    std::deque<Partition> loaded;
+    for (uint64_t i = 0; i < count; ++i) {
+        Partition partition{0, BloomFilter()};
+        if (!read_pod(in, partition.created_at) || !partition.filter.read(in)) {
+            error = "Truncated filter file " + config_.persistence_path;
+            return false;
+        }
+        loaded.push_back(std::move(partition));
+    }
+    if (version < 2) {
+        // No snapshot time: keys may have been added any time after the newest partition opened
+        snapshot_time = loaded.empty() ? 0 : loaded.back().created_at;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    partitions_ = std::move(loaded);
+    loaded_snapshot_time_ = snapshot_time;
+    evict_expired(now_epoch_seconds());
+    return true;
+}
+
+int64_t DuplicateKeyFilter::loaded_snapshot_time() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return loaded_snapshot_time_;
+}
+
+bool DuplicateKeyFilter::save_if_due(std::string& error) {
+    if (config_.persistence_path.empty()) {
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (inserts_since_save_ == 0 ||
+            std::chrono::steady_clock::now() - last_save_ < config_.persist_interval) {
+            return true;
+        }
+        inserts_since_save_ = 0;
+        last_save_ = std::chrono::steady_clock::now();
+    }
+
+    return save(error);
+}
+
+size_t DuplicateKeyFilter::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t keys = 0;
+    for (const auto& partition : partitions_) {
+        keys += partition.filter.size();
+    }
+    return keys;
+}
+
+nlohmann::json DuplicateKeyFilter::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t keys = 0;
+    size_t bytes = 0;
+    for (const auto& partition : partitions_) {
+        keys += partition.filter.size();
+        bytes += partition.filter.memory_bytes();
+    }
+    return {
+        {"partitions", partitions_.size()},
+        {"keys", keys},
+        {"memory_bytes", bytes},
+        {"false_positive_rate", config_.false_positive_rate},
+        {"retention_hours", config_.retention.count()}
+    };
+}
+
+} // namespace regulens
@@ -0,0 +1,114 @@
+/**
+ * Duplicate Key Filter - Probabilistic "seen before?" index for ingestion
+ *
+ * A time-partitioned, scalable Bloom filter over duplicate keys. A negative
+ * answer means the key is definitely new, so only probable positives need a
+ * database confirmation. Keys are inserted into the newest partition; a new
+ * partition is opened when the current one reaches its capacity or its time
+ * span, and partitions older than the retention window are dropped, so memory
+ * tracks the ingest rate instead of growing without bound.
+ *
+ * The filter can be saved to and loaded from a file so restarts keep their
+ * history without re-reading processed_records. The file records when it was
+ * written, so a loader only needs the keys processed since then.
+ *
+ * Persistence assumes a single writer per path: processes sharing a
+ * persistence_path overwrite each other's snapshots (and share the .tmp file
+ * used while writing), so give each pipeline instance its own path.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace regulens {
+
+struct DuplicateFilterConfig {
+    size_t keys_per_partition = 1000000;
+    double false_positive_rate = 0.001;                            // per partition; lookups probe every live one
+    std::chrono::hours partition_span = std::chrono::hours(24);
+    std::chrono::hours retention = std::chrono::hours(24 * 7);   // keys older than this are forgotten
+    size_t max_partitions = 64;                                    // hard memory cap
+    std::string persistence_path;                                  // empty = not persisted
+    std::chrono::seconds persist_interval = std::chrono::seconds(300);
+};
+
+/**
+ * @brief Fixed-size Bloom filter using double hashing
+ */
+class BloomFilter {
+public:
+    BloomFilter() = default;
+    BloomFilter(size_t expected_keys, double false_positive_rate);
+
+    void insert(uint64_t hash);
+    bool might_contain(uint64_t hash) const;
+
+    size_t size() const { return keys_; }
+    size_t bit_count() const { return bits_; }
+    size_t memory_bytes() const { return words_.size() * sizeof(uint64_t); }
+
+    bool write(std::ostream& out) const;
+    bool read(std::istream& in);
+
+private:
+    size_t bits_ = 0;
+    uint32_t hashes_ = 0;
+    size_t keys_ = 0;
+    std::vector<uint64_t> words_;
+};
+
+class DuplicateKeyFilter {
+public:
+    explicit DuplicateKeyFilter(DuplicateFilterConfig config);
+
+    /**
+     * @brief false means definitely never inserted (within the retention window)
+     */
+    bool might_contain(const std::string& key) const;
+    void insert(const std::string& key);
+
+    bool save(std::string& error) const;
+    bool load(std::string& error);
+
+    /**
+     * @brief Save if a persistence path is set and persist_interval has passed since the last save
+     * @return false only if a save was attempted and failed
+     */
+    bool save_if_due(std::string& error);
+
+    /**
+     * @brief Epoch seconds at which the loaded snapshot was written; 0 before a successful load
+     */
+    int64_t loaded_snapshot_time() const;
+
+    size_t size() const;
+    nlohmann::json get_stats() const;
+
+    static uint64_t hash_key(const std::string& key);
+
+private:
+    struct Partition {
+        int64_t created_at;  // epoch seconds
+        BloomFilter filter;
+    };
+
+    Partition& writable_partition(int64_t now);
+    void evict_expired(int64_t now);
+
+    DuplicateFilterConfig config_;
+    mutable std::mutex mutex_;
+    std::deque<Partition> partitions_;
+    size_t inserts_since_save_ = 0;
+    int64_t loaded_snapshot_time_ = 0;
+    std::chrono::steady_clock::time_point last_save_;
+};
+
+} // namespace regulens
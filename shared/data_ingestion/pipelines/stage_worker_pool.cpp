@@ -0,0 +1,104 @@
+/**
+ * Stage Worker Pool Implementation
+ */
+
+#include "stage_worker_pool.hpp"
+#include <algorithm>
+
+namespace regulens {
+
+StageWorkerPool::StageWorkerPool(size_t worker_threads) {
+    workers_.reserve(worker_threads);
+    for (size_t i = 0; i < worker_threads; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+StageWorkerPool::~StageWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void StageWorkerPool::run(size_t tasks, const std::function<void(size_t)>& task) {
+    if (tasks == 0) {
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>();
+    batch->task = &task;
+    batch->tasks = tasks;
+
+    // One queue entry per worker that can usefully join; each claims tasks
+    // until none are left, so a busy worker never holds up the batch
+    size_t helpers = std::min(workers_.size(), tasks - 1);
+    if (helpers > 0) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.insert(queue_.end(), helpers, batch);
+        }
+        if (helpers == 1) {
+            work_available_.notify_one();
+        } else {
+            work_available_.notify_all();
+        }
+    }
+
+    work_on(*batch);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    batch->finished.wait(lock, [&] { return batch->done == batch->tasks; });
+    if (batch->failure) {
+        std::rethrow_exception(batch->failure);
+    }
+}
+
+void StageWorkerPool::worker_loop() {
+    while (true) {
+        std::shared_ptr<Batch> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_available_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            batch = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        work_on(*batch);
+    }
+}
+
+void StageWorkerPool::work_on(Batch& batch) {
+    size_t completed = 0;
+    std::exception_ptr failure;
+    for (size_t i = batch.next.fetch_add(1); i < batch.tasks; i = batch.next.fetch_add(1)) {
+        try {
+            (*batch.task)(i);
+        } catch (...) {
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+        ++completed;
+    }
+    if (completed == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (failure && !batch.failure) {
+        batch.failure = failure;
+    }
+    batch.done += completed;
+    if (batch.done == batch.tasks) {
+        batch.finished.notify_all();
+    }
+}
+
+} // namespace regulens
@@ -0,0 +1,63 @@
+/**
+ * Stage Worker Pool - Long-lived threads for record-level pipeline stages
+ *
+ * A stage splits each batch into slices; run() hands the slices to the pool's
+ * threads and the calling thread, and returns once all of them are done. The
+ * threads are started once and reused for every batch, so a stream of small
+ * micro-batches does not pay for thread creation on each one.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace regulens {
+
+class StageWorkerPool {
+public:
+    // worker_threads excludes the caller of run(), which always takes part
+    explicit StageWorkerPool(size_t worker_threads);
+    ~StageWorkerPool();
+
+    StageWorkerPool(const StageWorkerPool&) = delete;
+    StageWorkerPool& operator=(const StageWorkerPool&) = delete;
+
+    /**
+     * @brief Call task(0) .. task(tasks - 1) across the pool and the calling thread
+     * Blocks until every call has returned; the first exception is rethrown.
+     * Safe to call from several threads at once.
+     */
+    void run(size_t tasks, const std::function<void(size_t)>& task);
+
+    size_t worker_threads() const { return workers_.size(); }
+
+private:
+    struct Batch {
+        const std::function<void(size_t)>* task = nullptr;
+        size_t tasks = 0;
+        std::atomic<size_t> next{0};
+        size_t done = 0;                 // guarded by mutex_
+        std::exception_ptr failure;      // guarded by mutex_
+        std::condition_variable finished;
+    };
+
+    void worker_loop();
+    void work_on(Batch& batch);
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::deque<std::shared_ptr<Batch>> queue_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace regulens
@@ -9,6 +9,9 @@
 #include <openssl/rand.h>
 #include <iomanip>
 #include <sstream>
+#include <condition_variable>
+#include <exception>
+#include <thread>
 #include <pqxx/pqxx>
 
 namespace regulens {
@@ -46,52 +49,97 @@ StandardIngestionPipeline::StandardIngestionPipeline(const DataIngestionConfig&
     : IngestionPipeline(config, logger), total_records_processed_(0), successful_records_(0), failed_records_(0), storage_(nullptr) {
 }
 
-StandardIngestionPipeline::~StandardIngestionPipeline() = default;
+StandardIngestionPipeline::~StandardIngestionPipeline() {
+    if (duplicate_filter_ && !pipeline_config_.duplicate_filter.persistence_path.empty()) {
+        std::string error;
+        if (!duplicate_filter_->save(error)) {
+            logger_->log(LogLevel::WARN, "Failed to save duplicate filter: " + error);
+        }
+    }
+}
+
+namespace {
+
+/**
+ * Bounded hand-off between two streaming stages. close() ends the stream
+ * for the consumer; abort() also unblocks producers after a failure.
+ */
+class MicroBatchQueue {
+public:
+    explicit MicroBatchQueue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+
+    bool push(std::vector<nlohmann::json>&& batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return aborted_ || batches_.size() < capacity_; });
+        if (aborted_) {
+            return false;
+        }
+        batches_.push(std::move(batch));
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool pop(std::vector<nlohmann::json>& batch) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return aborted_ || closed_ || !batches_.empty(); });
+        if (aborted_ || batches_.empty()) {
+            return false;
+        }
+        batch = std::move(batches_.front());
+        batches_.pop();
+        not_full_.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+    void abort() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        aborted_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::queue<std::vector<nlohmann::json>> batches_;
+    bool closed_ = false;
+    bool aborted_ = false;
+};
+
+} // namespace
 
 IngestionBatch StandardIngestionPipeline::process_batch(const std::vector<nlohmann::json>& raw_data) {
+    // The interface hands us a const reference: copy once, then move from there on
+    return process_batch(std::vector<nlohmann::json>(raw_data));
+}
+
+IngestionBatch StandardIngestionPipeline::process_batch(std::vector<nlohmann::json>&& raw_data) {
     IngestionBatch batch;
     batch.batch_id = generate_batch_id();
     batch.source_id = config_.source_id;
     batch.status = IngestionStatus::PROCESSING;
     batch.start_time = std::chrono::system_clock::now();
-    batch.raw_data = raw_data;
 
     try {
-        // Apply enabled pipeline stages
-        std::vector<nlohmann::json> processed_data = raw_data;
-
-        for (PipelineStage stage : enabled_stages_) {
-            switch (stage) {
-                case PipelineStage::VALIDATION:
-                    processed_data = validate_data(processed_data);
-                    break;
-                case PipelineStage::CLEANING:
-                    processed_data = clean_data(processed_data);
-                    break;
-                case PipelineStage::TRANSFORMATION:
-                    processed_data = transform_batch(processed_data);
-                    break;
-                case PipelineStage::ENRICHMENT:
-                    processed_data = enrich_data(processed_data);
-                    break;
-                case PipelineStage::QUALITY_CHECK:
-                    processed_data = check_quality(processed_data);
-                    break;
-                case PipelineStage::DUPLICATE_DETECTION:
-                    processed_data = detect_duplicates(processed_data);
-                    break;
-                case PipelineStage::COMPLIANCE_CHECK:
-                    processed_data = check_compliance(processed_data);
-                    break;
-                case PipelineStage::STORAGE_PREPARATION:
-                    // Final preparation for storage
-                    break;
-            }
-        }
-
-        batch.processed_data = processed_data;
+        // Apply enabled pipeline stages, in place
+        std::vector<nlohmann::json> processed_data = std::move(raw_data);
+        std::unordered_set<std::string> seen_duplicate_keys;
+
+        for (PipelineStage stage : ordered_stages()) {
+            run_stage(stage, processed_data, seen_duplicate_keys);
+        }
+
         batch.records_processed = processed_data.size();
         batch.records_succeeded = processed_data.size();
+        batch.processed_data = std::move(processed_data);
         batch.status = IngestionStatus::COMPLETED;
         batch.end_time = std::chrono::system_clock::now();
 
@@ -104,6 +152,110 @@ IngestionBatch StandardIngestionPipeline::process_batch(const std::vector<nlohma
     return batch;
 }
 
+IngestionBatch StandardIngestionPipeline::process_stream(
+    const std::function<bool(std::vector<nlohmann::json>&)>& next_micro_batch,
+    const std::function<void(std::vector<nlohmann::json>&&)>& sink) {
+
+    IngestionBatch batch;
+    batch.batch_id = generate_batch_id();
+    batch.source_id = config_.source_id;
+    batch.status = IngestionStatus::PROCESSING;
+    batch.start_time = std::chrono::system_clock::now();
+
+    std::vector<PipelineStage> stages = ordered_stages();
+
+    // queues[i] feeds stage i; the last queue feeds the sink
+    std::vector<std::unique_ptr<MicroBatchQueue>> queues;
+    for (size_t i = 0; i <= stages.size(); ++i) {
+        queues.push_back(std::make_unique<MicroBatchQueue>(pipeline_config_.stream_queue_depth));
+    }
+
+    std::mutex error_mutex;
+    std::vector<std::string> errors;
+    auto fail = [&](const std::string& error) {
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            errors.push_back(error);
+        }
+        for (auto& queue : queues) {
+            queue->abort();
+        }
+    };
+
+    // Only the duplicate detection stage thread touches this
+    std::unordered_set<std::string> seen_duplicate_keys;
+    std::atomic<int> records_in{0};
+    std::atomic<int> records_out{0};
+
+    std::vector<std::thread> threads;
+    threads.reserve(stages.size() + 1);
+    for (size_t i = 0; i < stages.size(); ++i) {
+        threads.emplace_back([&, i] {
+            std::vector<nlohmann::json> micro_batch;
+            try {
+                while (queues[i]->pop(micro_batch)) {
+                    run_stage(stages[i], micro_batch, seen_duplicate_keys);
+                    if (!queues[i + 1]->push(std::move(micro_batch))) {
+                        return;
+                    }
+                    micro_batch = {};
+                }
+                queues[i + 1]->close();
+            } catch (const std::exception& e) {
+                fail(std::string(e.what()));
+            }
+        });
+    }
+
+    threads.emplace_back([&] {
+        std::vector<nlohmann::json> micro_batch;
+        try {
+            while (queues.back()->pop(micro_batch)) {
+                records_out += static_cast<int>(micro_batch.size());
+                sink(std::move(micro_batch));
+                micro_batch = {};
+            }
+        } catch (const std::exception& e) {
+            fail("Stream sink failed: " + std::string(e.what()));
+        }
+    });
+
+    // The calling thread produces
+    try {
+        std::vector<nlohmann::json> micro_batch;
+        while (next_micro_batch(micro_batch)) {
+            if (micro_batch.empty()) {
+                continue;
+            }
+            records_in += static_cast<int>(micro_batch.size());
+            if (!queues.front()->push(std::move(micro_batch))) {
+                break;
+            }
+            micro_batch = {};
+        }
+        queues.front()->close();
+    } catch (const std::exception& e) {
+        fail("Stream source failed: " + std::string(e.what()));
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    batch.records_processed = records_in.load();
+    batch.records_succeeded = records_out.load();
+    batch.records_failed = records_in.load() - records_out.load();
+    batch.errors = std::move(errors);
+    batch.status = batch.errors.empty() ? IngestionStatus::COMPLETED : IngestionStatus::FAILED;
+    batch.end_time = std::chrono::system_clock::now();
+
+    logger_->log(LogLevel::INFO, "Stream processing complete: " + std::to_string(batch.records_succeeded) +
+                "/" + std::to_string(batch.records_processed) + " records through " +
+                std::to_string(stages.size()) + " stages");
+
+    return batch;
+}
+
 bool StandardIngestionPipeline::validate_batch(const IngestionBatch& batch) {
     // Production-grade batch validation
     
@@ -202,6 +354,18 @@ void StandardIngestionPipeline::set_pipeline_config(const PipelineConfig& config
     for (auto stage : config.enabled_stages) {
         enabled_stages_.insert(stage);
     }
+
+    // Rebuilt from the new settings on next use
+    {
+        std::lock_guard<std::mutex> lock(stage_pools_mutex_);
+        stage_pools_.clear();
+    }
+    std::lock_guard<std::mutex> lock(duplicate_filter_mutex_);
+    duplicate_filter_.reset();
+}
+
+void StandardIngestionPipeline::set_storage(std::shared_ptr<ConnectionPool> storage) {
+    storage_ = std::move(storage);
 }
 
 bool StandardIngestionPipeline::enable_stage(PipelineStage stage) {
@@ -218,264 +382,378 @@ std::vector<PipelineStage> StandardIngestionPipeline::get_enabled_stages() const
     return std::vector<PipelineStage>(enabled_stages_.begin(), enabled_stages_.end());
 }
 
-// Processing methods - production implementations
-std::vector<nlohmann::json> StandardIngestionPipeline::validate_data(const std::vector<nlohmann::json>& data) {
-    std::vector<nlohmann::json> valid_data;
-    
-    for (const auto& item : data) {
-        bool is_valid = true;
-        
-        // Apply all configured validation rules
-        for (const auto& rule : pipeline_config_.validation_rules) {
-            bool rule_passed = true;
-            
-            switch (rule.rule_type) {
-                case ValidationRule::REQUIRED_FIELDS:
-                    rule_passed = validate_required_fields(item, rule);
-                    break;
-                case ValidationRule::DATA_TYPE_CHECK:
-                    rule_passed = validate_data_types(item, rule);
-                    break;
-                case ValidationRule::RANGE_CHECK:
-                    rule_passed = validate_ranges(item, rule);
-                    break;
-                case ValidationRule::FORMAT_VALIDATION:
-                    rule_passed = validate_formats(item, rule);
-                    break;
-                case ValidationRule::REFERENCE_INTEGRITY:
-                    rule_passed = validate_references(item, rule);
-                    break;
-                case ValidationRule::BUSINESS_RULES:
-                    rule_passed = validate_business_rules(item, rule);
-                    break;
-            }
-            
-            if (!rule_passed && rule.fail_on_error) {
-                is_valid = false;
-                logger_->log(LogLevel::ERROR, "Validation failed for rule: " + rule.rule_name);
-                break;
-            }
-        }
-        
-        // If no validation rules are configured, perform basic validation
-        if (pipeline_config_.validation_rules.empty()) {
-            // Basic validation: check if data is not null and has some content
-            if (item.is_null() || (item.is_object() && item.empty())) {
-                is_valid = false;
-                logger_->log(LogLevel::WARN, "Data item is null or empty");
-            }
-        }
-        
-        if (is_valid) {
-            valid_data.push_back(item);
-        } else {
-            failed_records_++;
+// Stage execution
+std::vector<PipelineStage> StandardIngestionPipeline::ordered_stages() const {
+    // Stages always run in declaration order, whatever order they were enabled in
+    static const PipelineStage stage_order[] = {
+        PipelineStage::VALIDATION,
+        PipelineStage::CLEANING,
+        PipelineStage::TRANSFORMATION,
+        PipelineStage::ENRICHMENT,
+        PipelineStage::QUALITY_CHECK,
+        PipelineStage::DUPLICATE_DETECTION,
+        PipelineStage::COMPLIANCE_CHECK
+    };
+
+    std::vector<PipelineStage> stages;
+    for (PipelineStage stage : stage_order) {
+        if (enabled_stages_.count(stage) > 0) {
+            stages.push_back(stage);
         }
     }
-    
-    logger_->log(LogLevel::INFO, "Validation complete: " + std::to_string(valid_data.size()) + 
-                "/" + std::to_string(data.size()) + " records passed");
-    
-    return valid_data;
+    return stages;
 }
 
-std::vector<nlohmann::json> StandardIngestionPipeline::clean_data(const std::vector<nlohmann::json>& data) {
-    // Production-grade comprehensive data cleaning
-    std::vector<nlohmann::json> cleaned_data;
-    
-    for (const auto& item : data) {
-        nlohmann::json cleaned = item;
-        
-        // Process all string fields for comprehensive cleaning
-        for (auto it = cleaned.begin(); it != cleaned.end(); ++it) {
-            if (it->is_string()) {
-                std::string value = it.value().get<std::string>();
-                std::string cleaned_value = value;
-                
-                // Trim leading and trailing whitespace
-                size_t start = cleaned_value.find_first_not_of(" \t\n\r\f\v");
-                size_t end = cleaned_value.find_last_not_of(" \t\n\r\f\v");
-                if (start == std::string::npos) {
-                    cleaned_value = "";
-                } else {
-                    cleaned_value = cleaned_value.substr(start, end - start + 1);
-                }
-                
-                // Remove control characters (ASCII 0-31 except common whitespace)
-                std::string temp;
-                for (char c : cleaned_value) {
-                    unsigned char uc = static_cast<unsigned char>(c);
-                    // Keep printable characters and common whitespace (tab, newline, carriage return)
-                    if (uc >= 32 || c == '\t' || c == '\n' || c == '\r') {
-                        temp += c;
-                    }
-                }
-                cleaned_value = temp;
-                
-                // Normalize line endings to \n
-                size_t pos = 0;
-                while ((pos = cleaned_value.find("\r\n", pos)) != std::string::npos) {
-                    cleaned_value.replace(pos, 2, "\n");
-                    pos += 1;
-                }
-                pos = 0;
-                while ((pos = cleaned_value.find("\r", pos)) != std::string::npos) {
-                    cleaned_value.replace(pos, 1, "\n");
-                    pos += 1;
-                }
-                
-                // Collapse multiple spaces to single space
-                pos = 0;
-                while ((pos = cleaned_value.find("  ", pos)) != std::string::npos) {
-                    cleaned_value.replace(pos, 2, " ");
-                }
-                
-                // Remove null bytes
-                cleaned_value.erase(std::remove(cleaned_value.begin(), cleaned_value.end(), '\0'), 
-                                  cleaned_value.end());
-                
-                // Update the value if it changed
-                if (cleaned_value != value) {
-                    *it = cleaned_value;
-                    logger_->log(LogLevel::DEBUG, "Cleaned field '" + it.key() + "'");
-                }
-                
-                // If value is now empty after cleaning, consider removing or marking as null
-                if (cleaned_value.empty() && !value.empty()) {
-                    logger_->log(LogLevel::DEBUG, "Field '" + it.key() + "' became empty after cleaning");
-                }
-            }
-            else if (it->is_number()) {
-                // Validate numeric values for NaN, infinity
-                if (it->is_number_float()) {
-                    double val = it.value().get<double>();
-                    if (std::isnan(val)) {
-                        *it = nullptr;
-                        logger_->log(LogLevel::WARN, "Field '" + it.key() + "' contained NaN, set to null");
-                    } else if (std::isinf(val)) {
-                        *it = nullptr;
-                        logger_->log(LogLevel::WARN, "Field '" + it.key() + "' contained infinity, set to null");
-                    }
-                }
+void StandardIngestionPipeline::run_stage(PipelineStage stage, std::vector<nlohmann::json>& data,
+                                          std::unordered_set<std::string>& seen_duplicate_keys) {
+    auto start = std::chrono::steady_clock::now();
+    size_t records_in = data.size();
+
+    if (stage == PipelineStage::DUPLICATE_DETECTION) {
+        // Order-dependent (first occurrence wins), so it stays sequential
+        detect_duplicates(data, seen_duplicate_keys);
+    } else {
+        batch_process_stage(stage, data);
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    record_stage_metrics(stage, duration, static_cast<int>(records_in));
+}
+
+bool StandardIngestionPipeline::process_record(PipelineStage stage, nlohmann::json& record) {
+    switch (stage) {
+        case PipelineStage::VALIDATION:
+            return validate_record(record);
+        case PipelineStage::CLEANING:
+            clean_record(record);
+            return true;
+        case PipelineStage::TRANSFORMATION:
+            record["processed_at"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            return true;
+        case PipelineStage::ENRICHMENT:
+            enrich_record(record);
+            return true;
+        case PipelineStage::QUALITY_CHECK:
+            record["quality_score"] = calculate_data_quality_score(record);
+            return true;
+        case PipelineStage::COMPLIANCE_CHECK:
+            if (!check_compliance_rules(record, pipeline_config_.compliance_rules)) {
+                return false;
             }
-            else if (it->is_object() || it->is_array()) {
-                // Recursively clean nested structures
-                if (it->is_object() && it->empty()) {
-                    logger_->log(LogLevel::DEBUG, "Field '" + it.key() + "' is empty object");
-                } else if (it->is_array() && it->empty()) {
-                    logger_->log(LogLevel::DEBUG, "Field '" + it.key() + "' is empty array");
-                }
+            record["compliance_checked"] = true;
+            return true;
+        case PipelineStage::DUPLICATE_DETECTION:
+        case PipelineStage::STORAGE_PREPARATION:
+            return true;
+    }
+    return true;
+}
+
+size_t StandardIngestionPipeline::worker_thread_count() const {
+    if (pipeline_config_.worker_threads > 0) {
+        return static_cast<size_t>(pipeline_config_.worker_threads);
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::shared_ptr<StageWorkerPool> StandardIngestionPipeline::stage_pool(PipelineStage stage) {
+    std::lock_guard<std::mutex> lock(stage_pools_mutex_);
+    auto& pool = stage_pools_[stage];
+    if (!pool) {
+        // The thread running the stage works too
+        pool = std::make_shared<StageWorkerPool>(worker_thread_count() - 1);
+    }
+    return pool;
+}
+
+// Processing methods - production implementations
+void StandardIngestionPipeline::validate_data(std::vector<nlohmann::json>& data) {
+    size_t records_in = data.size();
+    batch_process_stage(PipelineStage::VALIDATION, data);
+
+    logger_->log(LogLevel::INFO, "Validation complete: " + std::to_string(data.size()) + 
+                "/" + std::to_string(records_in) + " records passed");
+}
+
+void StandardIngestionPipeline::clean_data(std::vector<nlohmann::json>& data) {
+    batch_process_stage(PipelineStage::CLEANING, data);
+    logger_->log(LogLevel::INFO, "Data cleaning complete: " + std::to_string(data.size()) + " records cleaned");
+}
+
+void StandardIngestionPipeline::transform_batch(std::vector<nlohmann::json>& data) {
+    batch_process_stage(PipelineStage::TRANSFORMATION, data);
+}
+
+void StandardIngestionPipeline::enrich_data(std::vector<nlohmann::json>& data) {
+    batch_process_stage(PipelineStage::ENRICHMENT, data);
+    logger_->log(LogLevel::INFO, "Enrichment complete: " + std::to_string(data.size()) + " records enriched");
+}
+
+void StandardIngestionPipeline::check_quality(std::vector<nlohmann::json>& data) {
+    batch_process_stage(PipelineStage::QUALITY_CHECK, data);
+}
+
+void StandardIngestionPipeline::detect_duplicates(std::vector<nlohmann::json>& data) {
+    std::unordered_set<std::string> seen_keys;
+    detect_duplicates(data, seen_keys);
+}
+
+void StandardIngestionPipeline::detect_duplicates(std::vector<nlohmann::json>& data,
+                                                  std::unordered_set<std::string>& seen_keys) {
+    // Within the batch (or stream): first occurrence wins
+    std::vector<std::string> keys;
+    keys.reserve(data.size());
+    size_t kept = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        std::string key = generate_duplicate_key(data[i], pipeline_config_.duplicate_key_fields);
+        if (seen_keys.insert(key).second) {
+            if (kept != i) {
+                data[kept] = std::move(data[i]);
             }
+            keys.push_back(std::move(key));
+            ++kept;
         }
-        
-        // Production: Configurable null handling - keep nulls with logging for audit trail
-        int null_count = 0;
-        for (auto it = cleaned.begin(); it != cleaned.end(); ++it) {
-            if (it->is_null()) {
-                null_count++;
-            }
+    }
+    data.resize(kept);
+
+    // Against earlier batches: the filter rules out most keys, the rest are confirmed in one lookup
+    DuplicateKeyFilter* filter = duplicate_filter();
+    if (!filter || data.empty()) {
+        return;
+    }
+
+    std::vector<std::string> probable;
+    for (const auto& key : keys) {
+        if (filter->might_contain(key)) {
+            probable.push_back(key);
+        }
+    }
+    duplicate_filter_negatives_ += keys.size() - probable.size();
+
+    std::unordered_set<std::string> confirmed;
+    if (!probable.empty()) {
+        confirmed = confirm_processed_keys(probable);
+    }
+
+    kept = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (confirmed.count(keys[i]) > 0) {
+            continue;
         }
-        if (null_count > 0) {
-            logger_->log(LogLevel::DEBUG, "Data item has " + std::to_string(null_count) + " null fields");
+        if (kept != i) {
+            data[kept] = std::move(data[i]);
         }
-        
-        cleaned_data.push_back(cleaned);
+        ++kept;
     }
-    
-    logger_->log(LogLevel::INFO, "Data cleaning complete: " + std::to_string(cleaned_data.size()) + " records cleaned");
-    return cleaned_data;
+    data.resize(kept);
+
+    if (!confirmed.empty()) {
+        logger_->log(LogLevel::INFO, "Dropped " + std::to_string(confirmed.size()) +
+                    " records already processed in earlier batches");
+    }
+
+    // Surviving keys are recorded by on_records_stored(): a record that compliance
+    // rejects or storage fails to write must not block its retry
 }
 
-std::vector<nlohmann::json> StandardIngestionPipeline::transform_batch(const std::vector<nlohmann::json>& data) {
-    std::vector<nlohmann::json> transformed_data;
-    for (const auto& item : data) {
-        transformed_data.push_back(transform_data(item));
+void StandardIngestionPipeline::on_records_stored(const std::vector<nlohmann::json>& records) {
+    if (enabled_stages_.count(PipelineStage::DUPLICATE_DETECTION) == 0 || records.empty()) {
+        return;
+    }
+
+    std::vector<std::string> keys;
+    keys.reserve(records.size());
+    for (const auto& record : records) {
+        keys.push_back(generate_duplicate_key(record, pipeline_config_.duplicate_key_fields));
     }
-    return transformed_data;
+    mark_as_processed(keys);
+}
+
+void StandardIngestionPipeline::check_compliance(std::vector<nlohmann::json>& data) {
+    batch_process_stage(PipelineStage::COMPLIANCE_CHECK, data);
 }
 
-std::vector<nlohmann::json> StandardIngestionPipeline::enrich_data(const std::vector<nlohmann::json>& data) {
-    std::vector<nlohmann::json> enriched_data;
+bool StandardIngestionPipeline::validate_record(const nlohmann::json& item) {
+    bool is_valid = true;
     
-    for (const auto& item : data) {
-        nlohmann::json enriched = item;
-        bool was_enriched = false;
+    // Apply all configured validation rules
+    for (const auto& rule : pipeline_config_.validation_rules) {
+        bool rule_passed = true;
         
-        // Apply all configured enrichment rules
-        for (const auto& rule : pipeline_config_.enrichment_rules) {
-            try {
-                nlohmann::json result;
-                
-                if (rule.source_type == "lookup_table") {
-                    result = enrich_from_lookup_table(enriched, rule);
-                } else if (rule.source_type == "api_call") {
-                    result = enrich_from_api_call(enriched, rule);
-                } else if (rule.source_type == "calculation") {
-                    result = enrich_from_calculation(enriched, rule);
-                } else {
-                    logger_->log(LogLevel::WARN, "Unknown enrichment source type: " + rule.source_type);
-                    continue;
-                }
-                
-                // Update enriched with the result
-                enriched = result;
-                was_enriched = true;
-                
-            } catch (const std::exception& e) {
-                logger_->log(LogLevel::ERROR, "Enrichment error for rule '" + rule.rule_name + 
-                            "': " + e.what());
-            }
+        switch (rule.rule_type) {
+            case ValidationRule::REQUIRED_FIELDS:
+                rule_passed = validate_required_fields(item, rule);
+                break;
+            case ValidationRule::DATA_TYPE_CHECK:
+                rule_passed = validate_data_types(item, rule);
+                break;
+            case ValidationRule::RANGE_CHECK:
+                rule_passed = validate_ranges(item, rule);
+                break;
+            case ValidationRule::FORMAT_VALIDATION:
+                rule_passed = validate_formats(item, rule);
+                break;
+            case ValidationRule::REFERENCE_INTEGRITY:
+                rule_passed = validate_references(item, rule);
+                break;
+            case ValidationRule::BUSINESS_RULES:
+                rule_passed = validate_business_rules(item, rule);
+                break;
         }
         
-        // Add enrichment metadata
-        if (was_enriched) {
-            enriched["_enriched"] = true;
-            enriched["_enrichment_timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()).count();
+        if (!rule_passed && rule.fail_on_error) {
+            is_valid = false;
+            logger_->log(LogLevel::ERROR, "Validation failed for rule: " + rule.rule_name);
+            break;
         }
-        
-        enriched_data.push_back(enriched);
     }
     
-    logger_->log(LogLevel::INFO, "Enrichment complete: " + std::to_string(enriched_data.size()) + " records enriched");
-    return enriched_data;
-}
-
-std::vector<nlohmann::json> StandardIngestionPipeline::check_quality(const std::vector<nlohmann::json>& data) {
-    std::vector<nlohmann::json> quality_data;
-    for (const auto& item : data) {
-        nlohmann::json quality_checked = item;
-        quality_checked["quality_score"] = calculate_data_quality_score(item);
-        quality_data.push_back(quality_checked);
+    // If no validation rules are configured, perform basic validation
+    if (pipeline_config_.validation_rules.empty()) {
+        // Basic validation: check if data is not null and has some content
+        if (item.is_null() || (item.is_object() && item.empty())) {
+            is_valid = false;
+            logger_->log(LogLevel::WARN, "Data item is null or empty");
+        }
     }
-    return quality_data;
+    
+    if (!is_valid) {
+        failed_records_++;
+    }
+    return is_valid;
 }
 
-std::vector<nlohmann::json> StandardIngestionPipeline::detect_duplicates(const std::vector<nlohmann::json>& data) {
-    std::vector<nlohmann::json> unique_data;
-    std::unordered_set<std::string> seen_keys;
-
-    for (const auto& item : data) {
-        std::string key = generate_duplicate_key(item, pipeline_config_.duplicate_key_fields);
-        if (seen_keys.find(key) == seen_keys.end()) {
-            seen_keys.insert(key);
-            unique_data.push_back(item);
+void StandardIngestionPipeline::clean_record(nlohmann::json& cleaned) {
+    // Process all string fields for comprehensive cleaning
+    for (auto it = cleaned.begin(); it != cleaned.end(); ++it) {
+        if (it->is_string()) {
+            std::string value = it.value().get<std::string>();
+            std::string cleaned_value = value;
+            
+            // Trim leading and trailing whitespace
+            size_t start = cleaned_value.find_first_not_of(" \t\n\r\f\v");
+            size_t end = cleaned_value.find_last_not_of(" \t\n\r\f\v");
+            if (start == std::string::npos) {
+                cleaned_value = "";
+            } else {
+                cleaned_value = cleaned_value.substr(start, end - start + 1);
+            }
+            
+            // Remove control characters (ASCII 0-31 except common whitespace)
+            std::string temp;
+            for (char c : cleaned_value) {
+                unsigned char uc = static_cast<unsigned char>(c);
+                // Keep printable characters and common whitespace (tab, newline, carriage return)
+                if (uc >= 32 || c == '\t' || c == '\n' || c == '\r') {
+                    temp += c;
+                }
+            }
+            cleaned_value = temp;
+            
+            // Normalize line endings to \n
+            size_t pos = 0;
+            while ((pos = cleaned_value.find("\r\n", pos)) != std::string::npos) {
+                cleaned_value.replace(pos, 2, "\n");
+                pos += 1;
+            }
+            pos = 0;
+            while ((pos = cleaned_value.find("\r", pos)) != std::string::npos) {
+                cleaned_value.replace(pos, 1, "\n");
+                pos += 1;
+            }
+            
+            // Collapse multiple spaces to single space
+            pos = 0;
+            while ((pos = cleaned_value.find("  ", pos)) != std::string::npos) {
+                cleaned_value.replace(pos, 2, " ");
+            }
+            
+            // Remove null bytes
+            cleaned_value.erase(std::remove(cleaned_value.begin(), cleaned_value.end(), '\0'), 
+                              cleaned_value.end());
+            
+            // Update the value if it changed
+            if (cleaned_value != value) {
+                *it = cleaned_value;
+                logger_->log(LogLevel::DEBUG, "Cleaned field '" + it.key() + "'");
+            }
+            
+            // If value is now empty after cleaning, consider removing or marking as null
+            if (cleaned_value.empty() && !value.empty()) {
+                logger_->log(LogLevel::DEBUG, "Field '" + it.key() + "' became empty after cleaning");
+            }
+        }
+        else if (it->is_number()) {
+            // Validate numeric values for NaN, infinity
+            if (it->is_number_float()) {
+                double val = it.value().get<double>();
+                if (std::isnan(val)) {
+                    *it = nullptr;
+                    logger_->log(LogLevel::WARN, "Field '" + it.key() + "' contained NaN, set to null");
+                } else if (std::isinf(val)) {
+                    *it = nullptr;
+                    logger_->log(LogLevel::WARN, "Field '" + it.key() + "' contained infinity, set to null");
+                }
+            }
+        }
+        else if (it->is_object() || it->is_array()) {
+            // Recursively clean nested structures
+            if (it->is_object() && it->empty()) {
+                logger_->log(LogLevel::DEBUG, "Field '" + it.key() + "' is empty object");
+            } else if (it->is_array() && it->empty()) {
+                logger_->log(LogLevel::DEBUG, "Field '" + it.key() + "' is empty array");
+            }
         }
     }
-
-    return unique_data;
+    
+    // Production: Configurable null handling - keep nulls with logging for audit trail
+    int null_count = 0;
+    for (auto it = cleaned.begin(); it != cleaned.end(); ++it) {
+        if (it->is_null()) {
+            null_count++;
+        }
+    }
+    if (null_count > 0) {
+        logger_->log(LogLevel::DEBUG, "Data item has " + std::to_string(null_count) + " null fields");
+    }
 }
 
-std::vector<nlohmann::json> StandardIngestionPipeline::check_compliance(const std::vector<nlohmann::json>& data) {
-    std::vector<nlohmann::json> compliant_data;
-    for (const auto& item : data) {
-        if (check_compliance_rules(item, pipeline_config_.compliance_rules)) {
-            nlohmann::json compliant = item;
-            compliant["compliance_checked"] = true;
-            compliant_data.push_back(compliant);
+void StandardIngestionPipeline::enrich_record(nlohmann::json& enriched) {
+    bool was_enriched = false;
+    
+    // Apply all configured enrichment rules
+    for (const auto& rule : pipeline_config_.enrichment_rules) {
+        try {
+            nlohmann::json result;
+            
+            if (rule.source_type == "lookup_table") {
+                result = enrich_from_lookup_table(enriched, rule);
+            } else if (rule.source_type == "api_call") {
+                result = enrich_from_api_call(enriched, rule);
+            } else if (rule.source_type == "calculation") {
+                result = enrich_from_calculation(enriched, rule);
+            } else {
+                logger_->log(LogLevel::WARN, "Unknown enrichment source type: " + rule.source_type);
+                continue;
+            }
+            
+            // Update enriched with the result
+            enriched = std::move(result);
+            was_enriched = true;
+            
+        } catch (const std::exception& e) {
+            logger_->log(LogLevel::ERROR, "Enrichment error for rule '" + rule.rule_name + 
+                        "': " + e.what());
         }
     }
-    return compliant_data;
+    
+    // Add enrichment metadata
+    if (was_enriched) {
+        enriched["_enriched"] = true;
+        enriched["_enrichment_timestamp"] = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
 }
 
 // Private methods
@@ -2039,9 +2317,19 @@ std::string StandardIngestionPipeline::generate_duplicate_key(const nlohmann::js
                 field_value.erase(0, field_value.find_first_not_of(" \t\n\r"));
                 field_value.erase(field_value.find_last_not_of(" \t\n\r") + 1);
                 
-                // Remove common variations (for fuzzy matching)
-                std::regex spaces_regex("\\s+");
-                field_value = std::regex_replace(field_value, spaces_regex, " ");
+                // Remove common variations (for fuzzy matching): collapse whitespace runs
+                std::string collapsed;
+                collapsed.reserve(field_value.size());
+                for (char c : field_value) {
+                    if (std::isspace(static_cast<unsigned char>(c))) {
+                        if (collapsed.empty() || collapsed.back() != ' ') {
+                            collapsed += ' ';
+                        }
+                    } else {
+                        collapsed += c;
+                    }
+                }
+                field_value = std::move(collapsed);
             }
             else {
                 field_value = data[field].dump();
@@ -2069,61 +2357,158 @@ std::string StandardIngestionPipeline::generate_duplicate_key(const nlohmann::js
     return std::to_string(hasher(composite));
 }
 
-bool StandardIngestionPipeline::is_duplicate(const std::string& duplicate_key) {
-    // Check exact match in processed keys
-    if (processed_duplicate_keys_.find(duplicate_key) != processed_duplicate_keys_.end()) {
-        return true;
+namespace {
+
+// Returns a pooled connection on every path out of the scope, exceptions included
+class PooledConnection {
+public:
+    explicit PooledConnection(const std::shared_ptr<ConnectionPool>& pool)
+        : pool_(pool), conn_(pool->get_connection()) {}
+    ~PooledConnection() {
+        if (conn_) {
+            pool_->return_connection(std::move(conn_));
+        }
     }
-    
-    // For production: also check database for historical duplicates
-    // This ensures duplicate detection across batch processing sessions
-    if (storage_) {
-        try {
-            auto* pool = static_cast<ConnectionPool*>(storage_.get());
-            auto conn = pool->get_connection();
-            
-            if (conn && conn->is_connected()) {
-                std::string query = "SELECT EXISTS(SELECT 1 FROM processed_records WHERE record_hash = $1 LIMIT 1)";
-                auto result = conn->execute_query_single(query, {duplicate_key});
-                pool->return_connection(conn);
-                
-                if (result.has_value() && result.value().contains("exists")) {
-                    return result.value()["exists"].get<bool>();
+    PooledConnection(const PooledConnection&) = delete;
+    PooledConnection& operator=(const PooledConnection&) = delete;
+
+    PostgreSQLConnection* operator->() const { return conn_.get(); }
+    bool usable() const { return conn_ && conn_->is_connected(); }
+
+private:
+    std::shared_ptr<ConnectionPool> pool_;
+    std::shared_ptr<PostgreSQLConnection> conn_;
+};
+
+// Slack when warming from processed_records after a snapshot, covering
+// clock differences between this host and the database
+constexpr int64_t DUPLICATE_WARM_OVERLAP_SECONDS = 300;
+
+} // namespace
+
+DuplicateKeyFilter* StandardIngestionPipeline::duplicate_filter() {
+    // Without a database there is nothing to confirm probable hits against
+    if (!storage_) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(duplicate_filter_mutex_);
+    if (duplicate_filter_) {
+        return duplicate_filter_.get();
+    }
+
+    duplicate_filter_ = std::make_unique<DuplicateKeyFilter>(pipeline_config_.duplicate_filter);
+
+    // A saved filter only lacks the keys processed after it was written (by
+    // this process before it stopped, or by others); without one, warm from
+    // the whole retention window of processed_records
+    std::string error;
+    std::string query;
+    std::vector<std::string> params;
+    if (!pipeline_config_.duplicate_filter.persistence_path.empty() && duplicate_filter_->load(error)) {
+        logger_->log(LogLevel::INFO, "Loaded duplicate filter with " +
+                    std::to_string(duplicate_filter_->size()) + " keys");
+        query = "SELECT record_hash FROM processed_records WHERE processed_at > to_timestamp($1)";
+        params.push_back(std::to_string(duplicate_filter_->loaded_snapshot_time() - DUPLICATE_WARM_OVERLAP_SECONDS));
+    } else {
+        query = "SELECT record_hash FROM processed_records "
+                "WHERE processed_at >= NOW() - ($1 || ' hours')::interval";
+        params.push_back(std::to_string(pipeline_config_.duplicate_filter.retention.count()));
+    }
+
+    try {
+        PooledConnection conn(storage_);
+        if (conn.usable()) {
+            auto rows = conn->execute_query_multi(query, params);
+            for (const auto& row : rows) {
+                if (row.contains("record_hash") && row["record_hash"].is_string()) {
+                    duplicate_filter_->insert(row["record_hash"].get<std::string>());
                 }
-            } else {
-                if (conn) pool->return_connection(conn);
             }
+            logger_->log(LogLevel::INFO, "Warmed duplicate filter with " + std::to_string(rows.size()) +
+                        " keys from processed_records");
         }
-        catch (const std::exception& e) {
-            logger_->log(LogLevel::WARN, "is_duplicate: Database check failed, using in-memory only: " + 
-                        std::string(e.what()));
+    } catch (const std::exception& e) {
+        logger_->log(LogLevel::WARN, "Failed to warm duplicate filter: " + std::string(e.what()));
+    }
+
+    return duplicate_filter_.get();
+}
+
+static std::string to_pg_text_array(const std::vector<std::string>& values) {
+    std::string literal = "{";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) {
+            literal += ',';
+        }
+        literal += '"';
+        for (char c : values[i]) {
+            if (c == '"' || c == '\\') {
+                literal += '\\';
+            }
+            literal += c;
         }
+        literal += '"';
     }
-    
-    return false;
+    literal += '}';
+    return literal;
 }
 
-void StandardIngestionPipeline::mark_as_processed(const std::string& duplicate_key) {
-    // Add to in-memory cache for fast lookup
-    processed_duplicate_keys_.insert(duplicate_key);
-    
-    // Persist to database for long-term duplicate prevention
+std::unordered_set<std::string> StandardIngestionPipeline::confirm_processed_keys(const std::vector<std::string>& candidate_keys) {
+    std::unordered_set<std::string> confirmed;
+    duplicate_confirm_lookups_++;
+
+    try {
+        PooledConnection conn(storage_);
+        if (conn.usable()) {
+            auto rows = conn->execute_query_multi(
+                "SELECT record_hash FROM processed_records WHERE record_hash = ANY($1::varchar[])",
+                {to_pg_text_array(candidate_keys)});
+
+            for (const auto& row : rows) {
+                if (row.contains("record_hash") && row["record_hash"].is_string()) {
+                    confirmed.insert(row["record_hash"].get<std::string>());
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        // Unconfirmed keys are treated as new rather than silently dropping records
+        logger_->log(LogLevel::WARN, "Duplicate confirmation failed, keeping " +
+                    std::to_string(candidate_keys.size()) + " probable duplicates: " + std::string(e.what()));
+    }
+
+    duplicates_confirmed_ += confirmed.size();
+    return confirmed;
+}
+
+void StandardIngestionPipeline::mark_as_processed(const std::vector<std::string>& duplicate_keys) {
+    if (duplicate_keys.empty()) {
+        return;
+    }
+
+    DuplicateKeyFilter* filter = duplicate_filter();
+    if (filter) {
+        for (const auto& key : duplicate_keys) {
+            filter->insert(key);
+        }
+        std::string error;
+        if (!filter->save_if_due(error)) {
+            logger_->log(LogLevel::WARN, "Failed to save duplicate filter: " + error);
+        }
+    }
+
+    // Persist to database for long-term duplicate prevention, one statement per batch
     if (storage_) {
         try {
-            auto* pool = static_cast<ConnectionPool*>(storage_.get());
-            auto conn = pool->get_connection();
-            
-            if (conn && conn->is_connected()) {
+            PooledConnection conn(storage_);
+            if (conn.usable()) {
                 std::string insert_query = R"(
                     INSERT INTO processed_records (record_hash, processed_at, pipeline_id)
-                    VALUES ($1, NOW(), $2)
+                    SELECT key, NOW(), $2 FROM unnest($1::varchar[]) AS key
                     ON CONFLICT (record_hash) DO UPDATE SET processed_at = NOW()
                 )";
-                
-                conn->execute_query(insert_query, {duplicate_key, config_.source_id});
-                pool->return_connection(conn);
-            } else {
-                if (conn) pool->return_connection(conn);
+
+                conn->execute_command(insert_query, {to_pg_text_array(duplicate_keys), config_.source_id});
             }
         }
         catch (const std::exception& e) {
@@ -2131,73 +2516,79 @@ void StandardIngestionPipeline::mark_as_processed(const std::string& duplicate_k
                         std::string(e.what()));
         }
     }
-    
+
+    if (enable_fuzzy_matching_ && storage_) {
+        for (const auto& key : duplicate_keys) {
+            store_fuzzy_signature(key);
+        }
+    }
+}
+
+void StandardIngestionPipeline::store_fuzzy_signature(const std::string& duplicate_key) {
     // Production-grade similarity-based duplicate detection using MinHash for fuzzy matching
     // MinHash enables efficient near-duplicate detection with Jaccard similarity estimation
-    if (enable_fuzzy_matching_ && storage_) {
-        try {
-            // Tokenize and normalize the duplicate_key for MinHash computation
-            // Split on common delimiters and normalize to lowercase for consistent hashing
-            std::vector<std::string> normalized_keys;
-            std::string current_token;
-            for (char c : duplicate_key) {
-                if (std::isalnum(c)) {
-                    current_token += std::tolower(c);
-                } else if (!current_token.empty()) {
-                    normalized_keys.push_back(current_token);
-                    current_token.clear();
-                }
-            }
-            if (!current_token.empty()) {
+    try {
+        // Tokenize and normalize the duplicate_key for MinHash computation
+        // Split on common delimiters and normalize to lowercase for consistent hashing
+        std::vector<std::string> normalized_keys;
+        std::string current_token;
+        for (char c : duplicate_key) {
+            if (std::isalnum(c)) {
+                current_token += std::tolower(c);
+            } else if (!current_token.empty()) {
                 normalized_keys.push_back(current_token);
+                current_token.clear();
             }
+        }
+        if (!current_token.empty()) {
+            normalized_keys.push_back(current_token);
+        }
+        
+        // Compute MinHash signature for efficient similarity detection
+        std::vector<size_t> minhash_signature;
+        const int num_hash_functions = 128; // Standard MinHash signature size
+        
+        // Generate MinHash signature from normalized token set
+        for (int i = 0; i < num_hash_functions; ++i) {
+            size_t min_hash = std::numeric_limits<size_t>::max();
             
-            // Compute MinHash signature for efficient similarity detection
-            std::vector<size_t> minhash_signature;
-            const int num_hash_functions = 128; // Standard MinHash signature size
+            for (const auto& token : normalized_keys) {
+                // Hash each token with function index i for MinHash computation
+                std::hash<std::string> hasher;
+                size_t hash_value = hasher(token + std::to_string(i));
+                min_hash = std::min(min_hash, hash_value);
+            }
             
-            // Generate MinHash signature from normalized token set
-            for (int i = 0; i < num_hash_functions; ++i) {
-                size_t min_hash = std::numeric_limits<size_t>::max();
-                
-                for (const auto& token : normalized_keys) {
-                    // Hash each token with function index i for MinHash computation
-                    std::hash<std::string> hasher;
-                    size_t hash_value = hasher(token + std::to_string(i));
-                    min_hash = std::min(min_hash, hash_value);
-                }
-                
-                minhash_signature.push_back(min_hash);
+            minhash_signature.push_back(min_hash);
+        }
+        
+        // Store MinHash signature in database for future fuzzy match queries
+        auto* pool = static_cast<ConnectionPool*>(storage_.get());
+        auto conn = pool->get_connection();
+        
+        if (conn && conn->is_connected()) {
+            // Serialize MinHash signature to JSON array
+            nlohmann::json signature_array = nlohmann::json::array();
+            for (size_t hash_val : minhash_signature) {
+                signature_array.push_back(hash_val);
             }
             
-            // Store MinHash signature in database for future fuzzy match queries
-            auto* pool = static_cast<ConnectionPool*>(storage_.get());
-            auto conn = pool->get_connection();
+            // Persist MinHash signature for near-duplicate detection queries
+            std::string insert_query = R"(
+                INSERT INTO fuzzy_match_cache (record_hash, minhash_signature, created_at)
+                VALUES ($1, $2, NOW())
+                ON CONFLICT (record_hash) DO UPDATE SET minhash_signature = $2, created_at = NOW()
+            )";
             
-            if (conn && conn->is_connected()) {
-                // Serialize MinHash signature to JSON array
-                nlohmann::json signature_array = nlohmann::json::array();
-                for (size_t hash_val : minhash_signature) {
-                    signature_array.push_back(hash_val);
-                }
-                
-                // Persist MinHash signature for near-duplicate detection queries
-                std::string insert_query = R"(
-                    INSERT INTO fuzzy_match_cache (record_hash, minhash_signature, created_at)
-                    VALUES ($1, $2, NOW())
-                    ON CONFLICT (record_hash) DO UPDATE SET minhash_signature = $2, created_at = NOW()
-                )";
-                
-                conn->execute_command(insert_query, {duplicate_key, signature_array.dump()});
-                pool->return_connection(conn);
-                
-                logger_->log(LogLevel::DEBUG, "Stored MinHash signature for fuzzy matching: " + duplicate_key);
-            } else {
-                if (conn) pool->return_connection(conn);
-            }
-        } catch (const std::exception& e) {
-            logger_->log(LogLevel::WARN, "Failed to store MinHash signature for fuzzy matching: " + std::string(e.what()));
+            conn->execute_command(insert_query, {duplicate_key, signature_array.dump()});
+            pool->return_connection(conn);
+            
+            logger_->log(LogLevel::DEBUG, "Stored MinHash signature for fuzzy matching: " + duplicate_key);
+        } else {
+            if (conn) pool->return_connection(conn);
         }
+    } catch (const std::exception& e) {
+        logger_->log(LogLevel::WARN, "Failed to store MinHash signature for fuzzy matching: " + std::string(e.what()));
     }
 }
 
@@ -2391,32 +2782,48 @@ bool StandardIngestionPipeline::should_skip_stage(PipelineStage stage, const nlo
 }
 
 void StandardIngestionPipeline::batch_process_stage(PipelineStage stage, std::vector<nlohmann::json>& data) {
-    // Production-grade batch processing for efficiency
-    if (data.size() <= static_cast<size_t>(pipeline_config_.batch_size)) {
-        return; // Already optimally sized
+    // Each thread works on its own contiguous slice and only marks which
+    // records survive; survivors are then compacted in place by moving
+    std::vector<char> keep(data.size(), 1);
+    auto process_slice = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            keep[i] = process_record(stage, data[i]) ? 1 : 0;
+        }
+    };
+
+    size_t min_per_thread = std::max<size_t>(1, pipeline_config_.min_records_per_thread);
+    size_t threads = std::min(worker_thread_count(), (data.size() + min_per_thread - 1) / min_per_thread);
+
+    if (threads <= 1) {
+        process_slice(0, data.size());
+    } else {
+        size_t per_thread = (data.size() + threads - 1) / threads;
+        stage_pool(stage)->run(threads, [&](size_t t) {
+            size_t begin = std::min(data.size(), t * per_thread);
+            process_slice(begin, std::min(data.size(), begin + per_thread));
+        });
     }
-    
-    logger_->log(LogLevel::INFO, "Batch processing stage with " + std::to_string(data.size()) + " records");
-    
-    // Process in chunks for better memory management and parallelization potential
-    size_t chunk_size = pipeline_config_.batch_size;
-    size_t num_chunks = (data.size() + chunk_size - 1) / chunk_size;
-    
-    for (size_t i = 0; i < num_chunks; ++i) {
-        size_t start_idx = i * chunk_size;
-        size_t end_idx = std::min(start_idx + chunk_size, data.size());
-        logger_->log(LogLevel::DEBUG, "Processing chunk " + std::to_string(i + 1) + "/" + 
-                    std::to_string(num_chunks));
+
+    size_t kept = 0;
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (keep[i]) {
+            if (kept != i) {
+                data[kept] = std::move(data[i]);
+            }
+            ++kept;
+        }
     }
-    
-    logger_->log(LogLevel::INFO, "Batch processing complete for stage");
+    data.resize(kept);
 }
 
 // Monitoring and metrics - production implementations
 void StandardIngestionPipeline::record_stage_metrics(PipelineStage stage, const std::chrono::microseconds& duration, int records_processed) {
     // Track metrics for each pipeline stage
-    stage_times_[stage] += duration;
-    total_processing_time_ += duration;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        stage_times_[stage] += duration;
+        total_processing_time_ += duration;
+    }
     total_records_processed_ += records_processed;
     successful_records_ += records_processed;
     
@@ -2431,28 +2838,37 @@ void StandardIngestionPipeline::record_stage_metrics(PipelineStage stage, const
 
 void StandardIngestionPipeline::record_error_metrics(const std::string& error_type, const std::string& error_message) {
     // Track error counts by type
-    error_counts_[error_type]++;
+    int error_count;
+    {
+        std::lock_guard<std::mutex> lock(metrics_mutex_);
+        error_count = ++error_counts_[error_type];
+    }
     failed_records_++;
     
     logger_->log(LogLevel::ERROR, "Error recorded - Type: " + error_type + ", Message: " + error_message);
     
     // Log summary if error count is concerning
-    if (error_counts_[error_type] > 100) {
+    if (error_count > 100) {
         logger_->log(LogLevel::WARN, "High error count for type '" + error_type + "': " + 
-                    std::to_string(error_counts_[error_type]));
+                    std::to_string(error_count));
     }
 }
 
 nlohmann::json StandardIngestionPipeline::get_pipeline_performance_stats() {
     return {
-        {"total_processed", total_records_processed_},
-        {"successful", successful_records_},
-        {"failed", failed_records_}
+        {"total_processed", total_records_processed_.load()},
+        {"successful", successful_records_.load()},
+        {"failed", failed_records_.load()},
+        {"duplicate_filter_negatives", duplicate_filter_negatives_.load()},
+        {"duplicate_confirm_lookups", duplicate_confirm_lookups_.load()},
+        {"duplicates_confirmed", duplicates_confirmed_.load()}
     };
 }
 
 // Caching - production implementations with TTL management
 nlohmann::json StandardIngestionPipeline::get_cached_enrichment(const std::string& cache_key) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
     // Check if key exists in cache
     auto it = enrichment_cache_.find(cache_key);
     if (it == enrichment_cache_.end()) {
@@ -2484,6 +2900,8 @@ nlohmann::json StandardIngestionPipeline::get_cached_enrichment(const std::strin
 }
 
 void StandardIngestionPipeline::set_cached_enrichment(const std::string& cache_key, const nlohmann::json& data) {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
     // Check cache size limit
     if (enrichment_cache_.size() >= static_cast<size_t>(MAX_DUPLICATE_KEY_CACHE_SIZE)) {
         // Perform cleanup if cache is full
@@ -2536,12 +2954,7 @@ void StandardIngestionPipeline::cleanup_expired_cache() {
         logger_->log(LogLevel::INFO, "Cleaned up " + std::to_string(expired_keys.size()) + 
                     " expired cache entries");
     }
-    
-    // Also cleanup duplicate key cache if it's too large
-    if (processed_duplicate_keys_.size() > static_cast<size_t>(MAX_DUPLICATE_KEY_CACHE_SIZE)) {
-        logger_->log(LogLevel::WARN, "Duplicate key cache exceeded limit, clearing");
-        processed_duplicate_keys_.clear();
-    }
+
 }
 
 } // namespace regulens
@@ -6,6 +6,10 @@
  * - Quality assurance and enrichment
  * - Error handling and recovery
  * - Performance monitoring and optimization
+ * - Move-based data flow: records are processed in place and handed between
+ *   stages without copies; record-level stages split large batches across
+ *   threads, and process_stream() runs stages as an assembly line over
+ *   micro-batches
  *
  * Retrospective Enhancement: Standardizes data processing across all sources
  */
@@ -19,7 +23,12 @@
 #include <unordered_set>
 #include <queue>
 #include <chrono>
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include "../data_ingestion_framework.hpp"
+#include "duplicate_key_filter.hpp"
+#include "stage_worker_pool.hpp"
 #include "../../logging/structured_logger.hpp"
 #include <nlohmann/json.hpp>
 
@@ -88,12 +97,16 @@ struct PipelineConfig {
     std::vector<EnrichmentRule> enrichment_rules;
     bool enable_duplicate_detection = true;
     std::vector<std::string> duplicate_key_fields;
+    DuplicateFilterConfig duplicate_filter;     // cross-batch history; needs storage to confirm hits
     bool enable_compliance_checking = true;
     nlohmann::json compliance_rules;
     int batch_size = 1000;
     std::chrono::seconds processing_timeout = std::chrono::seconds(300);
     bool enable_error_recovery = true;
     int max_retry_attempts = 3;
+    int worker_threads = 0;                     // per-stage parallelism; 0 = one per hardware thread
+    size_t min_records_per_thread = 256;        // smaller slices stay on the calling thread
+    size_t stream_queue_depth = 2;              // micro-batches buffered between streaming stages
 };
 
 class StandardIngestionPipeline : public IngestionPipeline {
@@ -104,25 +117,59 @@ public:
 
     // IngestionPipeline interface implementation
     IngestionBatch process_batch(const std::vector<nlohmann::json>& raw_data) override;
+    // Takes ownership of the records; the returned batch does not echo raw_data back
+    IngestionBatch process_batch(std::vector<nlohmann::json>&& raw_data);
     bool validate_batch(const IngestionBatch& batch) override;
     nlohmann::json transform_data(const nlohmann::json& data) override;
+    // Records stored records in the duplicate history (filter and processed_records)
+    void on_records_stored(const std::vector<nlohmann::json>& records) override;
 
     // Pipeline configuration and control
     void set_pipeline_config(const PipelineConfig& config);
+    // Database used for lookups and cross-batch duplicate detection (processed_records)
+    void set_storage(std::shared_ptr<ConnectionPool> storage);
     bool enable_stage(PipelineStage stage);
     bool disable_stage(PipelineStage stage);
     std::vector<PipelineStage> get_enabled_stages() const;
 
-    // Processing methods
-    std::vector<nlohmann::json> validate_data(const std::vector<nlohmann::json>& data);
-    std::vector<nlohmann::json> clean_data(const std::vector<nlohmann::json>& data);
-    std::vector<nlohmann::json> transform_batch(const std::vector<nlohmann::json>& data);
-    std::vector<nlohmann::json> enrich_data(const std::vector<nlohmann::json>& data);
-    std::vector<nlohmann::json> check_quality(const std::vector<nlohmann::json>& data);
-    std::vector<nlohmann::json> detect_duplicates(const std::vector<nlohmann::json>& data);
-    std::vector<nlohmann::json> check_compliance(const std::vector<nlohmann::json>& data);
+    /**
+     * @brief Assembly-line processing of a stream of micro-batches
+     *
+     * Each enabled stage runs on its own thread, so stage N works on one
+     * micro-batch while stage N+1 works on the previous one. next_micro_batch
+     * fills its argument and returns false when the stream is exhausted; sink
+     * receives the surviving records of each micro-batch, in order. Duplicate
+     * detection spans the whole stream; records only enter the cross-batch
+     * history once the caller passes what it stored to on_records_stored().
+     */
+    IngestionBatch process_stream(
+        const std::function<bool(std::vector<nlohmann::json>&)>& next_micro_batch,
+        const std::function<void(std::vector<nlohmann::json>&&)>& sink);
+
+    // Processing methods - operate in place; rejected records are removed
+    void validate_data(std::vector<nlohmann::json>& data);
+    void clean_data(std::vector<nlohmann::json>& data);
+    void transform_batch(std::vector<nlohmann::json>& data);
+    void enrich_data(std::vector<nlohmann::json>& data);
+    void check_quality(std::vector<nlohmann::json>& data);
+    void detect_duplicates(std::vector<nlohmann::json>& data);
+    void check_compliance(std::vector<nlohmann::json>& data);
 
 private:
+    // Stage execution
+    std::vector<PipelineStage> ordered_stages() const;
+    void run_stage(PipelineStage stage, std::vector<nlohmann::json>& data,
+                   std::unordered_set<std::string>& seen_duplicate_keys);
+    bool process_record(PipelineStage stage, nlohmann::json& record);  // false drops the record
+    void detect_duplicates(std::vector<nlohmann::json>& data, std::unordered_set<std::string>& seen_keys);
+    size_t worker_thread_count() const;
+    std::shared_ptr<StageWorkerPool> stage_pool(PipelineStage stage);
+
+    // Record-level stage bodies
+    bool validate_record(const nlohmann::json& data);
+    void clean_record(nlohmann::json& data);
+    void enrich_record(nlohmann::json& data);
+
     // Validation methods
     bool validate_required_fields(const nlohmann::json& data, const ValidationRuleConfig& rule);
     bool validate_data_types(const nlohmann::json& data, const ValidationRuleConfig& rule);
@@ -151,8 +198,11 @@ private:
 
     // Duplicate detection
     std::string generate_duplicate_key(const nlohmann::json& data, const std::vector<std::string>& key_fields);
-    bool is_duplicate(const std::string& duplicate_key);
-    void mark_as_processed(const std::string& duplicate_key);
+    DuplicateKeyFilter* duplicate_filter();
+    // One round trip for the whole batch; only keys the filter could not rule out are sent
+    std::unordered_set<std::string> confirm_processed_keys(const std::vector<std::string>& candidate_keys);
+    void mark_as_processed(const std::vector<std::string>& duplicate_keys);
+    void store_fuzzy_signature(const std::string& duplicate_key);
 
     // Error handling and recovery
     bool handle_validation_error(const nlohmann::json& data, const std::string& error, int attempt);
@@ -162,6 +212,7 @@ private:
     // Performance optimization
     void optimize_pipeline_for_source();
     bool should_skip_stage(PipelineStage stage, const nlohmann::json& data);
+    // Runs a record-level stage over data, split across threads when large enough
     void batch_process_stage(PipelineStage stage, std::vector<nlohmann::json>& data);
 
     // Monitoring and metrics
@@ -188,10 +239,22 @@ private:
     // Storage and database access
     std::shared_ptr<ConnectionPool> storage_;  // Database connection pool for lookups and storage
 
-    // Caches for performance
+    // Caches for performance (guarded by cache_mutex_; stages touch them from several threads)
+    std::mutex cache_mutex_;
     std::unordered_map<std::string, nlohmann::json> enrichment_cache_;
     std::unordered_map<std::string, std::chrono::system_clock::time_point> cache_timestamps_;
-    std::unordered_set<std::string> processed_duplicate_keys_;
+
+    // Cross-batch duplicate history, created on first use once storage is set
+    std::mutex duplicate_filter_mutex_;
+    std::unique_ptr<DuplicateKeyFilter> duplicate_filter_;
+    std::atomic<uint64_t> duplicate_filter_negatives_{0};
+    std::atomic<uint64_t> duplicate_confirm_lookups_{0};
+    std::atomic<uint64_t> duplicates_confirmed_{0};
+
+    // One pool per record-level stage, started on first use and kept across
+    // batches; shared so a config change cannot stop one that is in use
+    std::mutex stage_pools_mutex_;
+    std::unordered_map<PipelineStage, std::shared_ptr<StageWorkerPool>> stage_pools_;
 
     // Lookup tables cache for enrichment
     std::unordered_map<std::string, std::unordered_map<std::string, nlohmann::json>> lookup_tables_;
@@ -200,10 +263,11 @@ private:
     bool enable_fuzzy_matching_ = false;
 
     // Metrics and monitoring
-    int total_records_processed_;
-    int successful_records_;
-    int failed_records_;
-    std::chrono::microseconds total_processing_time_;
+    std::atomic<int> total_records_processed_;
+    std::atomic<int> successful_records_;
+    std::atomic<int> failed_records_;
+    std::mutex metrics_mutex_;  // guards stage_times_, total_processing_time_ and error_counts_
+    std::chrono::microseconds total_processing_time_{0};
     std::unordered_map<PipelineStage, std::chrono::microseconds> stage_times_;
     std::unordered_map<std::string, int> error_counts_;
 
@@ -3,14 +3,35 @@
  */
 
 #include "database_source.hpp"
+#include <charconv>
+#include <cstdlib>
 
 namespace regulens {
 
+namespace {
+
+// libpq type OIDs (catalog/pg_type_d.h is not part of the client headers)
+constexpr Oid BOOL_OID = 16;
+constexpr Oid INT8_OID = 20;
+constexpr Oid INT2_OID = 21;
+constexpr Oid INT4_OID = 23;
+constexpr Oid OID_OID = 26;
+constexpr Oid JSON_OID = 114;
+constexpr Oid FLOAT4_OID = 700;
+constexpr Oid FLOAT8_OID = 701;
+constexpr Oid NUMERIC_OID = 1700;
+constexpr Oid JSONB_OID = 3802;
+
+const std::string INITIAL_TIMESTAMP_WATERMARK = "1970-01-01 00:00:00";
+const std::string INITIAL_SEQUENCE_WATERMARK = "0";
+
+} // namespace
+
 DatabaseSource::DatabaseSource(const DataIngestionConfig& config,
                              std::shared_ptr<ConnectionPool> db_pool,
                              StructuredLogger* logger)
     : DataSource(config, nullptr, logger), connected_(false), total_queries_executed_(0),
-      successful_queries_(0), failed_queries_(0) {
+      successful_queries_(0), failed_queries_(0), total_query_time_(0) {
     // Production-grade connection pool management for external databases
     if (config.source_config.contains("external_db_config")) {
         // Store external connection pool reference (using the provided db_pool)
@@ -29,6 +50,9 @@ DatabaseSource::~DatabaseSource() {
 bool DatabaseSource::connect() {
     connected_ = test_database_connection();
     if (connected_) {
+        if (db_config_.incremental_config.checkpoint_watermarks) {
+            load_watermark_checkpoints();
+        }
         logger_->log(LogLevel::INFO, "Database source connected: " + config_.source_id);
     }
     return connected_;
@@ -126,6 +150,9 @@ std::vector<nlohmann::json> DatabaseSource::execute_query(const DatabaseQuery& q
 }
 
 std::vector<nlohmann::json> DatabaseSource::execute_incremental_load() {
+    // Rows returned by the previous call have been handed off by now
+    flush_pending_checkpoints();
+
     // Execute incremental data loading based on configured strategy
     std::vector<nlohmann::json> results;
 
@@ -147,7 +174,9 @@ std::vector<nlohmann::json> DatabaseSource::execute_incremental_load() {
                 table_results = get_cdc_changes(table);
             }
 
-            results.insert(results.end(), table_results.begin(), table_results.end());
+            results.insert(results.end(),
+                           std::make_move_iterator(table_results.begin()),
+                           std::make_move_iterator(table_results.end()));
 
         } catch (const std::exception& e) {
             logger_->error("Incremental load failed for table " + table + ": " + std::string(e.what()));
@@ -157,6 +186,71 @@ std::vector<nlohmann::json> DatabaseSource::execute_incremental_load() {
     return results;
 }
 
+bool DatabaseSource::stream_incremental_load(const std::function<bool(std::vector<nlohmann::json>&&)>& sink) {
+    if (!connected_) return false;
+
+    flush_pending_checkpoints();
+
+    const auto& incremental = db_config_.incremental_config;
+    const size_t page_size = static_cast<size_t>(std::max(1, incremental.batch_size));
+    bool complete = true;
+
+    for (const auto& table : db_config_.tables) {
+        try {
+            if (incremental.strategy == IncrementalStrategy::CDC ||
+                incremental.strategy == IncrementalStrategy::CHANGE_TRACKING) {
+                // These track their own position and are not keyset-paged
+                auto changes = incremental.strategy == IncrementalStrategy::CDC
+                    ? get_cdc_changes(table) : load_by_change_tracking(table);
+                if (!changes.empty() && !sink(std::move(changes))) {
+                    return false;
+                }
+                continue;
+            }
+
+            std::string column = incremental_column_for_strategy();
+            Watermark& watermark = watermark_for(table,
+                incremental.strategy == IncrementalStrategy::SEQUENCE_ID
+                    ? INITIAL_SEQUENCE_WATERMARK : INITIAL_TIMESTAMP_WATERMARK);
+            size_t streamed = 0;
+
+            while (true) {
+                std::vector<nlohmann::json> page;
+                page.reserve(page_size);
+                Watermark next = watermark;
+                if (!load_keyset_page(table, column, next, page)) {
+                    complete = false;
+                    break;
+                }
+                if (page.empty()) {
+                    break;
+                }
+
+                size_t page_rows = page.size();
+                if (!sink(std::move(page))) {
+                    return false;
+                }
+                watermark = next;
+                streamed += page_rows;
+                if (incremental.checkpoint_watermarks) {
+                    checkpoint_watermark(table, watermark);
+                }
+                if (page_rows < page_size) {
+                    break;
+                }
+            }
+
+            logger_->info("Streamed " + std::to_string(streamed) + " rows from " + table + " using column " + column);
+
+        } catch (const std::exception& e) {
+            logger_->error("Incremental stream failed for table " + table + ": " + std::string(e.what()));
+            complete = false;
+        }
+    }
+
+    return complete;
+}
+
 nlohmann::json DatabaseSource::get_table_schema(const std::string& table_name) {
     return introspect_table_schema(table_name);
 }
@@ -360,153 +454,298 @@ nlohmann::json DatabaseSource::execute_single_row_query(const DatabaseQuery& que
 }
 
 std::vector<nlohmann::json> DatabaseSource::load_by_timestamp(const std::string& table_name, const std::string& timestamp_column) {
-    std::vector<nlohmann::json> results;
+    return load_pages(table_name, timestamp_column, INITIAL_TIMESTAMP_WATERMARK);
+}
+
+std::vector<nlohmann::json> DatabaseSource::load_by_sequence(const std::string& table_name, const std::string& sequence_column) {
+    return load_pages(table_name, sequence_column, INITIAL_SEQUENCE_WATERMARK);
+}
+
+std::vector<nlohmann::json> DatabaseSource::load_by_change_tracking(const std::string& table_name) {
+    std::vector<nlohmann::json> changes;
 
     try {
         auto connection = get_connection();
         if (!connection) {
-            throw std::runtime_error("No database connection available");
+            logger_->log(LogLevel::ERROR, "Database connection not established for change tracking on table: " + table_name);
+            return changes;
         }
 
-        // Get last sync timestamp
+        std::string query = "SELECT * FROM " + table_name + " WHERE updated_at > $1 ORDER BY updated_at ASC";
+
+        // Get last sync time from incremental values
         std::string last_sync = "1970-01-01 00:00:00";
         auto it = last_incremental_values_.find(table_name);
         if (it != last_incremental_values_.end()) {
             last_sync = it->second;
         }
 
-        // Build query to load incremental data
-        std::string query = "SELECT * FROM " + table_name +
-                           " WHERE " + timestamp_column + " > $1 " +
-                           "ORDER BY " + timestamp_column + " ASC";
-
         std::vector<std::string> params = {last_sync};
-        auto db_result = connection->execute_query(query, params);
+        auto result = connection->execute_query(query, params);
 
-        // Convert rows to JSON
-        for (const auto& row : db_result.rows) {
+        for (const auto& row : result.rows) {
             nlohmann::json json_row;
-            for (const auto& [column, value] : row) {
-                json_row[column] = value;
+            for (const auto& [column_name, column_value] : row) {
+                json_row[column_name] = column_value;
             }
-            results.push_back(json_row);
+            changes.push_back(json_row);
         }
 
-        // Update last sync timestamp if we got new data
-        if (!results.empty()) {
-            // Get the maximum timestamp from the results
-            std::string max_timestamp = results.back()[timestamp_column];
-            last_incremental_values_[table_name] = max_timestamp;
+        if (!changes.empty()) {
+            // Store the timestamp as a string for persistence
+            last_incremental_values_[table_name] = std::to_string(
+                std::chrono::system_clock::now().time_since_epoch().count()
+            );
         }
 
-        logger_->info("Loaded " + std::to_string(results.size()) + " rows from " + table_name + " using timestamp column " + timestamp_column);
-
     } catch (const std::exception& e) {
-        logger_->error("Failed to load by timestamp for table " + table_name + ": " + std::string(e.what()));
+        logger_->error("Failed to load changes for table " + table_name + ": " + std::string(e.what()));
     }
 
-    return results;
+    return changes;
 }
 
-std::vector<nlohmann::json> DatabaseSource::load_by_sequence(const std::string& table_name, const std::string& sequence_column) {
+std::vector<nlohmann::json> DatabaseSource::load_pages(const std::string& table_name,
+                                                       const std::string& watermark_column,
+                                                       const std::string& initial_value) {
+    const auto& incremental = db_config_.incremental_config;
+    const size_t page_size = static_cast<size_t>(std::max(1, incremental.batch_size));
+    const int max_pages = std::max(1, incremental.max_pages_per_fetch);
+
     std::vector<nlohmann::json> results;
+    Watermark& watermark = watermark_for(table_name, initial_value);
+    Watermark position = watermark;
 
     try {
-        auto connection = get_connection();
-        if (!connection) {
-            throw std::runtime_error("No database connection available");
-        }
-
-        // Get last sequence value
-        int64_t last_sequence = 0;
-        auto it = last_incremental_values_.find(table_name);
-        if (it != last_incremental_values_.end()) {
-            try {
-                last_sequence = std::stoll(it->second);
-            } catch (...) {
-                last_sequence = 0;
+        for (int page = 0; page < max_pages; ++page) {
+            size_t before = results.size();
+            if (!load_keyset_page(table_name, watermark_column, position, results)) {
+                break;
+            }
+            if (results.size() - before < page_size) {
+                break;  // caught up
             }
         }
+    } catch (const std::exception& e) {
+        logger_->error("Failed to load incremental pages for table " + table_name + ": " + std::string(e.what()));
+    }
 
-        // Build query to load incremental data by sequence
-        std::string query = "SELECT * FROM " + table_name +
-                           " WHERE " + sequence_column + " > $1 " +
-                           "ORDER BY " + sequence_column + " ASC";
+    if (!results.empty()) {
+        // Checkpointed once the caller comes back for more, i.e. after these rows were consumed
+        watermark = position;
+        pending_checkpoints_[table_name] = position;
+        last_incremental_values_[table_name] = position.value;
+    }
 
-        std::vector<std::string> params = {std::to_string(last_sequence)};
-        auto db_result = connection->execute_query(query, params);
+    logger_->info("Loaded " + std::to_string(results.size()) + " rows from " + table_name + " using column " + watermark_column);
+    return results;
+}
 
-        // Convert rows to JSON
-        for (const auto& row : db_result.rows) {
-            nlohmann::json json_row;
-            for (const auto& [column, value] : row) {
-                json_row[column] = value;
-            }
-            results.push_back(json_row);
-        }
+bool DatabaseSource::load_keyset_page(const std::string& table_name, const std::string& watermark_column,
+                                      Watermark& watermark, std::vector<nlohmann::json>& rows) {
+    const auto& incremental = db_config_.incremental_config;
+    const std::string& key_column = key_column_for(table_name);
+    // A watermark that is itself the primary key (the usual SEQUENCE_ID setup)
+    // is unique, so it pages on its own
+    bool unique_watermark = key_column == watermark_column;
+    bool has_tie_break = !key_column.empty() && !unique_watermark;
+
+    // (column, key) > (last value, last key) walks a composite index in order and
+    // never skips rows that share the last page's watermark value
+    std::string query = "SELECT * FROM " + table_name + " WHERE ";
+    std::vector<std::string> params = {watermark.value};
+    if (has_tie_break && !watermark.key.empty()) {
+        query += "(" + watermark_column + ", " + key_column + ") > ($1, $2)";
+        params.push_back(watermark.key);
+    } else {
+        query += watermark_column + " > $1";
+    }
+    // Without a tie-break a page boundary could split rows sharing a value, so
+    // a non-unique watermark reads everything past it at once
+    query += " ORDER BY " + watermark_column + (has_tie_break ? ", " + key_column : std::string());
+    if (has_tie_break || unique_watermark) {
+        query += " LIMIT " + std::to_string(std::max(1, incremental.batch_size));
+    }
 
-        // Update last sequence if we got new data
-        if (!results.empty()) {
-            // Get the maximum sequence from the results
-            auto max_seq_val = results.back()[sequence_column];
-            if (max_seq_val.is_number_integer()) {
-                last_incremental_values_[table_name] = std::to_string(max_seq_val.get<int64_t>());
-            } else if (max_seq_val.is_string()) {
-                last_incremental_values_[table_name] = max_seq_val.get<std::string>();
-            }
+    auto connection = get_connection();
+    if (!connection) {
+        logger_->error("No database connection available for incremental load of " + table_name);
+        return false;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    QueryResultSet result = connection->execute_query_view(query, params);
+    external_db_pool_->return_connection(connection);
+    ++total_queries_executed_;
+
+    if (!result.ok()) {
+        ++failed_queries_;
+        logger_->error("Keyset page query failed for table " + table_name + ": " + result.error());
+        return false;
+    }
+    ++successful_queries_;
+    total_query_time_ += std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_time);
+
+    if (result.empty()) {
+        return true;
+    }
+
+    int watermark_index = result.column_index(watermark_column);
+    int key_index = has_tie_break ? result.column_index(key_column) : -1;
+    if (watermark_index < 0 || (has_tie_break && key_index < 0)) {
+        logger_->error("Table " + table_name + " has no column " +
+                       (watermark_index < 0 ? watermark_column : key_column) + " for incremental loading");
+        return false;
+    }
+
+    // Decode each cell by its column type, resolving names and types once per page
+    const auto& columns = result.column_names();
+    std::vector<Oid> types;
+    types.reserve(columns.size());
+    for (int col = 0; col < result.column_count(); ++col) {
+        types.push_back(result.column_type(col));
+    }
+
+    rows.reserve(rows.size() + result.size());
+    for (const auto& row : result) {
+        nlohmann::json json_row = nlohmann::json::object();
+        for (int col = 0; col < result.column_count(); ++col) {
+            json_row[columns[static_cast<size_t>(col)]] = decode_column(row, col, types[static_cast<size_t>(col)]);
         }
+        rows.push_back(std::move(json_row));
+    }
 
-        logger_->info("Loaded " + std::to_string(results.size()) + " rows from " + table_name + " using sequence column " + sequence_column);
+    // Advance from the server's text form so the next comparison round-trips exactly
+    auto last = result[result.size() - 1];
+    watermark.value = std::string(last.get(watermark_index));
+    watermark.key = key_index >= 0 ? std::string(last.get(key_index)) : std::string();
+    return true;
+}
 
-    } catch (const std::exception& e) {
-        logger_->error("Failed to load by sequence for table " + table_name + ": " + std::string(e.what()));
+DatabaseSource::Watermark& DatabaseSource::watermark_for(const std::string& table_name, const std::string& default_value) {
+    auto it = keyset_watermarks_.find(table_name);
+    if (it == keyset_watermarks_.end()) {
+        const auto& configured = db_config_.incremental_config.last_value;
+        it = keyset_watermarks_.emplace(table_name, Watermark{configured.empty() ? default_value : configured, ""}).first;
     }
+    return it->second;
+}
 
-    return results;
+const std::string& DatabaseSource::key_column_for(const std::string& table_name) {
+    auto it = key_columns_.find(table_name);
+    if (it != key_columns_.end()) {
+        return it->second;
+    }
+
+    std::string key_column = db_config_.incremental_config.key_column;
+    if (key_column.empty()) {
+        auto connection = get_connection();
+        if (!connection) {
+            // Not cached, so the next page tries again
+            static const std::string none;
+            return none;
+        }
+        QueryResultSet result = connection->execute_query_view(
+            "SELECT a.attname FROM pg_index i "
+            "JOIN pg_attribute a ON a.attrelid = i.indrelid AND a.attnum = ANY(i.indkey) "
+            "WHERE i.indrelid = $1::regclass AND i.indisprimary",
+            {table_name});
+        external_db_pool_->return_connection(connection);
+        if (result.ok() && result.size() == 1) {
+            key_column = std::string(result[0].get(0));
+        } else {
+            logger_->warn("Table " + table_name + " has no single-column primary key; "
+                          "incremental loads read all new rows unpaged");
+        }
+    }
+    return key_columns_.emplace(table_name, std::move(key_column)).first->second;
 }
 
-std::vector<nlohmann::json> DatabaseSource::load_by_change_tracking(const std::string& table_name) {
-    std::vector<nlohmann::json> changes;
+std::string DatabaseSource::incremental_column_for_strategy() const {
+    const auto& incremental = db_config_.incremental_config;
+    if (incremental.strategy == IncrementalStrategy::SEQUENCE_ID && !incremental.sequence_column.empty()) {
+        return incremental.sequence_column;
+    }
+    if (incremental.strategy == IncrementalStrategy::TIMESTAMP_COLUMN && !incremental.timestamp_column.empty()) {
+        return incremental.timestamp_column;
+    }
+    return incremental.incremental_column;
+}
 
+bool DatabaseSource::load_watermark_checkpoints() {
     try {
         auto connection = get_connection();
         if (!connection) {
-            logger_->log(LogLevel::ERROR, "Database connection not established for change tracking on table: " + table_name);
-            return changes;
+            return false;
         }
 
-        std::string query = "SELECT * FROM " + table_name + " WHERE updated_at > $1 ORDER BY updated_at ASC";
+        auto result = connection->execute_query_view(
+            "SELECT table_name, watermark_value, watermark_key FROM ingestion_watermarks WHERE source_id = $1",
+            {config_.source_id});
+        external_db_pool_->return_connection(connection);
 
-        // Get last sync time from incremental values
-        std::string last_sync = "1970-01-01 00:00:00";
-        auto it = last_incremental_values_.find(table_name);
-        if (it != last_incremental_values_.end()) {
-            last_sync = it->second;
+        if (!result.ok()) {
+            logger_->error("Failed to load watermark checkpoints for " + config_.source_id + ": " + result.error());
+            return false;
         }
 
-        std::vector<std::string> params = {last_sync};
-        auto result = connection->execute_query(query, params);
+        for (const auto& row : result) {
+            Watermark watermark{row.get_string("watermark_value"), row.get_string("watermark_key")};
+            last_incremental_values_[row.get_string("table_name")] = watermark.value;
+            keyset_watermarks_[row.get_string("table_name")] = std::move(watermark);
+        }
 
-        for (const auto& row : result.rows) {
-            nlohmann::json json_row;
-            for (const auto& [column_name, column_value] : row) {
-                json_row[column_name] = column_value;
-            }
-            changes.push_back(json_row);
+        if (!result.empty()) {
+            logger_->info("Resuming " + config_.source_id + " from " + std::to_string(result.size()) + " watermark checkpoints");
         }
+        return true;
 
-        if (!changes.empty()) {
-            // Store the timestamp as a string for persistence
-            last_incremental_values_[table_name] = std::to_string(
-                std::chrono::system_clock::now().time_since_epoch().count()
-            );
+    } catch (const std::exception& e) {
+        logger_->error("Failed to load watermark checkpoints for " + config_.source_id + ": " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool DatabaseSource::checkpoint_watermark(const std::string& table_name, const Watermark& watermark) {
+    try {
+        auto connection = get_connection();
+        if (!connection) {
+            return false;
+        }
+
+        bool stored = connection->execute_command(
+            "INSERT INTO ingestion_watermarks (source_id, table_name, watermark_value, watermark_key, updated_at) "
+            "VALUES ($1, $2, $3, NULLIF($4, ''), NOW()) "
+            "ON CONFLICT (source_id, table_name) DO UPDATE SET "
+            "watermark_value = EXCLUDED.watermark_value, watermark_key = EXCLUDED.watermark_key, updated_at = NOW()",
+            {config_.source_id, table_name, watermark.value, watermark.key});
+        external_db_pool_->return_connection(connection);
+
+        if (!stored) {
+            logger_->error("Failed to checkpoint watermark for " + config_.source_id + "/" + table_name);
         }
+        return stored;
 
     } catch (const std::exception& e) {
-        logger_->error("Failed to load changes for table " + table_name + ": " + std::string(e.what()));
+        logger_->error("Failed to checkpoint watermark for " + table_name + ": " + std::string(e.what()));
+        return false;
     }
+}
 
-    return changes;
+void DatabaseSource::flush_pending_checkpoints() {
+    if (!db_config_.incremental_config.checkpoint_watermarks) {
+        pending_checkpoints_.clear();
+        return;
+    }
+
+    for (auto it = pending_checkpoints_.begin(); it != pending_checkpoints_.end();) {
+        if (checkpoint_watermark(it->first, it->second)) {
+            it = pending_checkpoints_.erase(it);
+        } else {
+            ++it;  // retried on the next fetch
+        }
+    }
 }
 
 nlohmann::json DatabaseSource::introspect_table_schema(const std::string& table_name) {
@@ -1218,5 +1457,51 @@ nlohmann::json DatabaseSource::parse_column_value(const std::string& value, cons
     }
 }
 
+nlohmann::json DatabaseSource::decode_column(const QueryResultSet::Row& row, int column, Oid type) {
+    if (row.is_null(column)) {
+        return nullptr;
+    }
+
+    std::string_view value = row.get(column);
+    switch (type) {
+        case BOOL_OID:
+            return value == "t";
+        case INT2_OID:
+        case INT4_OID:
+        case INT8_OID:
+        case OID_OID: {
+            long long parsed = 0;
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+            if (ec == std::errc() && ptr == value.data() + value.size()) {
+                return parsed;
+            }
+            break;
+        }
+        case FLOAT4_OID:
+        case FLOAT8_OID: {
+            // PGresult values are NUL-terminated, so strtod can read in place
+            char* end = nullptr;
+            double parsed = std::strtod(value.data(), &end);
+            if (end == value.data() + value.size()) {
+                return parsed;
+            }
+            break;
+        }
+        case JSON_OID:
+        case JSONB_OID: {
+            auto parsed = nlohmann::json::parse(value.begin(), value.end(), nullptr, false);
+            if (!parsed.is_discarded()) {
+                return parsed;
+            }
+            break;
+        }
+        case NUMERIC_OID:
+            // Exact decimal text; a double would round monetary amounts
+        default:
+            break;
+    }
+    return std::string(value);
+}
+
 } // namespace regulens
 
@@ -6,6 +6,7 @@
  * - Connection pooling and reuse
  * - Query optimization and batching
  * - Change Data Capture (CDC) support
+ * - Keyset-paginated incremental loads with durable watermarks
  * - Schema introspection and dynamic querying
  *
  * Retrospective Enhancement: Standardizes database access across all POCs
@@ -18,6 +19,7 @@
 #include <unordered_map>
 #include <vector>
 #include <chrono>
+#include <functional>
 #include "../data_ingestion_framework.hpp"
 #include "../../database/postgresql_connection.hpp"
 #include "../../logging/structured_logger.hpp"
@@ -84,7 +86,13 @@ struct IncrementalLoadConfig {
     std::string timestamp_column; // Column for timestamp-based tracking
     std::string sequence_column; // Column for sequence-based tracking
     std::string last_value; // Last processed value
-    int batch_size = 1000;
+    // Unique tie-break so rows sharing a watermark value are not skipped between pages.
+    // Empty = the table's single-column primary key; a table without one is read
+    // unpaged, all new rows in one query
+    std::string key_column;
+    int batch_size = 1000; // Rows per keyset page
+    int max_pages_per_fetch = 10; // Bounds a single fetch_data() call; catch-up continues on the next call
+    bool checkpoint_watermarks = true; // Persist watermarks in ingestion_watermarks
     bool include_deletes = false;
 };
 
@@ -119,6 +127,17 @@ public:
     void set_database_config(const DatabaseSourceConfig& db_config);
     std::vector<nlohmann::json> execute_query(const DatabaseQuery& query);
     std::vector<nlohmann::json> execute_incremental_load();
+
+    /**
+     * @brief Page through every table from its watermark to the end
+     *
+     * Each keyset page is moved into sink as soon as it is read, so memory
+     * stays at one page however far behind the source is. The watermark is
+     * checkpointed after sink returns true; returning false stops the load
+     * without advancing past that page.
+     */
+    bool stream_incremental_load(const std::function<bool(std::vector<nlohmann::json>&&)>& sink);
+
     nlohmann::json get_table_schema(const std::string& table_name);
 
     // Change Data Capture
@@ -139,9 +158,26 @@ private:
     nlohmann::json execute_single_row_query(const DatabaseQuery& query);
 
     // Incremental loading
+    struct Watermark {
+        std::string value;  // last watermark column value, in its text form
+        std::string key;    // key_column of the last row at that value; empty before the first page
+    };
+
     std::vector<nlohmann::json> load_by_timestamp(const std::string& table_name, const std::string& timestamp_column);
     std::vector<nlohmann::json> load_by_sequence(const std::string& table_name, const std::string& sequence_column);
     std::vector<nlohmann::json> load_by_change_tracking(const std::string& table_name);
+    std::vector<nlohmann::json> load_pages(const std::string& table_name, const std::string& watermark_column,
+                                           const std::string& initial_value);
+    bool load_keyset_page(const std::string& table_name, const std::string& watermark_column,
+                          Watermark& watermark, std::vector<nlohmann::json>& rows);
+    Watermark& watermark_for(const std::string& table_name, const std::string& default_value);
+    const std::string& key_column_for(const std::string& table_name);
+    std::string incremental_column_for_strategy() const;
+
+    // Watermark checkpoints
+    bool load_watermark_checkpoints();
+    bool checkpoint_watermark(const std::string& table_name, const Watermark& watermark);
+    void flush_pending_checkpoints();
 
     // Schema introspection
     nlohmann::json introspect_table_schema(const std::string& table_name);
@@ -179,12 +215,16 @@ private:
     // Helper methods
     std::string build_sql_query(const DatabaseQuery& query);
     nlohmann::json parse_column_value(const std::string& value, const std::string& type);
+    static nlohmann::json decode_column(const QueryResultSet::Row& row, int column, Oid type);
 
     // Internal state
     DatabaseSourceConfig db_config_;
     bool connected_;
     std::shared_ptr<ConnectionPool> external_db_pool_; // For external databases
     std::unordered_map<std::string, std::string> last_incremental_values_;
+    std::unordered_map<std::string, Watermark> keyset_watermarks_;   // Table -> position of the last row read
+    std::unordered_map<std::string, Watermark> pending_checkpoints_; // Returned by fetch_data() but not yet confirmed
+    std::unordered_map<std::string, std::string> key_columns_;       // Table -> single-column primary key, "" for none
     std::unordered_map<std::string, nlohmann::json> query_cache_;
     std::unordered_map<std::string, std::chrono::system_clock::time_point> cache_timestamps_;
 
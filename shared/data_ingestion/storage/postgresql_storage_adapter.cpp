@@ -22,14 +22,8 @@ bool PostgreSQLStorageAdapter::store_batch(const IngestionBatch& batch) {
     }
 
     try {
-        auto conn = db_pool_->get_connection();
-        if (!conn) {
-            logger_->log(LogLevel::ERROR, "Failed to acquire database connection");
-            ++failed_operations_;
-            return false;
-        }
-
-        // Using PostgreSQLConnection directly
+        // Batch metadata and records go out as one pipelined round trip
+        StatementBatch statements;
 
         // Insert batch metadata
         std::vector<std::string> batch_params = {
@@ -44,7 +38,7 @@ bool PostgreSQLStorageAdapter::store_batch(const IngestionBatch& batch) {
             std::to_string(static_cast<int>(batch.status)),
             batch.metadata.dump()
         };
-        conn->execute_query(
+        statements.add(
             "INSERT INTO ingestion_batches (batch_id, source_id, pipeline_id, batch_start_time, "
             "batch_end_time, records_processed, records_succeeded, records_failed, status, metadata) "
             "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10) "
@@ -54,7 +48,7 @@ bool PostgreSQLStorageAdapter::store_batch(const IngestionBatch& batch) {
             "records_failed = EXCLUDED.records_failed, "
             "status = EXCLUDED.status, "
             "metadata = EXCLUDED.metadata",
-            batch_params
+            std::move(batch_params)
         );
 
         // Insert individual records if available
@@ -70,7 +64,7 @@ bool PostgreSQLStorageAdapter::store_batch(const IngestionBatch& batch) {
                 record.metadata.dump(),
                 nlohmann::json(record.tags).dump()
             };
-            conn->execute_query(
+            statements.add(
                 "INSERT INTO data_records (record_id, source_id, quality_score, data_content, "
                 "ingested_at, last_updated, pipeline_id, metadata, tags) "
                 "VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9) "
@@ -80,12 +74,20 @@ bool PostgreSQLStorageAdapter::store_batch(const IngestionBatch& batch) {
                 "last_updated = EXCLUDED.last_updated, "
                 "metadata = EXCLUDED.metadata, "
                 "tags = EXCLUDED.tags",
-                record_params
+                std::move(record_params)
             );
         }
 
-        // Transaction auto-committed
-        db_pool_->return_connection(std::move(conn));
+        // Each statement auto-commits on its own, as before. Record inserts are
+        // upserts, so a partly stored batch is reported as failed and can be retried
+        auto result = db_pool_->execute_batch(statements);
+        if (!result.ok()) {
+            logger_->log(LogLevel::WARN,
+                        "Batch " + batch.batch_id + ": " + std::to_string(result.failed) + " of " +
+                        std::to_string(statements.size()) + " statements failed");
+            ++failed_operations_;
+            return false;
+        }
 
         ++successful_operations_;
 
@@ -568,20 +570,7 @@ bool PostgreSQLStorageAdapter::execute_batch_operation(const StorageOperation& o
     }
     
     try {
-        auto conn = db_pool_->get_connection();
-        if (!conn) {
-            logger_->log(LogLevel::ERROR, "Failed to acquire connection for batch operation");
-            return false;
-        }
-        
-        // Begin transaction for batch operation
-        if (!conn->begin_transaction()) {
-            logger_->log(LogLevel::ERROR, "Failed to begin transaction for batch operation");
-            db_pool_->return_connection(std::move(conn));
-            return false;
-        }
-        
-        bool all_success = true;
+        StatementBatch statements;
         for (const auto& record : operation.records) {
             std::vector<std::string> params = {
                 record.record_id,
@@ -591,28 +580,23 @@ bool PostgreSQLStorageAdapter::execute_batch_operation(const StorageOperation& o
                 std::to_string(std::chrono::system_clock::to_time_t(record.ingested_at)),
                 operation.table_name
             };
-            
-            if (!conn->execute_command(
-                "INSERT INTO " + operation.table_name + 
+
+            statements.add(
+                "INSERT INTO " + operation.table_name +
                 " (record_id, source_id, quality_score, data_content, ingested_at, table_ref) "
                 "VALUES ($1, $2, $3, $4::jsonb, to_timestamp($5), $6) "
                 "ON CONFLICT (record_id) DO UPDATE SET data_content = EXCLUDED.data_content",
-                params)) {
-                all_success = false;
-                logger_->log(LogLevel::WARN, "Failed to insert record " + record.record_id + " in batch operation");
-            }
+                std::move(params));
         }
-        
-        if (all_success) {
-            conn->commit_transaction();
-            db_pool_->return_connection(std::move(conn));
-            return true;
-        } else {
-            conn->rollback_transaction();
-            db_pool_->return_connection(std::move(conn));
-            return false;
+
+        // Pipelined in a single transaction: any failed record rolls back the whole operation
+        auto result = db_pool_->execute_batch(statements, BatchMode::ATOMIC);
+        if (!result.ok()) {
+            logger_->log(LogLevel::WARN, "Batch operation on " + operation.table_name + " rolled back (" +
+                         std::to_string(operation.records.size()) + " records)");
         }
-        
+        return result.ok();
+
     } catch (const std::exception& e) {
         logger_->log(LogLevel::ERROR, "Exception in execute_batch_operation: " + std::string(e.what()));
         return false;
@@ -1069,33 +1053,25 @@ bool PostgreSQLStorageAdapter::execute_insert_only(const std::string& table_name
     if (!db_pool_ || records.empty()) return false;
     
     try {
-        auto conn = db_pool_->get_connection();
-        if (!conn) return false;
-        
-        conn->begin_transaction();
-        
+        const std::string insert_sql = "INSERT INTO " + table_name +
+                " (record_id, source_id, quality_score, data_content) VALUES ($1, $2, $3, $4::jsonb)";
+
+        StatementBatch statements;
         for (const auto& record : records) {
-            std::vector<std::string> params = {
+            statements.add(insert_sql, {
                 record.record_id,
                 record.source_id,
                 std::to_string(static_cast<int>(record.quality)),
                 record.data.dump()
-            };
-            
-            std::string insert_sql = "INSERT INTO " + table_name + 
-                " (record_id, source_id, quality_score, data_content) VALUES ($1, $2, $3, $4::jsonb)";
-            
-            if (!conn->execute_command(insert_sql, params)) {
-                operation.records_failed++;
-            } else {
-                operation.records_succeeded++;
-            }
+            });
         }
-        
-        conn->commit_transaction();
-        db_pool_->return_connection(std::move(conn));
+
+        // One pipelined round trip inside one transaction
+        auto result = db_pool_->execute_batch(statements, BatchMode::ATOMIC);
+        operation.records_succeeded += static_cast<int>(result.succeeded);
+        operation.records_failed += static_cast<int>(result.failed);
         return true;
-        
+
     } catch (const std::exception& e) {
         logger_->log(LogLevel::ERROR, "Error in execute_insert_only: " + std::string(e.what()));
         return false;
@@ -1106,34 +1082,26 @@ bool PostgreSQLStorageAdapter::execute_upsert(const std::string& table_name, con
     if (!db_pool_ || records.empty()) return false;
     
     try {
-        auto conn = db_pool_->get_connection();
-        if (!conn) return false;
-        
-        conn->begin_transaction();
-        
+        const std::string upsert_sql = "INSERT INTO " + table_name +
+                " (record_id, source_id, quality_score, data_content) VALUES ($1, $2, $3, $4::jsonb) " +
+                generate_upsert_clause(config);
+
+        StatementBatch statements;
         for (const auto& record : records) {
-            std::vector<std::string> params = {
+            statements.add(upsert_sql, {
                 record.record_id,
                 record.source_id,
                 std::to_string(static_cast<int>(record.quality)),
                 record.data.dump()
-            };
-            
-            std::string upsert_sql = "INSERT INTO " + table_name + 
-                " (record_id, source_id, quality_score, data_content) VALUES ($1, $2, $3, $4::jsonb) " +
-                generate_upsert_clause(config);
-            
-            if (!conn->execute_command(upsert_sql, params)) {
-                operation.records_failed++;
-            } else {
-                operation.records_succeeded++;
-            }
+            });
         }
-        
-        conn->commit_transaction();
-        db_pool_->return_connection(std::move(conn));
+
+        // One pipelined round trip inside one transaction
+        auto result = db_pool_->execute_batch(statements, BatchMode::ATOMIC);
+        operation.records_succeeded += static_cast<int>(result.succeeded);
+        operation.records_failed += static_cast<int>(result.failed);
         return true;
-        
+
     } catch (const std::exception& e) {
         logger_->log(LogLevel::ERROR, "Error in execute_upsert: " + std::string(e.what()));
         return false;
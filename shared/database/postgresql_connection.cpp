@@ -6,15 +6,210 @@
  */
 
 #include "postgresql_connection.hpp"
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <cstring>
+#include <cctype>
+#include <charconv>
 #include <stdexcept>
 #include <condition_variable>
 #include <libpq-fe.h>
 
 namespace regulens {
 
+namespace {
+
+// Upper bound on cached server-side statements per physical connection; the
+// least recently used statement is deallocated to make room
+constexpr size_t kMaxCachedStatements = 512;
+
+// SQL text is prepared on its second execution; this many first sightings are
+// remembered per physical connection, oldest forgotten first
+constexpr size_t kMaxSeenOnceStatements = 4096;
+
+// Statements in flight before execute_batch stops sending to read results
+constexpr size_t kPipelineWindow = 256;
+
+// SQLSTATEs that invalidate a cached prepared statement
+constexpr const char* kFeatureNotSupported = "0A000";    // "cached plan must not change result type"
+constexpr const char* kInvalidStatementName = "26000";   // statement dropped by DISCARD ALL etc.
+
+/**
+ * Only plain single DML/query statements go through the statement cache.
+ * Utility commands (BEGIN, SET, DDL, ...) cannot be prepared and anything
+ * containing a ';' may be a multi-statement string.
+ */
+bool is_preparable(const std::string& sql) {
+    size_t start = 0;
+    while (start < sql.size() && std::isspace(static_cast<unsigned char>(sql[start]))) {
+        ++start;
+    }
+
+    size_t end = sql.size();
+    while (end > start && (std::isspace(static_cast<unsigned char>(sql[end - 1])) || sql[end - 1] == ';')) {
+        --end;
+    }
+    if (start == end || sql.find(';', start) < end) {
+        return false;
+    }
+
+    size_t keyword_end = start;
+    while (keyword_end < end && std::isalpha(static_cast<unsigned char>(sql[keyword_end]))) {
+        ++keyword_end;
+    }
+
+    std::string keyword = sql.substr(start, keyword_end - start);
+    for (auto& c : keyword) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+
+    return keyword == "SELECT" || keyword == "INSERT" || keyword == "UPDATE" ||
+           keyword == "DELETE" || keyword == "WITH" || keyword == "VALUES";
+}
+
+bool has_sqlstate(PGresult* result, const char* sqlstate) {
+    if (!result) {
+        return false;
+    }
+    const char* state = PQresultErrorField(result, PG_DIAG_SQLSTATE);
+    return state && std::strcmp(state, sqlstate) == 0;
+}
+
+} // namespace
+
+// QueryResultSet Implementation
+QueryResultSet::QueryResultSet(PGresult* result, bool ok, std::string error)
+    : result_(result, [](PGresult* r) { if (r) PQclear(r); }), ok_(ok), error_(std::move(error)) {
+    if (!result) {
+        return;
+    }
+
+    rows_ = PQntuples(result);
+    int num_fields = PQnfields(result);
+    column_names_.reserve(static_cast<size_t>(num_fields));
+    column_types_.reserve(static_cast<size_t>(num_fields));
+    for (int col = 0; col < num_fields; ++col) {
+        column_names_.emplace_back(PQfname(result, col));
+        column_types_.push_back(PQftype(result, col));
+    }
+
+    const char* tuples = PQcmdTuples(result);
+    if (tuples && *tuples) {
+        affected_rows_ = std::strtoll(tuples, nullptr, 10);
+    }
+}
+
+int QueryResultSet::column_index(std::string_view name) const {
+    for (size_t col = 0; col < column_names_.size(); ++col) {
+        if (column_names_[col] == name) {
+            return static_cast<int>(col);
+        }
+    }
+    return -1;
+}
+
+Oid QueryResultSet::column_type(int column) const {
+    if (column < 0 || column >= column_count()) {
+        return InvalidOid;
+    }
+    return column_types_[static_cast<size_t>(column)];
+}
+
+std::string_view QueryResultSet::Row::get(int column) const {
+    if (column < 0 || column >= set_->column_count() || row_ < 0 || row_ >= set_->rows_) {
+        return {};
+    }
+    PGresult* result = set_->result_.get();
+    if (PQgetisnull(result, row_, column)) {
+        return {};
+    }
+    return std::string_view(PQgetvalue(result, row_, column),
+                            static_cast<size_t>(PQgetlength(result, row_, column)));
+}
+
+std::string_view QueryResultSet::Row::get(std::string_view column) const {
+    return get(set_->column_index(column));
+}
+
+bool QueryResultSet::Row::is_null(int column) const {
+    if (column < 0 || column >= set_->column_count() || row_ < 0 || row_ >= set_->rows_) {
+        return true;
+    }
+    return PQgetisnull(set_->result_.get(), row_, column) != 0;
+}
+
+bool QueryResultSet::Row::is_null(std::string_view column) const {
+    return is_null(set_->column_index(column));
+}
+
+std::string QueryResultSet::Row::get_string(std::string_view column, const std::string& default_value) const {
+    int index = set_->column_index(column);
+    if (is_null(index)) {
+        return default_value;
+    }
+    return std::string(get(index));
+}
+
+std::optional<long long> QueryResultSet::Row::get_int(std::string_view column) const {
+    auto value = get(column);
+    long long parsed = 0;
+    auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), parsed);
+    if (value.empty() || ec != std::errc() || ptr != value.data() + value.size()) {
+        return std::nullopt;
+    }
+    return parsed;
+}
+
+std::optional<double> QueryResultSet::Row::get_double(std::string_view column) const {
+    auto value = get(column);
+    if (value.empty()) {
+        return std::nullopt;
+    }
+    // PGresult values are NUL-terminated, so strtod can read in place
+    char* end = nullptr;
+    double parsed = std::strtod(value.data(), &end);
+    if (end != value.data() + value.size()) {
+        return std::nullopt;
+    }
+    return parsed;
+}
+
+std::optional<bool> QueryResultSet::Row::get_bool(std::string_view column) const {
+    auto value = get(column);
+    if (value == "t" || value == "true" || value == "1") {
+        return true;
+    }
+    if (value == "f" || value == "false" || value == "0") {
+        return false;
+    }
+    return std::nullopt;
+}
+
+/**
+ * RAII checkout of one physical connection for the duration of a statement.
+ */
+class PostgreSQLConnection::ConnectionLease {
+public:
+    explicit ConnectionLease(PostgreSQLConnection& owner)
+        : owner_(owner), physical_(owner.acquire_connection()) {}
+    ~ConnectionLease() {
+        if (physical_) {
+            owner_.release_connection(physical_);
+        }
+    }
+
+    ConnectionLease(const ConnectionLease&) = delete;
+    ConnectionLease& operator=(const ConnectionLease&) = delete;
+
+    PhysicalConnection* get() const { return physical_; }
+    explicit operator bool() const { return physical_ != nullptr; }
+
+private:
+    PostgreSQLConnection& owner_;
+    PhysicalConnection* physical_;
+};
+
 PostgreSQLConnection::PostgreSQLConnection(const DatabaseConfig& config)
     : config_(config), connection_(nullptr), connected_(false) {
 }
@@ -31,11 +226,31 @@ bool PostgreSQLConnection::connect() {
     }
 
     std::string conn_string = build_connection_string();
-    connection_ = PQconnectdb(conn_string.c_str());
+    const int requested = std::max(1, config_.connections_per_instance);
+
+    for (int i = 0; i < requested; ++i) {
+        PGconn* conn = PQconnectdb(conn_string.c_str());
+        if (PQstatus(conn) != CONNECTION_OK) {
+            log_error("connect", nullptr, conn);
+            PQfinish(conn);
+            if (physical_connections_.empty()) {
+                return false;
+            }
+            // Run with the connections we have rather than failing outright
+            break;
+        }
 
-    if (PQstatus(connection_) != CONNECTION_OK) {
-        log_error("connect");
-        return false;
+        auto physical = std::make_unique<PhysicalConnection>();
+        physical->conn = conn;
+        physical_connections_.push_back(std::move(physical));
+    }
+
+    connection_ = physical_connections_.front()->conn;
+
+    // With several connections the primary one is left to raw get_connection() users
+    size_t first_shared = physical_connections_.size() > 1 ? 1 : 0;
+    for (size_t i = first_shared; i < physical_connections_.size(); ++i) {
+        idle_connections_.push_back(physical_connections_[i].get());
     }
 
     connected_ = true;
@@ -43,13 +258,23 @@ bool PostgreSQLConnection::connect() {
 }
 
 void PostgreSQLConnection::disconnect() {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
+    std::unique_lock<std::mutex> lock(connection_mutex_);
 
-    if (connection_) {
-        PQfinish(connection_);
-        connection_ = nullptr;
-    }
     connected_ = false;
+    idle_cv_.notify_all();
+
+    // Let statements already running finish before their connections go away
+    idle_cv_.wait(lock, [this]() { return leased_connections_ == 0; });
+
+    for (auto& physical : physical_connections_) {
+        if (physical->conn) {
+            PQfinish(physical->conn);
+        }
+    }
+    physical_connections_.clear();
+    idle_connections_.clear();
+    pinned_connections_.clear();
+    connection_ = nullptr;
 }
 
 bool PostgreSQLConnection::is_connected() const {
@@ -61,24 +286,209 @@ bool PostgreSQLConnection::reconnect() {
     return connect();
 }
 
-std::optional<nlohmann::json> PostgreSQLConnection::execute_query_single(
-    const std::string& query, const std::vector<std::string>& params) {
-
-    std::lock_guard<std::mutex> lock(connection_mutex_);
+PostgreSQLConnection::PhysicalConnection* PostgreSQLConnection::acquire_connection() {
+    std::unique_lock<std::mutex> lock(connection_mutex_);
 
     if (!connected_) {
-        return std::nullopt;
+        return nullptr;
+    }
+
+    // A thread inside a transaction keeps talking to the connection that opened it
+    auto pinned = pinned_connections_.find(std::this_thread::get_id());
+    if (pinned != pinned_connections_.end()) {
+        leased_connections_++;
+        return pinned->second;
+    }
+
+    auto timeout = std::chrono::seconds(std::max(1, config_.connection_timeout));
+    if (!idle_cv_.wait_for(lock, timeout, [this]() { return !connected_ || !idle_connections_.empty(); }) ||
+        !connected_) {
+        if (connected_) {
+            log_error("acquire_connection: timed out waiting for an idle connection");
+        }
+        return nullptr;
+    }
+
+    PhysicalConnection* physical = idle_connections_.back();
+    idle_connections_.pop_back();
+    leased_connections_++;
+    return physical;
+}
+
+void PostgreSQLConnection::release_connection(PhysicalConnection* physical) {
+    // Whether the statement left a transaction open decides who may use the connection next
+    PGTransactionStatusType tx_status = PQtransactionStatus(physical->conn);
+    bool in_transaction = tx_status == PQTRANS_INTRANS || tx_status == PQTRANS_INERROR;
+
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex_);
+        leased_connections_--;
+
+        if (in_transaction && !physical->in_transaction) {
+            pinned_connections_[std::this_thread::get_id()] = physical;
+        } else if (!in_transaction && physical->in_transaction) {
+            pinned_connections_.erase(std::this_thread::get_id());
+        }
+        physical->in_transaction = in_transaction;
+
+        if (!in_transaction && connected_) {
+            idle_connections_.push_back(physical);
+        }
+    }
+    idle_cv_.notify_all();
+}
+
+const std::string* PostgreSQLConnection::cached_statement_name(PhysicalConnection& physical,
+                                                               const std::string& sql) {
+    auto it = physical.statement_names.find(sql);
+    if (it == physical.statement_names.end()) {
+        return nullptr;
+    }
+    physical.statement_lru.splice(physical.statement_lru.begin(), physical.statement_lru,
+                                  it->second.lru_position);
+    return &it->second.name;
+}
+
+void PostgreSQLConnection::evict_cached_statement(PhysicalConnection& physical, const std::string& sql) {
+    auto it = physical.statement_names.find(sql);
+    if (it == physical.statement_names.end()) {
+        return;
+    }
+    if (!it->second.name.empty()) {
+        PQclear(PQexec(physical.conn, ("DEALLOCATE " + it->second.name).c_str()));
+    }
+    physical.statement_lru.erase(it->second.lru_position);
+    physical.statement_names.erase(it);
+}
+
+void PostgreSQLConnection::clear_statement_cache(PhysicalConnection& physical) {
+    physical.statement_names.clear();
+    physical.statement_lru.clear();
+    physical.seen_once.clear();
+    physical.seen_once_order.clear();
+}
+
+const std::string* PostgreSQLConnection::prepared_name_for(PhysicalConnection& physical,
+                                                           const std::string& sql,
+                                                           int param_count) {
+    if (const std::string* cached = cached_statement_name(physical, sql)) {
+        if (cached->empty()) {
+            return nullptr;
+        }
+        prepared_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+        return cached;
+    }
+
+    // One-off dynamic SQL would pay PREPARE (and later DEALLOCATE) round trips for
+    // nothing, so text runs unprepared until it is seen a second time
+    const size_t sql_hash = std::hash<std::string>{}(sql);
+    if (physical.seen_once.erase(sql_hash) == 0) {
+        if (physical.seen_once_order.size() >= kMaxSeenOnceStatements) {
+            physical.seen_once.erase(physical.seen_once_order.front());
+            physical.seen_once_order.pop_front();
+        }
+        physical.seen_once.insert(sql_hash);
+        physical.seen_once_order.push_back(sql_hash);
+        return nullptr;
     }
 
+    if (physical.statement_names.size() >= kMaxCachedStatements) {
+        // DEALLOCATE cannot run in an aborted transaction; run unprepared until it ends
+        if (PQtransactionStatus(physical.conn) == PQTRANS_INERROR) {
+            return nullptr;
+        }
+        evict_cached_statement(physical, *physical.statement_lru.back());
+    }
+
+    std::string name;
+    if (is_preparable(sql)) {
+        name = "regulens_stmt_" + std::to_string(physical.next_statement_id++);
+        PGresult* result = PQprepare(physical.conn, name.c_str(), sql.c_str(), param_count, nullptr);
+        bool success = PQresultStatus(result) == PGRES_COMMAND_OK;
+        PQclear(result);
+
+        // A failed prepare is not cached: the unprepared path reports the real error
+        if (!success) {
+            return nullptr;
+        }
+        prepared_cache_misses_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto entry = physical.statement_names.emplace(sql, PhysicalConnection::CachedStatement{}).first;
+    physical.statement_lru.push_front(&entry->first);
+    entry->second.lru_position = physical.statement_lru.begin();
+    entry->second.name = std::move(name);
+    return entry->second.name.empty() ? nullptr : &entry->second.name;
+}
+
+PGresult* PostgreSQLConnection::execute_on(PhysicalConnection& physical,
+                                           const std::string& sql,
+                                           const std::vector<std::string>& params) {
     // Convert parameters to C-style strings
     std::vector<const char*> param_values;
+    param_values.reserve(params.size());
     for (const auto& param : params) {
         param_values.push_back(param.c_str());
     }
+    const int param_count = static_cast<int>(params.size());
+
+    PGresult* result = nullptr;
+    if (config_.prepared_statement_cache) {
+        if (const std::string* name = prepared_name_for(physical, sql, param_count)) {
+            std::string statement_name = *name;
+            result = PQexecPrepared(physical.conn, statement_name.c_str(), param_count,
+                                    param_values.data(), nullptr, nullptr, 0);
+
+            // Schema changes can invalidate a cached plan; outside a transaction
+            // it is safe to drop the statement and run the query unprepared
+            bool stale = has_sqlstate(result, kFeatureNotSupported) ||
+                         has_sqlstate(result, kInvalidStatementName);
+            if (stale && PQtransactionStatus(physical.conn) == PQTRANS_IDLE) {
+                PQclear(result);
+                result = nullptr;
+                evict_cached_statement(physical, sql);
+            }
+        }
+    }
 
-    PGresult* result = PQexecParams(connection_, query.c_str(),
-                                   static_cast<int>(params.size()),
-                                   nullptr, param_values.data(), nullptr, nullptr, 0);
+    if (!result) {
+        result = PQexecParams(physical.conn, sql.c_str(), param_count,
+                              nullptr, param_values.data(), nullptr, nullptr, 0);
+    }
+
+    check_connection_health(physical);
+    return result;
+}
+
+void PostgreSQLConnection::check_connection_health(PhysicalConnection& physical) {
+    if (PQstatus(physical.conn) != CONNECTION_BAD) {
+        return;
+    }
+
+    log_error("connection lost, resetting", nullptr, physical.conn);
+    PQreset(physical.conn);
+
+    // Server-side statements died with the old session
+    clear_statement_cache(physical);
+    physical.named_statements.clear();
+}
+
+PGresult* PostgreSQLConnection::run_statement(const std::string& sql,
+                                              const std::vector<std::string>& params) {
+    ConnectionLease lease(*this);
+    if (!lease) {
+        return nullptr;
+    }
+    return execute_on(*lease.get(), sql, params);
+}
+
+std::optional<nlohmann::json> PostgreSQLConnection::execute_query_single(
+    const std::string& query, const std::vector<std::string>& params) {
+
+    PGresult* result = run_statement(query, params);
+    if (!result) {
+        return std::nullopt;
+    }
 
     if (PQresultStatus(result) != PGRES_TUPLES_OK) {
         log_error("execute_query_single", result);
@@ -100,22 +510,12 @@ std::vector<nlohmann::json> PostgreSQLConnection::execute_query_multi(
     const std::string& query, const std::vector<std::string>& params) {
 
     std::vector<nlohmann::json> results;
-    std::lock_guard<std::mutex> lock(connection_mutex_);
 
-    if (!connected_) {
+    PGresult* result = run_statement(query, params);
+    if (!result) {
         return results;
     }
 
-    // Convert parameters to C-style strings
-    std::vector<const char*> param_values;
-    for (const auto& param : params) {
-        param_values.push_back(param.c_str());
-    }
-
-    PGresult* result = PQexecParams(connection_, query.c_str(),
-                                   static_cast<int>(params.size()),
-                                   nullptr, param_values.data(), nullptr, nullptr, 0);
-
     if (PQresultStatus(result) != PGRES_TUPLES_OK) {
         log_error("execute_query_multi", result);
         PQclear(result);
@@ -123,6 +523,7 @@ std::vector<nlohmann::json> PostgreSQLConnection::execute_query_multi(
     }
 
     int num_rows = PQntuples(result);
+    results.reserve(static_cast<size_t>(num_rows));
     for (int i = 0; i < num_rows; ++i) {
         results.push_back(result_to_json(result, i));
     }
@@ -135,75 +536,256 @@ PostgreSQLConnection::QueryResult PostgreSQLConnection::execute_query(
     const std::string& query, const std::vector<std::string>& params) {
 
     QueryResult result;
-    std::lock_guard<std::mutex> lock(connection_mutex_);
 
-    if (!connected_) {
+    QueryResultSet view = execute_query_view(query, params);
+    if (!view.ok()) {
         return result;
     }
 
-    // Convert parameters to C-style strings
-    std::vector<const char*> param_values;
-    for (const auto& param : params) {
-        param_values.push_back(param.c_str());
+    const auto& columns = view.column_names();
+    result.rows.reserve(view.size());
+    for (const auto& row : view) {
+        std::unordered_map<std::string, std::string> values;
+        values.reserve(columns.size());
+        for (int col = 0; col < static_cast<int>(columns.size()); ++col) {
+            values.emplace(columns[static_cast<size_t>(col)], std::string(row.get(col)));
+        }
+        result.rows.push_back(std::move(values));
     }
 
-    PGresult* pg_result = PQexecParams(connection_, query.c_str(),
-                                      static_cast<int>(params.size()),
-                                      nullptr, param_values.data(), nullptr, nullptr, 0);
+    return result;
+}
 
-    if (PQresultStatus(pg_result) != PGRES_TUPLES_OK) {
-        log_error("execute_query", pg_result);
-        PQclear(pg_result);
-        return result;
+QueryResultSet PostgreSQLConnection::execute_query_view(
+    const std::string& query, const std::vector<std::string>& params) {
+
+    PGresult* result = run_statement(query, params);
+    if (!result) {
+        return QueryResultSet(nullptr, false, connected_ ? "No database connection available" : "Not connected");
+    }
+
+    ExecStatusType status = PQresultStatus(result);
+    if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK) {
+        log_error("execute_query_view", result);
+        std::string error = PQresultErrorMessage(result);
+        PQclear(result);
+        return QueryResultSet(nullptr, false, std::move(error));
     }
 
-    int num_rows = PQntuples(pg_result);
-    int num_fields = PQnfields(pg_result);
+    return QueryResultSet(result, true, "");
+}
 
-    for (int i = 0; i < num_rows; ++i) {
-        std::unordered_map<std::string, std::string> row;
-        for (int j = 0; j < num_fields; ++j) {
-            const char* field_name = PQfname(pg_result, j);
-            if (PQgetisnull(pg_result, i, j)) {
-                row[field_name] = "";
-            } else {
-                const char* value = PQgetvalue(pg_result, i, j);
-                row[field_name] = std::string(value);
+bool PostgreSQLConnection::execute_command(
+    const std::string& command, const std::vector<std::string>& params) {
+
+    PGresult* result = run_statement(command, params);
+    if (!result) {
+        return false;
+    }
+
+    bool success = (PQresultStatus(result) == PGRES_COMMAND_OK);
+    if (!success) {
+        log_error("execute_command", result);
+    }
+
+    PQclear(result);
+    return success;
+}
+
+BatchResult PostgreSQLConnection::execute_batch(const StatementBatch& batch, BatchMode mode) {
+    BatchResult out;
+    out.results.reserve(batch.size());
+    if (batch.empty()) {
+        return out;
+    }
+
+    ConnectionLease lease(*this);
+    if (!lease) {
+        out.results.resize(batch.size());
+        out.failed = batch.size();
+        return out;
+    }
+
+    PhysicalConnection& physical = *lease.get();
+    if (!execute_batch_pipelined(physical, batch, mode, out)) {
+        execute_batch_sequential(physical, batch, mode, out);
+    }
+
+    // Statements that "succeeded" in a failed atomic batch were rolled back with it
+    if (mode == BatchMode::ATOMIC && out.failed > 0) {
+        for (auto& result : out.results) {
+            if (result.ok_) {
+                result.ok_ = false;
+                result.error_ = "Rolled back: another statement in the batch failed";
             }
         }
-        result.rows.push_back(row);
+        out.failed = out.results.size();
+        out.succeeded = 0;
     }
 
-    PQclear(pg_result);
-    return result;
+    check_connection_health(physical);
+    return out;
 }
 
-bool PostgreSQLConnection::execute_command(
-    const std::string& command, const std::vector<std::string>& params) {
+void PostgreSQLConnection::record_batch_result(PGresult* result, BatchResult& out) {
+    ExecStatusType status = result ? PQresultStatus(result) : PGRES_FATAL_ERROR;
+    if (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK) {
+        out.results.push_back(QueryResultSet(result, true, ""));
+        out.succeeded++;
+        return;
+    }
 
-    std::lock_guard<std::mutex> lock(connection_mutex_);
+    std::string error = "Connection lost during batch";
+#ifdef LIBPQ_HAS_PIPELINING
+    if (status == PGRES_PIPELINE_ABORTED) {
+        error = "Skipped: an earlier statement in the batch failed";
+    } else
+#endif
+    if (result) {
+        log_error("execute_batch", result);
+        error = PQresultErrorMessage(result);
+    }
 
-    if (!connected_) {
+    if (result) {
+        PQclear(result);
+    }
+    out.results.push_back(QueryResultSet(nullptr, false, std::move(error)));
+    out.failed++;
+}
+
+bool PostgreSQLConnection::execute_batch_pipelined(PhysicalConnection& physical,
+                                                   const StatementBatch& batch,
+                                                   BatchMode mode,
+                                                   BatchResult& out) {
+#ifdef LIBPQ_HAS_PIPELINING
+    PGconn* conn = physical.conn;
+    if (PQenterPipelineMode(conn) != 1) {
         return false;
     }
 
-    // Convert parameters to C-style strings
+    const auto& statements = batch.statements;
+    size_t sent = 0;
+    size_t received = 0;
+    bool broken = false;
+
     std::vector<const char*> param_values;
-    for (const auto& param : params) {
-        param_values.push_back(param.c_str());
+    while (received < statements.size() && !broken) {
+        // Send a window, then read its results before sending more so neither
+        // side blocks on a full socket buffer
+        size_t window_end = std::min(statements.size(), sent + kPipelineWindow);
+        for (; sent < window_end; ++sent) {
+            const auto& statement = statements[sent];
+            param_values.clear();
+            for (const auto& param : statement.params) {
+                param_values.push_back(param.c_str());
+            }
+            const int param_count = static_cast<int>(statement.params.size());
+
+            // Reuse statements this connection already prepared; new ones go unprepared
+            int queued = 0;
+            const std::string* cached = config_.prepared_statement_cache
+                                            ? cached_statement_name(physical, statement.sql)
+                                            : nullptr;
+            if (cached && !cached->empty()) {
+                prepared_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+                queued = PQsendQueryPrepared(conn, cached->c_str(), param_count,
+                                             param_values.data(), nullptr, nullptr, 0);
+            } else {
+                queued = PQsendQueryParams(conn, statement.sql.c_str(), param_count,
+                                           nullptr, param_values.data(), nullptr, nullptr, 0);
+            }
+
+            if (!queued || (mode == BatchMode::INDEPENDENT && PQpipelineSync(conn) != 1)) {
+                log_error("execute_batch: failed to queue statement", nullptr, conn);
+                broken = true;
+                break;
+            }
+        }
+
+        if (!broken && mode == BatchMode::ATOMIC) {
+            // One sync for the whole batch keeps it in a single implicit transaction
+            int flushed = sent == statements.size() ? PQpipelineSync(conn) : PQsendFlushRequest(conn);
+            broken = flushed != 1 || PQflush(conn) != 0;
+        } else if (!broken) {
+            broken = PQflush(conn) != 0;
+        }
+
+        for (; received < sent && !broken; ++received) {
+            PGresult* result = PQgetResult(conn);
+            if (!result) {
+                broken = true;
+                break;
+            }
+            record_batch_result(result, out);
+
+            // Each statement's results end with a NULL, followed by its sync in INDEPENDENT mode
+            while (PGresult* extra = PQgetResult(conn)) {
+                PQclear(extra);
+            }
+            if (mode == BatchMode::INDEPENDENT) {
+                PGresult* sync = PQgetResult(conn);
+                broken = !sync || PQresultStatus(sync) != PGRES_PIPELINE_SYNC;
+                if (sync) {
+                    PQclear(sync);
+                }
+            }
+        }
     }
 
-    PGresult* result = PQexecParams(connection_, command.c_str(),
-                                   static_cast<int>(params.size()),
-                                   nullptr, param_values.data(), nullptr, nullptr, 0);
+    if (!broken && mode == BatchMode::ATOMIC) {
+        PGresult* sync = PQgetResult(conn);
+        broken = !sync || PQresultStatus(sync) != PGRES_PIPELINE_SYNC;
+        if (sync) {
+            PQclear(sync);
+        }
+    }
 
-    bool success = (PQresultStatus(result) == PGRES_COMMAND_OK);
-    if (!success) {
-        log_error("execute_command", result);
+    if (broken) {
+        // The pipeline state is unknown; report the rest as failed and start a clean session
+        while (out.results.size() < statements.size()) {
+            record_batch_result(nullptr, out);
+        }
+        log_error("execute_batch: pipeline aborted, resetting connection", nullptr, conn);
+        PQreset(conn);
+        clear_statement_cache(physical);
+        physical.named_statements.clear();
+        return true;
     }
 
-    PQclear(result);
-    return success;
+    PQexitPipelineMode(conn);
+    return true;
+#else
+    (void)physical;
+    (void)batch;
+    (void)mode;
+    (void)out;
+    return false;
+#endif
+}
+
+void PostgreSQLConnection::execute_batch_sequential(PhysicalConnection& physical,
+                                                    const StatementBatch& batch,
+                                                    BatchMode mode,
+                                                    BatchResult& out) {
+    // Fallback when the client library or connection cannot pipeline
+    bool own_transaction = mode == BatchMode::ATOMIC &&
+                           PQtransactionStatus(physical.conn) == PQTRANS_IDLE;
+    if (own_transaction) {
+        PQclear(PQexec(physical.conn, "BEGIN"));
+    }
+
+    for (const auto& statement : batch.statements) {
+        if (mode == BatchMode::ATOMIC && out.failed > 0) {
+            out.results.push_back(QueryResultSet(nullptr, false, "Skipped: an earlier statement in the batch failed"));
+            out.failed++;
+            continue;
+        }
+        record_batch_result(execute_on(physical, statement.sql, statement.params), out);
+    }
+
+    if (own_transaction) {
+        PQclear(PQexec(physical.conn, out.failed > 0 ? "ROLLBACK" : "COMMIT"));
+    }
 }
 
 bool PostgreSQLConnection::begin_transaction() {
@@ -221,18 +803,28 @@ bool PostgreSQLConnection::rollback_transaction() {
 bool PostgreSQLConnection::prepare_statement(const std::string& name,
                                            const std::string& query,
                                            int param_count) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex_);
+        named_statement_definitions_[name] = {query, param_count};
+    }
 
-    if (!connected_) {
+    // Prepare on one connection now to surface errors; the others prepare lazily
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
-    PGresult* result = PQprepare(connection_, name.c_str(), query.c_str(),
+    PhysicalConnection& physical = *lease.get();
+    PGresult* result = PQprepare(physical.conn, name.c_str(), query.c_str(),
                                 param_count, nullptr);
 
     bool success = (PQresultStatus(result) == PGRES_COMMAND_OK);
-    if (!success) {
+    if (success) {
+        physical.named_statements.insert(name);
+    } else {
         log_error("prepare_statement", result);
+        std::lock_guard<std::mutex> lock(connection_mutex_);
+        named_statement_definitions_.erase(name);
     }
 
     PQclear(result);
@@ -241,61 +833,108 @@ bool PostgreSQLConnection::prepare_statement(const std::string& name,
 
 bool PostgreSQLConnection::execute_prepared(const std::string& name,
                                           const std::vector<std::string>& params) {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
+    std::pair<std::string, int> definition;
+    {
+        std::lock_guard<std::mutex> lock(connection_mutex_);
+        auto it = named_statement_definitions_.find(name);
+        if (it == named_statement_definitions_.end()) {
+            std::cerr << "[PostgreSQL Error] execute_prepared: unknown statement " << name << std::endl;
+            return false;
+        }
+        definition = it->second;
+    }
 
-    if (!connected_) {
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
+    PhysicalConnection& physical = *lease.get();
+    if (!physical.named_statements.count(name)) {
+        PGresult* prepared = PQprepare(physical.conn, name.c_str(), definition.first.c_str(),
+                                       definition.second, nullptr);
+        bool prepared_ok = PQresultStatus(prepared) == PGRES_COMMAND_OK;
+        if (!prepared_ok) {
+            log_error("execute_prepared", prepared);
+        }
+        PQclear(prepared);
+        if (!prepared_ok) {
+            return false;
+        }
+        physical.named_statements.insert(name);
+    }
+
     // Convert parameters to C-style strings
     std::vector<const char*> param_values;
     for (const auto& param : params) {
         param_values.push_back(param.c_str());
     }
 
-    PGresult* result = PQexecPrepared(connection_, name.c_str(),
+    PGresult* result = PQexecPrepared(physical.conn, name.c_str(),
                                      static_cast<int>(params.size()),
                                      param_values.data(), nullptr, nullptr, 0);
 
     bool success = (PQresultStatus(result) == PGRES_COMMAND_OK);
     if (!success) {
-        log_error("execute_prepared", result);
+        log_error("execute_prepared", result, physical.conn);
     }
 
     PQclear(result);
+    check_connection_health(physical);
     return success;
 }
 
 bool PostgreSQLConnection::ping() {
-    std::lock_guard<std::mutex> lock(connection_mutex_);
-
-    if (!connected_) {
+    ConnectionLease lease(*this);
+    if (!lease) {
         return false;
     }
 
-    PGresult* result = PQexec(connection_, "SELECT 1");
+    PhysicalConnection& physical = *lease.get();
+    PGresult* result = PQexec(physical.conn, "SELECT 1");
     bool success = (PQresultStatus(result) == PGRES_TUPLES_OK);
     PQclear(result);
+    check_connection_health(physical);
     return success;
 }
 
 PGconn* PostgreSQLConnection::get_connection() {
     std::lock_guard<std::mutex> lock(connection_mutex_);
-    
+
     if (!connected_) {
         return nullptr;
     }
-    
+
     return connection_;
 }
 
+PGconn* PostgreSQLConnection::open_dedicated_connection() const {
+    std::string conn_string = build_connection_string();
+    PGconn* conn = PQconnectdb(conn_string.c_str());
+    if (PQstatus(conn) != CONNECTION_OK) {
+        log_error("open_dedicated_connection", nullptr, conn);
+        PQfinish(conn);
+        return nullptr;
+    }
+    return conn;
+}
+
 nlohmann::json PostgreSQLConnection::get_connection_stats() const {
+    std::lock_guard<std::mutex> lock(connection_mutex_);
+
     return {
         {"connected", connected_.load()},
         {"host", config_.host},
         {"port", config_.port},
         {"database", config_.database},
-        {"user", config_.user}
+        {"user", config_.user},
+        {"pool_size", physical_connections_.size()},
+        {"idle_connections", idle_connections_.size()},
+        {"leased_connections", leased_connections_},
+        {"open_transactions", pinned_connections_.size()},
+        {"prepared_statement_cache", config_.prepared_statement_cache},
+        {"prepared_cache_hits", prepared_cache_hits_.load()},
+        {"prepared_cache_misses", prepared_cache_misses_.load()}
     };
 }
 
@@ -335,27 +974,32 @@ nlohmann::json PostgreSQLConnection::result_to_json(PGresult* result, int row) c
 }
 
 void PostgreSQLConnection::log_error(const std::string& operation,
-                                    PGresult* result) const {
-    std::cerr << "[PostgreSQL Error] " << operation << ": ";
+                                    PGresult* result,
+                                    PGconn* conn) const {
+    std::cerr << "[PostgreSQL Error] " << operation;
 
     if (result) {
-        std::cerr << PQresultErrorMessage(result);
-    } else {
-        std::cerr << PQerrorMessage(connection_);
+        std::cerr << ": " << PQresultErrorMessage(result);
+    } else if (conn) {
+        std::cerr << ": " << PQerrorMessage(conn);
     }
 
     std::cerr << std::endl;
 }
 
 int PostgreSQLConnection::get_pool_size() const {
-    // For individual connection, report 1 as pool size
-    // This method is primarily for ConnectionPool but provided here for API consistency
-    return 1;
+    std::lock_guard<std::mutex> lock(connection_mutex_);
+    return static_cast<int>(physical_connections_.size());
 }
 
 int PostgreSQLConnection::get_active_connections() const {
-    // For individual connection, report 1 if connected, 0 if not
-    return connected_.load() ? 1 : 0;
+    // Connections running a statement or held open by a transaction
+    std::lock_guard<std::mutex> lock(connection_mutex_);
+    if (!connected_) {
+        return 0;
+    }
+    size_t shared = physical_connections_.size() > 1 ? physical_connections_.size() - 1 : physical_connections_.size();
+    return static_cast<int>(shared - idle_connections_.size());
 }
 
 // Connection Pool Implementation
@@ -450,6 +1094,20 @@ void ConnectionPool::shutdown() {
     available_connections_.clear();
 }
 
+BatchResult ConnectionPool::execute_batch(const StatementBatch& batch, BatchMode mode) {
+    auto conn = get_connection();
+    if (!conn) {
+        BatchResult result;
+        result.results.resize(batch.size());
+        result.failed = batch.size();
+        return result;
+    }
+
+    auto result = conn->execute_batch(batch, mode);
+    return_connection(std::move(conn));
+    return result;
+}
+
 nlohmann::json ConnectionPool::get_pool_stats() const {
     return {
         {"total_connections", connections_.size()},
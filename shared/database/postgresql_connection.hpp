@@ -15,8 +15,13 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <list>
 #include <optional>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
 #include <condition_variable>
+#include <deque>
 #include <nlohmann/json.hpp>
 #include <libpq-fe.h>
 
@@ -30,6 +35,113 @@ typedef struct pg_result PGresult;
 
 namespace regulens {
 
+/**
+ * @brief Read-only view over a PostgreSQL result set
+ *
+ * Owns the PGresult and exposes rows as lightweight views into it. Column
+ * names are resolved once per result and no cell is copied until asked for,
+ * unlike QueryResult which builds a hashed map per row.
+ */
+class QueryResultSet {
+public:
+    class Row {
+    public:
+        // Empty for NULL or unknown columns
+        std::string_view get(std::string_view column) const;
+        std::string_view get(int column) const;
+        bool is_null(std::string_view column) const;
+        bool is_null(int column) const;
+
+        std::string get_string(std::string_view column, const std::string& default_value = "") const;
+        std::optional<long long> get_int(std::string_view column) const;
+        std::optional<double> get_double(std::string_view column) const;
+        std::optional<bool> get_bool(std::string_view column) const;
+
+        int index() const { return row_; }
+
+    private:
+        friend class QueryResultSet;
+        Row(const QueryResultSet* set, int row) : set_(set), row_(row) {}
+
+        const QueryResultSet* set_;
+        int row_;
+    };
+
+    class Iterator {
+    public:
+        Iterator(const QueryResultSet* set, int row) : set_(set), row_(row) {}
+        Row operator*() const { return Row(set_, row_); }
+        Iterator& operator++() { ++row_; return *this; }
+        bool operator!=(const Iterator& other) const { return row_ != other.row_; }
+
+    private:
+        const QueryResultSet* set_;
+        int row_;
+    };
+
+    QueryResultSet() = default;
+
+    bool ok() const { return ok_; }
+    const std::string& error() const { return error_; }
+
+    size_t size() const { return static_cast<size_t>(rows_); }
+    bool empty() const { return rows_ == 0; }
+    long long affected_rows() const { return affected_rows_; }
+
+    int column_count() const { return static_cast<int>(column_names_.size()); }
+    int column_index(std::string_view name) const; // -1 if the column does not exist
+    const std::vector<std::string>& column_names() const { return column_names_; }
+    Oid column_type(int column) const; // InvalidOid if the column does not exist
+
+    Row operator[](size_t row) const { return Row(this, static_cast<int>(row)); }
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, rows_); }
+
+private:
+    friend class PostgreSQLConnection;
+    QueryResultSet(PGresult* result, bool ok, std::string error);
+
+    std::shared_ptr<PGresult> result_;
+    std::vector<std::string> column_names_;
+    std::vector<Oid> column_types_;
+    int rows_ = 0;
+    long long affected_rows_ = 0;
+    bool ok_ = false;
+    std::string error_;
+};
+
+/**
+ * @brief Independent statements sent to the server in one pipelined round trip
+ */
+struct StatementBatch {
+    struct Statement {
+        std::string sql;
+        std::vector<std::string> params;
+    };
+
+    std::vector<Statement> statements;
+
+    void add(std::string sql, std::vector<std::string> params = {}) {
+        statements.push_back({std::move(sql), std::move(params)});
+    }
+    size_t size() const { return statements.size(); }
+    bool empty() const { return statements.empty(); }
+    void clear() { statements.clear(); }
+};
+
+enum class BatchMode {
+    INDEPENDENT, // Each statement commits or fails on its own
+    ATOMIC       // All statements share one transaction; any failure rolls back the batch
+};
+
+struct BatchResult {
+    std::vector<QueryResultSet> results; // One per statement, in submission order
+    size_t succeeded = 0;
+    size_t failed = 0;
+
+    bool ok() const { return failed == 0; }
+};
+
 class PostgreSQLConnection {
 public:
     PostgreSQLConnection() {
@@ -54,9 +166,14 @@ public:
     };
     QueryResult execute_query(const std::string& query,
                               const std::vector<std::string>& params = {});
+    QueryResultSet execute_query_view(const std::string& query,
+                                      const std::vector<std::string>& params = {});
     bool execute_command(const std::string& command,
                          const std::vector<std::string>& params = {});
 
+    // Pipelined execution: all statements are sent before any result is read
+    BatchResult execute_batch(const StatementBatch& batch, BatchMode mode = BatchMode::INDEPENDENT);
+
     // Transaction management
     bool begin_transaction();
     bool commit_transaction();
@@ -74,20 +191,72 @@ public:
     
     // Raw connection access for advanced operations
     PGconn* get_connection();
+
+    // New connection outside the pool, e.g. for LISTEN; the caller PQfinish()es it
+    PGconn* open_dedicated_connection() const;
     
-    // Pool-style methods for health monitoring (when used with ConnectionPool)
+    // Physical connections multiplexed by this instance (DatabaseConfig::connections_per_instance)
     int get_pool_size() const;
     int get_active_connections() const;
 
 private:
+    /**
+     * One libpq connection plus its prepared statement cache. With more than
+     * one physical connection, statements run concurrently on whichever is idle;
+     * the first connection is then reserved for raw get_connection() callers.
+     */
+    struct PhysicalConnection {
+        struct CachedStatement {
+            std::string name; // "" = not preparable
+            std::list<const std::string*>::iterator lru_position;
+        };
+
+        PGconn* conn = nullptr;
+        std::unordered_map<std::string, CachedStatement> statement_names; // keyed by SQL text
+        std::list<const std::string*> statement_lru;                      // statement_names keys, most recent first
+        std::unordered_set<std::string> named_statements;                 // prepare_statement() names prepared here
+        std::unordered_set<size_t> seen_once;                             // hashes of SQL run once, not yet prepared
+        std::deque<size_t> seen_once_order;                               // seen_once, oldest first (may hold promoted hashes)
+        uint64_t next_statement_id = 0;
+        bool in_transaction = false; // pinned to the thread that opened the transaction
+    };
+
+    class ConnectionLease;
+
     DatabaseConfig config_;
     PGconn* connection_;
     std::atomic<bool> connected_;
     mutable std::mutex connection_mutex_;
 
+    std::vector<std::unique_ptr<PhysicalConnection>> physical_connections_;
+    std::vector<PhysicalConnection*> idle_connections_;
+    std::unordered_map<std::thread::id, PhysicalConnection*> pinned_connections_; // open transactions
+    std::unordered_map<std::string, std::pair<std::string, int>> named_statement_definitions_;
+    std::condition_variable idle_cv_;
+    size_t leased_connections_ = 0;
+    std::atomic<uint64_t> prepared_cache_hits_{0};
+    std::atomic<uint64_t> prepared_cache_misses_{0};
+
+    PhysicalConnection* acquire_connection();
+    void release_connection(PhysicalConnection* physical);
+
+    PGresult* run_statement(const std::string& sql, const std::vector<std::string>& params);
+    PGresult* execute_on(PhysicalConnection& physical, const std::string& sql,
+                         const std::vector<std::string>& params);
+    bool execute_batch_pipelined(PhysicalConnection& physical, const StatementBatch& batch,
+                                 BatchMode mode, BatchResult& out);
+    void execute_batch_sequential(PhysicalConnection& physical, const StatementBatch& batch,
+                                  BatchMode mode, BatchResult& out);
+    void record_batch_result(PGresult* result, BatchResult& out);
+    const std::string* prepared_name_for(PhysicalConnection& physical, const std::string& sql, int param_count);
+    const std::string* cached_statement_name(PhysicalConnection& physical, const std::string& sql);
+    void evict_cached_statement(PhysicalConnection& physical, const std::string& sql);
+    static void clear_statement_cache(PhysicalConnection& physical);
+    void check_connection_health(PhysicalConnection& physical);
+
     std::string build_connection_string() const;
     nlohmann::json result_to_json(PGresult* result, int row = 0) const;
-    void log_error(const std::string& operation, PGresult* result = nullptr) const;
+    void log_error(const std::string& operation, PGresult* result = nullptr, PGconn* conn = nullptr) const;
 };
 
 class ConnectionPool {
@@ -99,6 +268,9 @@ public:
     void return_connection(std::shared_ptr<PostgreSQLConnection> conn);
     void shutdown();
 
+    // Runs the batch on a pooled connection and returns the connection afterwards
+    BatchResult execute_batch(const StatementBatch& batch, BatchMode mode = BatchMode::INDEPENDENT);
+
     nlohmann::json get_pool_stats() const;
 
 private:
@@ -26,6 +26,11 @@ EventBus::~EventBus() {
 }
 
 bool EventBus::initialize() {
+    if (running_.load()) {
+        logger_->log(LogLevel::WARN, "Event Bus already initialized");
+        return true;
+    }
+
     logger_->log(LogLevel::INFO, "Initializing Event Bus");
 
     try {
@@ -74,10 +79,8 @@ bool EventBus::initialize() {
             }
         }
 
-        // Start worker threads
-        set_worker_threads(4);  // Default to 4 worker threads
-
-        running_ = true;
+        // Create the dispatch shards, mark the bus running and start one worker per shard
+        start_workers();
 
         // Start background threads
         dead_letter_thread_ = std::thread(&EventBus::dead_letter_processing_loop, this);
@@ -93,21 +96,33 @@ bool EventBus::initialize() {
 }
 
 void EventBus::shutdown() {
-    if (!running_.load()) {
-        return;
+    // Publishers check running_ under the shared lock, so once the exclusive
+    // lock is released none is inside enqueue() and none will enter it. The
+    // shards are detached here and drained below without holding the lock, so
+    // a handler that publishes from a worker cannot deadlock the join.
+    std::vector<std::unique_ptr<DispatchShard>> shards;
+    {
+        std::unique_lock<std::shared_mutex> shards_lock(shards_mutex_);
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!running_.exchange(false)) {
+            return;
+        }
+        shards.swap(shards_);
     }
 
     logger_->log(LogLevel::INFO, "Shutting down Event Bus");
 
-    running_ = false;
-
     // Wake up all waiting threads
     queue_cv_.notify_all();
+    for (auto& shard : shards) {
+        shard->signal.fetch_add(1);
+        shard->signal.notify_all();
+    }
 
     // Join worker threads
-    for (auto& thread : worker_threads_) {
-        if (thread.joinable()) {
-            thread.join();
+    for (auto& shard : shards) {
+        if (shard->worker.joinable()) {
+            shard->worker.join();
         }
     }
 
@@ -121,11 +136,9 @@ void EventBus::shutdown() {
     }
 
     // Clear queues
+    shards.clear();
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
-        while (!event_queue_.empty()) {
-            event_queue_.pop();
-        }
         while (!dead_letter_queue_.empty()) {
             dead_letter_queue_.pop();
         }
@@ -140,50 +153,79 @@ void EventBus::set_worker_threads(size_t count) {
         return;
     }
 
-    worker_threads_.clear();
-    for (size_t i = 0; i < count; ++i) {
-        worker_threads_.emplace_back(&EventBus::event_processing_loop, this);
+    worker_count_ = std::max<size_t>(1, count);
+    logger_->log(LogLevel::INFO, "Configured " + std::to_string(worker_count_) + " worker threads");
+}
+
+void EventBus::start_workers() {
+    // Ring capacity is per shard; together they hold about max_queue_size_ events
+    size_t per_shard_capacity = std::max<size_t>(64, max_queue_size_ / worker_count_);
+
+    std::unique_lock<std::shared_mutex> shards_lock(shards_mutex_);
+    if (running_.load()) {
+        return; // already started; the live shards still have publishers and workers
+    }
+
+    // shutdown() detached any previous shards, so nothing else references these
+    shards_.clear();
+    for (size_t i = 0; i < worker_count_; ++i) {
+        shards_.push_back(std::make_unique<DispatchShard>(per_shard_capacity));
     }
 
-    logger_->log(LogLevel::INFO, "Configured " + std::to_string(count) + " worker threads");
+    // Shards must exist before publishers can see running_
+    running_ = true;
+    for (size_t i = 0; i < worker_count_; ++i) {
+        shards_[i]->worker = std::thread(&EventBus::event_processing_loop, this, std::ref(*shards_[i]));
+    }
 }
 
-bool EventBus::publish(std::unique_ptr<Event> event) {
-    if (!running_.load()) {
-        logger_->log(LogLevel::WARN, "Event Bus is not running, cannot publish event");
-        return false;
+size_t EventBus::shard_for(const Event& event) const {
+    if (partitioning_ == EventPartitioning::CORRELATION_ID && !event.get_correlation_id().empty()) {
+        return std::hash<std::string>{}(event.get_correlation_id()) % shards_.size();
     }
+    return std::hash<int>{}(static_cast<int>(event.get_category())) % shards_.size();
+}
 
-    if (!event) {
-        logger_->log(LogLevel::WARN, "Cannot publish null event");
-        return false;
-    }
+bool EventBus::enqueue(EventHandle event) {
+    auto& shard = *shards_[shard_for(*event)];
 
-    // Set event state to published
     event->set_state(EventState::PUBLISHED);
+    if (!shard.queue.try_push(event)) {
+        logger_->log(LogLevel::WARN, "Event queue full, dropping event: " + event->get_event_id());
+        events_failed_++;
+        return false;
+    }
+    events_published_++;
 
-    // Add to queue
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
+    // Dekker-style handshake with the worker's sleeping flag: only pay for a wake-up when it is idle
+    shard.signal.fetch_add(1);
+    if (shard.sleeping.load()) {
+        shard.signal.notify_one();
+    }
+    return true;
+}
 
-        // Check queue size limit
-        if (event_queue_.size() >= max_queue_size_) {
-            logger_->log(LogLevel::WARN, "Event queue full, dropping event: " + event->get_event_id());
-            events_failed_++;
-            return false;
-        }
+bool EventBus::publish(std::unique_ptr<Event> event) {
+    return publish(std::shared_ptr<Event>(std::move(event)));
+}
 
-        event_queue_.push(std::move(event));
-        events_published_++;
+bool EventBus::publish(std::shared_ptr<Event> event) {
+    if (!event) {
+        logger_->log(LogLevel::WARN, "Cannot publish null event");
+        return false;
     }
 
-    // Notify worker threads
-    queue_cv_.notify_one();
+    std::shared_lock<std::shared_mutex> shards_lock(shards_mutex_);
+    if (!running_.load()) {
+        logger_->log(LogLevel::WARN, "Event Bus is not running, cannot publish event");
+        return false;
+    }
 
-    return true;
+    return enqueue(std::move(event));
 }
 
 bool EventBus::publish_batch(std::vector<std::unique_ptr<Event>> events) {
+    std::shared_lock<std::shared_mutex> shards_lock(shards_mutex_);
     if (!running_.load()) {
         logger_->log(LogLevel::WARN, "Event Bus is not running, cannot publish batch");
         return false;
@@ -194,30 +236,14 @@ bool EventBus::publish_batch(std::vector<std::unique_ptr<Event>> events) {
     }
 
     size_t published_count = 0;
+    for (auto& event : events) {
+        if (!event) continue;
 
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex_);
-
-        for (auto& event : events) {
-            if (!event) continue;
-
-            // Check queue size limit
-            if (event_queue_.size() >= max_queue_size_) {
-                logger_->log(LogLevel::WARN, "Event queue full during batch publish, stopping batch");
-                break;
-            }
-
-            event->set_state(EventState::PUBLISHED);
-            event_queue_.push(std::move(event));
-            published_count++;
+        if (!enqueue(std::shared_ptr<Event>(std::move(event)))) {
+            logger_->log(LogLevel::WARN, "Event queue full during batch publish, stopping batch");
+            break;
         }
-
-        events_published_ += published_count;
-    }
-
-    // Notify worker threads
-    if (published_count > 0) {
-        queue_cv_.notify_all();
+        published_count++;
     }
 
     logger_->log(LogLevel::DEBUG, "Published batch of " + std::to_string(published_count) + " events");
@@ -244,7 +270,8 @@ bool EventBus::subscribe(
             return false;
         }
 
-        handlers_[handler_id] = std::make_pair(handler, std::move(filter));
+        handlers_[handler_id] = HandlerEntry{handler_id, handler, std::shared_ptr<EventFilter>(std::move(filter))};
+        rebuild_handler_snapshot();
     }
 
     logger_->log(LogLevel::INFO, "Subscribed event handler: " + handler_id);
@@ -260,6 +287,7 @@ bool EventBus::unsubscribe(const std::string& handler_id) {
     }
 
     handlers_.erase(it);
+    rebuild_handler_snapshot();
     logger_->log(LogLevel::INFO, "Unsubscribed event handler: " + handler_id);
     return true;
 }
@@ -270,6 +298,7 @@ void EventBus::register_stream_handler(
 ) {
     std::lock_guard<std::mutex> lock(stream_mutex_);
     stream_handlers_[stream_id] = handler;
+    rebuild_stream_snapshot();
     logger_->log(LogLevel::INFO, "Registered stream handler: " + stream_id);
 }
 
@@ -278,22 +307,69 @@ void EventBus::unregister_stream_handler(const std::string& stream_id) {
     auto it = stream_handlers_.find(stream_id);
     if (it != stream_handlers_.end()) {
         stream_handlers_.erase(it);
+        rebuild_stream_snapshot();
         logger_->log(LogLevel::INFO, "Unregistered stream handler: " + stream_id);
     }
 }
 
+void EventBus::rebuild_handler_snapshot() {
+    // Caller holds handlers_mutex_
+    auto snapshot = std::make_shared<HandlerList>();
+    snapshot->reserve(handlers_.size());
+    for (const auto& [handler_id, entry] : handlers_) {
+        snapshot->push_back(entry);
+    }
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    handler_snapshot_ = std::move(snapshot);
+}
+
+void EventBus::rebuild_stream_snapshot() {
+    // Caller holds stream_mutex_
+    auto snapshot = std::make_shared<StreamHandlerList>(stream_handlers_.begin(), stream_handlers_.end());
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    stream_snapshot_ = std::move(snapshot);
+}
+
 nlohmann::json EventBus::get_statistics() const {
+    std::shared_ptr<const HandlerList> handlers;
+    std::shared_ptr<const StreamHandlerList> streams;
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        handlers = handler_snapshot_;
+        streams = stream_snapshot_;
+    }
+
+    size_t dead_letter_size = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        dead_letter_size = dead_letter_queue_.size();
+    }
+
+    nlohmann::json shard_depths = nlohmann::json::array();
+    size_t shard_count = 0;
+    {
+        std::shared_lock<std::shared_mutex> shards_lock(shards_mutex_);
+        for (const auto& shard : shards_) {
+            shard_depths.push_back(shard->queue.size());
+        }
+        shard_count = shards_.size();
+    }
+
     return {
         {"events_published", events_published_.load()},
         {"events_processed", events_processed_.load()},
         {"events_failed", events_failed_.load()},
         {"events_expired", events_expired_.load()},
         {"events_dead_lettered", events_dead_lettered_.load()},
-        {"active_handlers", handlers_.size()},
-        {"stream_handlers", stream_handlers_.size()},
-        {"queue_size", event_queue_.size()},
-        {"dead_letter_queue_size", dead_letter_queue_.size()},
-        {"worker_threads", worker_threads_.size()}
+        {"active_handlers", handlers ? handlers->size() : 0},
+        {"stream_handlers", streams ? streams->size() : 0},
+        {"queue_size", get_pending_event_count()},
+        {"shard_queue_sizes", shard_depths},
+        {"partitioning", partitioning_ == EventPartitioning::CATEGORY ? "category" : "correlation_id"},
+        {"dead_letter_queue_size", dead_letter_size},
+        {"worker_threads", shard_count == 0 ? worker_count_ : shard_count}
     };
 }
 
@@ -307,15 +383,21 @@ void EventBus::reset_statistics() {
 }
 
 size_t EventBus::get_pending_event_count() const {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    return event_queue_.size();
+    std::shared_lock<std::shared_mutex> shards_lock(shards_mutex_);
+    size_t pending = 0;
+    for (const auto& shard : shards_) {
+        pending += shard->queue.size();
+    }
+    return pending;
 }
 
 size_t EventBus::get_processing_event_count() const {
-    // Production-grade tracking of events currently being processed
-    // Count events in PROCESSING state across all worker threads
-    std::lock_guard<std::mutex> lock(processing_mutex_);
-    return currently_processing_events_.size();
+    std::shared_lock<std::shared_mutex> shards_lock(shards_mutex_);
+    size_t processing = 0;
+    for (const auto& shard : shards_) {
+        processing += shard->in_flight.load(std::memory_order_relaxed);
+    }
+    return processing;
 }
 
 size_t EventBus::get_failed_event_count() const {
@@ -324,46 +406,43 @@ size_t EventBus::get_failed_event_count() const {
 
 // Private methods
 
-void EventBus::event_processing_loop() {
+void EventBus::event_processing_loop(DispatchShard& shard) {
     while (running_.load()) {
-        std::unique_ptr<Event> event;
-
-        // Get event from queue
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_cv_.wait(lock, [this]() {
-                return !running_.load() || !event_queue_.empty();
-            });
-
-            if (!running_.load()) {
-                break;
-            }
-
-            if (!event_queue_.empty()) {
-                event = std::move(event_queue_.front());
-                event_queue_.pop();
+        EventHandle event;
+        if (!shard.queue.try_pop(event)) {
+            // Sleep until a publisher bumps the signal; re-check after announcing so no wake-up is lost
+            uint64_t observed = shard.signal.load();
+            shard.sleeping.store(true);
+            if (shard.queue.empty() && running_.load()) {
+                shard.signal.wait(observed);
             }
+            shard.sleeping.store(false);
+            continue;
         }
 
-        if (event) {
-            try {
-                // Route the event to handlers
-                if (route_event(std::move(event))) {
-                    events_processed_++;
-                } else {
-                    events_failed_++;
-                }
-            } catch (const std::exception& e) {
-                logger_->log(LogLevel::ERROR, "Event processing error: " + std::string(e.what()));
+        shard.in_flight.fetch_add(1, std::memory_order_relaxed);
+        try {
+            // Route the event to handlers
+            if (route_event(std::move(event))) {
+                events_processed_++;
+            } else {
                 events_failed_++;
             }
+        } catch (const std::exception& e) {
+            logger_->log(LogLevel::ERROR, "Event processing error: " + std::string(e.what()));
+            events_failed_++;
         }
+        shard.in_flight.fetch_sub(1, std::memory_order_relaxed);
     }
 }
 
 void EventBus::dead_letter_processing_loop() {
     while (running_.load()) {
-        std::this_thread::sleep_for(std::chrono::seconds(30));  // Check every 30 seconds
+        {
+            // Check every 30 seconds, but wake immediately on shutdown
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait_for(lock, std::chrono::seconds(30), [this]() { return !running_.load(); });
+        }
 
         if (!running_.load()) {
             break;
@@ -379,7 +458,11 @@ void EventBus::dead_letter_processing_loop() {
 
 void EventBus::cleanup_expired_events_loop() {
     while (running_.load()) {
-        std::this_thread::sleep_for(std::chrono::minutes(5));  // Clean up every 5 minutes
+        {
+            // Clean up every 5 minutes, but wake immediately on shutdown
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait_for(lock, std::chrono::minutes(5), [this]() { return !running_.load(); });
+        }
 
         if (!running_.load()) {
             break;
@@ -454,7 +537,7 @@ void EventBus::cleanup_expired_events() {
     }
 }
 
-bool EventBus::route_event(std::unique_ptr<Event> event) {
+bool EventBus::route_event(EventHandle event) {
     if (!event) {
         return false;
     }
@@ -465,10 +548,17 @@ bool EventBus::route_event(std::unique_ptr<Event> event) {
 
     logger_->log(LogLevel::DEBUG, "Routing event: " + event->to_string());
 
-    // Send to stream handlers (real-time)
+    std::shared_ptr<const HandlerList> handlers;
+    std::shared_ptr<const StreamHandlerList> streams;
     {
-        std::lock_guard<std::mutex> lock(stream_mutex_);
-        for (const auto& [stream_id, handler] : stream_handlers_) {
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        handlers = handler_snapshot_;
+        streams = stream_snapshot_;
+    }
+
+    // Send to stream handlers (real-time)
+    if (streams) {
+        for (const auto& [stream_id, handler] : *streams) {
             try {
                 handler(*event);
             } catch (const std::exception& e) {
@@ -477,11 +567,15 @@ bool EventBus::route_event(std::unique_ptr<Event> event) {
         }
     }
 
+    // Every handler receives the same immutable event; no per-handler copy
+    std::shared_ptr<const Event> shared_event = event;
+
     // Route to registered handlers
-    {
-        std::lock_guard<std::mutex> lock(handlers_mutex_);
-        for (const auto& [handler_id, handler_pair] : handlers_) {
-            const auto& [handler, filter] = handler_pair;
+    if (handlers) {
+        for (const auto& entry : *handlers) {
+            const auto& handler_id = entry.handler_id;
+            const auto& handler = entry.handler;
+            const auto& filter = entry.filter;
 
             try {
                 // Check if handler is active
@@ -512,25 +606,8 @@ bool EventBus::route_event(std::unique_ptr<Event> event) {
 
                 logger_->log(LogLevel::DEBUG, "Handler " + handler_id + " will process event");
 
-                // Clone event for handler (since it might be processed by multiple handlers)
-                auto event_clone = std::make_unique<Event>(
-                    event->get_event_id(),
-                    event->get_category(),
-                    event->get_source(),
-                    event->get_event_type(),
-                    event->get_payload(),
-                    event->get_priority()
-                );
-
-                // Copy headers and metadata
-                for (const auto& [key, value] : event->get_headers()) {
-                    event_clone->add_header(key, value);
-                }
-                event_clone->set_correlation_id(event->get_correlation_id());
-                event_clone->set_trace_id(event->get_trace_id());
-
                 // Handle the event
-                handler->handle_event(std::move(event_clone));
+                handler->handle_event(shared_event);
                 routed = true;
 
                 logger_->log(LogLevel::DEBUG, "Routed event " + event->get_event_id() +
@@ -558,7 +635,8 @@ bool EventBus::route_event(std::unique_ptr<Event> event) {
 }
 
 void EventBus::process_dead_letter_queue() {
-    std::vector<std::unique_ptr<Event>> retry_events;
+    std::vector<EventHandle> retry_events;
+    StatementBatch failed_events;
 
     {
         std::lock_guard<std::mutex> lock(queue_mutex_);
@@ -573,69 +651,54 @@ void EventBus::process_dead_letter_queue() {
             } else {
                 // Event has exceeded retry limit or expired
                 event->set_state(EventState::FAILED);
-                persist_critical_event(*event);
+                append_event_upsert(failed_events, *event);
                 logger_->log(LogLevel::WARN, "Event moved to permanent failure: " + event->get_event_id());
             }
         }
     }
 
-    // Retry eligible events
+    // Written in one pipelined batch, outside queue_mutex_
+    persist_events(failed_events);
+
+    // Retry eligible events; like publish(), enqueue only under the shared lock
+    // while running, since shutdown() detaches the shards
     if (!retry_events.empty()) {
-        std::lock_guard<std::mutex> lock(queue_mutex_);
+        std::shared_lock<std::shared_mutex> shards_lock(shards_mutex_);
+        if (!running_.load()) {
+            logger_->log(LogLevel::WARN, "Event Bus is not running, dropping " +
+                         std::to_string(retry_events.size()) + " dead letter retries");
+            return;
+        }
+
+        size_t retried = 0;
         for (auto& event : retry_events) {
-            event_queue_.push(std::move(event));
+            retried += enqueue(std::move(event)) ? 1 : 0;
         }
-        logger_->log(LogLevel::INFO, "Retried " + std::to_string(retry_events.size()) + " events from dead letter queue");
+        logger_->log(LogLevel::INFO, "Retried " + std::to_string(retried) + " events from dead letter queue");
     }
 }
 
 void EventBus::persist_critical_event(const Event& event) {
-    if (!db_pool_) {
+    StatementBatch batch;
+    append_event_upsert(batch, event);
+    persist_events(batch);
+}
+
+void EventBus::persist_events(const StatementBatch& batch) {
+    if (!db_pool_ || batch.empty()) {
         return;  // No database, skip persistence
     }
 
     try {
-        auto conn = db_pool_->get_connection();
-        if (!conn) return;
-
-        std::string upsert_sql = R"(
-            INSERT INTO events (
-                event_id, category, source, event_type, payload, priority,
-                state, retry_count, created_at, expires_at, headers,
-                correlation_id, trace_id, processed_at
-            ) VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, $14)
-            ON CONFLICT (event_id) DO UPDATE SET
-                state = EXCLUDED.state,
-                retry_count = EXCLUDED.retry_count,
-                processed_at = EXCLUDED.processed_at
-        )";
-
-        auto created_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            event.get_created_at().time_since_epoch()).count();
-        auto expires_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            event.get_expires_at().time_since_epoch()).count();
-        auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::system_clock::now().time_since_epoch()).count();
-
-        std::vector<std::string> params = {
-            event.get_event_id(),
-            event_category_to_string(event.get_category()),
-            event.get_source(),
-            event.get_event_type(),
-            event.get_payload().dump(),
-            event_priority_to_string(event.get_priority()),
-            event_state_to_string(event.get_state()),
-            std::to_string(event.get_retry_count()),
-            std::to_string(created_ms),
-            std::to_string(expires_ms),
-            nlohmann::json(event.get_headers()).dump(),
-            event.get_correlation_id(),
-            event.get_trace_id(),
-            std::to_string(now_ms)
-        };
-
-        if (conn->execute_command(upsert_sql, params)) {
-            logger_->log(LogLevel::DEBUG, "Persisted critical event: " + event.get_event_id());
+        auto result = db_pool_->execute_batch(batch);
+        for (size_t i = 0; i < result.results.size(); ++i) {
+            const auto& event_id = batch.statements[i].params.front();
+            if (result.results[i].ok()) {
+                logger_->log(LogLevel::DEBUG, "Persisted critical event: " + event_id);
+            } else {
+                logger_->log(LogLevel::ERROR, "Failed to persist critical event " + event_id + ": " +
+                             result.results[i].error());
+            }
         }
 
     } catch (const std::exception& e) {
@@ -643,6 +706,44 @@ void EventBus::persist_critical_event(const Event& event) {
     }
 }
 
+void EventBus::append_event_upsert(StatementBatch& batch, const Event& event) {
+    static const std::string upsert_sql = R"(
+        INSERT INTO events (
+            event_id, category, source, event_type, payload, priority,
+            state, retry_count, created_at, expires_at, headers,
+            correlation_id, trace_id, processed_at
+        ) VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12, $13, $14)
+        ON CONFLICT (event_id) DO UPDATE SET
+            state = EXCLUDED.state,
+            retry_count = EXCLUDED.retry_count,
+            processed_at = EXCLUDED.processed_at
+    )";
+
+    auto created_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        event.get_created_at().time_since_epoch()).count();
+    auto expires_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        event.get_expires_at().time_since_epoch()).count();
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    batch.add(upsert_sql, {
+        event.get_event_id(),
+        event_category_to_string(event.get_category()),
+        event.get_source(),
+        event.get_event_type(),
+        event.get_payload().dump(),
+        event_priority_to_string(event.get_priority()),
+        event_state_to_string(event.get_state()),
+        std::to_string(event.get_retry_count()),
+        std::to_string(created_ms),
+        std::to_string(expires_ms),
+        nlohmann::json(event.get_headers()).dump(),
+        event.get_correlation_id(),
+        event.get_trace_id(),
+        std::to_string(now_ms)
+    });
+}
+
 std::vector<std::unique_ptr<Event>> EventBus::get_events(
     EventCategory category,
     std::chrono::system_clock::time_point since
@@ -7,7 +7,8 @@
  * Features:
  * - Publisher-subscriber pattern
  * - Event routing and filtering
- * - Asynchronous processing queues
+ * - Sharded lock-free dispatch queues with per-key ordering
+ * - Zero-copy fan-out of immutable events to handlers
  * - Dead letter queues for failed events
  * - Event persistence for critical events
  * - Real-time streaming capabilities
@@ -22,11 +23,13 @@
 #include <queue>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <atomic>
 #include <functional>
 #include <chrono>
 #include "event.hpp"
+#include "mpsc_ring_buffer.hpp"
 #include "../logging/structured_logger.hpp"
 #include "../database/postgresql_connection.hpp"
 #include "../metrics/metrics_collector.hpp"
@@ -36,7 +39,8 @@ namespace regulens {
 class EventHandler {
 public:
     virtual ~EventHandler() = default;
-    virtual void handle_event(std::unique_ptr<Event> event) = 0;
+    // The same immutable event is shared by every matching handler; keep the handle to retain it
+    virtual void handle_event(std::shared_ptr<const Event> event) = 0;
     virtual std::vector<EventCategory> get_supported_categories() const = 0;
     virtual std::string get_handler_id() const = 0;
     virtual bool is_active() const = 0;
@@ -96,6 +100,17 @@ private:
     std::vector<std::unique_ptr<EventFilter>> filters_;
 };
 
+/**
+ * @brief How published events are assigned to dispatch shards
+ *
+ * Events with the same key land on the same shard and are delivered in
+ * publish order; different keys are processed in parallel.
+ */
+enum class EventPartitioning {
+    CORRELATION_ID,  // Key on correlation id, falling back to category when it is unset
+    CATEGORY         // Key on category only
+};
+
 class EventBus {
 public:
     EventBus(
@@ -112,6 +127,7 @@ public:
 
     // Event publishing
     bool publish(std::unique_ptr<Event> event);
+    bool publish(std::shared_ptr<Event> event);
     bool publish_batch(std::vector<std::unique_ptr<Event>> events);
 
     // Event subscription
@@ -151,45 +167,86 @@ public:
     size_t get_failed_event_count() const;
     size_t get_queue_capacity() const { return max_queue_size_; }
 
-    // Configuration
+    // Configuration (queue size, workers and partitioning take effect at initialize())
     void set_max_queue_size(size_t size) { max_queue_size_ = size; }
     void set_worker_threads(size_t count);
+    void set_partitioning(EventPartitioning partitioning) { partitioning_ = partitioning; }
     void set_event_ttl(std::chrono::seconds ttl) { event_ttl_ = ttl; }
     void set_batch_size(size_t size) { batch_size_ = size; }
 
 private:
+    using EventHandle = std::shared_ptr<Event>;
+
+    struct HandlerEntry {
+        std::string handler_id;
+        std::shared_ptr<EventHandler> handler;
+        std::shared_ptr<EventFilter> filter;
+    };
+    using HandlerList = std::vector<HandlerEntry>;
+    using StreamHandlerList = std::vector<std::pair<std::string, std::function<void(const Event&)>>>;
+
+    /**
+     * One dispatch partition: a bounded MPSC ring drained by a single worker,
+     * which is what keeps events with the same key in order.
+     */
+    struct DispatchShard {
+        explicit DispatchShard(size_t capacity) : queue(capacity) {}
+
+        MpscRingBuffer<EventHandle> queue;
+        std::atomic<uint64_t> signal{0};    // bumped on publish; the worker waits on it when idle
+        std::atomic<bool> sleeping{false};
+        std::atomic<size_t> in_flight{0};
+        std::thread worker;
+    };
+
     // Event processing
-    void event_processing_loop();
+    void event_processing_loop(DispatchShard& shard);
     void dead_letter_processing_loop();
     void cleanup_expired_events_loop();
     void cleanup_expired_events();
 
-    bool route_event(std::unique_ptr<Event> event);
+    bool enqueue(EventHandle event); // caller holds shards_mutex_ shared and has seen running_
+    size_t shard_for(const Event& event) const;
+    void start_workers();
+    void rebuild_handler_snapshot();
+    void rebuild_stream_snapshot();
+
+    bool route_event(EventHandle event);
     void process_dead_letter_queue();
     void persist_critical_event(const Event& event);
+    void persist_events(const StatementBatch& batch);
+    static void append_event_upsert(StatementBatch& batch, const Event& event);
 
     // Internal data structures
     std::shared_ptr<ConnectionPool> db_pool_;
     StructuredLogger* logger_;
 
     std::atomic<bool> running_;
-    std::vector<std::thread> worker_threads_;
+    std::vector<std::unique_ptr<DispatchShard>> shards_;
+    // Publishers and readers hold it shared; start_workers/shutdown hold it
+    // exclusively to flip running_ and to create or destroy shards_
+    mutable std::shared_mutex shards_mutex_;
+    size_t worker_count_ = 4;
+    EventPartitioning partitioning_ = EventPartitioning::CORRELATION_ID;
     std::thread dead_letter_thread_;
     std::thread cleanup_thread_;
 
-    // Event queues
-    std::queue<std::unique_ptr<Event>> event_queue_;
-    std::queue<std::unique_ptr<Event>> dead_letter_queue_;
+    // Dead letter queue (rare path, plain mutex)
+    std::queue<EventHandle> dead_letter_queue_;
     mutable std::mutex queue_mutex_;  // Mutable to allow locking from const member functions
     std::condition_variable queue_cv_;
 
-    // Event routing
-    std::unordered_map<std::string, std::pair<std::shared_ptr<EventHandler>, std::unique_ptr<EventFilter>>> handlers_;
+    // Event routing: handlers_ is the source of truth; workers read immutable snapshots
+    std::unordered_map<std::string, HandlerEntry> handlers_;
     std::mutex handlers_mutex_;
+    std::shared_ptr<const HandlerList> handler_snapshot_;
 
     // Streaming handlers
     std::unordered_map<std::string, std::function<void(const Event&)>> stream_handlers_;
     std::mutex stream_mutex_;
+    std::shared_ptr<const StreamHandlerList> stream_snapshot_;
+
+    mutable std::mutex snapshot_mutex_;  // guards the two snapshot pointers only
 
     // Configuration
     size_t max_queue_size_;
@@ -203,10 +260,6 @@ private:
     std::atomic<size_t> events_expired_;
     std::atomic<size_t> events_dead_lettered_;
 
-    // Processing state tracking
-    mutable std::mutex processing_mutex_;
-    std::unordered_set<std::string> currently_processing_events_;
-
     // Database connection for persistence
     std::shared_ptr<PostgreSQLConnection> db_connection_;
 
@@ -225,7 +278,7 @@ public:
     LoggingEventHandler(StructuredLogger* logger, const std::string& handler_id)
         : logger_(logger), handler_id_(handler_id) {}
 
-    void handle_event(std::unique_ptr<Event> event) override {
+    void handle_event(std::shared_ptr<const Event> event) override {
         logger_->log(LogLevel::INFO, "Event received: " + event->to_string() +
                      " | Payload: " + event->get_payload().dump(2));
     }
@@ -252,7 +305,7 @@ public:
     MetricsEventHandler(StructuredLogger* logger, const std::string& handler_id)
         : logger_(logger), handler_id_(handler_id) {}
 
-    void handle_event(std::unique_ptr<Event> event) override {
+    void handle_event(std::shared_ptr<const Event> event) override {
         if (event->get_category() == EventCategory::SYSTEM_PERFORMANCE_METRIC) {
             // Process performance metrics
             const auto& payload = event->get_payload();
@@ -0,0 +1,110 @@
+/**
+ * MPSC Ring Buffer
+ *
+ * Bounded lock-free queue for many producers and a single consumer, used by
+ * the EventBus shards. Each slot carries a sequence number (Vyukov-style) so
+ * producers claim slots with one CAS and the consumer never takes a lock.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace regulens {
+
+template <typename T>
+class MpscRingBuffer {
+public:
+    explicit MpscRingBuffer(size_t min_capacity)
+        : capacity_(round_up_pow2(min_capacity < 2 ? 2 : min_capacity)),
+          mask_(capacity_ - 1),
+          slots_(std::make_unique<Slot[]>(capacity_)) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    /**
+     * @brief Enqueue from any thread
+     * @return false if the buffer is full; the value is left untouched
+     */
+    bool try_push(T& value) {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // consumer has not freed this slot yet
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Dequeue; must only be called from the single consumer thread
+     */
+    bool try_pop(T& value) {
+        Slot& slot = slots_[dequeue_pos_ & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeue_pos_ + 1) {
+            return false;
+        }
+
+        value = std::move(slot.value);
+        slot.value = T{};
+        slot.sequence.store(dequeue_pos_ + capacity_, std::memory_order_release);
+        ++dequeue_pos_;
+        consumed_.store(dequeue_pos_, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate when producers are active
+    size_t size() const {
+        size_t produced = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t consumed = consumed_.load(std::memory_order_relaxed);
+        return produced > consumed ? produced - consumed : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    static size_t round_up_pow2(size_t value) {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+
+    alignas(64) std::atomic<size_t> enqueue_pos_{0};
+    alignas(64) size_t dequeue_pos_ = 0;        // consumer-owned
+    std::atomic<size_t> consumed_{0};           // dequeue_pos_ published for size()
+};
+
+} // namespace regulens
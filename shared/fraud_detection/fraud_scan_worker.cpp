@@ -4,16 +4,43 @@
  */
 
 #include "fraud_scan_worker.hpp"
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <map>
 #include <vector>
 #include <sstream>
+#include <poll.h>
 
 namespace regulens {
 namespace fraud {
 
-FraudScanWorker::FraudScanWorker(PGconn* db_conn, const std::string& worker_id)
-    : db_conn_(db_conn), worker_id_(worker_id), running_(false) {
+namespace {
+
+constexpr const char* kJobChannel = "fraud_scan_jobs";
+
+// fraud_alerts rows per INSERT, keeping well under the 65535 bind parameter limit
+constexpr size_t kAlertInsertBatch = 1000;
+
+bool exec_command(PGconn* conn, const char* sql, std::string& error) {
+    PGresult* result = PQexec(conn, sql);
+    bool ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+    if (!ok) {
+        error = PQerrorMessage(conn);
+    }
+    PQclear(result);
+    return ok;
+}
+
+} // anonymous namespace
+
+FraudScanWorker::FraudScanWorker(PGconn* db_conn, const std::string& worker_id,
+                                 FraudScanOptions options)
+    : db_conn_(db_conn), worker_id_(worker_id), options_(options), running_(false) {
+    options_.chunk_size = std::max(1, options_.chunk_size);
+    if (options_.scoring_threads == 0) {
+        options_.scoring_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
 }
 
 FraudScanWorker::~FraudScanWorker() {
@@ -23,13 +50,14 @@ FraudScanWorker::~FraudScanWorker() {
 void FraudScanWorker::start() {
     running_ = true;
     worker_thread_ = std::thread([this]() {
+        listening_ = listen_for_jobs();
         while (running_) {
             auto job = claim_next_job();
             if (job.has_value()) {
                 process_job(job.value());
             } else {
-                // No jobs available, sleep before checking again
-                std::this_thread::sleep_for(std::chrono::seconds(5));
+                // No jobs available, block until one is queued
+                wait_for_jobs();
             }
         }
     });
@@ -42,26 +70,75 @@ void FraudScanWorker::stop() {
     }
 }
 
+bool FraudScanWorker::listen_for_jobs() {
+    // On failure the worker falls back to polling every idle_recheck_interval
+    std::string error;
+    std::string listen_sql = std::string("LISTEN ") + kJobChannel;
+    return exec_command(db_conn_, listen_sql.c_str(), error);
+}
+
+void FraudScanWorker::wait_for_jobs() {
+    // Wake on a notification, on stop(), or after idle_recheck_interval so
+    // jobs abandoned by a dead worker are still picked up
+    auto deadline = std::chrono::steady_clock::now() + options_.idle_recheck_interval;
+
+    while (running_ && std::chrono::steady_clock::now() < deadline) {
+        if (!listening_) {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            continue;
+        }
+
+        // Notifications can arrive while other queries run; check the backlog first
+        bool notified = false;
+        PQconsumeInput(db_conn_);
+        while (PGnotify* notify = PQnotifies(db_conn_)) {
+            PQfreemem(notify);
+            notified = true;
+        }
+        if (notified) {
+            return;
+        }
+
+        pollfd pfd{PQsocket(db_conn_), POLLIN, 0};
+        if (pfd.fd < 0) {
+            listening_ = false;
+            continue;
+        }
+        int rc = poll(&pfd, 1, 1000);
+        if (rc < 0 && errno != EINTR) {
+            listening_ = false;
+        }
+    }
+}
+
 std::optional<ScanJob> FraudScanWorker::claim_next_job() {
-    // Atomic job claiming using UPDATE ... RETURNING with FOR UPDATE SKIP LOCKED
+    // Atomic job claiming using UPDATE ... RETURNING with FOR UPDATE SKIP LOCKED.
+    // Jobs still 'processing' without a recent heartbeat belong to a worker that
+    // died and are resumed from their checkpoint.
     std::string worker_id_str = worker_id_;
-    const char* params[1] = {worker_id_str.c_str()};
+    std::string stale_seconds = std::to_string(options_.stale_job_timeout.count());
+    const char* params[2] = {worker_id_str.c_str(), stale_seconds.c_str()};
 
     PGresult* result = PQexecParams(db_conn_,
         "UPDATE fraud_scan_job_queue "
         "SET status = 'processing', "
         "    worker_id = $1, "
         "    claimed_at = NOW(), "
-        "    started_at = NOW() "
+        "    started_at = COALESCE(started_at, NOW()), "
+        "    heartbeat_at = NOW() "
         "WHERE job_id = ("
         "  SELECT job_id FROM fraud_scan_job_queue "
         "  WHERE status = 'queued' "
+        "     OR (status = 'processing' "
+        "         AND COALESCE(heartbeat_at, claimed_at) < NOW() - make_interval(secs => $2::int)) "
         "  ORDER BY priority DESC, created_at ASC "
         "  LIMIT 1 "
         "  FOR UPDATE SKIP LOCKED"
         ") "
-        "RETURNING job_id, filters, created_by",
-        1, NULL, params, NULL, NULL, 0);
+        "RETURNING job_id, filters, created_by, last_transaction_id, "
+        "          COALESCE(transactions_processed, 0), COALESCE(transactions_flagged, 0), "
+        "          COALESCE(transactions_total, 0)",
+        2, NULL, params, NULL, NULL, 0);
 
     if (PQresultStatus(result) != PGRES_TUPLES_OK || PQntuples(result) == 0) {
         PQclear(result);
@@ -80,103 +157,88 @@ std::optional<ScanJob> FraudScanWorker::claim_next_job() {
 
     job.created_by = PQgetvalue(result, 0, 2);
 
+    if (!PQgetisnull(result, 0, 3)) {
+        job.resume_after_transaction_id = PQgetvalue(result, 0, 3);
+        job.transactions_processed = std::atoi(PQgetvalue(result, 0, 4));
+        job.transactions_flagged = std::atoi(PQgetvalue(result, 0, 5));
+        job.transactions_total = std::atoi(PQgetvalue(result, 0, 6));
+    }
+
     PQclear(result);
     return job;
 }
 
 void FraudScanWorker::process_job(const ScanJob& job) {
     try {
-        // Build transaction query based on filters
-        std::string query = "SELECT transaction_id, amount, currency, from_account, to_account, "
-                           "       transaction_type, metadata "
-                           "FROM transactions "
-                           "WHERE 1=1";
-
         std::vector<std::string> param_values;
+        std::string filter_clause = build_filter_clause(job.filters, param_values);
 
-        // Apply filters
-        if (job.filters.contains("date_from")) {
-            query += " AND created_at >= $" + std::to_string(param_values.size() + 1);
-            param_values.push_back(job.filters["date_from"].get<std::string>());
-        }
-
-        if (job.filters.contains("date_to")) {
-            query += " AND created_at <= $" + std::to_string(param_values.size() + 1);
-            param_values.push_back(job.filters["date_to"].get<std::string>());
-        }
-
-        if (job.filters.contains("amount_min")) {
-            query += " AND amount >= $" + std::to_string(param_values.size() + 1);
-            param_values.push_back(std::to_string(job.filters["amount_min"].get<double>()));
-        }
-
-        if (job.filters.contains("amount_max")) {
-            query += " AND amount <= $" + std::to_string(param_values.size() + 1);
-            param_values.push_back(std::to_string(job.filters["amount_max"].get<double>()));
-        }
-
-        if (job.filters.contains("status")) {
-            query += " AND status = $" + std::to_string(param_values.size() + 1);
-            param_values.push_back(job.filters["status"].get<std::string>());
+        // Rules are loaded once per job and evaluated in memory
+        std::vector<FraudRule> rules;
+        std::string error;
+        if (!load_fraud_rules(rules, error)) {
+            finalize_job(job.job_id, false, "Failed to load fraud rules: " + error);
+            return;
         }
 
-        // Execute query to get transactions
-        std::vector<const char*> params;
-        for (const auto& val : param_values) {
-            params.push_back(val.c_str());
+        int processed = job.transactions_processed;
+        int flagged = job.transactions_flagged;
+        int total = job.transactions_total;
+        std::string last_txn_id = job.resume_after_transaction_id;
+
+        if (last_txn_id.empty()) {
+            // Fresh job: record the exact size of the scan
+            total = count_transactions(filter_clause, param_values);
+            std::string total_str = std::to_string(total);
+            const char* total_params[3] = {total_str.c_str(), job.job_id.c_str(), worker_id_.c_str()};
+            PGresult* update_total = PQexecParams(db_conn_,
+                "UPDATE fraud_scan_job_queue SET transactions_total = $1 WHERE job_id = $2 AND worker_id = $3",
+                3, NULL, total_params, NULL, NULL, 0);
+            PQclear(update_total);
         }
 
-        PGresult* txn_result = PQexecParams(db_conn_, query.c_str(),
-            params.size(), NULL, params.data(), NULL, NULL, 0);
-
-        if (PQresultStatus(txn_result) != PGRES_TUPLES_OK) {
-            std::string error = PQerrorMessage(db_conn_);
-            PQclear(txn_result);
-            finalize_job(job.job_id, false, "Query failed: " + error);
-            return;
-        }
+        // Stream the scan one chunk at a time; each chunk's alerts and the
+        // checkpoint commit together, so a resumed job neither skips nor repeats work
+        std::vector<ScanTransaction> chunk;
+        while (running_) {
+            if (!fetch_chunk(filter_clause, param_values, last_txn_id, chunk, error)) {
+                finalize_job(job.job_id, false, "Query failed: " + error);
+                return;
+            }
+            if (chunk.empty()) {
+                break;
+            }
 
-        int total_transactions = PQntuples(txn_result);
-        int processed = 0;
-        int flagged = 0;
-
-        // Update job with total count
-        std::string total_str = std::to_string(total_transactions);
-        const char* total_params[2] = {total_str.c_str(), job.job_id.c_str()};
-        PGresult* update_total = PQexecParams(db_conn_,
-            "UPDATE fraud_scan_job_queue SET transactions_total = $1 WHERE job_id = $2",
-            2, NULL, total_params, NULL, NULL, 0);
-        PQclear(update_total);
-
-        // Process each transaction
-        for (int i = 0; i < total_transactions; i++) {
-            std::string txn_id = PQgetvalue(txn_result, i, 0);
-            double amount = std::stod(PQgetvalue(txn_result, i, 1));
-            std::string currency = PQgetvalue(txn_result, i, 2);
-            std::string from_account = PQgetvalue(txn_result, i, 3);
-            std::string to_account = PQgetvalue(txn_result, i, 4);
-            std::string txn_type = PQgetvalue(txn_result, i, 5);
-
-            // Apply fraud detection rules
-            bool is_flagged = apply_fraud_rules(txn_id, amount, currency, from_account,
-                                               to_account, txn_type);
-
-            if (is_flagged) {
-                flagged++;
+            ChunkHits hits = score_chunk(chunk, rules);
+            int chunk_flagged = static_cast<int>(std::count_if(hits.begin(), hits.end(),
+                [](const auto& txn_hits) { return !txn_hits.empty(); }));
+
+            ChunkCommit committed = commit_chunk(job, chunk, hits, rules, processed + static_cast<int>(chunk.size()),
+                                                 flagged + chunk_flagged, total, error);
+            if (committed == ChunkCommit::NOT_OWNER) {
+                // Reclaimed by another worker after a missed heartbeat; it resumes
+                // from the last checkpoint, so this worker walks away without
+                // writing anything further
+                return;
+            }
+            if (committed == ChunkCommit::FAILED) {
+                finalize_job(job.job_id, false, "Checkpoint failed: " + error);
+                return;
             }
 
-            processed++;
+            processed += static_cast<int>(chunk.size());
+            flagged += chunk_flagged;
+            last_txn_id = chunk.back().txn_id;
 
-            // Update progress every 100 transactions
-            if (processed % 100 == 0) {
-                update_job_progress(job.job_id, processed, flagged);
+            if (chunk.size() < static_cast<size_t>(options_.chunk_size)) {
+                break;
             }
         }
 
-        PQclear(txn_result);
-
-        // Final progress update
-        update_job_progress(job.job_id, processed, flagged);
+        if (!running_) {
+            // Shutting down: leave the job 'processing' so it is resumed from the checkpoint
+            return;
+        }
 
         // Finalize job
         finalize_job(job.job_id, true);
@@ -186,43 +248,109 @@ void FraudScanWorker::process_job(const ScanJob& job) {
     }
 }
 
-void FraudScanWorker::update_job_progress(const std::string& job_id, int processed, int flagged) {
-    int progress = (processed * 100) / (processed + 1);  // Avoid division by zero
+std::string FraudScanWorker::build_filter_clause(const json& filters,
+                                                 std::vector<std::string>& param_values) const {
+    std::string clause = "WHERE 1=1";
 
-    std::string progress_str = std::to_string(progress);
-    std::string processed_str = std::to_string(processed);
-    std::string flagged_str = std::to_string(flagged);
+    if (filters.contains("date_from")) {
+        clause += " AND created_at >= $" + std::to_string(param_values.size() + 1);
+        param_values.push_back(filters["date_from"].get<std::string>());
+    }
+
+    if (filters.contains("date_to")) {
+        clause += " AND created_at <= $" + std::to_string(param_values.size() + 1);
+        param_values.push_back(filters["date_to"].get<std::string>());
+    }
 
-    const char* params[4] = {progress_str.c_str(), processed_str.c_str(),
-                            flagged_str.c_str(), job_id.c_str()};
+    if (filters.contains("amount_min")) {
+        clause += " AND amount >= $" + std::to_string(param_values.size() + 1);
+        param_values.push_back(std::to_string(filters["amount_min"].get<double>()));
+    }
 
-    PGresult* result = PQexecParams(db_conn_,
-        "UPDATE fraud_scan_job_queue "
-        "SET progress = $1, transactions_processed = $2, transactions_flagged = $3 "
-        "WHERE job_id = $4",
-        4, NULL, params, NULL, NULL, 0);
+    if (filters.contains("amount_max")) {
+        clause += " AND amount <= $" + std::to_string(param_values.size() + 1);
+        param_values.push_back(std::to_string(filters["amount_max"].get<double>()));
+    }
 
-    PQclear(result);
+    if (filters.contains("status")) {
+        clause += " AND status = $" + std::to_string(param_values.size() + 1);
+        param_values.push_back(filters["status"].get<std::string>());
+    }
+
+    return clause;
 }
 
-void FraudScanWorker::finalize_job(const std::string& job_id, bool success,
-                                  const std::string& error) {
-    std::string status = success ? "completed" : "failed";
+int FraudScanWorker::count_transactions(const std::string& filter_clause,
+                                        const std::vector<std::string>& param_values) {
+    std::string query = "SELECT COUNT(*) FROM transactions " + filter_clause;
 
-    const char* params[3] = {status.c_str(), error.c_str(), job_id.c_str()};
+    std::vector<const char*> params;
+    for (const auto& val : param_values) {
+        params.push_back(val.c_str());
+    }
 
-    PGresult* result = PQexecParams(db_conn_,
-        "UPDATE fraud_scan_job_queue "
-        "SET status = $1, error_message = $2, completed_at = NOW() "
-        "WHERE job_id = $3",
-        3, NULL, params, NULL, NULL, 0);
+    PGresult* result = PQexecParams(db_conn_, query.c_str(),
+        static_cast<int>(params.size()), NULL, params.data(), NULL, NULL, 0);
 
+    int total = 0;
+    if (PQresultStatus(result) == PGRES_TUPLES_OK && PQntuples(result) > 0) {
+        total = std::atoi(PQgetvalue(result, 0, 0));
+    }
     PQclear(result);
+    return total;
+}
+
+bool FraudScanWorker::fetch_chunk(const std::string& filter_clause,
+                                  const std::vector<std::string>& param_values,
+                                  const std::string& after_txn_id,
+                                  std::vector<ScanTransaction>& chunk,
+                                  std::string& error) {
+    chunk.clear();
+
+    // Keyset pagination on the primary key: every chunk is an index range
+    // scan, however deep into the job we are
+    std::vector<const char*> params;
+    for (const auto& val : param_values) {
+        params.push_back(val.c_str());
+    }
+
+    std::string query = "SELECT transaction_id, amount, currency, from_account, to_account, "
+                        "       transaction_type "
+                        "FROM transactions " + filter_clause;
+    if (!after_txn_id.empty()) {
+        query += " AND transaction_id > $" + std::to_string(params.size() + 1);
+        params.push_back(after_txn_id.c_str());
+    }
+    std::string limit_str = std::to_string(options_.chunk_size);
+    query += " ORDER BY transaction_id LIMIT $" + std::to_string(params.size() + 1);
+    params.push_back(limit_str.c_str());
+
+    PGresult* txn_result = PQexecParams(db_conn_, query.c_str(),
+        static_cast<int>(params.size()), NULL, params.data(), NULL, NULL, 0);
+
+    if (PQresultStatus(txn_result) != PGRES_TUPLES_OK) {
+        error = PQerrorMessage(db_conn_);
+        PQclear(txn_result);
+        return false;
+    }
+
+    int rows = PQntuples(txn_result);
+    chunk.resize(rows);
+    for (int i = 0; i < rows; i++) {
+        ScanTransaction& txn = chunk[i];
+        txn.txn_id = PQgetvalue(txn_result, i, 0);
+        txn.amount = std::stod(PQgetvalue(txn_result, i, 1));
+        txn.currency = PQgetvalue(txn_result, i, 2);
+        txn.from_account = PQgetvalue(txn_result, i, 3);
+        txn.to_account = PQgetvalue(txn_result, i, 4);
+        txn.txn_type = PQgetvalue(txn_result, i, 5);
+    }
+
+    PQclear(txn_result);
+    return true;
 }
 
-bool FraudScanWorker::apply_fraud_rules(const std::string& txn_id, double amount, const std::string& currency,
-                                       const std::string& from_account, const std::string& to_account,
-                                       const std::string& txn_type) {
+bool FraudScanWorker::load_fraud_rules(std::vector<FraudRule>& rules, std::string& error) {
     // Query active fraud rules (enabled rules)
     PGresult* rule_result = PQexec(db_conn_,
         "SELECT rule_id, rule_name, rule_definition, severity, rule_type "
@@ -230,70 +358,225 @@ bool FraudScanWorker::apply_fraud_rules(const std::string& txn_id, double amount
         "ORDER BY priority DESC");
 
     if (PQresultStatus(rule_result) != PGRES_TUPLES_OK) {
+        error = PQerrorMessage(db_conn_);
         PQclear(rule_result);
         return false;
     }
 
     int rule_count = PQntuples(rule_result);
-    bool flagged = false;
-
+    rules.clear();
+    rules.reserve(rule_count);
     for (int i = 0; i < rule_count; i++) {
-        std::string rule_id = PQgetvalue(rule_result, i, 0);
-        std::string rule_name = PQgetvalue(rule_result, i, 1);
-        std::string rule_definition = PQgetvalue(rule_result, i, 2);
-        std::string severity = PQgetvalue(rule_result, i, 3);
-        std::string rule_type = PQgetvalue(rule_result, i, 4);
-
-        // Evaluate rule based on type and definition
-        bool rule_triggered = evaluate_fraud_rule(rule_definition, rule_type, amount, currency,
-                                                 from_account, to_account, txn_type);
-
-        if (rule_triggered) {
-            // Create fraud alert
-            std::string alert_query =
-                "INSERT INTO fraud_alerts "
-                "(transaction_id, rule_id, severity, alert_status, flagged_amount, "
-                "flagged_currency, from_account, to_account, transaction_type, alert_message, "
-                "detected_at) "
-                "VALUES ($1, $2, $3, 'active', $4, $5, $6, $7, $8, $9, CURRENT_TIMESTAMP)";
-
-            std::string amount_str = std::to_string(amount);
-            std::string message = "Transaction flagged by rule: " + rule_name;
-
-            const char* alert_params[9] = {
-                txn_id.c_str(),
-                rule_id.c_str(),
-                severity.c_str(),
-                amount_str.c_str(),
-                currency.c_str(),
-                from_account.c_str(),
-                to_account.c_str(),
-                txn_type.c_str(),
-                message.c_str()
-            };
+        rules.push_back(FraudRule{
+            PQgetvalue(rule_result, i, 0),
+            PQgetvalue(rule_result, i, 1),
+            PQgetvalue(rule_result, i, 2),
+            PQgetvalue(rule_result, i, 3),
+            PQgetvalue(rule_result, i, 4)
+        });
+    }
+
+    PQclear(rule_result);
+    return true;
+}
+
+FraudScanWorker::ChunkHits FraudScanWorker::score_chunk(const std::vector<ScanTransaction>& chunk,
+                                                        const std::vector<FraudRule>& rules) const {
+    ChunkHits hits(chunk.size());
+
+    auto score_range = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const ScanTransaction& txn = chunk[i];
+            for (size_t r = 0; r < rules.size(); ++r) {
+                if (evaluate_fraud_rule(rules[r].rule_definition, rules[r].rule_type, txn.amount,
+                                        txn.currency, txn.from_account, txn.to_account, txn.txn_type)) {
+                    hits[i].push_back(r);
+                }
+            }
+        }
+    };
+
+    // Rule evaluation is pure CPU work; split the chunk across threads. Each
+    // thread writes only its own slice of hits.
+    size_t threads = std::min<size_t>(options_.scoring_threads, (chunk.size() + 255) / 256);
+    if (threads <= 1) {
+        score_range(0, chunk.size());
+        return hits;
+    }
+
+    size_t per_thread = (chunk.size() + threads - 1) / threads;
+    std::vector<std::thread> scorers;
+    scorers.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) {
+        size_t begin = std::min(chunk.size(), t * per_thread);
+        size_t end = std::min(chunk.size(), begin + per_thread);
+        scorers.emplace_back(score_range, begin, end);
+    }
+    score_range(0, std::min(chunk.size(), per_thread));
+    for (auto& scorer : scorers) {
+        scorer.join();
+    }
+
+    return hits;
+}
+
+FraudScanWorker::ChunkCommit FraudScanWorker::commit_chunk(const ScanJob& job,
+                                                          const std::vector<ScanTransaction>& chunk,
+                                                          const ChunkHits& hits,
+                                                          const std::vector<FraudRule>& rules,
+                                                          int processed, int flagged, int total,
+                                                          std::string& error) {
+    if (!exec_command(db_conn_, "BEGIN", error)) {
+        return ChunkCommit::FAILED;
+    }
+
+    auto rollback = [this](ChunkCommit outcome = ChunkCommit::FAILED) {
+        std::string ignored;
+        exec_command(db_conn_, "ROLLBACK", ignored);
+        return outcome;
+    };
+
+    // Checkpoint first: progress, counters, resume position and heartbeat.
+    // It only matches while this worker still owns the job, and the row lock
+    // it takes keeps the job from being reclaimed until the chunk commits
+    int progress = total > 0 ? std::min(100, static_cast<int>((static_cast<int64_t>(processed) * 100) / total)) : 0;
+    std::string progress_str = std::to_string(progress);
+    std::string processed_str = std::to_string(processed);
+    std::string flagged_str = std::to_string(flagged);
 
-            PGresult* alert_result = PQexecParams(db_conn_, alert_query.c_str(),
-                9, NULL, alert_params, NULL, NULL, 0);
-            PQclear(alert_result);
+    const char* params[6] = {progress_str.c_str(), processed_str.c_str(), flagged_str.c_str(),
+                             chunk.back().txn_id.c_str(), job.job_id.c_str(), worker_id_.c_str()};
 
-            // Update rule's alert count and last triggered time
-            std::string update_rule_query =
-                "UPDATE fraud_rules SET "
-                "alert_count = alert_count + 1, "
-                "last_triggered_at = CURRENT_TIMESTAMP "
-                "WHERE rule_id = $1";
+    PGresult* result = PQexecParams(db_conn_,
+        "UPDATE fraud_scan_job_queue "
+        "SET progress = $1, transactions_processed = $2, transactions_flagged = $3, "
+        "    last_transaction_id = $4, heartbeat_at = NOW() "
+        "WHERE job_id = $5 AND worker_id = $6 AND status = 'processing'",
+        6, NULL, params, NULL, NULL, 0);
+    bool ok = PQresultStatus(result) == PGRES_COMMAND_OK;
+    bool owned = ok && std::atoi(PQcmdTuples(result)) > 0;
+    if (!ok) {
+        error = PQerrorMessage(db_conn_);
+    }
+    PQclear(result);
+    if (!ok) {
+        return rollback();
+    }
+    if (!owned) {
+        return rollback(ChunkCommit::NOT_OWNER);
+    }
+
+    // Create fraud alerts, batched into multi-row inserts
+    struct AlertRow {
+        size_t txn;
+        size_t rule;
+    };
+    std::vector<AlertRow> alerts;
+    std::map<size_t, int> rule_alert_counts;
+    for (size_t i = 0; i < hits.size(); ++i) {
+        for (size_t r : hits[i]) {
+            alerts.push_back(AlertRow{i, r});
+            rule_alert_counts[r]++;
+        }
+    }
+
+    for (size_t start = 0; start < alerts.size(); start += kAlertInsertBatch) {
+        size_t end = std::min(alerts.size(), start + kAlertInsertBatch);
+
+        std::string alert_query =
+            "INSERT INTO fraud_alerts "
+            "(transaction_id, rule_id, severity, alert_status, flagged_amount, "
+            "flagged_currency, from_account, to_account, transaction_type, alert_message, "
+            "detected_at) VALUES ";
+
+        std::vector<std::string> values;
+        values.reserve((end - start) * 2);
+        std::vector<const char*> alert_params;
+        alert_params.reserve((end - start) * 9);
+
+        for (size_t a = start; a < end; ++a) {
+            const ScanTransaction& txn = chunk[alerts[a].txn];
+            const FraudRule& rule = rules[alerts[a].rule];
+            values.push_back(std::to_string(txn.amount));
+            values.push_back("Transaction flagged by rule: " + rule.rule_name);
+        }
+
+        for (size_t a = start; a < end; ++a) {
+            const ScanTransaction& txn = chunk[alerts[a].txn];
+            const FraudRule& rule = rules[alerts[a].rule];
+            size_t base = alert_params.size();
+            alert_query += (a == start ? "(" : ", (");
+            for (size_t p = 1; p <= 9; ++p) {
+                alert_query += "$" + std::to_string(base + p) + (p == 3 ? ", 'active', " : ", ");
+            }
+            alert_query += "CURRENT_TIMESTAMP)";
+
+            const std::string& amount_str = values[(a - start) * 2];
+            const std::string& message = values[(a - start) * 2 + 1];
+            alert_params.insert(alert_params.end(), {
+                txn.txn_id.c_str(),
+                rule.rule_id.c_str(),
+                rule.severity.c_str(),
+                amount_str.c_str(),
+                txn.currency.c_str(),
+                txn.from_account.c_str(),
+                txn.to_account.c_str(),
+                txn.txn_type.c_str(),
+                message.c_str()
+            });
+        }
 
-            const char* update_params[1] = {rule_id.c_str()};
-            PGresult* update_result = PQexecParams(db_conn_, update_rule_query.c_str(),
-                1, NULL, update_params, NULL, NULL, 0);
-            PQclear(update_result);
+        PGresult* alert_result = PQexecParams(db_conn_, alert_query.c_str(),
+            static_cast<int>(alert_params.size()), NULL, alert_params.data(), NULL, NULL, 0);
+        bool inserted = PQresultStatus(alert_result) == PGRES_COMMAND_OK;
+        if (!inserted) {
+            error = PQerrorMessage(db_conn_);
+        }
+        PQclear(alert_result);
+        if (!inserted) {
+            return rollback();
+        }
+    }
 
-            flagged = true;
+    // Update each triggered rule's alert count and last triggered time once per chunk
+    for (const auto& [rule_index, count] : rule_alert_counts) {
+        std::string count_str = std::to_string(count);
+        const char* update_params[2] = {count_str.c_str(), rules[rule_index].rule_id.c_str()};
+        PGresult* update_result = PQexecParams(db_conn_,
+            "UPDATE fraud_rules SET "
+            "alert_count = alert_count + $1, "
+            "last_triggered_at = CURRENT_TIMESTAMP "
+            "WHERE rule_id = $2",
+            2, NULL, update_params, NULL, NULL, 0);
+        // A failed statement aborts the transaction, and COMMIT would then roll it back while reporting success
+        bool updated = PQresultStatus(update_result) == PGRES_COMMAND_OK;
+        if (!updated) {
+            error = PQerrorMessage(db_conn_);
+        }
+        PQclear(update_result);
+        if (!updated) {
+            return rollback();
         }
     }
 
-    PQclear(rule_result);
-    return flagged;
+    return exec_command(db_conn_, "COMMIT", error) ? ChunkCommit::COMMITTED : ChunkCommit::FAILED;
+}
+
+void FraudScanWorker::finalize_job(const std::string& job_id, bool success,
+                                  const std::string& error) {
+    std::string status = success ? "completed" : "failed";
+
+    const char* params[4] = {status.c_str(), error.c_str(), job_id.c_str(), worker_id_.c_str()};
+
+    // A job reclaimed by another worker is left to that worker
+    PGresult* result = PQexecParams(db_conn_,
+        "UPDATE fraud_scan_job_queue "
+        "SET status = $1, error_message = $2, completed_at = NOW(), "
+        "    progress = CASE WHEN $1 = 'completed' THEN 100 ELSE progress END "
+        "WHERE job_id = $3 AND worker_id = $4 AND status = 'processing'",
+        4, NULL, params, NULL, NULL, 0);
+
+    PQclear(result);
 }
 
 bool FraudScanWorker::evaluate_fraud_rule(const std::string& rule_definition, const std::string& rule_type,
@@ -9,7 +9,9 @@
 #include <string>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <optional>
+#include <vector>
 #include <libpq-fe.h>
 #include <nlohmann/json.hpp>
 
@@ -25,15 +27,41 @@ struct ScanJob {
     std::string job_id;
     json filters;
     std::string created_by;
+
+    // Checkpoint of a job resumed after its previous worker stopped heartbeating
+    std::string resume_after_transaction_id;
+    int transactions_processed = 0;
+    int transactions_flagged = 0;
+    int transactions_total = 0;
+};
+
+/**
+ * Tuning for FraudScanWorker
+ */
+struct FraudScanOptions {
+    int chunk_size = 5000;                                  // transactions fetched and committed per step
+    unsigned int scoring_threads = 0;                       // 0 = hardware concurrency
+    std::chrono::seconds idle_recheck_interval{30};         // queue re-check without a notification
+    std::chrono::seconds stale_job_timeout{600};            // reclaim 'processing' jobs silent this long
 };
 
 /**
  * FraudScanWorker - Background worker for processing fraud scan jobs
  * Production-grade implementation with atomic job claiming and progress tracking
+ *
+ * Transactions are streamed in keyset-paginated chunks (ordered by
+ * transaction_id), scored in parallel, and each chunk's alerts are committed
+ * together with the job checkpoint, so memory stays bounded and a job whose
+ * worker dies is resumed from its last chunk by the next worker. Checkpoints
+ * and the final status only apply while worker_id still owns the job, so a
+ * worker whose job was reclaimed stops without writing alerts. Idle workers
+ * block on LISTEN fraud_scan_jobs rather than polling. The connection must be
+ * dedicated to the worker, since it holds the LISTEN registration.
  */
 class FraudScanWorker {
 public:
-    FraudScanWorker(PGconn* db_conn, const std::string& worker_id);
+    FraudScanWorker(PGconn* db_conn, const std::string& worker_id,
+                    FraudScanOptions options = FraudScanOptions{});
     ~FraudScanWorker();
 
     void start();
@@ -41,22 +69,59 @@ public:
     bool is_running() const { return running_; }
 
 private:
+    struct FraudRule {
+        std::string rule_id;
+        std::string rule_name;
+        std::string rule_definition;
+        std::string severity;
+        std::string rule_type;
+    };
+
+    struct ScanTransaction {
+        std::string txn_id;
+        double amount = 0.0;
+        std::string currency;
+        std::string from_account;
+        std::string to_account;
+        std::string txn_type;
+    };
+
+    // Indexes of the rules each transaction of a chunk triggered
+    using ChunkHits = std::vector<std::vector<size_t>>;
+
+    enum class ChunkCommit {
+        COMMITTED,
+        FAILED,
+        NOT_OWNER   // the job was reclaimed by another worker; nothing was written
+    };
+
     PGconn* db_conn_;
     std::string worker_id_;
+    FraudScanOptions options_;
     std::atomic<bool> running_;
     std::thread worker_thread_;
+    bool listening_ = false;
 
+    bool listen_for_jobs();
+    void wait_for_jobs();
     std::optional<ScanJob> claim_next_job();
     void process_job(const ScanJob& job);
-    void update_job_progress(const std::string& job_id, int processed, int flagged);
+    std::string build_filter_clause(const json& filters, std::vector<std::string>& param_values) const;
+    int count_transactions(const std::string& filter_clause, const std::vector<std::string>& param_values);
+    bool fetch_chunk(const std::string& filter_clause, const std::vector<std::string>& param_values,
+                     const std::string& after_txn_id, std::vector<ScanTransaction>& chunk,
+                     std::string& error);
+    bool load_fraud_rules(std::vector<FraudRule>& rules, std::string& error);
+    ChunkHits score_chunk(const std::vector<ScanTransaction>& chunk,
+                          const std::vector<FraudRule>& rules) const;
+    ChunkCommit commit_chunk(const ScanJob& job, const std::vector<ScanTransaction>& chunk,
+                             const ChunkHits& hits, const std::vector<FraudRule>& rules,
+                             int processed, int flagged, int total, std::string& error);
     void finalize_job(const std::string& job_id, bool success, const std::string& error = "");
-    bool apply_fraud_rules(const std::string& txn_id, double amount, const std::string& currency,
-                          const std::string& from_account, const std::string& to_account,
-                          const std::string& txn_type);
-    bool evaluate_fraud_rule(const std::string& rule_definition, const std::string& rule_type,
-                           double amount, const std::string& currency,
-                           const std::string& from_account, const std::string& to_account,
-                           const std::string& txn_type);
+    static bool evaluate_fraud_rule(const std::string& rule_definition, const std::string& rule_type,
+                                    double amount, const std::string& currency,
+                                    const std::string& from_account, const std::string& to_account,
+                                    const std::string& txn_type);
 };
 
 } // namespace fraud
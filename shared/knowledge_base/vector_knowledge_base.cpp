@@ -112,6 +112,22 @@ VectorKnowledgeBase::~VectorKnowledgeBase() {
 
 bool VectorKnowledgeBase::initialize(const VectorMemoryConfig& config) {
     config_ = config;
+
+    persistent_embedding_cache_.reset();
+    if (config_.enable_embedding_cache && !config_.persistent_embedding_cache_path.empty()) {
+        EmbeddingCacheConfig cache_config;
+        cache_config.path = config_.persistent_embedding_cache_path;
+        cache_config.max_entries = config_.persistent_embedding_cache_entries;
+
+        // Embeddings come from the hashing fallback; a new dimension is a new model
+        persistent_embedding_cache_ = std::make_unique<PersistentEmbeddingCache>(
+            cache_config, "semantic-hash-fallback/" + std::to_string(config_.embedding_dimensions));
+        std::string error;
+        if (!persistent_embedding_cache_->open(error)) {
+            spdlog::warn("Persistent embedding cache unavailable at {}: {}", cache_config.path, error);
+        }
+    }
+
     initialized_ = true;
     return true;
 }
@@ -336,6 +352,9 @@ std::vector<float> VectorKnowledgeBase::generate_embedding(const std::string& te
         return embedding;
     }
 
+    // The hashing fallback is cheaper than a cache lookup and exact, so it is
+    // never cached: an int8 copy would only lose precision, and persisting it
+    // would leave fallback vectors behind once a real model is configured
     static std::once_flag fallback_notice;
     std::call_once(fallback_notice, []() {
         spdlog::info("VectorKnowledgeBase is producing embeddings via deterministic semantic hashing fallback");
@@ -404,6 +423,119 @@ std::vector<float> VectorKnowledgeBase::generate_embedding(const std::string& te
     return embedding;
 }
 
+bool VectorKnowledgeBase::is_embedding_cached(const std::string& text_key) const {
+    std::lock_guard<std::mutex> lock(entity_cache_mutex_);
+    auto it = embedding_cache_.find(text_key);
+    return it != embedding_cache_.end() &&
+           std::chrono::system_clock::now() - it->second.cached_at < config_.embedding_cache_ttl;
+}
+
+std::vector<float> VectorKnowledgeBase::get_cached_embedding(const std::string& text_key) {
+    {
+        std::lock_guard<std::mutex> lock(entity_cache_mutex_);
+        auto it = embedding_cache_.find(text_key);
+        if (it != embedding_cache_.end()) {
+            if (std::chrono::system_clock::now() - it->second.cached_at < config_.embedding_cache_ttl) {
+                embedding_cache_lru_.splice(embedding_cache_lru_.begin(), embedding_cache_lru_,
+                                            it->second.lru_position);
+                return it->second.quantized.empty() ? it->second.values : it->second.quantized.decode();
+            }
+            erase_cached_embedding(text_key);
+        }
+    }
+
+    // Fall back to the persistent cache, which other processes may have filled
+    if (persistent_embedding_cache_) {
+        if (auto persisted = persistent_embedding_cache_->get(text_key)) {
+            cache_embedding_in_memory(text_key, *persisted);
+            return std::move(*persisted);
+        }
+    }
+
+    return {};
+}
+
+void VectorKnowledgeBase::cache_embedding(const std::string& text_key, const std::vector<float>& embedding) {
+    cache_embedding_in_memory(text_key, embedding);
+    if (persistent_embedding_cache_) {
+        persistent_embedding_cache_->put(text_key, embedding);
+    }
+}
+
+void VectorKnowledgeBase::cache_embedding_in_memory(const std::string& text_key, const std::vector<float>& embedding) {
+    std::lock_guard<std::mutex> lock(entity_cache_mutex_);
+    auto it = embedding_cache_.find(text_key);
+    if (it == embedding_cache_.end()) {
+        // Drop the least recently used entry to stay within the cache bound
+        if (embedding_cache_.size() >= static_cast<size_t>(MAX_EMBEDDING_CACHE_SIZE) &&
+            !embedding_cache_lru_.empty()) {
+            erase_cached_embedding(embedding_cache_lru_.back());
+        }
+        embedding_cache_lru_.push_front(text_key);
+        it = embedding_cache_.emplace(text_key, CachedEmbedding{}).first;
+        it->second.lru_position = embedding_cache_lru_.begin();
+    } else {
+        embedding_cache_lru_.splice(embedding_cache_lru_.begin(), embedding_cache_lru_, it->second.lru_position);
+    }
+
+    CachedEmbedding& entry = it->second;
+    if (config_.embedding_cache_quantization == VectorQuantization::NONE) {
+        entry.values = embedding;
+        entry.quantized = {};
+    } else {
+        entry.values.clear();
+        entry.quantized = Int8Embedding::encode(embedding);
+
+        // Keep a float sample so the cost of the int8 codes can be measured
+        size_t slot = embedding_cache_recall_sample_.size();
+        ++embedding_cache_sample_seen_;
+        if (slot >= EMBEDDING_CACHE_RECALL_SAMPLE_SIZE) {
+            slot = std::uniform_int_distribution<size_t>(0, embedding_cache_sample_seen_ - 1)(
+                embedding_cache_sample_rng_);
+        } else {
+            embedding_cache_recall_sample_.emplace_back();
+        }
+        if (slot < EMBEDDING_CACHE_RECALL_SAMPLE_SIZE) {
+            std::vector<float> unit = embedding;
+            vector_kernels::normalize(unit.data(), unit.size());
+            embedding_cache_recall_sample_[slot] = std::move(unit);
+        }
+    }
+    entry.cached_at = std::chrono::system_clock::now();
+}
+
+double VectorKnowledgeBase::measure_embedding_cache_recall(size_t k) {
+    std::vector<std::vector<float>> sample;
+    {
+        std::lock_guard<std::mutex> lock(entity_cache_mutex_);
+        if (config_.embedding_cache_quantization == VectorQuantization::NONE) {
+            return 1.0;
+        }
+        // Embeddings of another dimension (a model change) are left out
+        for (const auto& unit : embedding_cache_recall_sample_) {
+            if (sample.empty() || unit.size() == sample[0].size()) {
+                sample.push_back(unit);
+            }
+        }
+    }
+
+    double recall = int8_recall_at_k(sample, k);
+
+    std::lock_guard<std::mutex> lock(entity_cache_mutex_);
+    measured_cache_recall_ = recall;
+    measured_cache_recall_k_ = k;
+    return recall;
+}
+
+void VectorKnowledgeBase::erase_cached_embedding(const std::string& text_key) {
+    auto it = embedding_cache_.find(text_key);
+    if (it == embedding_cache_.end()) {
+        return;
+    }
+    embedding_cache_lru_.erase(it->second.lru_position);
+    embedding_cache_.erase(it);
+}
+
 std::chrono::system_clock::time_point VectorKnowledgeBase::parse_timestamp(const std::string& timestamp_str) {
     // Simple timestamp parsing - in production, use a proper date library
     std::tm tm = {};
@@ -565,7 +697,7 @@ bool VectorKnowledgeBase::delete_entity(const std::string& entity_id) {
             // Clean up indexes and cache
             remove_from_index(entity_id);
             entity_cache_.erase(entity_id);
-            embedding_cache_.erase(entity_id);
+            erase_cached_embedding(entity_id);
             total_entities_--;
         }
 
@@ -805,7 +937,7 @@ std::vector<std::string> VectorKnowledgeBase::cleanup_expired_memory(MemoryReten
 
             // Clean up caches and indexes
             entity_cache_.erase(entity_id);
-            embedding_cache_.erase(entity_id);
+            erase_cached_embedding(entity_id);
             remove_from_index(entity_id);
         }
 
@@ -862,6 +994,21 @@ nlohmann::json VectorKnowledgeBase::get_memory_statistics() const {
         // Cache statistics
         stats["cache"]["entity_cache_size"] = entity_cache_.size();
         stats["cache"]["embedding_cache_size"] = embedding_cache_.size();
+        stats["cache"]["embedding_cache_quantization"] =
+            vector_quantization_to_string(config_.embedding_cache_quantization);
+        {
+            std::lock_guard<std::mutex> lock(entity_cache_mutex_);
+            stats["cache"]["embedding_cache_recall"] =
+                config_.embedding_cache_quantization == VectorQuantization::NONE
+                    ? nlohmann::json{{"k", 10}, {"recall", 1.0}}
+                    : measured_cache_recall_
+                        ? nlohmann::json{{"k", measured_cache_recall_k_}, {"recall", *measured_cache_recall_},
+                                         {"sample_size", embedding_cache_recall_sample_.size()}}
+                        : nlohmann::json(nullptr);
+        }
+        if (persistent_embedding_cache_) {
+            stats["cache"]["persistent_embedding_cache"] = persistent_embedding_cache_->get_stats();
+        }
         stats["cache"]["total_searches"] = static_cast<int>(total_searches_);
         stats["cache"]["cache_hits"] = static_cast<int>(cache_hits_);
         stats["cache"]["cache_misses"] = static_cast<int>(cache_misses_);
@@ -872,6 +1019,13 @@ nlohmann::json VectorKnowledgeBase::get_memory_statistics() const {
 
     return stats;
 }
+
+void VectorKnowledgeBase::set_embedding_cache_redis_client(std::shared_ptr<RedisClient> redis_client) {
+    if (persistent_embedding_cache_) {
+        persistent_embedding_cache_->set_redis_client(std::move(redis_client));
+    }
+}
+
 bool VectorKnowledgeBase::learn_from_interaction(const std::string& query, const std::string& selected_entity_id, float reward) {
     if (!initialized_) return false;
 
@@ -1343,6 +1497,7 @@ bool VectorKnowledgeBase::optimize_storage() {
         if (entity_cache_.size() > static_cast<size_t>(MAX_EMBEDDING_CACHE_SIZE)) {
             entity_cache_.clear();
             embedding_cache_.clear();
+            embedding_cache_lru_.clear();
             logger_->log(LogLevel::INFO, "Cleared oversized caches during optimization");
         }
 
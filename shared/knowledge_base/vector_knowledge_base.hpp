@@ -11,7 +11,10 @@
 
 #pragma once
 
+#include <list>
 #include <memory>
+#include <optional>
+#include <random>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -22,6 +25,8 @@
 #include "../logging/structured_logger.hpp"
 #include <thread>
 #include "../agentic_brain/llm_interface.hpp"
+#include "../llm/vector_index.hpp"
+#include "../llm/embedding_cache.hpp"
 #include <nlohmann/json.hpp>
 
 namespace regulens {
@@ -114,6 +119,14 @@ struct VectorMemoryConfig {
     bool enable_auto_cleanup = true;
     bool enable_embedding_cache = true;
     std::chrono::seconds embedding_cache_ttl = std::chrono::seconds(3600);
+    // INT8 stores cached embeddings at a quarter of their float size, at the
+    // cost of precision (see measure_embedding_cache_recall()); entries are
+    // independent, so PRODUCT (which needs shared codebooks) is treated as INT8
+    VectorQuantization embedding_cache_quantization = VectorQuantization::NONE;
+    // Memory-mapped cache behind the in-memory one, shared by processes on the
+    // host and kept across restarts; empty path disables it
+    std::string persistent_embedding_cache_path = "./embedding_cache/knowledge_base.cache";
+    size_t persistent_embedding_cache_entries = 100000;
     int batch_indexing_size = 100;
     bool enable_incremental_updates = true;
 };
@@ -175,6 +188,12 @@ private:
     bool set_memory_policy(const std::string& entity_id, MemoryRetention policy);
     std::vector<std::string> cleanup_expired_memory(MemoryRetention policy = MemoryRetention::EPHEMERAL);
     nlohmann::json get_memory_statistics() const;
+    // Recall@k of the int8 embedding cache against the float embeddings it was
+    // given, on a sample; cached for get_memory_statistics()
+    double measure_embedding_cache_recall(size_t k = 10);
+
+    // Optional Redis tier behind the persistent embedding cache (after initialize())
+    void set_embedding_cache_redis_client(std::shared_ptr<RedisClient> redis_client);
 
     // Learning and Adaptation
     bool learn_from_interaction(const std::string& query, const std::string& selected_entity_id, float reward = 1.0f);
@@ -243,6 +262,8 @@ private:
     bool is_embedding_cached(const std::string& text_key) const;
     std::vector<float> get_cached_embedding(const std::string& text_key);
     void cache_embedding(const std::string& text_key, const std::vector<float>& embedding);
+    void cache_embedding_in_memory(const std::string& text_key, const std::vector<float>& embedding);
+    void erase_cached_embedding(const std::string& text_key);  // caller holds entity_cache_mutex_
 
     // Relationship Management
     bool store_relationship(const std::string& source_id,
@@ -275,8 +296,22 @@ private:
     // In-memory caches and indexes
     mutable std::mutex entity_cache_mutex_;
     std::unordered_map<std::string, KnowledgeEntity> entity_cache_;
-    std::unordered_map<std::string, std::vector<float>> embedding_cache_;
-    std::unordered_map<std::string, std::chrono::system_clock::time_point> embedding_cache_timestamps_;
+    struct CachedEmbedding {
+        std::vector<float> values;   // used when the cache is unquantized
+        Int8Embedding quantized;
+        std::chrono::system_clock::time_point cached_at;
+        std::list<std::string>::iterator lru_position;
+    };
+    std::unordered_map<std::string, CachedEmbedding> embedding_cache_;
+    std::list<std::string> embedding_cache_lru_;  // most recently used first
+    std::unique_ptr<PersistentEmbeddingCache> persistent_embedding_cache_;
+    // Reservoir sample of unit-length float embeddings entering a quantized
+    // cache, and the last measured recall; guarded by entity_cache_mutex_
+    std::vector<std::vector<float>> embedding_cache_recall_sample_;
+    size_t embedding_cache_sample_seen_ = 0;
+    std::mt19937 embedding_cache_sample_rng_{7};
+    std::optional<double> measured_cache_recall_;
+    size_t measured_cache_recall_k_ = 0;
 
     // Domain-specific indexes
     std::unordered_map<KnowledgeDomain, std::unordered_set<std::string>> domain_index_;
@@ -300,6 +335,7 @@ private:
     // Constants
     const std::string EMBEDDING_MODEL = "sentence-transformers/all-MiniLM-L6-v2";
     const int MAX_EMBEDDING_CACHE_SIZE = 10000;
+    const size_t EMBEDDING_CACHE_RECALL_SAMPLE_SIZE = 1024;
     const std::chrono::seconds CLEANUP_INTERVAL = std::chrono::seconds(300);
     const std::chrono::seconds LEARNING_INTERVAL = std::chrono::seconds(600);
 };
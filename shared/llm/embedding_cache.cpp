@@ -0,0 +1,451 @@
+/**
+ * Embedding Cache Implementation
+ */
+
+#include "embedding_cache.hpp"
+#include "../cache/redis_client.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <openssl/evp.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace regulens {
+
+namespace {
+
+constexpr uint64_t kCacheMagic = 0x3130434d45474552ULL;  // "REGEMC01"
+constexpr uint32_t kCacheVersion = 1;
+constexpr size_t kWays = 8;
+constexpr uint32_t kSlotEmpty = 0;
+constexpr uint32_t kSlotValid = 1;
+
+uint64_t fnv1a(const std::string& value) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (unsigned char c : value) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Holds flock() on the cache file for the lifetime of the guard
+class FileLock {
+public:
+    FileLock(int fd, int operation) : fd_(fd) { while (::flock(fd_, operation) != 0 && errno == EINTR) {} }
+    ~FileLock() { ::flock(fd_, LOCK_UN); }
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+private:
+    int fd_;
+};
+
+} // namespace
+
+struct PersistentEmbeddingCache::FileHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t dim;
+    uint64_t sets;
+    uint64_t model_fingerprint;
+    uint64_t clock;  // logical LRU clock, advanced atomically by every process
+    uint8_t reserved[24];
+};
+
+struct PersistentEmbeddingCache::SlotHeader {
+    uint64_t key[2];
+    uint64_t last_used;
+    uint32_t state;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(PersistentEmbeddingCache::ContentKey) == 16, "content key is 128 bits");
+
+PersistentEmbeddingCache::PersistentEmbeddingCache(EmbeddingCacheConfig config, std::string model_name)
+    : config_(std::move(config)), model_name_(std::move(model_name)), model_fingerprint_(fnv1a(model_name_)) {
+    config_.max_entries = std::max(config_.max_entries, kWays);
+    sets_ = (config_.max_entries + kWays - 1) / kWays;
+}
+
+PersistentEmbeddingCache::~PersistentEmbeddingCache() {
+    unmap_file();
+}
+
+PersistentEmbeddingCache::ContentKey PersistentEmbeddingCache::content_key(const std::string& text) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_Digest(text.data(), text.size(), digest, &length, EVP_sha256(), nullptr);
+
+    ContentKey key{};
+    std::memcpy(key.data(), digest, sizeof(key));
+    return key;
+}
+
+bool PersistentEmbeddingCache::open(std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mapping_) {
+        return true;
+    }
+
+    std::error_code ec;
+    if (!std::filesystem::exists(config_.path, ec)) {
+        return true;  // created on first put
+    }
+    if (!map_file(false, 0, error)) {
+        // Built for another model or geometry; replaced on first put
+        error.clear();
+    }
+    return true;
+}
+
+bool PersistentEmbeddingCache::map_file(bool create, size_t dim, std::string& error) {
+    namespace fs = std::filesystem;
+
+    auto header_matches = [&](const FileHeader& header) {
+        return header.magic == kCacheMagic && header.version == kCacheVersion &&
+               header.model_fingerprint == model_fingerprint_ && header.sets == sets_ &&
+               (dim == 0 || header.dim == dim);
+    };
+    auto slot_size_for = [](size_t d) {
+        return (sizeof(SlotHeader) + d * sizeof(float) + 63) & ~static_cast<size_t>(63);
+    };
+
+    // Adopt an existing file built for this model
+    auto open_matching = [&]() {
+        int existing = ::open(config_.path.c_str(), O_RDWR | O_CLOEXEC);
+        if (existing < 0) {
+            return -1;
+        }
+        FileHeader header{};
+        struct stat st{};
+        if (::pread(existing, &header, sizeof(header), 0) == static_cast<ssize_t>(sizeof(header)) &&
+            header_matches(header) && ::fstat(existing, &st) == 0 &&
+            static_cast<size_t>(st.st_size) >= sizeof(FileHeader) + header.sets * kWays * slot_size_for(header.dim)) {
+            dim = header.dim;
+            return existing;
+        }
+        ::close(existing);
+        return -1;
+    };
+
+    int fd = open_matching();
+    if (fd < 0) {
+        if (!create) {
+            error = "cache file does not match model " + model_name_;
+            return false;
+        }
+
+        // Creation is serialized across processes on a sidecar lock file, and
+        // the path is checked again under it: a process that lost the race
+        // adopts the winner's table instead of replacing it and leaving the
+        // winner writing to an orphaned file
+        std::error_code ec;
+        fs::create_directories(fs::path(config_.path).parent_path(), ec);
+        std::string lock_path = config_.path + ".lock";
+        int lock_fd = ::open(lock_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (lock_fd < 0) {
+            error = "cannot open " + lock_path + ": " + std::strerror(errno);
+            return false;
+        }
+        {
+            FileLock create_lock(lock_fd, LOCK_EX);
+            fd = open_matching();
+            if (fd < 0) {
+                fd = create_file(dim, error);
+            }
+        }
+        ::close(lock_fd);
+        if (fd < 0) {
+            return false;
+        }
+    }
+
+    size_t size = sizeof(FileHeader) + sets_ * kWays * slot_size_for(dim);
+    void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + config_.path + ": " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    mapping_ = mapping;
+    mapping_size_ = size;
+    dim_ = dim;
+    slot_size_ = slot_size_for(dim);
+    return true;
+}
+
+int PersistentEmbeddingCache::create_file(size_t dim, std::string& error) {
+    // Build the new table beside the old one and rename it into place, so
+    // processes still mapping the old file never see it truncated
+    std::string temp_path = config_.path + ".tmp." + std::to_string(::getpid());
+    int fd = ::open(temp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        error = "cannot create " + temp_path + ": " + std::strerror(errno);
+        return -1;
+    }
+
+    FileHeader header{};
+    header.magic = kCacheMagic;
+    header.version = kCacheVersion;
+    header.dim = static_cast<uint32_t>(dim);
+    header.sets = sets_;
+    header.model_fingerprint = model_fingerprint_;
+    size_t slot_size = (sizeof(SlotHeader) + dim * sizeof(float) + 63) & ~static_cast<size_t>(63);
+    size_t size = sizeof(FileHeader) + sets_ * kWays * slot_size;
+
+    // The table stays sparse until slots are written
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0 ||
+        ::pwrite(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        ::rename(temp_path.c_str(), config_.path.c_str()) != 0) {
+        error = "cannot initialize " + config_.path + ": " + std::strerror(errno);
+        ::close(fd);
+        ::unlink(temp_path.c_str());
+        return -1;
+    }
+    return fd;
+}
+
+void PersistentEmbeddingCache::unmap_file() {
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+PersistentEmbeddingCache::SlotHeader* PersistentEmbeddingCache::slot(size_t index) const {
+    auto* base = static_cast<char*>(mapping_) + sizeof(FileHeader);
+    return reinterpret_cast<SlotHeader*>(base + index * slot_size_);
+}
+
+float* PersistentEmbeddingCache::slot_data(size_t index) const {
+    return reinterpret_cast<float*>(reinterpret_cast<char*>(slot(index)) + sizeof(SlotHeader));
+}
+
+std::optional<std::vector<float>> PersistentEmbeddingCache::lookup_local(const ContentKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!mapping_) {
+        return std::nullopt;
+    }
+
+    FileLock file_lock(fd_, LOCK_SH);
+    auto* header = static_cast<FileHeader*>(mapping_);
+    size_t first = (key[0] % sets_) * kWays;
+    for (size_t way = 0; way < kWays; ++way) {
+        SlotHeader* entry = slot(first + way);
+        if (__atomic_load_n(&entry->state, __ATOMIC_ACQUIRE) != kSlotValid ||
+            entry->key[0] != key[0] || entry->key[1] != key[1]) {
+            continue;
+        }
+        std::vector<float> embedding(slot_data(first + way), slot_data(first + way) + dim_);
+        __atomic_store_n(&entry->last_used, __atomic_add_fetch(&header->clock, 1, __ATOMIC_RELAXED),
+                         __ATOMIC_RELAXED);
+        return embedding;
+    }
+    return std::nullopt;
+}
+
+bool PersistentEmbeddingCache::store_local(const ContentKey& key, const std::vector<float>& embedding) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!mapping_) {
+        std::string error;
+        if (!map_file(true, embedding.size(), error)) {
+            return false;
+        }
+    }
+    if (embedding.size() != dim_) {
+        return false;
+    }
+
+    FileLock file_lock(fd_, LOCK_EX);
+    auto* header = static_cast<FileHeader*>(mapping_);
+    size_t first = (key[0] % sets_) * kWays;
+
+    // Same key, else an empty way, else the least recently used way
+    size_t target = first;
+    uint64_t oldest = UINT64_MAX;
+    bool evicting = true;
+    for (size_t way = 0; way < kWays; ++way) {
+        SlotHeader* entry = slot(first + way);
+        if (entry->state == kSlotValid && entry->key[0] == key[0] && entry->key[1] == key[1]) {
+            target = first + way;
+            evicting = false;
+            break;
+        }
+        if (entry->state != kSlotValid) {
+            if (evicting) {
+                target = first + way;
+                evicting = false;
+                oldest = 0;
+            }
+            continue;
+        }
+        if (evicting && entry->last_used < oldest) {
+            oldest = entry->last_used;
+            target = first + way;
+        }
+    }
+    if (evicting) {
+        evictions_++;
+    }
+
+    // Readers in other processes only trust a slot once state is valid again
+    SlotHeader* entry = slot(target);
+    __atomic_store_n(&entry->state, kSlotEmpty, __ATOMIC_RELEASE);
+    entry->key[0] = key[0];
+    entry->key[1] = key[1];
+    std::memcpy(slot_data(target), embedding.data(), dim_ * sizeof(float));
+    entry->last_used = __atomic_add_fetch(&header->clock, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->state, kSlotValid, __ATOMIC_RELEASE);
+    return true;
+}
+
+std::string PersistentEmbeddingCache::redis_key(const ContentKey& key) const {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "embedding:%016llx:%016llx%016llx",
+                  static_cast<unsigned long long>(model_fingerprint_),
+                  static_cast<unsigned long long>(key[0]), static_cast<unsigned long long>(key[1]));
+    return buffer;
+}
+
+std::optional<std::vector<float>> PersistentEmbeddingCache::get(const std::string& text) {
+    return std::move(get_batch({text}).front());
+}
+
+std::vector<std::optional<std::vector<float>>> PersistentEmbeddingCache::get_batch(
+    const std::vector<std::string>& texts) {
+    std::vector<std::optional<std::vector<float>>> embeddings(texts.size());
+    std::vector<size_t> miss_indices;
+    std::vector<ContentKey> miss_keys;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        ContentKey key = content_key(texts[i]);
+        if ((embeddings[i] = lookup_local(key))) {
+            local_hits_++;
+            continue;
+        }
+        miss_indices.push_back(i);
+        miss_keys.push_back(key);
+    }
+
+    std::shared_ptr<RedisClient> redis_client;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        redis_client = redis_client_;
+    }
+    if (redis_client && !miss_keys.empty()) {
+        // One MGET for every local miss; absent keys come back empty
+        std::vector<std::string> redis_keys;
+        redis_keys.reserve(miss_keys.size());
+        for (const auto& key : miss_keys) {
+            redis_keys.push_back(redis_key(key));
+        }
+        auto result = redis_client->mget(redis_keys);
+        if (result.success && result.array_value && result.array_value->size() == miss_keys.size()) {
+            for (size_t j = 0; j < miss_keys.size(); ++j) {
+                const std::string& value = (*result.array_value)[j];
+                if (value.empty() || value.size() % sizeof(float) != 0) {
+                    continue;
+                }
+                std::vector<float> embedding(value.size() / sizeof(float));
+                std::memcpy(embedding.data(), value.data(), value.size());
+                store_local(miss_keys[j], embedding);
+                embeddings[miss_indices[j]] = std::move(embedding);
+                redis_hits_++;
+            }
+        }
+    }
+
+    for (size_t index : miss_indices) {
+        if (!embeddings[index]) {
+            misses_++;
+        }
+    }
+    return embeddings;
+}
+
+bool PersistentEmbeddingCache::put(const std::string& text, const std::vector<float>& embedding) {
+    return put_batch({text}, {embedding}) == 1;
+}
+
+size_t PersistentEmbeddingCache::put_batch(const std::vector<std::string>& texts,
+                                           const std::vector<std::vector<float>>& embeddings) {
+    std::vector<std::string> redis_keys;
+    std::vector<std::string> payloads;
+    size_t stored = 0;
+    for (size_t i = 0; i < texts.size() && i < embeddings.size(); ++i) {
+        const auto& embedding = embeddings[i];
+        if (embedding.empty()) {
+            continue;
+        }
+        ContentKey key = content_key(texts[i]);
+        if (store_local(key, embedding)) {
+            stored++;
+        }
+        redis_keys.push_back(redis_key(key));
+        payloads.emplace_back(reinterpret_cast<const char*>(embedding.data()), embedding.size() * sizeof(float));
+    }
+
+    std::shared_ptr<RedisClient> redis_client;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        redis_client = redis_client_;
+    }
+    if (!redis_client || redis_keys.empty()) {
+        return stored;
+    }
+
+    bool redis_stored = false;
+    if (redis_keys.size() == 1) {
+        redis_stored = redis_client->set(redis_keys.front(), payloads.front(), config_.redis_ttl).success;
+    } else {
+        // SET ... EX for every key in one round trip
+        static const std::string kSetAllScript =
+            "for i, key in ipairs(KEYS) do "
+            "redis.call('SET', key, ARGV[i], 'EX', ARGV[#KEYS + 1]) "
+            "end "
+            "return #KEYS";
+        payloads.push_back(std::to_string(config_.redis_ttl.count()));
+        redis_stored = redis_client->eval(kSetAllScript, redis_keys, payloads).success;
+    }
+    return redis_stored ? redis_keys.size() : stored;
+}
+
+void PersistentEmbeddingCache::set_redis_client(std::shared_ptr<RedisClient> redis_client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    redis_client_ = std::move(redis_client);
+}
+
+nlohmann::json PersistentEmbeddingCache::get_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t hits = local_hits_.load() + redis_hits_.load();
+    uint64_t lookups = hits + misses_.load();
+    return {
+        {"model", model_name_},
+        {"path", config_.path},
+        {"mapped", mapping_ != nullptr},
+        {"dimension", dim_},
+        {"capacity", sets_ * kWays},
+        {"file_bytes", mapping_size_},
+        {"redis_tier", redis_client_ != nullptr},
+        {"local_hits", local_hits_.load()},
+        {"redis_hits", redis_hits_.load()},
+        {"misses", misses_.load()},
+        {"evictions", evictions_.load()},
+        {"hit_rate", lookups > 0 ? static_cast<double>(hits) / lookups : 0.0}
+    };
+}
+
+} // namespace regulens
@@ -0,0 +1,109 @@
+/**
+ * Embedding Cache - Persistent, content-addressed embedding store
+ *
+ * Embeddings are keyed by the SHA-256 of the input text and live in a
+ * memory-mapped file, so they survive restarts and are shared by every
+ * process on the host that maps the same path. The file is a fixed-size,
+ * 8-way set-associative table: each set evicts its least recently used
+ * entry, which bounds the cache at max_entries. The file header records the
+ * model it was built for; opening it with a different model (or dimension)
+ * starts a fresh cache, so re-embedding only happens after a model change.
+ *
+ * An optional RedisClient tier sits behind the file for cross-host reuse:
+ * local misses are looked up in Redis and written back locally. Batched
+ * calls reach Redis in a single round trip.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace regulens {
+
+class RedisClient;
+
+struct EmbeddingCacheConfig {
+    std::string path = "./embedding_cache/embeddings.cache";
+    size_t max_entries = 100000;
+    std::chrono::seconds redis_ttl = std::chrono::hours(24 * 7);
+};
+
+class PersistentEmbeddingCache {
+public:
+    using ContentKey = std::array<uint64_t, 2>;  // first 128 bits of SHA-256
+
+    PersistentEmbeddingCache(EmbeddingCacheConfig config, std::string model_name);
+    ~PersistentEmbeddingCache();
+
+    PersistentEmbeddingCache(const PersistentEmbeddingCache&) = delete;
+    PersistentEmbeddingCache& operator=(const PersistentEmbeddingCache&) = delete;
+
+    /**
+     * @brief Map an existing cache file built for this model, if there is one.
+     * Otherwise the file is (re)created on the first put, once the dimension is known.
+     */
+    bool open(std::string& error);
+
+    std::optional<std::vector<float>> get(const std::string& text);
+    bool put(const std::string& text, const std::vector<float>& embedding);
+
+    /**
+     * @brief Batched get/put: the Redis tier costs one round trip per call
+     * (MGET for local misses, a scripted SET ... EX for writes)
+     */
+    std::vector<std::optional<std::vector<float>>> get_batch(const std::vector<std::string>& texts);
+    size_t put_batch(const std::vector<std::string>& texts, const std::vector<std::vector<float>>& embeddings);
+
+    void set_redis_client(std::shared_ptr<RedisClient> redis_client);
+
+    const std::string& model_name() const { return model_name_; }
+    nlohmann::json get_stats() const;
+
+    static ContentKey content_key(const std::string& text);
+
+private:
+    struct FileHeader;
+    struct SlotHeader;
+
+    bool map_file(bool create, size_t dim, std::string& error);
+    int create_file(size_t dim, std::string& error);
+    void unmap_file();
+    SlotHeader* slot(size_t index) const;
+    float* slot_data(size_t index) const;
+    std::optional<std::vector<float>> lookup_local(const ContentKey& key);
+    bool store_local(const ContentKey& key, const std::vector<float>& embedding);
+    std::string redis_key(const ContentKey& key) const;
+
+    EmbeddingCacheConfig config_;
+    std::string model_name_;
+    uint64_t model_fingerprint_;
+
+    // flock() serializes processes; it is owned per open file, so threads of
+    // one process also serialize on this mutex around every file access
+    mutable std::mutex mutex_;
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    size_t dim_ = 0;
+    size_t sets_ = 0;
+    size_t slot_size_ = 0;
+
+    std::shared_ptr<RedisClient> redis_client_;
+
+    // Statistics
+    std::atomic<uint64_t> local_hits_{0};
+    std::atomic<uint64_t> redis_hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+} // namespace regulens
@@ -1,12 +1,13 @@
 /**
  * FastEmbed Embeddings Client Implementation
  *
- * Production-grade implementation of embeddings client with FastEmbed integration
- * and fallback mechanisms for robust operation.
+ * Production-grade implementation of embeddings client with local ONNX Runtime
+ * inference and fallback mechanisms for robust operation.
  */
 
 #include "embeddings_client.hpp"
 #include <algorithm>
+#include <cctype>
 #include <cmath>
 #include <random>
 #include <sstream>
@@ -14,13 +15,16 @@
 #include <chrono>
 #include <fstream>
 
-// FastEmbed integration (conditional compilation)
-#ifdef USE_FASTEMBED
-#include <fastembed/fastembed.hpp>
-#endif
-
 namespace regulens {
 
+namespace {
+
+// Backoff before a failed local model load is attempted again
+constexpr std::chrono::seconds MODEL_LOAD_RETRY_BASE{5};
+constexpr std::chrono::seconds MODEL_LOAD_RETRY_MAX{300};
+
+} // namespace
+
 // EmbeddingsClient Implementation
 
 EmbeddingsClient::EmbeddingsClient(std::shared_ptr<ConfigurationManager> config,
@@ -64,25 +68,8 @@ bool EmbeddingsClient::initialize() {
         return false;
     }
 
-#ifdef USE_FASTEMBED
-    if (!initialize_fastembed()) {
-        if (logger_) {
-            logger_->error("FastEmbed initialization failed - embeddings service unavailable",
-                          "EmbeddingsClient", "initialize");
-        }
-        if (error_handler_) {
-            error_handler_->report_error(ErrorInfo{
-                ErrorCategory::CONFIGURATION,
-                ErrorSeverity::HIGH,
-                "EmbeddingsClient",
-                "initialize",
-                "FastEmbed initialization failed",
-                "Embeddings functionality will be unavailable"
-            });
-        }
-        return false; // Cannot continue without proper embeddings
-    }
-#endif
+    // A missing model is not fatal here: requests report it until one is installed
+    initialize_local_backend();
 
     return true;
 }
@@ -92,7 +79,7 @@ void EmbeddingsClient::shutdown() {
         logger_->info("Shutting down EmbeddingsClient", "EmbeddingsClient", "shutdown");
     }
 
-    cleanup_fastembed();
+    cleanup_local_backend();
 }
 
 std::optional<EmbeddingResponse> EmbeddingsClient::generate_embeddings(const EmbeddingRequest& request) {
@@ -109,81 +96,74 @@ std::optional<EmbeddingResponse> EmbeddingsClient::generate_embeddings(const Emb
 
         EmbeddingResponse response;
         response.model_used = request.model_name;
+        response.embeddings.resize(request.texts.size());
+
+        // Serve what we can from the persistent cache; only misses reach the model.
+        // Cached vectors are unit length, so unnormalized requests bypass it.
+        auto cache = request.normalize ? get_or_create_cache(request.model_name) : nullptr;
+        std::vector<size_t> miss_indices;
+        std::vector<std::string> miss_texts;
+        std::vector<std::optional<std::vector<float>>> cached;
+        if (cache) {
+            cached = cache->get_batch(request.texts);
+        }
+        for (size_t i = 0; i < request.texts.size(); ++i) {
+            if (i < cached.size() && cached[i]) {
+                response.embeddings[i] = std::move(*cached[i]);
+                continue;
+            }
+            miss_indices.push_back(i);
+            miss_texts.push_back(request.texts[i]);
+        }
 
-#ifdef USE_FASTEMBED
-        // Use FastEmbed implementation
-        auto model = get_or_create_model(request.model_name);
-        if (model) {
-            // FastEmbed batch processing
-            std::vector<std::vector<float>> embeddings;
-
-            // Process in batches for memory efficiency
-            size_t batch_size = model_config_.batch_size;
-            for (size_t i = 0; i < request.texts.size(); i += batch_size) {
-                size_t end_idx = std::min(i + batch_size, request.texts.size());
-                std::vector<std::string> batch(request.texts.begin() + i,
-                                             request.texts.begin() + end_idx);
-
-                // Generate embeddings using FastEmbed API
-                std::vector<std::vector<float>> batch_embeddings;
-                if (!generate_fastembed_embeddings(model, batch, batch_embeddings)) {
-                    if (logger_) {
-                        logger_->error("Failed to generate embeddings using FastEmbed",
-                                      "EmbeddingsClient", "generate_embeddings");
-                    }
-                    if (error_handler_) {
-                        error_handler_->report_error(ErrorInfo{
-                            ErrorCategory::EXTERNAL_API,
-                            ErrorSeverity::HIGH,
-                            "EmbeddingsClient",
-                            "generate_embeddings",
-                            "FastEmbed embedding generation failed",
-                            "model: " + request.model_name
-                        });
-                    }
-                    return std::nullopt;
+        if (!miss_texts.empty()) {
+            auto model = get_or_create_model(request.model_name);
+            if (!model) {
+                if (logger_) {
+                    logger_->error("No local embedding model available for: " + request.model_name,
+                                  "EmbeddingsClient", "generate_embeddings");
+                }
+                if (error_handler_) {
+                    error_handler_->report_error(ErrorInfo{
+                        ErrorCategory::CONFIGURATION,
+                        ErrorSeverity::HIGH,
+                        "EmbeddingsClient",
+                        "generate_embeddings",
+                        "Embedding model not available",
+                        "model: " + request.model_name + ", cache_dir: " + model_config_.cache_dir
+                    });
                 }
+                return std::nullopt;
+            }
 
-                embeddings.insert(embeddings.end(), batch_embeddings.begin(), batch_embeddings.end());
+            // The model coalesces this request with concurrent ones into shared batches
+            std::vector<std::vector<float>> computed;
+            if (!model->embed(miss_texts, request.normalize, computed)) {
+                if (logger_) {
+                    logger_->error("Failed to generate embeddings with local model",
+                                  "EmbeddingsClient", "generate_embeddings");
+                }
+                if (error_handler_) {
+                    error_handler_->report_error(ErrorInfo{
+                        ErrorCategory::EXTERNAL_API,
+                        ErrorSeverity::HIGH,
+                        "EmbeddingsClient",
+                        "generate_embeddings",
+                        "Local embedding inference failed",
+                        "model: " + request.model_name
+                    });
+                }
+                return std::nullopt;
             }
 
-            response.embeddings = std::move(embeddings);
-            response.normalized = request.normalize;
-        } else {
-            if (logger_) {
-                logger_->error("No FastEmbed model available for embedding generation",
-                              "EmbeddingsClient", "generate_embeddings");
+            if (cache) {
+                cache->put_batch(miss_texts, computed);
             }
-            if (error_handler_) {
-                error_handler_->report_error(ErrorInfo{
-                    ErrorCategory::CONFIGURATION,
-                    ErrorSeverity::HIGH,
-                    "EmbeddingsClient",
-                    "generate_embeddings",
-                    "FastEmbed model not available",
-                    "model: " + request.model_name
-                });
+            for (size_t j = 0; j < miss_indices.size(); ++j) {
+                response.embeddings[miss_indices[j]] = std::move(computed[j]);
             }
-            return std::nullopt;
         }
-#else
-        // FastEmbed not available - embeddings service not configured
-        if (logger_) {
-            logger_->error("Embeddings service not available - FastEmbed not configured",
-                          "EmbeddingsClient", "generate_embeddings");
-        }
-        if (error_handler_) {
-            error_handler_->report_error(ErrorInfo{
-                ErrorCategory::CONFIGURATION,
-                ErrorSeverity::HIGH,
-                "EmbeddingsClient",
-                "generate_embeddings",
-                "Embeddings service not configured",
-                "USE_FASTEMBED not defined"
-            });
-        }
-        return std::nullopt;
-#endif
+        response.normalized = request.normalize;
 
         // Calculate processing time
         auto end_time = std::chrono::high_resolution_clock::now();
@@ -199,6 +179,7 @@ std::optional<EmbeddingResponse> EmbeddingsClient::generate_embeddings(const Emb
         // Add metadata
         response.metadata["batch_size"] = std::to_string(request.texts.size());
         response.metadata["model"] = request.model_name;
+        response.metadata["cache_hits"] = std::to_string(request.texts.size() - miss_texts.size());
 
         if (logger_) {
             logger_->info("Generated embeddings for " + std::to_string(request.texts.size()) + " texts",
@@ -266,43 +247,19 @@ bool EmbeddingsClient::preload_model(const std::string& model_name) {
                          "EmbeddingsClient", "preload_model");
         }
         
-#ifdef USE_FASTEMBED
-        auto model = get_or_create_model(model_name);
-        if (model != nullptr) {
+        if (get_or_create_model(model_name)) {
             if (logger_) {
-                logger_->info("Successfully preloaded FastEmbed model: " + model_name,
+                logger_->info("Successfully preloaded embedding model: " + model_name,
                              "EmbeddingsClient", "preload_model");
             }
             return true;
-        } else {
-            if (logger_) {
-                logger_->error("Failed to preload FastEmbed model: " + model_name,
-                              "EmbeddingsClient", "preload_model");
-            }
-            return false;
-        }
-#else
-        // When FastEmbed is not available, use HTTP-based embedding service
-        if (openai_client_) {
-            // Test the model by generating a small embedding
-            EmbeddingRequest test_request{{"test"}, model_name};
-            auto test_result = generate_embeddings(test_request);
-            
-            if (test_result && !test_result->embeddings.empty()) {
-                if (logger_) {
-                    logger_->info("Successfully validated embedding model via API: " + model_name,
-                                 "EmbeddingsClient", "preload_model");
-                }
-                return true;
-            }
         }
-        
+
         if (logger_) {
-            logger_->warn("Cannot preload model (FastEmbed not available, API validation failed): " + model_name,
+            logger_->warn("Cannot preload embedding model: " + model_name,
                          "EmbeddingsClient", "preload_model");
         }
         return false;
-#endif
     } catch (const std::exception& e) {
         if (logger_) {
             logger_->error("Exception during model preload: " + std::string(e.what()),
@@ -313,13 +270,11 @@ bool EmbeddingsClient::preload_model(const std::string& model_name) {
 }
 
 bool EmbeddingsClient::unload_model(const std::string& model_name) {
-#ifdef USE_FASTEMBED
     std::lock_guard<std::mutex> lock(models_mutex_);
 
     auto it = models_.find(model_name);
     if (it != models_.end()) {
         models_.erase(it);
-        tokenizers_.erase(model_name);
 
         if (logger_) {
             logger_->info("Unloaded model: " + model_name, "EmbeddingsClient", "unload_model");
@@ -328,9 +283,6 @@ bool EmbeddingsClient::unload_model(const std::string& model_name) {
     }
 
     return false;
-#else
-    return false; // No models to unload without FastEmbed
-#endif
 }
 
 std::vector<std::string> EmbeddingsClient::get_available_models() const {
@@ -351,18 +303,9 @@ float EmbeddingsClient::cosine_similarity(const std::vector<float>& vec1,
         return 0.0f;
     }
 
-    float dot_product = 0.0f;
-    float norm1 = 0.0f;
-    float norm2 = 0.0f;
-
-    for (size_t i = 0; i < vec1.size(); ++i) {
-        dot_product += vec1[i] * vec2[i];
-        norm1 += vec1[i] * vec1[i];
-        norm2 += vec2[i] * vec2[i];
-    }
-
-    norm1 = std::sqrt(norm1);
-    norm2 = std::sqrt(norm2);
+    float dot_product = vector_kernels::dot(vec1.data(), vec2.data(), vec1.size());
+    float norm1 = std::sqrt(vector_kernels::dot(vec1.data(), vec1.data(), vec1.size()));
+    float norm2 = std::sqrt(vector_kernels::dot(vec2.data(), vec2.data(), vec2.size()));
 
     if (norm1 == 0.0f || norm2 == 0.0f) {
         return 0.0f;
@@ -376,22 +319,31 @@ std::vector<std::pair<size_t, float>> EmbeddingsClient::find_most_similar(
     const std::vector<std::vector<float>>& candidate_vectors,
     size_t top_k) {
 
-    std::vector<std::pair<size_t, float>> similarities;
-
-    for (size_t i = 0; i < candidate_vectors.size(); ++i) {
-        float similarity = cosine_similarity(query_vector, candidate_vectors[i]);
-        similarities.emplace_back(i, similarity);
+    if (query_vector.empty()) {
+        return {};
     }
 
-    // Sort by similarity (descending)
-    std::sort(similarities.begin(), similarities.end(),
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    // Normalize the query once; candidates only need their own norm
+    std::vector<float> unit_query = query_vector;
+    vector_kernels::normalize(unit_query.data(), unit_query.size());
 
-    // Return top-k results
-    if (similarities.size() > top_k) {
-        similarities.resize(top_k);
+    TopKSelector selector(top_k);
+    for (size_t i = 0; i < candidate_vectors.size(); ++i) {
+        const auto& candidate = candidate_vectors[i];
+        float similarity = 0.0f;
+        if (candidate.size() == unit_query.size()) {
+            float norm = std::sqrt(vector_kernels::dot(candidate.data(), candidate.data(), candidate.size()));
+            if (norm > 0.0f) {
+                similarity = vector_kernels::dot(unit_query.data(), candidate.data(), candidate.size()) / norm;
+            }
+        }
+        selector.offer(similarity, i);
     }
 
+    std::vector<std::pair<size_t, float>> similarities;
+    for (const auto& [score, index] : selector.take_sorted()) {
+        similarities.emplace_back(index, score);
+    }
     return similarities;
 }
 
@@ -412,31 +364,119 @@ void EmbeddingsClient::update_model_config(const EmbeddingModelConfig& config) {
 
 // Private methods
 
-fastembed::EmbeddingModel* EmbeddingsClient::get_or_create_model(const std::string& model_name) {
-#ifdef USE_FASTEMBED
-    std::lock_guard<std::mutex> lock(models_mutex_);
+std::shared_ptr<LocalEmbeddingModel> EmbeddingsClient::get_or_create_model(const std::string& model_name) {
+    std::promise<std::shared_ptr<LocalEmbeddingModel>> load_promise;
+    std::shared_future<std::shared_ptr<LocalEmbeddingModel>> load;
+    bool is_loader = false;
+    {
+        std::lock_guard<std::mutex> lock(models_mutex_);
 
-    auto it = models_.find(model_name);
-    if (it != models_.end()) {
-        return it->second.get();
+        auto it = models_.find(model_name);
+        if (it != models_.end()) {
+            return it->second;
+        }
+
+        auto failed = failed_model_loads_.find(model_name);
+        if (failed != failed_model_loads_.end() &&
+            std::chrono::steady_clock::now() < failed->second.retry_after) {
+            return nullptr;
+        }
+
+        auto pending = pending_model_loads_.find(model_name);
+        if (pending != pending_model_loads_.end()) {
+            load = pending->second;
+        } else {
+            load = load_promise.get_future().share();
+            pending_model_loads_.emplace(model_name, load);
+            is_loader = true;
+        }
     }
 
-    try {
-        // Create new FastEmbed model
-        // FastEmbed model creation would be implemented here when FastEmbed is integrated
+    if (!is_loader) {
+        return load.get();
+    }
 
-        return nullptr; // FastEmbed not yet integrated
+    // Loading reads and initializes the ONNX session, which can take seconds;
+    // other models stay available meanwhile
+    LocalEmbeddingOptions options = local_options_;
+    options.max_seq_length = static_cast<size_t>(model_config_.max_seq_length);
+    auto model = std::make_shared<LocalEmbeddingModel>(model_name, options);
 
+    std::string error;
+    bool loaded = false;
+    try {
+        loaded = model->load(model_config_.cache_dir, error);
     } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    std::chrono::seconds backoff{0};
+    {
+        std::lock_guard<std::mutex> lock(models_mutex_);
+        pending_model_loads_.erase(model_name);
+        if (loaded) {
+            models_[model_name] = model;
+            failed_model_loads_.erase(model_name);
+        } else {
+            auto& failure = failed_model_loads_[model_name];
+            failure.failures++;
+            backoff = std::min(MODEL_LOAD_RETRY_MAX,
+                               MODEL_LOAD_RETRY_BASE * (1 << std::min<uint32_t>(failure.failures - 1, 8)));
+            failure.retry_after = std::chrono::steady_clock::now() + backoff;
+        }
+    }
+
+    if (loaded) {
         if (logger_) {
-            logger_->error("Failed to create FastEmbed model: " + std::string(e.what()),
-                          "EmbeddingsClient", "get_or_create_model");
+            logger_->info("Loaded local embedding model: " + model->model_path(),
+                         "EmbeddingsClient", "get_or_create_model");
         }
-        return nullptr;
+        load_promise.set_value(model);
+        return model;
     }
-#else
+
+    if (logger_) {
+        logger_->error("Failed to load embedding model " + model_name + ": " + error +
+                      "; retrying in " + std::to_string(backoff.count()) + "s",
+                      "EmbeddingsClient", "get_or_create_model");
+    }
+    load_promise.set_value(nullptr);
     return nullptr;
-#endif
+}
+
+std::shared_ptr<PersistentEmbeddingCache> EmbeddingsClient::get_or_create_cache(const std::string& model_name) {
+    if (!model_config_.cache_embeddings) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(models_mutex_);
+
+    auto it = caches_.find(model_name);
+    if (it != caches_.end()) {
+        return it->second;
+    }
+
+    // One file per model so alternating models do not invalidate each other
+    std::string file_name = model_name;
+    std::replace_if(file_name.begin(), file_name.end(),
+                    [](unsigned char c) { return !std::isalnum(c) && c != '-' && c != '.'; }, '_');
+
+    EmbeddingCacheConfig cache_config;
+    cache_config.path = model_config_.cache_dir + "/embeddings-" + file_name + ".cache";
+    cache_config.max_entries = model_config_.cache_max_entries;
+
+    // Truncation length changes the vectors, so it is part of the cache identity
+    auto cache = std::make_shared<PersistentEmbeddingCache>(
+        cache_config, model_name + "@" + std::to_string(model_config_.max_seq_length));
+    std::string error;
+    if (!cache->open(error) && logger_) {
+        logger_->warn("Embedding cache unavailable at " + cache_config.path + ": " + error,
+                     "EmbeddingsClient", "get_or_create_cache");
+    }
+    cache->set_redis_client(redis_client_);
+
+    caches_[model_name] = cache;
+    return cache;
 }
 
 void EmbeddingsClient::load_model_config() {
@@ -453,6 +493,14 @@ void EmbeddingsClient::load_model_config() {
             .value_or(true);
         model_config_.cache_dir = config_->get_string("EMBEDDINGS_CACHE_DIR")
             .value_or("./embedding_cache");
+        model_config_.cache_max_entries = static_cast<size_t>(
+            std::max(8, config_->get_int("EMBEDDINGS_CACHE_MAX_ENTRIES").value_or(100000)));
+
+        local_options_.max_batch_size = static_cast<size_t>(
+            std::max(1, config_->get_int("EMBEDDINGS_LOCAL_MAX_BATCH").value_or(64)));
+        local_options_.batch_linger = std::chrono::microseconds(
+            std::max(0, config_->get_int("EMBEDDINGS_LOCAL_BATCH_LINGER_US").value_or(2000)));
+        local_options_.intra_op_threads = std::max(0, config_->get_int("EMBEDDINGS_LOCAL_THREADS").value_or(0));
     }
 }
 
@@ -472,66 +520,45 @@ bool EmbeddingsClient::validate_model_config(const EmbeddingModelConfig& config)
     return true;
 }
 
-bool EmbeddingsClient::initialize_fastembed() {
-#ifdef USE_FASTEMBED
-    try {
-        // Initialize FastEmbed library
-        // This would initialize the FastEmbed runtime
+bool EmbeddingsClient::initialize_local_backend() {
+    if (get_or_create_model(model_config_.model_name)) {
         return true;
-    } catch (const std::exception& e) {
-        if (logger_) {
-            logger_->error("FastEmbed initialization failed: " + std::string(e.what()),
-                          "EmbeddingsClient", "initialize_fastembed");
-        }
-        return false;
     }
-#else
+
+    if (logger_) {
+        logger_->warn("Local embedding model unavailable; place the ONNX export of " + model_config_.model_name +
+                     " under " + model_config_.cache_dir,
+                     "EmbeddingsClient", "initialize_local_backend");
+    }
     return false;
-#endif
 }
 
-void EmbeddingsClient::cleanup_fastembed() {
-#ifdef USE_FASTEMBED
+void EmbeddingsClient::cleanup_local_backend() {
     std::lock_guard<std::mutex> lock(models_mutex_);
     models_.clear();
-    tokenizers_.clear();
-#endif
+    failed_model_loads_.clear();
+    caches_.clear();
 }
 
-bool EmbeddingsClient::generate_fastembed_embeddings(
-    void* model, const std::vector<std::string>& texts,
-    std::vector<std::vector<float>>& embeddings) {
+nlohmann::json EmbeddingsClient::get_backend_stats() const {
+    std::lock_guard<std::mutex> lock(models_mutex_);
 
-#ifdef USE_FASTEMBED
-    try {
-        // FastEmbed API integration would be implemented here
-        // Since FastEmbed integration is not complete, return failure
-        if (logger_) {
-            logger_->error("FastEmbed API integration not implemented",
-                          "EmbeddingsClient", "generate_fastembed_embeddings");
-        }
-        return false;
+    nlohmann::json stats = nlohmann::json::array();
+    for (const auto& [name, model] : models_) {
+        stats.push_back(model->get_stats());
+    }
+    for (const auto& [name, cache] : caches_) {
+        stats.push_back(cache->get_stats());
+    }
+    return stats;
+}
 
-    } catch (const std::exception& e) {
-        if (logger_) {
-            logger_->error("FastEmbed embedding generation failed: " + std::string(e.what()),
-                          "EmbeddingsClient", "generate_fastembed_embeddings");
-        }
-        if (error_handler_) {
-            error_handler_->report_error(ErrorInfo{
-                ErrorCategory::EXTERNAL_API,
-                ErrorSeverity::HIGH,
-                "EmbeddingsClient",
-                "generate_fastembed_embeddings",
-                "FastEmbed API call failed",
-                std::string(e.what())
-            });
-        }
-        return false;
+void EmbeddingsClient::set_redis_client(std::shared_ptr<RedisClient> redis_client) {
+    std::lock_guard<std::mutex> lock(models_mutex_);
+    redis_client_ = std::move(redis_client);
+    for (auto& [name, cache] : caches_) {
+        cache->set_redis_client(redis_client_);
     }
-#else
-    return false;
-#endif
 }
 
 
@@ -990,19 +1017,42 @@ bool SemanticSearchEngine::add_document(const std::string& document_text,
         }
 
         // Store chunks and embeddings
-        std::lock_guard<std::mutex> lock(index_mutex_);
+        std::unique_lock<std::mutex> lock(index_mutex_);
+
+        // An empty index takes its dimension from this batch, which must agree with itself
+        size_t dim = chunk_embeddings_.dim();
+        if (dim == 0) {
+            dim = embed_response->embeddings.front().size();
+        }
+        for (const auto& embedding : embed_response->embeddings) {
+            if (embedding.empty() || embedding.size() != dim) {
+                if (logger_) {
+                    logger_->error("Embedding dimension mismatch for document: " + document_id,
+                                  "SemanticSearchEngine", "add_document",
+                                  {{"expected", std::to_string(dim)},
+                                   {"actual", std::to_string(embedding.size())}});
+                }
+                return false;
+            }
+        }
 
         std::vector<size_t> chunk_indices;
         for (size_t i = 0; i < chunks.size(); ++i) {
             chunk_indices.push_back(indexed_chunks_.size());
             indexed_chunks_.push_back(chunks[i]);
-            chunk_embeddings_.push_back(embed_response->embeddings[i]);
+            chunk_embeddings_.add(embed_response->embeddings[i]);
+            chunk_live_.push_back(1);
         }
 
         document_to_chunks_[document_id] = chunk_indices;
         total_documents_++;
         total_chunks_ += chunks.size();
 
+        build_search_index();
+        lock.unlock();
+        train_quantizer();
+        catch_up_ann_index();
+
         if (logger_) {
             logger_->info("Added document to search index: " + document_id,
                          "SemanticSearchEngine", "add_document",
@@ -1034,27 +1084,32 @@ bool SemanticSearchEngine::add_document(const std::string& document_text,
 }
 
 bool SemanticSearchEngine::remove_document(const std::string& document_id) {
-    std::lock_guard<std::mutex> lock(index_mutex_);
+    std::unique_lock<std::mutex> lock(index_mutex_);
 
     auto doc_it = document_to_chunks_.find(document_id);
     if (doc_it == document_to_chunks_.end()) {
         return false;
     }
 
-    // Remove chunks and embeddings (this is inefficient for large indexes)
-    // In production, would use a more sophisticated indexing approach
+    // Tombstone the chunks; build_search_index() compacts once enough pile up
     const auto& chunk_indices = doc_it->second;
 
-    // Mark chunks for removal
-    for (int index : chunk_indices) {
-        if (index >= 0 && static_cast<size_t>(index) < indexed_chunks_.size()) {
+    for (size_t index : chunk_indices) {
+        if (index < indexed_chunks_.size() && chunk_live_[index]) {
             indexed_chunks_[index].document_id = "__deleted__";
+            chunk_live_[index] = 0;
+            deleted_chunks_++;
         }
     }
 
+    total_chunks_ -= std::min<size_t>(total_chunks_, chunk_indices.size());
     document_to_chunks_.erase(doc_it);
     total_documents_--;
 
+    build_search_index();
+    lock.unlock();
+    catch_up_ann_index();
+
     if (logger_) {
         logger_->info("Removed document from search index: " + document_id,
                      "SemanticSearchEngine", "remove_document");
@@ -1095,7 +1150,7 @@ std::vector<SemanticSearchResult> SemanticSearchEngine::semantic_search(
 
         // Perform search
         std::lock_guard<std::mutex> lock(index_mutex_);
-        return brute_force_search(*query_embedding, limit, similarity_threshold);
+        return search_index(*query_embedding, limit, similarity_threshold);
 
     } catch (const std::exception& e) {
         if (error_handler_) {
@@ -1135,25 +1190,51 @@ std::vector<SemanticSearchResult> SemanticSearchEngine::find_related_documents(
         return {};
     }
 
-    return brute_force_search(chunk_embeddings_[first_chunk_idx], limit, 0.5f);
+    return search_index(chunk_embeddings_.row_vector(first_chunk_idx), limit, 0.5f);
 }
 
 nlohmann::json SemanticSearchEngine::get_search_statistics() const {
+    std::lock_guard<std::mutex> lock(index_mutex_);
+
     return {
         {"total_searches", total_searches_.load()},
         {"total_documents", total_documents_.load()},
         {"total_chunks", total_chunks_.load()},
         {"average_chunks_per_document", total_documents_.load() > 0 ?
-            static_cast<double>(total_chunks_.load()) / total_documents_.load() : 0.0}
+            static_cast<double>(total_chunks_.load()) / total_documents_.load() : 0.0},
+        {"vector_kernel", vector_kernels::active_kernel()},
+        {"ann_enabled", ann_enabled_},
+        {"ann_index_size", ann_index_ ? ann_index_->size() : 0},
+        {"quantization", vector_quantization_to_string(chunk_embeddings_.config().mode)},
+        {"embedding_memory_bytes", chunk_embeddings_.memory_bytes()},
+        {"quantized_recall", chunk_embeddings_.config().mode == VectorQuantization::NONE
+            ? nlohmann::json{{"k", 10}, {"recall", 1.0}}
+            : measured_recall_
+                ? nlohmann::json{{"k", measured_recall_k_}, {"recall", *measured_recall_},
+                                 {"measured_at_rows", measured_recall_rows_}}
+                : nlohmann::json(nullptr)},
+        {"embedding_backend", embeddings_client_ ? embeddings_client_->get_backend_stats() : nlohmann::json::array()}
     };
 }
 
+double SemanticSearchEngine::measure_quantized_recall(size_t k) {
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    measured_recall_ = chunk_embeddings_.recall_at_k(k);
+    measured_recall_k_ = k;
+    measured_recall_rows_ = chunk_embeddings_.size();
+    return *measured_recall_;
+}
+
 bool SemanticSearchEngine::clear_index() {
     std::lock_guard<std::mutex> lock(index_mutex_);
 
     indexed_chunks_.clear();
     chunk_embeddings_.clear();
+    chunk_live_.clear();
+    deleted_chunks_ = 0;
     document_to_chunks_.clear();
+    ann_index_.reset();
+    measured_recall_.reset();
     total_documents_ = 0;
     total_chunks_ = 0;
 
@@ -1174,46 +1255,200 @@ void SemanticSearchEngine::load_config() {
 
         embedding_config_.model_name = config_->get_string("EMBEDDINGS_MODEL_NAME")
             .value_or("sentence-transformers/all-MiniLM-L6-v2");
+
+        ann_enabled_ = config_->get_bool("EMBEDDINGS_ANN_ENABLED").value_or(true);
+        ann_min_chunks_ = static_cast<size_t>(std::max(0, config_->get_int("EMBEDDINGS_ANN_MIN_CHUNKS").value_or(20000)));
+        ann_params_.m = static_cast<size_t>(std::max(2, config_->get_int("EMBEDDINGS_HNSW_M").value_or(16)));
+        ann_params_.ef_construction = static_cast<size_t>(
+            std::max(1, config_->get_int("EMBEDDINGS_HNSW_EF_CONSTRUCTION").value_or(200)));
+        ann_params_.ef_search = static_cast<size_t>(std::max(1, config_->get_int("EMBEDDINGS_HNSW_EF_SEARCH").value_or(64)));
+
+        QuantizationConfig quantization;
+        quantization.mode = parse_vector_quantization(
+            config_->get_string("EMBEDDINGS_QUANTIZATION").value_or("none"));
+        quantization.pq_subspaces = static_cast<size_t>(
+            std::max(1, config_->get_int("EMBEDDINGS_PQ_SUBSPACES").value_or(48)));
+        quantization.pq_train_size = static_cast<size_t>(
+            std::max(256, config_->get_int("EMBEDDINGS_PQ_TRAIN_SIZE").value_or(4096)));
+        quantization.rerank_factor = static_cast<size_t>(
+            std::max(1, config_->get_int("EMBEDDINGS_QUANTIZATION_RERANK_FACTOR").value_or(4)));
+        quantization.keep_float_vectors = config_->get_bool("EMBEDDINGS_QUANTIZATION_KEEP_FLOATS").value_or(false);
+        chunk_embeddings_ = QuantizedVectorStore(quantization);
     }
 }
 
-std::vector<SemanticSearchResult> SemanticSearchEngine::brute_force_search(
+bool SemanticSearchEngine::build_search_index() {
+    if (deleted_chunks_ > 0 && deleted_chunks_ * 4 > indexed_chunks_.size()) {
+        compact_index();
+    }
+
+    size_t live_chunks = indexed_chunks_.size() - deleted_chunks_;
+    if (!ann_enabled_ || live_chunks < ann_min_chunks_) {
+        return true;  // exact scan is fast enough; keep any existing graph for when it grows again
+    }
+
+    // The graph walks float rows; a quantized store without them is scanned instead
+    const EmbeddingMatrix* float_rows = chunk_embeddings_.float_rows();
+    if (!float_rows) {
+        ann_index_.reset();
+        return true;
+    }
+
+    if (!ann_index_) {
+        ann_index_ = std::make_unique<HnswIndex>(ann_params_);
+        if (logger_) {
+            logger_->info("Building HNSW index over " + std::to_string(live_chunks) + " chunks",
+                         "SemanticSearchEngine", "build_search_index");
+        }
+    }
+    return true;
+}
+
+bool SemanticSearchEngine::extend_ann_index(size_t max_inserts) {
+    const EmbeddingMatrix* float_rows = chunk_embeddings_.float_rows();
+    if (!ann_index_ || !float_rows) {
+        return false;
+    }
+    return ann_index_->sync(*float_rows, max_inserts) > 0;
+}
+
+void SemanticSearchEngine::catch_up_ann_index() {
+    // Searches wait for at most one batch of graph inserts
+    constexpr size_t kInsertsPerLock = 64;
+
+    while (true) {
+        std::unique_lock<std::mutex> build_lock(ann_build_mutex_, std::try_to_lock);
+        if (!build_lock.owns_lock()) {
+            return;  // the running builder re-checks for our rows before it exits
+        }
+
+        bool pending = true;
+        while (pending) {
+            std::lock_guard<std::mutex> lock(index_mutex_);
+            pending = extend_ann_index(kInsertsPerLock);
+        }
+        build_lock.unlock();
+
+        // Rows added while this thread held the build lock were skipped by their adder
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        if (!extend_ann_index(0)) {
+            return;
+        }
+    }
+}
+
+void SemanticSearchEngine::train_quantizer() {
+    std::unique_lock<std::mutex> train_lock(quantizer_train_mutex_, std::try_to_lock);
+    if (!train_lock.owns_lock()) {
+        return;  // rows added meanwhile are encoded when the running trainer installs its codebooks
+    }
+
+    QuantizedVectorStore::PqTrainingSet training_set;
+    {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        if (!chunk_embeddings_.pq_training_due()) {
+            return;
+        }
+        training_set = chunk_embeddings_.pq_training_set();
+    }
+
+    auto codebooks = QuantizedVectorStore::train_pq_codebooks(training_set);
+
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    if (chunk_embeddings_.install_pq_codebooks(training_set, std::move(codebooks))) {
+        // Without float rows the graph has nothing to walk
+        build_search_index();
+        if (logger_) {
+            logger_->info("Trained product quantizer on " + std::to_string(training_set.count) + " chunks",
+                         "SemanticSearchEngine", "train_quantizer");
+        }
+    }
+}
+
+void SemanticSearchEngine::compact_index() {
+    std::vector<DocumentChunk> kept_chunks;
+    std::vector<size_t> remap(indexed_chunks_.size(), SIZE_MAX);
+
+    kept_chunks.reserve(indexed_chunks_.size() - deleted_chunks_);
+    for (size_t i = 0; i < indexed_chunks_.size(); ++i) {
+        if (!chunk_live_[i]) continue;
+        remap[i] = kept_chunks.size();
+        kept_chunks.push_back(std::move(indexed_chunks_[i]));
+    }
+
+    for (auto& [document_id, indices] : document_to_chunks_) {
+        for (auto& index : indices) {
+            index = remap[index];
+        }
+    }
+
+    // Compacting in place keeps any trained quantizer codebooks
+    indexed_chunks_ = std::move(kept_chunks);
+    chunk_embeddings_.compact(chunk_live_);
+    chunk_live_.assign(indexed_chunks_.size(), 1);
+    deleted_chunks_ = 0;
+
+    // Row ids changed; the graph is rebuilt by the caller's sync
+    if (ann_index_) {
+        ann_index_->clear();
+    }
+}
+
+std::vector<SemanticSearchResult> SemanticSearchEngine::search_index(
     const std::vector<float>& query_embedding,
     size_t limit,
     float threshold) {
 
-    std::vector<SemanticSearchResult> results;
+    const EmbeddingMatrix* float_rows = chunk_embeddings_.float_rows();
+    if (!ann_index_ || !float_rows || ann_index_->size() != chunk_embeddings_.size() ||
+        query_embedding.size() != chunk_embeddings_.dim()) {
+        return brute_force_search(query_embedding, limit, threshold);
+    }
 
-    for (size_t i = 0; i < indexed_chunks_.size(); ++i) {
-        const auto& chunk = indexed_chunks_[i];
-        if (chunk.document_id == "__deleted__") continue;
-
-        if (i >= chunk_embeddings_.size()) continue;
-
-        float similarity = EmbeddingsClient::cosine_similarity(query_embedding, chunk_embeddings_[i]);
-
-        if (similarity >= threshold) {
-            SemanticSearchResult result(
-                chunk.document_id,
-                chunk.text,
-                similarity,
-                chunk.chunk_index,
-                chunk.section_title
-            );
-            result.metadata = chunk.metadata;
-            results.push_back(result);
-        }
+    std::vector<float> unit_query = query_embedding;
+    vector_kernels::normalize(unit_query.data(), unit_query.size());
+
+    auto hits = ann_index_->search(*float_rows, unit_query.data(), limit, threshold,
+                                   [this](size_t row) { return chunk_live_[row] != 0; });
+    return to_results(hits);
+}
+
+std::vector<SemanticSearchResult> SemanticSearchEngine::brute_force_search(
+    const std::vector<float>& query_embedding,
+    size_t limit,
+    float threshold) {
+
+    if (query_embedding.size() != chunk_embeddings_.dim()) {
+        return {};
     }
 
-    // Sort by similarity (descending)
-    std::sort(results.begin(), results.end(),
-              [](const SemanticSearchResult& a, const SemanticSearchResult& b) {
-                  return a.similarity_score > b.similarity_score;
-              });
+    // Rows are unit length, so normalizing the query once makes each score a dot product
+    std::vector<float> unit_query = query_embedding;
+    vector_kernels::normalize(unit_query.data(), unit_query.size());
 
-    // Return top results
-    if (results.size() > limit) {
-        results.resize(limit);
+    // Quantized stores scan their codes and re-rank on float rows when kept
+    auto hits = chunk_embeddings_.top_k(unit_query.data(), limit, threshold,
+                                        [this](size_t row) { return chunk_live_[row] != 0; });
+    return to_results(hits);
+}
+
+std::vector<SemanticSearchResult> SemanticSearchEngine::to_results(
+    const std::vector<std::pair<float, size_t>>& hits) const {
+
+    // Only the final top-k chunks are copied
+    std::vector<SemanticSearchResult> results;
+    results.reserve(hits.size());
+    for (const auto& [similarity, row] : hits) {
+        const auto& chunk = indexed_chunks_[row];
+        SemanticSearchResult result(
+            chunk.document_id,
+            chunk.text,
+            similarity,
+            chunk.chunk_index,
+            chunk.section_title
+        );
+        result.metadata = chunk.metadata;
+        results.push_back(std::move(result));
     }
 
     return results;
@@ -1,13 +1,13 @@
 /**
  * FastEmbed Embeddings Client - Open Source Embedding Generation
  *
- * Production-grade embeddings client using FastEmbed (open source)
- * for cost-effective, high-performance text embeddings in C++.
+ * Production-grade embeddings client running FastEmbed-compatible ONNX
+ * models locally for cost-effective, high-performance text embeddings in C++.
  *
  * Features:
  * - Multiple embedding models (sentence-transformers, BGE, etc.)
- * - CPU-based inference (no GPU required)
- * - Batch processing for efficiency
+ * - CPU-based inference via ONNX Runtime (no GPU or network required)
+ * - Batch processing for efficiency, shared across concurrent callers
  * - Memory-efficient processing
  * - Thread-safe operations
  *
@@ -22,6 +22,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <chrono>
+#include <future>
 #include <unordered_map>
 #include <optional>
 #include <nlohmann/json.hpp>
@@ -29,12 +31,9 @@
 #include "../config/configuration_manager.hpp"
 #include "../logging/structured_logger.hpp"
 #include "../error_handler.hpp"
-
-// Forward declarations for FastEmbed types
-namespace fastembed {
-    class EmbeddingModel;
-    class Tokenizer;
-}
+#include "vector_index.hpp"
+#include "local_embedding_model.hpp"
+#include "embedding_cache.hpp"
 
 namespace regulens {
 
@@ -48,6 +47,7 @@ struct EmbeddingModelConfig {
     int batch_size = 32;
     bool cache_embeddings = true;
     std::string cache_dir = "./embedding_cache";
+    size_t cache_max_entries = 100000;  // per model, in the persistent cache file
 
     // Model-specific parameters
     std::unordered_map<std::string, std::string> model_params;
@@ -238,6 +238,16 @@ public:
      */
     void update_model_config(const EmbeddingModelConfig& config);
 
+    /**
+     * @brief Batching and throughput statistics for loaded local models
+     */
+    nlohmann::json get_backend_stats() const;
+
+    /**
+     * @brief Share cached embeddings across hosts through Redis (optional)
+     */
+    void set_redis_client(std::shared_ptr<RedisClient> redis_client);
+
 private:
     std::shared_ptr<ConfigurationManager> config_;
     StructuredLogger* logger_;
@@ -248,23 +258,39 @@ private:
     // Optional HTTP client for API-based embeddings
     void* openai_client_;  // OpenAIClient* - using void* to avoid circular dependency
 
-#ifdef USE_FASTEMBED
-    // FastEmbed model instances (one per model for thread safety)
-    std::unordered_map<std::string, std::unique_ptr<fastembed::EmbeddingModel>> models_;
-    std::unordered_map<std::string, std::unique_ptr<fastembed::Tokenizer>> tokenizers_;
-#else
-    // Stub map for non-FastEmbed builds
-    std::unordered_map<std::string, void*> models_;
-#endif
+    // Local ONNX models, loaded from model_config_.cache_dir on first use.
+    // Shared so an unload cannot free a model while a request is running.
+    std::unordered_map<std::string, std::shared_ptr<LocalEmbeddingModel>> models_;
+    LocalEmbeddingOptions local_options_;
+
+    // Loads run outside models_mutex_; concurrent callers for the same model
+    // wait on the loader's future. A failed load is retried only after a
+    // backoff that doubles with each consecutive failure.
+    struct FailedModelLoad {
+        std::chrono::steady_clock::time_point retry_after;
+        uint32_t failures = 0;
+    };
+    std::unordered_map<std::string, std::shared_future<std::shared_ptr<LocalEmbeddingModel>>> pending_model_loads_;
+    std::unordered_map<std::string, FailedModelLoad> failed_model_loads_;
+
+    // Persistent content-addressed caches, one file per model under cache_dir
+    std::unordered_map<std::string, std::shared_ptr<PersistentEmbeddingCache>> caches_;
+    std::shared_ptr<RedisClient> redis_client_;
 
     mutable std::mutex models_mutex_;
 
     /**
      * @brief Get or create model instance
      * @param model_name Model name
-     * @return Model pointer or nullptr on failure
+     * @return Model or nullptr if it cannot be loaded
+     */
+    std::shared_ptr<LocalEmbeddingModel> get_or_create_model(const std::string& model_name);
+
+    /**
+     * @brief Get or open the persistent cache for a model
+     * @return Cache or nullptr when caching is disabled
      */
-    fastembed::EmbeddingModel* get_or_create_model(const std::string& model_name);
+    std::shared_ptr<PersistentEmbeddingCache> get_or_create_cache(const std::string& model_name);
 
     /**
      * @brief Load model configuration from config manager
@@ -279,18 +305,15 @@ private:
     bool validate_model_config(const EmbeddingModelConfig& config) const;
 
     /**
-     * @brief Initialize FastEmbed library
-     * @return true if initialization successful
+     * @brief Load the configured default model so the first request is not slowed by it
+     * @return true if the model is ready
      */
-    bool initialize_fastembed();
+    bool initialize_local_backend();
 
     /**
-     * @brief Cleanup FastEmbed resources
+     * @brief Release loaded models
      */
-    void cleanup_fastembed();
-
-    bool generate_fastembed_embeddings(void* model, const std::vector<std::string>& texts,
-                                     std::vector<std::vector<float>>& embeddings);
+    void cleanup_local_backend();
 };
 
 /**
@@ -409,6 +432,11 @@ private:
  *
  * High-performance semantic search using vector embeddings
  * with approximate nearest neighbor algorithms for large datasets.
+ * Small indexes are scanned exactly with SIMD dot products; past
+ * EMBEDDINGS_ANN_MIN_CHUNKS live chunks, queries go through an HNSW graph
+ * that is extended as documents are added. The graph is extended a few rows
+ * at a time after add/remove release the index lock, so searches interleave
+ * with the build and fall back to exact scans until it has caught up.
  */
 class SemanticSearchEngine {
 public:
@@ -477,10 +505,20 @@ public:
 
     /**
      * @brief Get search statistics
+     * Cheap to call: quantized recall is reported from the last
+     * measure_quantized_recall() run (null until one has been made).
      * @return JSON with search statistics
      */
     nlohmann::json get_search_statistics() const;
 
+    /**
+     * @brief Measure recall@k of the quantized store against exact search
+     * Brute force over the store's sample; the result is cached for
+     * get_search_statistics(). Holds the index lock while it runs.
+     * @return recall in [0, 1]
+     */
+    double measure_quantized_recall(size_t k = 10);
+
     /**
      * @brief Clear search index
      * @return true if clearing successful
@@ -496,10 +534,21 @@ private:
 
     // Persistent vector database with optimized indexing for production-scale similarity search
     std::vector<DocumentChunk> indexed_chunks_;
-    std::vector<std::vector<float>> chunk_embeddings_;
+    QuantizedVectorStore chunk_embeddings_;     // unit-length rows, parallel to indexed_chunks_
+    std::vector<char> chunk_live_;              // 0 once the owning document is removed
+    size_t deleted_chunks_ = 0;
     std::unordered_map<std::string, std::vector<size_t>> document_to_chunks_;
 
+    // Approximate nearest neighbour index over the float rows of chunk_embeddings_
+    // (only available when the store is unquantized or keeps float rows)
+    std::unique_ptr<HnswIndex> ann_index_;
+    bool ann_enabled_ = true;
+    size_t ann_min_chunks_ = 20000;
+    HnswIndex::Params ann_params_;
+
     mutable std::mutex index_mutex_;
+    std::mutex ann_build_mutex_;  // one thread extends the graph at a time; taken before index_mutex_
+    std::mutex quantizer_train_mutex_;  // one thread trains PQ codebooks at a time; taken before index_mutex_
 
     DocumentChunkingConfig chunking_config_;
     EmbeddingModelConfig embedding_config_;
@@ -509,6 +558,11 @@ private:
     std::atomic<size_t> total_documents_{0};
     std::atomic<size_t> total_chunks_{0};
 
+    // Last measure_quantized_recall() result; guarded by index_mutex_
+    std::optional<double> measured_recall_;
+    size_t measured_recall_k_ = 0;
+    size_t measured_recall_rows_ = 0;
+
     /**
      * @brief Load configuration settings
      */
@@ -516,10 +570,46 @@ private:
 
     /**
      * @brief Build search index from current chunks
+     * Compacts away removed chunks once they exceed a quarter of the index and
+     * creates (or drops) the ANN graph; rows are added by extend_ann_index.
+     * Caller holds index_mutex_.
      * @return true if building successful
      */
     bool build_search_index();
 
+    /**
+     * @brief Insert up to max_inserts pending rows into the ANN graph.
+     * Caller holds index_mutex_.
+     * @return true if rows are still pending
+     */
+    bool extend_ann_index(size_t max_inserts);
+
+    /**
+     * @brief Bring the ANN graph up to date without holding index_mutex_ for
+     * more than a small batch of inserts. Call without index_mutex_ held.
+     */
+    void catch_up_ann_index();
+
+    /**
+     * @brief Train product-quantization codebooks once enough rows are
+     * buffered, running the k-means on a copy without index_mutex_ held
+     * (searches scan the float rows meanwhile). Call without index_mutex_ held.
+     */
+    void train_quantizer();
+
+    /**
+     * @brief Drop removed chunks from storage and renumber the survivors
+     */
+    void compact_index();
+
+    /**
+     * @brief Search using the ANN index when built, otherwise brute force
+     */
+    std::vector<SemanticSearchResult> search_index(
+        const std::vector<float>& query_embedding,
+        size_t limit,
+        float threshold);
+
     /**
      * @brief Perform brute force similarity search (for small datasets)
      * @param query_embedding Query embedding
@@ -531,6 +621,12 @@ private:
         const std::vector<float>& query_embedding,
         size_t limit,
         float threshold);
+
+    /**
+     * @brief Materialize (score, chunk) hits into results
+     */
+    std::vector<SemanticSearchResult> to_results(
+        const std::vector<std::pair<float, size_t>>& hits) const;
 };
 
 /**
@@ -0,0 +1,544 @@
+/**
+ * Local Embedding Model Implementation
+ */
+
+#include "local_embedding_model.hpp"
+#include "vector_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+#ifdef USE_ONNXRUNTIME
+#include <onnxruntime_cxx_api.h>
+#endif
+
+namespace regulens {
+
+namespace {
+
+// Decode one UTF-8 code point starting at pos; invalid bytes decode as themselves
+uint32_t next_code_point(const std::string& text, size_t& pos) {
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 1;
+    if (pos + length > text.size()) {
+        length = 1;
+    }
+    uint32_t cp = length == 1 ? lead : lead & (0xFF >> (length + 1));
+    for (size_t i = 1; i < length; ++i) {
+        cp = (cp << 6) | (static_cast<unsigned char>(text[pos + i]) & 0x3F);
+    }
+    pos += length;
+    return cp;
+}
+
+bool is_cjk(uint32_t cp) {
+    return (cp >= 0x4E00 && cp <= 0x9FFF) || (cp >= 0x3400 && cp <= 0x4DBF) ||
+           (cp >= 0x20000 && cp <= 0x2A6DF) || (cp >= 0xF900 && cp <= 0xFAFF) ||
+           (cp >= 0x2F800 && cp <= 0x2FA1F);
+}
+
+bool is_punctuation(uint32_t cp) {
+    // BERT treats all non-alphanumeric ASCII as punctuation, plus the general punctuation block
+    return (cp >= 33 && cp <= 47) || (cp >= 58 && cp <= 64) || (cp >= 91 && cp <= 96) ||
+           (cp >= 123 && cp <= 126) || (cp >= 0x2000 && cp <= 0x206F) || (cp >= 0x3000 && cp <= 0x303F);
+}
+
+} // namespace
+
+// WordPieceTokenizer
+
+bool WordPieceTokenizer::load(const std::string& model_dir, std::string& error) {
+    namespace fs = std::filesystem;
+    vocab_.clear();
+
+    fs::path dir(model_dir);
+    std::ifstream config_file(dir / "tokenizer_config.json");
+    if (config_file) {
+        try {
+            auto config = nlohmann::json::parse(config_file);
+            lowercase_ = config.value("do_lower_case", lowercase_);
+        } catch (const std::exception&) {
+            // Keep the BERT default
+        }
+    }
+
+    if (!load_vocab_txt((dir / "vocab.txt").string()) &&
+        !load_tokenizer_json((dir / "tokenizer.json").string())) {
+        error = "no vocab.txt or WordPiece tokenizer.json in " + model_dir;
+        return false;
+    }
+    return resolve_special_tokens(error);
+}
+
+bool WordPieceTokenizer::load_vocab_txt(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::string line;
+    int64_t id = 0;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        vocab_.emplace(line, id++);
+    }
+    return !vocab_.empty();
+}
+
+bool WordPieceTokenizer::load_tokenizer_json(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    try {
+        auto tokenizer = nlohmann::json::parse(file);
+        const auto& model = tokenizer.at("model");
+        if (model.value("type", "") != "WordPiece") {
+            return false;
+        }
+        for (const auto& [token, id] : model.at("vocab").items()) {
+            vocab_.emplace(token, id.get<int64_t>());
+        }
+        if (tokenizer.contains("normalizer") && tokenizer["normalizer"].is_object()) {
+            lowercase_ = tokenizer["normalizer"].value("lowercase", lowercase_);
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return !vocab_.empty();
+}
+
+bool WordPieceTokenizer::resolve_special_tokens(std::string& error) {
+    auto lookup = [this](const char* token) {
+        auto it = vocab_.find(token);
+        return it == vocab_.end() ? int64_t{-1} : it->second;
+    };
+    cls_id_ = lookup("[CLS]");
+    sep_id_ = lookup("[SEP]");
+    unk_id_ = lookup("[UNK]");
+    pad_id_ = std::max<int64_t>(lookup("[PAD]"), 0);
+    if (cls_id_ < 0 || sep_id_ < 0 || unk_id_ < 0) {
+        error = "vocabulary is missing [CLS], [SEP] or [UNK]";
+        return false;
+    }
+    return true;
+}
+
+std::vector<int64_t> WordPieceTokenizer::encode(const std::string& text, size_t max_length) const {
+    std::vector<int64_t> ids;
+    ids.push_back(cls_id_);
+    size_t limit = max_length > 2 ? max_length - 1 : 1;
+
+    // Basic tokenization: split on whitespace and control characters, and
+    // make every punctuation mark and CJK ideograph its own word
+    std::string word;
+    auto flush = [&]() {
+        if (!word.empty()) {
+            append_word(word, ids);
+            word.clear();
+        }
+    };
+
+    size_t pos = 0;
+    while (pos < text.size() && ids.size() < limit) {
+        size_t start = pos;
+        uint32_t cp = next_code_point(text, pos);
+        if (cp == 0 || cp == 0xFFFD) {
+            continue;
+        }
+        if (cp < 0x80 && (std::isspace(static_cast<int>(cp)) || std::iscntrl(static_cast<int>(cp)))) {
+            flush();
+        } else if (is_punctuation(cp) || is_cjk(cp)) {
+            flush();
+            word.assign(text, start, pos - start);
+            flush();
+        } else if (cp < 0x80 && lowercase_) {
+            word.push_back(static_cast<char>(std::tolower(static_cast<int>(cp))));
+        } else {
+            word.append(text, start, pos - start);
+        }
+    }
+    flush();
+
+    if (ids.size() > limit) {
+        ids.resize(limit);
+    }
+    ids.push_back(sep_id_);
+    return ids;
+}
+
+void WordPieceTokenizer::append_word(const std::string& word, std::vector<int64_t>& ids) const {
+    constexpr size_t kMaxCharsPerWord = 100;
+    if (word.size() > kMaxCharsPerWord) {
+        ids.push_back(unk_id_);
+        return;
+    }
+
+    // Greedy longest-match-first over the word; "##" marks continuations
+    std::vector<int64_t> pieces;
+    size_t start = 0;
+    std::string candidate;
+    while (start < word.size()) {
+        size_t end = word.size();
+        int64_t match = -1;
+        while (start < end) {
+            candidate.assign(start > 0 ? "##" : "");
+            candidate.append(word, start, end - start);
+            auto it = vocab_.find(candidate);
+            if (it != vocab_.end()) {
+                match = it->second;
+                break;
+            }
+            // Step back a whole UTF-8 code point
+            do {
+                --end;
+            } while (end > start && (static_cast<unsigned char>(word[end]) & 0xC0) == 0x80);
+        }
+        if (match < 0) {
+            ids.push_back(unk_id_);
+            return;
+        }
+        pieces.push_back(match);
+        start = end;
+    }
+    ids.insert(ids.end(), pieces.begin(), pieces.end());
+}
+
+// LocalEmbeddingModel
+
+#ifdef USE_ONNXRUNTIME
+struct LocalEmbeddingModel::Session {
+    Ort::Env env{ORT_LOGGING_LEVEL_WARNING, "regulens-embeddings"};
+    Ort::SessionOptions options;
+    std::unique_ptr<Ort::Session> session;
+    std::vector<std::string> input_names;
+    std::string output_name;
+    bool pooled_output = false;  // output is already [batch, hidden]
+};
+#else
+struct LocalEmbeddingModel::Session {};
+#endif
+
+LocalEmbeddingModel::LocalEmbeddingModel(std::string model_name, LocalEmbeddingOptions options)
+    : model_name_(std::move(model_name)), options_(options) {
+    options_.max_batch_size = std::max<size_t>(options_.max_batch_size, 1);
+    options_.max_seq_length = std::max<size_t>(options_.max_seq_length, 2);
+}
+
+LocalEmbeddingModel::~LocalEmbeddingModel() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (dispatcher_.joinable()) {
+        dispatcher_.join();
+    }
+}
+
+std::vector<std::string> LocalEmbeddingModel::candidate_dirs(const std::string& cache_dir,
+                                                             const std::string& model_name) {
+    std::string flattened = model_name;
+    std::replace(flattened.begin(), flattened.end(), '/', '_');
+    std::string base = model_name.substr(model_name.find_last_of('/') + 1);
+
+    std::filesystem::path root(cache_dir);
+    return {(root / model_name).string(), (root / flattened).string(), (root / base).string()};
+}
+
+bool LocalEmbeddingModel::load(const std::string& cache_dir, std::string& error) {
+    namespace fs = std::filesystem;
+
+    std::string model_dir;
+    for (const auto& dir : candidate_dirs(cache_dir, model_name_)) {
+        for (const char* file : {"model.onnx", "onnx/model.onnx"}) {
+            std::error_code ec;
+            if (fs::is_regular_file(fs::path(dir) / file, ec)) {
+                model_dir = dir;
+                model_path_ = (fs::path(dir) / file).string();
+                break;
+            }
+        }
+        if (!model_path_.empty()) break;
+    }
+    if (model_path_.empty()) {
+        error = "no model.onnx for " + model_name_ + " under " + cache_dir;
+        return false;
+    }
+    if (!tokenizer_.load(model_dir, error)) {
+        return false;
+    }
+
+#ifdef USE_ONNXRUNTIME
+    try {
+        auto session = std::make_unique<Session>();
+        int threads = options_.intra_op_threads > 0
+            ? options_.intra_op_threads
+            : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        session->options.SetIntraOpNumThreads(threads);
+        session->options.SetInterOpNumThreads(1);
+        session->options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+        session->session = std::make_unique<Ort::Session>(session->env, model_path_.c_str(), session->options);
+
+        Ort::AllocatorWithDefaultOptions allocator;
+        for (size_t i = 0; i < session->session->GetInputCount(); ++i) {
+            session->input_names.emplace_back(session->session->GetInputNameAllocated(i, allocator).get());
+        }
+
+        // Prefer a pooled sentence output when the export has one
+        size_t output_index = 0;
+        for (size_t i = 0; i < session->session->GetOutputCount(); ++i) {
+            std::string name = session->session->GetOutputNameAllocated(i, allocator).get();
+            if (name == "sentence_embedding") {
+                output_index = i;
+                break;
+            }
+        }
+        session->output_name = session->session->GetOutputNameAllocated(output_index, allocator).get();
+        auto shape = session->session->GetOutputTypeInfo(output_index).GetTensorTypeAndShapeInfo().GetShape();
+        session->pooled_output = shape.size() == 2;
+
+        session_ = std::move(session);
+    } catch (const std::exception& e) {
+        error = "failed to load " + model_path_ + ": " + e.what();
+        return false;
+    }
+#else
+    error = "built without ONNX Runtime (USE_ONNXRUNTIME); local embeddings unavailable";
+    return false;
+#endif
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (!running_) {
+        running_ = true;
+        dispatcher_ = std::thread(&LocalEmbeddingModel::dispatch_loop, this);
+    }
+    return true;
+}
+
+bool LocalEmbeddingModel::embed(const std::vector<std::string>& texts, bool normalize,
+                                std::vector<std::vector<float>>& embeddings) {
+    embeddings.clear();
+    if (texts.empty()) {
+        return true;
+    }
+
+    Job job;
+    job.texts = &texts;
+    job.output = &embeddings;
+    job.normalize = normalize;
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    if (!running_) {
+        return false;
+    }
+    queue_.push_back(&job);
+    queue_cv_.notify_one();
+    done_cv_.wait(lock, [&job] { return job.done; });
+    return job.ok;
+}
+
+void LocalEmbeddingModel::dispatch_loop() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (true) {
+        queue_cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            break;  // stopped and drained
+        }
+
+        // Give other callers a moment to join this batch
+        auto deadline = std::chrono::steady_clock::now() + options_.batch_linger;
+        auto queued_texts = [this] {
+            size_t total = 0;
+            for (const Job* job : queue_) total += job->texts->size();
+            return total;
+        };
+        while (running_ && queued_texts() < options_.max_batch_size &&
+               queue_cv_.wait_until(lock, deadline) != std::cv_status::timeout) {
+        }
+
+        // Take whole jobs up to the batch size (always at least one)
+        std::vector<Job*> jobs;
+        size_t taken = 0;
+        while (!queue_.empty() &&
+               (jobs.empty() || taken + queue_.front()->texts->size() <= options_.max_batch_size)) {
+            taken += queue_.front()->texts->size();
+            jobs.push_back(queue_.front());
+            queue_.pop_front();
+        }
+
+        lock.unlock();
+        run_jobs(jobs);
+        lock.lock();
+
+        for (Job* job : jobs) {
+            job->done = true;
+        }
+        done_cv_.notify_all();
+    }
+
+    // Fail anything that raced with shutdown
+    for (Job* job : queue_) {
+        job->done = true;
+    }
+    queue_.clear();
+    done_cv_.notify_all();
+}
+
+void LocalEmbeddingModel::run_jobs(std::vector<Job*>& jobs) {
+    // Flatten every caller's texts, then order by token count so each
+    // inference call pads to a similar length
+    std::vector<std::vector<int64_t>> token_ids;
+    std::vector<std::pair<Job*, size_t>> owners;
+    for (Job* job : jobs) {
+        job->output->assign(job->texts->size(), {});
+        job->ok = true;
+        for (size_t i = 0; i < job->texts->size(); ++i) {
+            token_ids.push_back(tokenizer_.encode((*job->texts)[i], options_.max_seq_length));
+            owners.emplace_back(job, i);
+        }
+    }
+
+    std::vector<size_t> order(token_ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return token_ids[a].size() < token_ids[b].size(); });
+
+    for (size_t begin = 0; begin < order.size(); begin += options_.max_batch_size) {
+        size_t end = std::min(order.size(), begin + options_.max_batch_size);
+        std::vector<std::vector<int64_t>> batch;
+        batch.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            batch.push_back(std::move(token_ids[order[i]]));
+        }
+
+        std::vector<std::vector<float>> pooled;
+        bool ok = run_inference(batch, pooled);
+        for (size_t i = begin; i < end; ++i) {
+            auto [job, index] = owners[order[i]];
+            if (!ok) {
+                job->ok = false;
+                continue;
+            }
+            auto& vector = (*job->output)[index];
+            vector = std::move(pooled[i - begin]);
+            if (job->normalize) {
+                vector_kernels::normalize(vector.data(), vector.size());
+            }
+        }
+    }
+
+    callers_served_ += jobs.size();
+    texts_embedded_ += order.size();
+}
+
+bool LocalEmbeddingModel::run_inference(const std::vector<std::vector<int64_t>>& token_ids,
+                                        std::vector<std::vector<float>>& pooled) {
+#ifdef USE_ONNXRUNTIME
+    if (!session_ || token_ids.empty()) {
+        return false;
+    }
+
+    size_t batch = token_ids.size();
+    size_t seq_len = 0;
+    for (const auto& ids : token_ids) {
+        seq_len = std::max(seq_len, ids.size());
+    }
+
+    std::vector<int64_t> input_ids(batch * seq_len, tokenizer_.pad_id());
+    std::vector<int64_t> attention_mask(batch * seq_len, 0);
+    std::vector<int64_t> token_type_ids(batch * seq_len, 0);
+    size_t real_tokens = 0;
+    for (size_t b = 0; b < batch; ++b) {
+        std::copy(token_ids[b].begin(), token_ids[b].end(), input_ids.begin() + b * seq_len);
+        std::fill_n(attention_mask.begin() + b * seq_len, token_ids[b].size(), 1);
+        real_tokens += token_ids[b].size();
+    }
+    real_tokens_ += real_tokens;
+    padded_tokens_ += batch * seq_len - real_tokens;
+
+    try {
+        auto memory_info = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        std::array<int64_t, 2> shape{static_cast<int64_t>(batch), static_cast<int64_t>(seq_len)};
+
+        std::vector<Ort::Value> inputs;
+        std::vector<const char*> input_names;
+        for (const auto& name : session_->input_names) {
+            std::vector<int64_t>* source = name == "input_ids" ? &input_ids
+                                         : name == "attention_mask" ? &attention_mask
+                                         : name == "token_type_ids" ? &token_type_ids
+                                         : nullptr;
+            if (!source) {
+                return false;  // unexpected model signature
+            }
+            inputs.push_back(Ort::Value::CreateTensor<int64_t>(memory_info, source->data(), source->size(),
+                                                               shape.data(), shape.size()));
+            input_names.push_back(name.c_str());
+        }
+
+        const char* output_name = session_->output_name.c_str();
+        auto outputs = session_->session->Run(Ort::RunOptions{nullptr}, input_names.data(), inputs.data(),
+                                              inputs.size(), &output_name, 1);
+        inference_calls_++;
+
+        const float* data = outputs[0].GetTensorData<float>();
+        auto out_shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+        size_t hidden = static_cast<size_t>(out_shape.back());
+        dimension_ = hidden;
+
+        pooled.assign(batch, std::vector<float>(hidden, 0.0f));
+        if (session_->pooled_output || out_shape.size() == 2) {
+            for (size_t b = 0; b < batch; ++b) {
+                std::copy_n(data + b * hidden, hidden, pooled[b].begin());
+            }
+            return true;
+        }
+
+        // Mean over real (unmasked) token states
+        for (size_t b = 0; b < batch; ++b) {
+            size_t tokens = token_ids[b].size();
+            float* out = pooled[b].data();
+            for (size_t t = 0; t < tokens; ++t) {
+                const float* state = data + (b * seq_len + t) * hidden;
+                for (size_t h = 0; h < hidden; ++h) {
+                    out[h] += state[h];
+                }
+            }
+            float inv = 1.0f / static_cast<float>(std::max<size_t>(tokens, 1));
+            for (size_t h = 0; h < hidden; ++h) {
+                out[h] *= inv;
+            }
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+#else
+    (void)token_ids;
+    (void)pooled;
+    return false;
+#endif
+}
+
+nlohmann::json LocalEmbeddingModel::get_stats() const {
+    uint64_t calls = inference_calls_.load();
+    uint64_t real = real_tokens_.load();
+    uint64_t padded = padded_tokens_.load();
+    return {
+        {"model", model_name_},
+        {"model_path", model_path_},
+        {"dimension", dimension_.load()},
+        {"inference_calls", calls},
+        {"texts_embedded", texts_embedded_.load()},
+        {"callers_served", callers_served_.load()},
+        {"average_batch_size", calls > 0 ? static_cast<double>(texts_embedded_.load()) / static_cast<double>(calls) : 0.0},
+        {"padding_ratio", real + padded > 0 ? static_cast<double>(padded) / static_cast<double>(real + padded) : 0.0}
+    };
+}
+
+} // namespace regulens
@@ -0,0 +1,146 @@
+/**
+ * Local Embedding Model - CPU sentence-embedding inference
+ *
+ * Runs sentence-transformers style ONNX exports (BERT-family encoders with a
+ * WordPiece vocabulary) through ONNX Runtime and mean-pools the token states.
+ * Concurrent callers are coalesced into shared inference batches by a
+ * dispatcher thread, and ONNX Runtime's intra-op thread pool spreads each
+ * batch across the configured cores.
+ *
+ * Expected model directory layout (as exported by optimum / fastembed):
+ *   <cache_dir>/<model_name>/model.onnx     (or onnx/model.onnx)
+ *   <cache_dir>/<model_name>/vocab.txt      (or tokenizer.json)
+ *
+ * Builds without USE_ONNXRUNTIME still compile; load() then fails with an
+ * explanatory error.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace regulens {
+
+struct LocalEmbeddingOptions {
+    size_t max_seq_length = 512;
+    size_t max_batch_size = 64;                         // texts per inference call, across callers
+    std::chrono::microseconds batch_linger{2000};      // wait for more callers once one is queued
+    int intra_op_threads = 0;                           // 0 = one per hardware thread
+};
+
+/**
+ * @brief BERT WordPiece tokenizer (basic split + greedy longest-match)
+ */
+class WordPieceTokenizer {
+public:
+    /**
+     * @brief Load vocab.txt, falling back to tokenizer.json, from a model directory
+     */
+    bool load(const std::string& model_dir, std::string& error);
+
+    /**
+     * @brief Token ids including [CLS] and [SEP], truncated to max_length
+     */
+    std::vector<int64_t> encode(const std::string& text, size_t max_length) const;
+
+    int64_t pad_id() const { return pad_id_; }
+    size_t vocab_size() const { return vocab_.size(); }
+
+private:
+    bool load_vocab_txt(const std::string& path);
+    bool load_tokenizer_json(const std::string& path);
+    bool resolve_special_tokens(std::string& error);
+    void append_word(const std::string& word, std::vector<int64_t>& ids) const;
+
+    std::unordered_map<std::string, int64_t> vocab_;
+    bool lowercase_ = true;
+    int64_t cls_id_ = -1;
+    int64_t sep_id_ = -1;
+    int64_t unk_id_ = -1;
+    int64_t pad_id_ = 0;
+};
+
+/**
+ * @brief One loaded ONNX sentence-embedding model with cross-caller batching
+ *
+ * embed() is thread-safe; callers block until their texts have been run.
+ */
+class LocalEmbeddingModel {
+public:
+    LocalEmbeddingModel(std::string model_name, LocalEmbeddingOptions options);
+    ~LocalEmbeddingModel();
+
+    LocalEmbeddingModel(const LocalEmbeddingModel&) = delete;
+    LocalEmbeddingModel& operator=(const LocalEmbeddingModel&) = delete;
+
+    /**
+     * @brief Locate and load the model and tokenizer under cache_dir
+     */
+    bool load(const std::string& cache_dir, std::string& error);
+
+    /**
+     * @brief Embed texts, sharing inference batches with concurrent callers
+     */
+    bool embed(const std::vector<std::string>& texts, bool normalize,
+               std::vector<std::vector<float>>& embeddings);
+
+    const std::string& model_name() const { return model_name_; }
+    const std::string& model_path() const { return model_path_; }
+    size_t dimension() const { return dimension_.load(); }
+    nlohmann::json get_stats() const;
+
+    /**
+     * @brief Candidate directories for a model name under a cache root
+     */
+    static std::vector<std::string> candidate_dirs(const std::string& cache_dir, const std::string& model_name);
+
+private:
+    struct Session;  // ONNX Runtime state, kept out of this header
+
+    struct Job {
+        const std::vector<std::string>* texts = nullptr;
+        std::vector<std::vector<float>>* output = nullptr;
+        bool normalize = true;
+        bool done = false;
+        bool ok = false;
+    };
+
+    void dispatch_loop();
+    void run_jobs(std::vector<Job*>& jobs);
+    bool run_inference(const std::vector<std::vector<int64_t>>& token_ids,
+                       std::vector<std::vector<float>>& pooled);
+
+    std::string model_name_;
+    LocalEmbeddingOptions options_;
+    std::string model_path_;
+    WordPieceTokenizer tokenizer_;
+    std::unique_ptr<Session> session_;
+    std::atomic<size_t> dimension_{0};
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::condition_variable done_cv_;
+    std::deque<Job*> queue_;
+    std::thread dispatcher_;
+    bool running_ = false;
+
+    // Statistics
+    std::atomic<uint64_t> inference_calls_{0};
+    std::atomic<uint64_t> texts_embedded_{0};
+    std::atomic<uint64_t> callers_served_{0};
+    std::atomic<uint64_t> padded_tokens_{0};
+    std::atomic<uint64_t> real_tokens_{0};
+};
+
+} // namespace regulens
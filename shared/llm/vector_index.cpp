@@ -0,0 +1,994 @@
+/**
+ * Vector Index Implementation
+ */
+
+#include "vector_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <queue>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REGULENS_X86_KERNELS 1
+#endif
+
+namespace regulens {
+
+namespace vector_kernels {
+
+namespace {
+
+float dot_scalar(const float* a, const float* b, size_t dim) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= dim; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < dim; ++i) {
+        s0 += a[i] * b[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+
+float dot_int8_scalar(const float* query, const int8_t* codes, size_t dim) {
+    float s0 = 0.0f, s1 = 0.0f;
+    size_t i = 0;
+    for (; i + 2 <= dim; i += 2) {
+        s0 += query[i] * static_cast<float>(codes[i]);
+        s1 += query[i + 1] * static_cast<float>(codes[i + 1]);
+    }
+    for (; i < dim; ++i) {
+        s0 += query[i] * static_cast<float>(codes[i]);
+    }
+    return s0 + s1;
+}
+
+#ifdef REGULENS_X86_KERNELS
+
+__attribute__((target("avx2,fma")))
+float dot_avx2(const float* a, const float* b, size_t dim) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    if (i + 8 <= dim) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        i += 8;
+    }
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    float result = _mm_cvtss_f32(sum);
+    for (; i < dim; ++i) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+__attribute__((target("avx512f")))
+float dot_avx512(const float* a, const float* b, size_t dim) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= dim; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    for (; i + 16 <= dim; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    if (i < dim) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (dim - i)) - 1);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc1);
+    }
+    return _mm512_reduce_add_ps(_mm512_add_ps(acc0, acc1));
+}
+
+__attribute__((target("avx2,fma")))
+float dot_int8_avx2(const float* query, const int8_t* codes, size_t dim) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= dim; i += 8) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + i));
+        __m256 widened = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(bytes));
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(query + i), widened, acc);
+    }
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    float result = _mm_cvtss_f32(sum);
+    for (; i < dim; ++i) {
+        result += query[i] * static_cast<float>(codes[i]);
+    }
+    return result;
+}
+
+__attribute__((target("avx512f")))
+float dot_int8_avx512(const float* query, const int8_t* codes, size_t dim) {
+    __m512 acc = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= dim; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i));
+        __m512 widened = _mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(bytes));
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(query + i), widened, acc);
+    }
+    float result = _mm512_reduce_add_ps(acc);
+    for (; i < dim; ++i) {
+        result += query[i] * static_cast<float>(codes[i]);
+    }
+    return result;
+}
+
+#endif
+
+using DotFunction = float (*)(const float*, const float*, size_t);
+using DotInt8Function = float (*)(const float*, const int8_t*, size_t);
+
+struct KernelChoice {
+    DotFunction dot;
+    DotInt8Function dot_int8;
+    const char* name;
+};
+
+KernelChoice select_kernel() {
+#ifdef REGULENS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return {dot_avx512, dot_int8_avx512, "avx512"};
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return {dot_avx2, dot_int8_avx2, "avx2"};
+    }
+#endif
+    return {dot_scalar, dot_int8_scalar, "scalar"};
+}
+
+const KernelChoice& kernel() {
+    static const KernelChoice choice = select_kernel();
+    return choice;
+}
+
+} // namespace
+
+float dot(const float* a, const float* b, size_t dim) {
+    return kernel().dot(a, b, dim);
+}
+
+float normalize(float* values, size_t dim) {
+    float norm = std::sqrt(dot(values, values, dim));
+    if (norm > 0.0f) {
+        float inv = 1.0f / norm;
+        for (size_t i = 0; i < dim; ++i) {
+            values[i] *= inv;
+        }
+    }
+    return norm;
+}
+
+float dot_int8(const float* query, const int8_t* codes, size_t dim) {
+    return kernel().dot_int8(query, codes, dim);
+}
+
+const char* active_kernel() {
+    return kernel().name;
+}
+
+} // namespace vector_kernels
+
+// EmbeddingMatrix
+
+long EmbeddingMatrix::add(const std::vector<float>& embedding) {
+    if (embedding.empty()) {
+        return -1;
+    }
+    if (rows_ == 0 && dim_ == 0) {
+        dim_ = embedding.size();
+        stride_ = (dim_ + 15) & ~static_cast<size_t>(15);
+    }
+    if (embedding.size() != dim_) {
+        return -1;
+    }
+
+    data_.resize((rows_ + 1) * stride_, 0.0f);
+    float* dest = data_.data() + rows_ * stride_;
+    std::memcpy(dest, embedding.data(), dim_ * sizeof(float));
+    vector_kernels::normalize(dest, dim_);
+    return static_cast<long>(rows_++);
+}
+
+void EmbeddingMatrix::compact(const std::vector<char>& keep) {
+    size_t kept = 0;
+    for (size_t i = 0; i < rows_; ++i) {
+        if (i < keep.size() && keep[i]) {
+            if (kept != i) {
+                std::memcpy(data_.data() + kept * stride_, data_.data() + i * stride_, stride_ * sizeof(float));
+            }
+            ++kept;
+        }
+    }
+    rows_ = kept;
+    data_.resize(rows_ * stride_);
+    data_.shrink_to_fit();
+}
+
+void EmbeddingMatrix::reserve(size_t rows) {
+    if (stride_ > 0) {
+        data_.reserve(rows * stride_);
+    }
+}
+
+void EmbeddingMatrix::clear() {
+    decltype(data_)().swap(data_);
+    dim_ = 0;
+    stride_ = 0;
+    rows_ = 0;
+}
+
+// TopKSelector
+
+namespace {
+
+bool heap_greater(const std::pair<float, size_t>& a, const std::pair<float, size_t>& b) {
+    return a.first > b.first;
+}
+
+} // namespace
+
+float TopKSelector::floor() const {
+    if (heap_.size() < k_) {
+        return -std::numeric_limits<float>::infinity();
+    }
+    return heap_.front().first;
+}
+
+void TopKSelector::offer(float score, size_t row) {
+    if (k_ == 0) {
+        return;
+    }
+    if (heap_.size() < k_) {
+        heap_.emplace_back(score, row);
+        std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+    } else if (score > heap_.front().first) {
+        std::pop_heap(heap_.begin(), heap_.end(), heap_greater);
+        heap_.back() = {score, row};
+        std::push_heap(heap_.begin(), heap_.end(), heap_greater);
+    }
+}
+
+std::vector<std::pair<float, size_t>> TopKSelector::take_sorted() {
+    std::sort(heap_.begin(), heap_.end(), heap_greater);
+    return std::move(heap_);
+}
+
+std::vector<std::pair<float, size_t>> exact_top_k(
+    const EmbeddingMatrix& matrix,
+    const float* unit_query,
+    size_t k,
+    float threshold,
+    const std::function<bool(size_t)>& accept) {
+
+    TopKSelector selector(k);
+    for (size_t i = 0; i < matrix.size(); ++i) {
+        if (accept && !accept(i)) continue;
+        float score = matrix.similarity(i, unit_query);
+        if (score >= threshold && score > selector.floor()) {
+            selector.offer(score, i);
+        }
+    }
+    return selector.take_sorted();
+}
+
+// HnswIndex
+
+HnswIndex::HnswIndex(Params params)
+    : params_(params),
+      level_multiplier_(1.0 / std::log(static_cast<double>(std::max<size_t>(params.m, 2)))),
+      rng_(params.seed) {
+    params_.m = std::max<size_t>(params_.m, 2);
+}
+
+void HnswIndex::clear() {
+    levels_.clear();
+    links_.clear();
+    visit_marks_.clear();
+    visit_epoch_ = 0;
+    entry_point_ = 0;
+    max_level_ = -1;
+    rng_.seed(params_.seed);
+}
+
+void HnswIndex::sync(const EmbeddingMatrix& matrix) {
+    for (size_t node = levels_.size(); node < matrix.size(); ++node) {
+        insert(matrix, static_cast<uint32_t>(node));
+    }
+}
+
+size_t HnswIndex::sync(const EmbeddingMatrix& matrix, size_t max_inserts) {
+    size_t end = std::min(matrix.size(), levels_.size() + max_inserts);
+    for (size_t node = levels_.size(); node < end; ++node) {
+        insert(matrix, static_cast<uint32_t>(node));
+    }
+    return matrix.size() - levels_.size();
+}
+
+void HnswIndex::insert(const EmbeddingMatrix& matrix, uint32_t node) {
+    std::uniform_real_distribution<double> uniform(std::numeric_limits<double>::min(), 1.0);
+    int level = static_cast<int>(-std::log(uniform(rng_)) * level_multiplier_);
+
+    levels_.push_back(level);
+    links_.emplace_back(static_cast<size_t>(level) + 1);
+
+    if (max_level_ < 0) {
+        entry_point_ = node;
+        max_level_ = level;
+        return;
+    }
+
+    const float* query = matrix.row(node);
+    uint32_t entry = entry_point_;
+
+    // Greedy descent through layers above the new node
+    for (int layer = max_level_; layer > level; --layer) {
+        entry = search_layer(matrix, query, entry, 1, layer).front().second;
+    }
+
+    for (int layer = std::min(level, max_level_); layer >= 0; --layer) {
+        size_t max_links = layer == 0 ? params_.m * 2 : params_.m;
+        auto candidates = search_layer(matrix, query, entry, params_.ef_construction, layer);
+        entry = candidates.front().second;
+
+        links(node, layer) = select_neighbors(matrix, candidates, params_.m);
+        for (uint32_t neighbor : links(node, layer)) {
+            auto& neighbor_links = links(neighbor, layer);
+            neighbor_links.push_back(node);
+            if (neighbor_links.size() > max_links) {
+                std::vector<Candidate> scored;
+                scored.reserve(neighbor_links.size());
+                for (uint32_t other : neighbor_links) {
+                    scored.emplace_back(matrix.similarity(other, matrix.row(neighbor)), other);
+                }
+                std::sort(scored.begin(), scored.end(), std::greater<>());
+                neighbor_links = select_neighbors(matrix, std::move(scored), max_links);
+            }
+        }
+    }
+
+    if (level > max_level_) {
+        max_level_ = level;
+        entry_point_ = node;
+    }
+}
+
+std::vector<HnswIndex::Candidate> HnswIndex::search_layer(const EmbeddingMatrix& matrix, const float* query,
+                                                          uint32_t entry, size_t ef, int layer) const {
+    if (visit_marks_.size() < levels_.size()) {
+        visit_marks_.resize(levels_.size(), 0);
+    }
+    if (++visit_epoch_ == 0) {
+        std::fill(visit_marks_.begin(), visit_marks_.end(), 0);
+        visit_epoch_ = 1;
+    }
+    auto first_visit = [this](uint32_t node) {
+        if (visit_marks_[node] == visit_epoch_) return false;
+        visit_marks_[node] = visit_epoch_;
+        return true;
+    };
+
+    std::priority_queue<Candidate> frontier;                                            // best first
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> best;        // worst first
+
+    float entry_score = matrix.similarity(entry, query);
+    frontier.emplace(entry_score, entry);
+    best.emplace(entry_score, entry);
+    first_visit(entry);
+
+    while (!frontier.empty()) {
+        Candidate current = frontier.top();
+        if (best.size() >= ef && current.first < best.top().first) {
+            break;
+        }
+        frontier.pop();
+
+        for (uint32_t neighbor : links(current.second, layer)) {
+            if (!first_visit(neighbor)) continue;
+            float score = matrix.similarity(neighbor, query);
+            if (best.size() < ef || score > best.top().first) {
+                frontier.emplace(score, neighbor);
+                best.emplace(score, neighbor);
+                if (best.size() > ef) {
+                    best.pop();
+                }
+            }
+        }
+    }
+
+    std::vector<Candidate> result;
+    result.reserve(best.size());
+    while (!best.empty()) {
+        result.push_back(best.top());
+        best.pop();
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+std::vector<uint32_t> HnswIndex::select_neighbors(const EmbeddingMatrix& matrix,
+                                                  std::vector<Candidate> candidates, size_t max_links) const {
+    // Keep a candidate only if it is closer to the base node than to any neighbour
+    // already kept, which preserves links towards distinct regions of the graph
+    std::vector<uint32_t> selected;
+    std::vector<uint32_t> pruned;
+    selected.reserve(max_links);
+
+    for (const auto& [score, candidate] : candidates) {
+        if (selected.size() >= max_links) break;
+        bool diverse = true;
+        for (uint32_t kept : selected) {
+            if (matrix.similarity(candidate, matrix.row(kept)) > score) {
+                diverse = false;
+                break;
+            }
+        }
+        (diverse ? selected : pruned).push_back(candidate);
+    }
+
+    for (size_t i = 0; i < pruned.size() && selected.size() < max_links; ++i) {
+        selected.push_back(pruned[i]);
+    }
+    return selected;
+}
+
+std::vector<std::pair<float, size_t>> HnswIndex::search(
+    const EmbeddingMatrix& matrix,
+    const float* unit_query,
+    size_t k,
+    float threshold,
+    const std::function<bool(size_t)>& accept) const {
+
+    if (max_level_ < 0 || k == 0) {
+        return {};
+    }
+
+    uint32_t entry = entry_point_;
+    for (int layer = max_level_; layer > 0; --layer) {
+        entry = search_layer(matrix, unit_query, entry, 1, layer).front().second;
+    }
+
+    auto candidates = search_layer(matrix, unit_query, entry, std::max(params_.ef_search, k), 0);
+
+    std::vector<std::pair<float, size_t>> results;
+    results.reserve(k);
+    for (const auto& [score, node] : candidates) {
+        if (score < threshold) break;  // candidates are best first
+        if (accept && !accept(node)) continue;
+        results.emplace_back(score, node);
+        if (results.size() == k) break;
+    }
+    return results;
+}
+
+// Quantization
+
+namespace {
+
+constexpr size_t kPqCentroids = 256;
+constexpr size_t kPqTrainIterations = 8;
+constexpr size_t kRecallSampleSize = 1024;
+constexpr size_t kRecallQueries = 100;
+
+float squared_distance(const float* a, const float* b, size_t dim) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < dim; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+void quantize_int8(const float* values, size_t dim, int8_t* codes, float& scale) {
+    float max_abs = 0.0f;
+    for (size_t i = 0; i < dim; ++i) {
+        max_abs = std::max(max_abs, std::fabs(values[i]));
+    }
+    scale = max_abs > 0.0f ? max_abs / 127.0f : 0.0f;
+    float inv = scale > 0.0f ? 1.0f / scale : 0.0f;
+    for (size_t i = 0; i < dim; ++i) {
+        float q = std::nearbyint(values[i] * inv);
+        codes[i] = static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+    }
+}
+
+} // namespace
+
+VectorQuantization parse_vector_quantization(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "int8" || lower == "sq8") return VectorQuantization::INT8;
+    if (lower == "pq" || lower == "product") return VectorQuantization::PRODUCT;
+    return VectorQuantization::NONE;
+}
+
+std::string vector_quantization_to_string(VectorQuantization mode) {
+    switch (mode) {
+        case VectorQuantization::INT8: return "int8";
+        case VectorQuantization::PRODUCT: return "pq";
+        default: return "none";
+    }
+}
+
+Int8Embedding Int8Embedding::encode(const std::vector<float>& values) {
+    Int8Embedding encoded;
+    encoded.codes.resize(values.size());
+    quantize_int8(values.data(), values.size(), encoded.codes.data(), encoded.scale);
+    return encoded;
+}
+
+std::vector<float> Int8Embedding::decode() const {
+    std::vector<float> values(codes.size());
+    for (size_t i = 0; i < codes.size(); ++i) {
+        values[i] = static_cast<float>(codes[i]) * scale;
+    }
+    return values;
+}
+
+QuantizedVectorStore::QuantizedVectorStore(QuantizationConfig config)
+    : config_(config) {
+    config_.rerank_factor = std::max<size_t>(config_.rerank_factor, 1);
+    config_.pq_train_size = std::max(config_.pq_train_size, kPqCentroids);
+}
+
+long QuantizedVectorStore::add(const std::vector<float>& embedding) {
+    if (embedding.empty() || (rows_ > 0 && embedding.size() != dim_)) {
+        return -1;
+    }
+    if (rows_ == 0 && dim_ == 0) {
+        dim_ = embedding.size();
+        if (config_.mode == VectorQuantization::PRODUCT) {
+            pq_m_ = std::clamp<size_t>(config_.pq_subspaces, 1, dim_);
+            while (dim_ % pq_m_ != 0) {
+                --pq_m_;
+            }
+            pq_dsub_ = dim_ / pq_m_;
+        }
+    }
+
+    std::vector<float> unit = embedding;
+    vector_kernels::normalize(unit.data(), dim_);
+    size_t row = rows_;
+
+    bool keep_float = config_.mode == VectorQuantization::NONE || config_.keep_float_vectors ||
+                      (config_.mode == VectorQuantization::PRODUCT && !pq_trained());
+    if (keep_float) {
+        floats_.add(unit);
+    }
+    if (config_.mode == VectorQuantization::INT8 ||
+        (config_.mode == VectorQuantization::PRODUCT && pq_trained())) {
+        encode_row(unit.data());
+    }
+
+    ++rows_;
+    sample_row(unit.data(), row);
+    return static_cast<long>(row);
+}
+
+void QuantizedVectorStore::encode_row(const float* unit_row) {
+    if (config_.mode == VectorQuantization::INT8) {
+        size_t offset = int8_codes_.size();
+        int8_codes_.resize(offset + dim_);
+        float scale = 0.0f;
+        quantize_int8(unit_row, dim_, int8_codes_.data() + offset, scale);
+        int8_scales_.push_back(scale);
+        return;
+    }
+
+    for (size_t m = 0; m < pq_m_; ++m) {
+        const float* sub = unit_row + m * pq_dsub_;
+        const float* centroids = pq_centroids_.data() + m * kPqCentroids * pq_dsub_;
+        size_t best = 0;
+        float best_distance = std::numeric_limits<float>::max();
+        for (size_t c = 0; c < kPqCentroids; ++c) {
+            float distance = squared_distance(sub, centroids + c * pq_dsub_, pq_dsub_);
+            if (distance < best_distance) {
+                best_distance = distance;
+                best = c;
+            }
+        }
+        pq_codes_.push_back(static_cast<uint8_t>(best));
+    }
+}
+
+bool QuantizedVectorStore::pq_training_due() const {
+    return config_.mode == VectorQuantization::PRODUCT && !pq_trained() && rows_ >= config_.pq_train_size;
+}
+
+QuantizedVectorStore::PqTrainingSet QuantizedVectorStore::pq_training_set() const {
+    // A random sample of the buffered float rows
+    std::mt19937 rng(1234);
+    std::vector<size_t> order(rows_);
+    for (size_t i = 0; i < rows_; ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    PqTrainingSet set;
+    set.count = std::min(rows_, config_.pq_train_size);
+    set.dim = dim_;
+    set.subspaces = pq_m_;
+    set.rows.resize(set.count * dim_);
+    for (size_t t = 0; t < set.count; ++t) {
+        std::memcpy(set.rows.data() + t * dim_, floats_.row(order[t]), dim_ * sizeof(float));
+    }
+    return set;
+}
+
+std::vector<float> QuantizedVectorStore::train_pq_codebooks(const PqTrainingSet& set) {
+    // k-means per subspace (Lloyd iterations, centroids seeded from the
+    // sample's leading rows, which are already in random order)
+    if (set.count == 0 || set.subspaces == 0) {
+        return {};
+    }
+    std::mt19937 rng(1234);
+    size_t dsub = set.dim / set.subspaces;
+    std::vector<float> codebooks(set.subspaces * kPqCentroids * dsub, 0.0f);
+    std::vector<uint16_t> assignment(set.count);
+    std::vector<float> sums(kPqCentroids * dsub);
+    std::vector<size_t> counts(kPqCentroids);
+
+    for (size_t m = 0; m < set.subspaces; ++m) {
+        float* centroids = codebooks.data() + m * kPqCentroids * dsub;
+        auto sub_of = [&](size_t t) { return set.rows.data() + t * set.dim + m * dsub; };
+
+        for (size_t c = 0; c < kPqCentroids; ++c) {
+            std::memcpy(centroids + c * dsub, sub_of(c % set.count), dsub * sizeof(float));
+        }
+
+        for (size_t iteration = 0; iteration < kPqTrainIterations; ++iteration) {
+            for (size_t t = 0; t < set.count; ++t) {
+                const float* sub = sub_of(t);
+                float best_distance = std::numeric_limits<float>::max();
+                for (size_t c = 0; c < kPqCentroids; ++c) {
+                    float distance = squared_distance(sub, centroids + c * dsub, dsub);
+                    if (distance < best_distance) {
+                        best_distance = distance;
+                        assignment[t] = static_cast<uint16_t>(c);
+                    }
+                }
+            }
+
+            std::fill(sums.begin(), sums.end(), 0.0f);
+            std::fill(counts.begin(), counts.end(), 0);
+            for (size_t t = 0; t < set.count; ++t) {
+                const float* sub = sub_of(t);
+                float* sum = sums.data() + assignment[t] * dsub;
+                for (size_t d = 0; d < dsub; ++d) sum[d] += sub[d];
+                ++counts[assignment[t]];
+            }
+            for (size_t c = 0; c < kPqCentroids; ++c) {
+                if (counts[c] == 0) {
+                    // Re-seed empty clusters so every code stays useful
+                    std::memcpy(centroids + c * dsub, sub_of(rng() % set.count), dsub * sizeof(float));
+                    continue;
+                }
+                for (size_t d = 0; d < dsub; ++d) {
+                    centroids[c * dsub + d] = sums[c * dsub + d] / static_cast<float>(counts[c]);
+                }
+            }
+        }
+    }
+    return codebooks;
+}
+
+bool QuantizedVectorStore::install_pq_codebooks(const PqTrainingSet& set, std::vector<float> codebooks) {
+    // The store may have been cleared or reconfigured while the codebooks were trained
+    if (config_.mode != VectorQuantization::PRODUCT || pq_trained() || rows_ == 0 ||
+        set.dim != dim_ || set.subspaces != pq_m_ || codebooks.size() != pq_m_ * kPqCentroids * pq_dsub_) {
+        return false;
+    }
+
+    pq_centroids_ = std::move(codebooks);
+    pq_codes_.reserve(rows_ * pq_m_);
+    for (size_t row = 0; row < rows_; ++row) {
+        encode_row(floats_.row(row));
+    }
+    if (!config_.keep_float_vectors) {
+        floats_.clear();
+    }
+    return true;
+}
+
+std::vector<float> QuantizedVectorStore::build_lut(const float* unit_query) const {
+    if (config_.mode != VectorQuantization::PRODUCT || !pq_trained()) {
+        return {};
+    }
+    std::vector<float> lut(pq_m_ * kPqCentroids);
+    for (size_t m = 0; m < pq_m_; ++m) {
+        const float* sub = unit_query + m * pq_dsub_;
+        const float* centroids = pq_centroids_.data() + m * kPqCentroids * pq_dsub_;
+        for (size_t c = 0; c < kPqCentroids; ++c) {
+            lut[m * kPqCentroids + c] = vector_kernels::dot(sub, centroids + c * pq_dsub_, pq_dsub_);
+        }
+    }
+    return lut;
+}
+
+float QuantizedVectorStore::quantized_similarity(size_t row, const float* unit_query,
+                                                 const std::vector<float>& lut) const {
+    switch (config_.mode) {
+        case VectorQuantization::INT8:
+            return vector_kernels::dot_int8(unit_query, int8_codes_.data() + row * dim_, dim_) * int8_scales_[row];
+        case VectorQuantization::PRODUCT:
+            if (!lut.empty()) {
+                const uint8_t* codes = pq_codes_.data() + row * pq_m_;
+                float score = 0.0f;
+                for (size_t m = 0; m < pq_m_; ++m) {
+                    score += lut[m * kPqCentroids + codes[m]];
+                }
+                return score;
+            }
+            [[fallthrough]];
+        default:
+            return floats_.similarity(row, unit_query);
+    }
+}
+
+float QuantizedVectorStore::similarity(size_t row, const float* unit_query) const {
+    if (floats_.size() == rows_) {
+        return floats_.similarity(row, unit_query);
+    }
+    return quantized_similarity(row, unit_query, build_lut(unit_query));
+}
+
+std::vector<std::pair<float, size_t>> QuantizedVectorStore::top_k(
+    const float* unit_query,
+    size_t k,
+    float threshold,
+    const std::function<bool(size_t)>& accept) const {
+
+    bool quantized_scan = config_.mode == VectorQuantization::INT8 ||
+                          (config_.mode == VectorQuantization::PRODUCT && pq_trained());
+    if (!quantized_scan) {
+        return exact_top_k(floats_, unit_query, k, threshold, accept);
+    }
+
+    bool rerank = floats_.size() == rows_;
+    std::vector<float> lut = build_lut(unit_query);
+
+    // Quantized scores are approximate, so when re-ranking the threshold is
+    // only applied to the exact scores
+    TopKSelector selector(rerank ? k * config_.rerank_factor : k);
+    for (size_t i = 0; i < rows_; ++i) {
+        if (accept && !accept(i)) continue;
+        float score = quantized_similarity(i, unit_query, lut);
+        if ((rerank || score >= threshold) && score > selector.floor()) {
+            selector.offer(score, i);
+        }
+    }
+    auto candidates = selector.take_sorted();
+    if (!rerank) {
+        return candidates;
+    }
+
+    TopKSelector exact(k);
+    for (const auto& candidate : candidates) {
+        float score = floats_.similarity(candidate.second, unit_query);
+        if (score >= threshold) {
+            exact.offer(score, candidate.second);
+        }
+    }
+    return exact.take_sorted();
+}
+
+std::vector<float> QuantizedVectorStore::decode_row(size_t row) const {
+    std::vector<float> values(dim_);
+    if (config_.mode == VectorQuantization::INT8) {
+        const int8_t* codes = int8_codes_.data() + row * dim_;
+        for (size_t i = 0; i < dim_; ++i) {
+            values[i] = static_cast<float>(codes[i]) * int8_scales_[row];
+        }
+    } else {
+        const uint8_t* codes = pq_codes_.data() + row * pq_m_;
+        for (size_t m = 0; m < pq_m_; ++m) {
+            const float* centroid = pq_centroids_.data() + (m * kPqCentroids + codes[m]) * pq_dsub_;
+            std::memcpy(values.data() + m * pq_dsub_, centroid, pq_dsub_ * sizeof(float));
+        }
+    }
+    return values;
+}
+
+std::vector<float> QuantizedVectorStore::row_vector(size_t row) const {
+    if (floats_.size() == rows_) {
+        return floats_.row_vector(row);
+    }
+    return decode_row(row);
+}
+
+const EmbeddingMatrix* QuantizedVectorStore::float_rows() const {
+    // Untrained PQ rows are only buffered; they disappear once codebooks exist
+    bool stable = config_.mode == VectorQuantization::NONE || config_.keep_float_vectors;
+    return stable && floats_.size() == rows_ ? &floats_ : nullptr;
+}
+
+void QuantizedVectorStore::compact(const std::vector<char>& keep) {
+    if (floats_.size() == rows_) {
+        floats_.compact(keep);
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < rows_; ++i) {
+        if (i >= keep.size() || !keep[i]) continue;
+        if (kept != i) {
+            if (!int8_scales_.empty()) {
+                std::memmove(int8_codes_.data() + kept * dim_, int8_codes_.data() + i * dim_, dim_);
+                int8_scales_[kept] = int8_scales_[i];
+            }
+            if (!pq_codes_.empty()) {
+                std::memmove(pq_codes_.data() + kept * pq_m_, pq_codes_.data() + i * pq_m_, pq_m_);
+            }
+        }
+        ++kept;
+    }
+    if (!int8_scales_.empty()) {
+        int8_codes_.resize(kept * dim_);
+        int8_scales_.resize(kept);
+        int8_codes_.shrink_to_fit();
+        int8_scales_.shrink_to_fit();
+    }
+    if (!pq_codes_.empty()) {
+        pq_codes_.resize(kept * pq_m_);
+        pq_codes_.shrink_to_fit();
+    }
+
+    // Remap the recall sample onto the surviving rows
+    std::vector<size_t> remap(rows_, std::numeric_limits<size_t>::max());
+    for (size_t i = 0, next = 0; i < rows_; ++i) {
+        if (i < keep.size() && keep[i]) remap[i] = next++;
+    }
+    size_t sampled = 0;
+    for (size_t s = 0; s < sample_rows_.size(); ++s) {
+        size_t mapped = remap[sample_rows_[s]];
+        if (mapped == std::numeric_limits<size_t>::max()) continue;
+        if (sampled != s) {
+            std::memcpy(sample_vectors_.data() + sampled * dim_, sample_vectors_.data() + s * dim_,
+                        dim_ * sizeof(float));
+        }
+        sample_rows_[sampled++] = mapped;
+    }
+    sample_rows_.resize(sampled);
+    sample_vectors_.resize(sampled * dim_);
+    sample_seen_ = sampled;
+
+    rows_ = kept;
+}
+
+void QuantizedVectorStore::clear() {
+    floats_.clear();
+    std::vector<int8_t>().swap(int8_codes_);
+    std::vector<float>().swap(int8_scales_);
+    std::vector<uint8_t>().swap(pq_codes_);
+    std::vector<float>().swap(pq_centroids_);
+    std::vector<float>().swap(sample_vectors_);
+    std::vector<size_t>().swap(sample_rows_);
+    sample_seen_ = 0;
+    dim_ = 0;
+    rows_ = 0;
+    pq_m_ = 0;
+    pq_dsub_ = 0;
+}
+
+size_t QuantizedVectorStore::memory_bytes() const {
+    return floats_.memory_bytes() +
+           int8_codes_.capacity() + int8_scales_.capacity() * sizeof(float) +
+           pq_codes_.capacity() + pq_centroids_.capacity() * sizeof(float) +
+           sample_vectors_.capacity() * sizeof(float) + sample_rows_.capacity() * sizeof(size_t);
+}
+
+void QuantizedVectorStore::sample_row(const float* unit_row, size_t row) {
+    if (config_.mode == VectorQuantization::NONE) {
+        return;
+    }
+    ++sample_seen_;
+    size_t slot = sample_rows_.size();
+    if (slot >= kRecallSampleSize) {
+        slot = std::uniform_int_distribution<size_t>(0, sample_seen_ - 1)(sample_rng_);
+        if (slot >= kRecallSampleSize) return;
+    } else {
+        sample_rows_.push_back(row);
+        sample_vectors_.resize(sample_vectors_.size() + dim_);
+    }
+    sample_rows_[slot] = row;
+    std::memcpy(sample_vectors_.data() + slot * dim_, unit_row, dim_ * sizeof(float));
+}
+
+double QuantizedVectorStore::recall_at_k(size_t k) const {
+    if (config_.mode == VectorQuantization::NONE || k == 0) {
+        return 1.0;
+    }
+    size_t sample = sample_rows_.size();
+    if (sample <= k + 1) {
+        return 1.0;
+    }
+
+    // Queries are sampled rows; neighbours are searched among the other sampled
+    // rows with exact float scores and with this store's own scoring path
+    size_t queries = std::min(kRecallQueries, sample);
+    size_t hits = 0;
+    size_t total = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        const float* query = sample_vectors_.data() + q * dim_;
+        std::vector<float> lut = build_lut(query);
+        bool rerank = floats_.size() == rows_;
+
+        TopKSelector exact(k);
+        TopKSelector approx(rerank ? k * config_.rerank_factor : k);
+        for (size_t s = 0; s < sample; ++s) {
+            if (s == q) continue;
+            exact.offer(vector_kernels::dot(sample_vectors_.data() + s * dim_, query, dim_), s);
+            approx.offer(quantized_similarity(sample_rows_[s], query, lut), s);
+        }
+        auto candidates = approx.take_sorted();
+        if (rerank) {
+            TopKSelector reranked(k);
+            for (const auto& candidate : candidates) {
+                reranked.offer(vector_kernels::dot(sample_vectors_.data() + candidate.second * dim_, query, dim_),
+                               candidate.second);
+            }
+            candidates = reranked.take_sorted();
+        }
+
+        std::vector<size_t> truth;
+        for (const auto& entry : exact.take_sorted()) truth.push_back(entry.second);
+        for (const auto& candidate : candidates) {
+            if (std::find(truth.begin(), truth.end(), candidate.second) != truth.end()) ++hits;
+        }
+        total += truth.size();
+    }
+    return total == 0 ? 1.0 : static_cast<double>(hits) / static_cast<double>(total);
+}
+
+double int8_recall_at_k(const std::vector<std::vector<float>>& unit_vectors, size_t k) {
+    size_t sample = std::min(unit_vectors.size(), kRecallSampleSize);
+    if (k == 0 || sample <= k + 1) {
+        return 1.0;
+    }
+    size_t dim = unit_vectors[0].size();
+    std::vector<Int8Embedding> codes;
+    codes.reserve(sample);
+    for (size_t s = 0; s < sample; ++s) {
+        if (unit_vectors[s].size() != dim) {
+            return 1.0;
+        }
+        codes.push_back(Int8Embedding::encode(unit_vectors[s]));
+    }
+
+    size_t queries = std::min(kRecallQueries, sample);
+    size_t hits = 0;
+    size_t total = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        const float* query = unit_vectors[q].data();
+        TopKSelector exact(k);
+        TopKSelector approx(k);
+        for (size_t s = 0; s < sample; ++s) {
+            if (s == q) continue;
+            exact.offer(vector_kernels::dot(unit_vectors[s].data(), query, dim), s);
+            approx.offer(vector_kernels::dot_int8(query, codes[s].codes.data(), dim) * codes[s].scale, s);
+        }
+
+        std::vector<size_t> truth;
+        for (const auto& entry : exact.take_sorted()) truth.push_back(entry.second);
+        for (const auto& candidate : approx.take_sorted()) {
+            if (std::find(truth.begin(), truth.end(), candidate.second) != truth.end()) ++hits;
+        }
+        total += truth.size();
+    }
+    return total == 0 ? 1.0 : static_cast<double>(hits) / static_cast<double>(total);
+}
+
+} // namespace regulens
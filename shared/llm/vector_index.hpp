@@ -0,0 +1,354 @@
+/**
+ * Vector Index - Dense embedding storage and nearest-neighbour search
+ *
+ * Embeddings are stored pre-normalized in one contiguous, 64-byte aligned
+ * matrix so cosine similarity reduces to a dot product. Dot products use
+ * AVX-512 or AVX2/FMA kernels selected at runtime (scalar elsewhere), and
+ * candidates are selected with a bounded top-k heap. HnswIndex adds an
+ * incremental approximate index over the same matrix for large corpora.
+ * QuantizedVectorStore trades precision for memory with int8 scalar or
+ * product quantization, optionally re-ranking candidates on float rows.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace regulens {
+
+namespace vector_kernels {
+
+/**
+ * @brief Dot product of two float vectors using the best available SIMD path
+ */
+float dot(const float* a, const float* b, size_t dim);
+
+/**
+ * @brief Scale a vector to unit length in place; zero vectors are left as-is
+ * @return the original L2 norm
+ */
+float normalize(float* values, size_t dim);
+
+/**
+ * @brief Dot product of a float query with int8 codes (caller applies the row scale)
+ */
+float dot_int8(const float* query, const int8_t* codes, size_t dim);
+
+/**
+ * @brief Name of the kernel chosen for this CPU ("avx512", "avx2", "scalar")
+ */
+const char* active_kernel();
+
+} // namespace vector_kernels
+
+/**
+ * @brief Minimal allocator giving 64-byte aligned storage for SIMD rows
+ */
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+/**
+ * @brief Row-major matrix of unit-length embeddings
+ *
+ * Rows are padded to a multiple of 16 floats so every row starts on a cache
+ * line and the SIMD kernels never need a masked tail for stored data.
+ */
+class EmbeddingMatrix {
+public:
+    EmbeddingMatrix() = default;
+
+    /**
+     * @brief Append a row (normalized on the way in)
+     * @return row index, or -1 if the dimension does not match existing rows
+     */
+    long add(const std::vector<float>& embedding);
+
+    /**
+     * @brief Keep only rows whose keep[row] is non-zero, preserving order
+     */
+    void compact(const std::vector<char>& keep);
+
+    const float* row(size_t index) const { return data_.data() + index * stride_; }
+    std::vector<float> row_vector(size_t index) const { return {row(index), row(index) + dim_}; }
+
+    size_t size() const { return rows_; }
+    size_t dim() const { return dim_; }
+    bool empty() const { return rows_ == 0; }
+    size_t memory_bytes() const { return data_.capacity() * sizeof(float); }
+
+    void reserve(size_t rows);
+    void clear();
+
+    float similarity(size_t index, const float* unit_query) const {
+        return vector_kernels::dot(row(index), unit_query, dim_);
+    }
+
+private:
+    std::vector<float, AlignedAllocator<float>> data_;
+    size_t dim_ = 0;
+    size_t stride_ = 0;
+    size_t rows_ = 0;
+};
+
+/**
+ * @brief Keeps the k best (score, row) pairs seen so far
+ */
+class TopKSelector {
+public:
+    explicit TopKSelector(size_t k) : k_(k) { heap_.reserve(k + 1); }
+
+    // Lowest score that can still enter; -inf until k items are held
+    float floor() const;
+    void offer(float score, size_t row);
+
+    // Best first
+    std::vector<std::pair<float, size_t>> take_sorted();
+
+private:
+    size_t k_;
+    std::vector<std::pair<float, size_t>> heap_;  // min-heap on score
+};
+
+/**
+ * @brief Exact top-k scan over a matrix
+ * @param accept optional filter for deleted rows
+ */
+std::vector<std::pair<float, size_t>> exact_top_k(
+    const EmbeddingMatrix& matrix,
+    const float* unit_query,
+    size_t k,
+    float threshold,
+    const std::function<bool(size_t)>& accept = nullptr);
+
+/**
+ * @brief Hierarchical navigable small world graph over EmbeddingMatrix rows
+ *
+ * Rows are inserted incrementally in matrix order. Deleted rows stay in the
+ * graph as routing nodes and are filtered out of results; rebuild once the
+ * tombstone ratio gets high. Not thread-safe: callers serialize access.
+ */
+class HnswIndex {
+public:
+    struct Params {
+        size_t m = 16;                 // links per node on upper layers (2*m on layer 0)
+        size_t ef_construction = 200;
+        size_t ef_search = 64;
+        uint32_t seed = 42;
+    };
+
+    explicit HnswIndex(Params params);
+
+    /**
+     * @brief Insert every matrix row not yet in the graph
+     */
+    void sync(const EmbeddingMatrix& matrix);
+
+    /**
+     * @brief Insert at most max_inserts pending rows, so callers can release
+     * their lock between steps
+     * @return rows of the matrix still missing from the graph
+     */
+    size_t sync(const EmbeddingMatrix& matrix, size_t max_inserts);
+
+    std::vector<std::pair<float, size_t>> search(
+        const EmbeddingMatrix& matrix,
+        const float* unit_query,
+        size_t k,
+        float threshold,
+        const std::function<bool(size_t)>& accept = nullptr) const;
+
+    size_t size() const { return levels_.size(); }
+    void clear();
+    const Params& params() const { return params_; }
+
+private:
+    using Candidate = std::pair<float, uint32_t>;  // (similarity, node)
+
+    void insert(const EmbeddingMatrix& matrix, uint32_t node);
+    std::vector<Candidate> search_layer(const EmbeddingMatrix& matrix, const float* query,
+                                        uint32_t entry, size_t ef, int layer) const;
+    std::vector<uint32_t> select_neighbors(const EmbeddingMatrix& matrix,
+                                           std::vector<Candidate> candidates, size_t max_links) const;
+    std::vector<uint32_t>& links(uint32_t node, int layer) { return links_[node][layer]; }
+    const std::vector<uint32_t>& links(uint32_t node, int layer) const { return links_[node][layer]; }
+
+    Params params_;
+    double level_multiplier_;
+    std::mt19937 rng_;
+
+    std::vector<int> levels_;                               // top layer of each node
+    std::vector<std::vector<std::vector<uint32_t>>> links_; // node -> layer -> neighbours
+    uint32_t entry_point_ = 0;
+    int max_level_ = -1;
+
+    // Visited marks for search_layer, reused across searches via an epoch counter
+    mutable std::vector<uint32_t> visit_marks_;
+    mutable uint32_t visit_epoch_ = 0;
+};
+
+enum class VectorQuantization {
+    NONE,     // float32 rows
+    INT8,     // per-row scaled int8, ~4x smaller
+    PRODUCT   // product quantization, one byte per subspace (8-32x smaller)
+};
+
+// "none", "int8" or "pq"; unknown values map to NONE
+VectorQuantization parse_vector_quantization(const std::string& name);
+std::string vector_quantization_to_string(VectorQuantization mode);
+
+/**
+ * @brief One int8 scalar-quantized vector, for key-value caches of embeddings
+ */
+struct Int8Embedding {
+    std::vector<int8_t> codes;
+    float scale = 0.0f;   // value = code * scale
+
+    static Int8Embedding encode(const std::vector<float>& values);
+    std::vector<float> decode() const;
+    bool empty() const { return codes.empty(); }
+};
+
+/**
+ * @brief Recall@k of Int8Embedding scoring against exact float scoring, with
+ * each of the given unit-length vectors queried against the others
+ * @return recall in [0, 1]; 1.0 when there are too few vectors to measure
+ */
+double int8_recall_at_k(const std::vector<std::vector<float>>& unit_vectors, size_t k);
+
+struct QuantizationConfig {
+    VectorQuantization mode = VectorQuantization::NONE;
+    size_t pq_subspaces = 48;        // rounded down to a divisor of the dimension
+    size_t pq_train_size = 4096;     // rows buffered as floats before the codebooks are trained
+    size_t rerank_factor = 4;        // quantized candidates kept per result for float re-ranking
+    bool keep_float_vectors = false; // exact re-ranking and HNSW, at the cost of the float rows
+};
+
+/**
+ * @brief Embedding store with optional int8 or product quantization
+ *
+ * Rows are normalized on insert. Searches scan the compact codes and, when
+ * float rows are kept, re-score the best rerank_factor * k candidates
+ * exactly. A reservoir sample of float rows is retained so recall_at_k()
+ * can report what quantization costs against exact search.
+ */
+class QuantizedVectorStore {
+public:
+    explicit QuantizedVectorStore(QuantizationConfig config = {});
+
+    /**
+     * @return row index, or -1 on a dimension mismatch
+     */
+    long add(const std::vector<float>& embedding);
+
+    std::vector<std::pair<float, size_t>> top_k(
+        const float* unit_query,
+        size_t k,
+        float threshold,
+        const std::function<bool(size_t)>& accept = nullptr) const;
+
+    float similarity(size_t row, const float* unit_query) const;
+
+    // Exact when float rows are kept, otherwise reconstructed from the codes
+    std::vector<float> row_vector(size_t row) const;
+
+    // Float rows for HNSW; null when quantized without keep_float_vectors
+    const EmbeddingMatrix* float_rows() const;
+
+    void compact(const std::vector<char>& keep);
+    void clear();
+
+    size_t size() const { return rows_; }
+    size_t dim() const { return dim_; }
+    bool empty() const { return rows_ == 0; }
+    size_t memory_bytes() const;
+    const QuantizationConfig& config() const { return config_; }
+
+    /**
+     * @brief Product-quantization training, split so the k-means can run
+     * without the caller's lock
+     *
+     * Rows are kept as floats and searched exactly until codebooks are
+     * installed. Once pq_training_due(), copy a pq_training_set(), train it
+     * with train_pq_codebooks() and hand the result to install_pq_codebooks(),
+     * which encodes every row and returns false if the store has since been
+     * cleared, reconfigured or trained.
+     */
+    struct PqTrainingSet {
+        std::vector<float> rows;   // count * dim, in random order
+        size_t count = 0;
+        size_t dim = 0;
+        size_t subspaces = 0;
+    };
+    bool pq_training_due() const;
+    PqTrainingSet pq_training_set() const;
+    static std::vector<float> train_pq_codebooks(const PqTrainingSet& set);
+    bool install_pq_codebooks(const PqTrainingSet& set, std::vector<float> codebooks);
+
+    /**
+     * @brief Recall@k of this store's search against exact float search,
+     * measured on the retained sample (1.0 for unquantized stores)
+     */
+    double recall_at_k(size_t k) const;
+
+private:
+    bool pq_trained() const { return !pq_centroids_.empty(); }
+    void encode_row(const float* unit_row);
+    float quantized_similarity(size_t row, const float* unit_query, const std::vector<float>& lut) const;
+    std::vector<float> build_lut(const float* unit_query) const;
+    std::vector<float> decode_row(size_t row) const;
+    void sample_row(const float* unit_row, size_t row);
+
+    QuantizationConfig config_;
+    size_t dim_ = 0;
+    size_t rows_ = 0;
+
+    EmbeddingMatrix floats_;                 // all rows for NONE / keep_float_vectors / untrained PQ
+
+    // INT8
+    std::vector<int8_t> int8_codes_;         // rows_ * dim_
+    std::vector<float> int8_scales_;
+
+    // PRODUCT
+    size_t pq_m_ = 0;                        // subspaces
+    size_t pq_dsub_ = 0;                     // dimensions per subspace
+    std::vector<float> pq_centroids_;        // pq_m_ * 256 * pq_dsub_
+    std::vector<uint8_t> pq_codes_;          // rows_ * pq_m_
+
+    // Reservoir sample for recall measurement
+    std::vector<float> sample_vectors_;
+    std::vector<size_t> sample_rows_;
+    size_t sample_seen_ = 0;
+    std::mt19937 sample_rng_{7};
+};
+
+} // namespace regulens
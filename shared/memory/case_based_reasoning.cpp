@@ -14,6 +14,13 @@
 
 namespace regulens {
 
+namespace {
+
+// Cases copied out for measure_embedding_recall()
+constexpr size_t kMaxRecallSampleCases = 1024;
+
+} // namespace
+
 // ComplianceCase Implementation
 
 std::string ComplianceCase::generate_case_id() {
@@ -150,6 +157,10 @@ CaseBasedReasoner::CaseBasedReasoner(std::shared_ptr<ConfigurationManager> confi
     // Load configuration
     enable_embeddings_ = config_->get_bool("CASE_EMBEDDINGS_ENABLED").value_or(true);
     enable_persistence_ = config_->get_bool("CASE_PERSISTENCE_ENABLED").value_or(true);
+    // Optional int8 scoring codes ("none" by default); "pq" is treated as int8,
+    // the only mode that applies per case
+    embedding_quantization_ = parse_vector_quantization(
+        config_->get_string("CASE_EMBEDDING_QUANTIZATION").value_or("none"));
     max_case_base_size_ = config_->get_int("CASE_MAX_BASE_SIZE").value_or(10000);
     similarity_threshold_ = config_->get_double("CASE_SIMILARITY_THRESHOLD").value_or(0.3);
     case_retention_period_ = std::chrono::hours(config_->get_int("CASE_RETENTION_HOURS").value_or(8760)); // 1 year
@@ -266,8 +277,14 @@ bool CaseBasedReasoner::add_case(const ComplianceCase& case_data) {
         // Extract features
         processed_case.feature_weights = extract_case_features(case_data.context);
 
-        // Add to case base
+        // Add to case base, with int8 scoring codes if configured
         case_base_[processed_case.case_id] = processed_case;
+        quantized_embeddings_.erase(processed_case.case_id);
+        if (embedding_quantization_ != VectorQuantization::NONE && !processed_case.semantic_embedding.empty()) {
+            std::vector<float> unit = processed_case.semantic_embedding;
+            vector_kernels::normalize(unit.data(), unit.size());
+            quantized_embeddings_[processed_case.case_id] = Int8Embedding::encode(unit);
+        }
 
         // Update indexes
         build_indexes();
@@ -369,6 +386,11 @@ std::vector<CaseRetrievalResult> CaseBasedReasoner::retrieve_similar_cases(const
                 logger_->log(LogLevel::WARN, "Failed to generate embeddings for query, using fallback");
                 query_embedding = std::vector<float>(384, 0.0f); // Fallback to zeros
             }
+
+            // A zero query carries no semantic signal
+            if (vector_kernels::normalize(query_embedding.data(), query_embedding.size()) == 0.0f) {
+                query_embedding.clear();
+            }
         }
 
         // Score all cases
@@ -399,9 +421,15 @@ std::vector<CaseRetrievalResult> CaseBasedReasoner::retrieve_similar_cases(const
             double similarity = 0.0;
             std::vector<std::string> matching_features;
 
-            if (!query_embedding.empty() && !case_data.semantic_embedding.empty()) {
-                // Semantic similarity
-                similarity = calculate_case_similarity(case_data, ComplianceCase("", "", query.context, {}));
+            std::optional<float> embedding_similarity;
+            if (!query_embedding.empty()) {
+                embedding_similarity = case_embedding_similarity(case_data, query_embedding);
+            }
+
+            if (embedding_similarity) {
+                // Semantic similarity blended with the feature match
+                double feature_similarity = calculate_case_similarity(case_data, ComplianceCase("", "", query.context, {}));
+                similarity = (feature_similarity + std::max(0.0f, *embedding_similarity)) / 2.0;
                 matching_features = {"semantic_similarity"};
             } else {
                 // Feature-based similarity
@@ -748,8 +776,24 @@ nlohmann::json CaseBasedReasoner::get_case_statistics() const {
         }
     }
 
+    size_t embedding_bytes = 0;
+    for (const auto& [id, case_data] : case_base_) {
+        embedding_bytes += case_data.semantic_embedding.capacity() * sizeof(float);
+    }
+    for (const auto& [id, embedding] : quantized_embeddings_) {
+        embedding_bytes += embedding.codes.capacity() + sizeof(embedding.scale);
+    }
+
     stats["domains"] = domain_counts;
     stats["risk_levels"] = risk_counts;
+    stats["embedding_quantization"] = vector_quantization_to_string(embedding_quantization_);
+    stats["embedding_memory_bytes"] = embedding_bytes;
+    stats["embedding_recall"] = embedding_quantization_ == VectorQuantization::NONE
+        ? nlohmann::json{{"k", 10}, {"recall", 1.0}}
+        : measured_recall_
+            ? nlohmann::json{{"k", measured_recall_k_}, {"recall", *measured_recall_},
+                             {"measured_at_cases", measured_recall_cases_}}
+            : nlohmann::json(nullptr);
     stats["cases_with_outcomes"] = cases_with_outcomes;
     stats["average_success_score"] = cases_with_outcomes > 0 ?
         total_success / cases_with_outcomes : 0.0;
@@ -757,6 +801,37 @@ nlohmann::json CaseBasedReasoner::get_case_statistics() const {
     return stats;
 }
 
+double CaseBasedReasoner::measure_embedding_recall(size_t k) {
+    // Copy a sample of the embeddings so the scan runs without the case lock
+    std::vector<std::vector<float>> unit_embeddings;
+    size_t cases = 0;
+    {
+        std::unique_lock<std::mutex> lock(case_mutex_);
+        if (embedding_quantization_ == VectorQuantization::NONE) {
+            return 1.0;
+        }
+        cases = case_base_.size();
+        for (const auto& [id, case_data] : case_base_) {
+            if (unit_embeddings.size() >= kMaxRecallSampleCases) break;
+            if (case_data.semantic_embedding.empty() ||
+                (!unit_embeddings.empty() && case_data.semantic_embedding.size() != unit_embeddings[0].size())) {
+                continue;
+            }
+            std::vector<float> unit = case_data.semantic_embedding;
+            vector_kernels::normalize(unit.data(), unit.size());
+            unit_embeddings.push_back(std::move(unit));
+        }
+    }
+
+    double recall = int8_recall_at_k(unit_embeddings, k);
+
+    std::unique_lock<std::mutex> lock(case_mutex_);
+    measured_recall_ = recall;
+    measured_recall_k_ = k;
+    measured_recall_cases_ = cases;
+    return recall;
+}
+
 nlohmann::json CaseBasedReasoner::export_case_base(const std::optional<std::string>& domain) {
     nlohmann::json export_data = nlohmann::json::array();
 
@@ -801,6 +876,26 @@ void CaseBasedReasoner::perform_maintenance() {
 
 // Private helper methods
 
+std::optional<float> CaseBasedReasoner::case_embedding_similarity(const ComplianceCase& case_data,
+                                                                const std::vector<float>& unit_query) const {
+    auto quantized = quantized_embeddings_.find(case_data.case_id);
+    if (quantized != quantized_embeddings_.end()) {
+        if (quantized->second.codes.size() != unit_query.size()) return std::nullopt;
+        return vector_kernels::dot_int8(unit_query.data(), quantized->second.codes.data(), unit_query.size()) *
+               quantized->second.scale;
+    }
+
+    const auto& embedding = case_data.semantic_embedding;
+    if (embedding.empty() || embedding.size() != unit_query.size()) {
+        return std::nullopt;
+    }
+    float norm = std::sqrt(vector_kernels::dot(embedding.data(), embedding.data(), embedding.size()));
+    if (norm == 0.0f) {
+        return std::nullopt;
+    }
+    return vector_kernels::dot(embedding.data(), unit_query.data(), embedding.size()) / norm;
+}
+
 std::vector<float> CaseBasedReasoner::generate_case_embedding(const ComplianceCase& case_data) {
     if (!embeddings_client_ || !enable_embeddings_) {
         // Return zero vector if embeddings are disabled or client unavailable
@@ -1091,6 +1186,7 @@ void CaseBasedReasoner::cleanup_case_base() {
     // Remove the cases
     for (const auto& id : to_remove) {
         case_base_.erase(id);
+        quantized_embeddings_.erase(id);
     }
 
     if (logger_ && !to_remove.empty()) {
@@ -202,10 +202,19 @@ public:
 
     /**
      * @brief Get case statistics and analytics
+     * Embedding recall is reported from the last measure_embedding_recall()
+     * run (null until one has been made).
      * @return JSON with case base statistics
      */
     nlohmann::json get_case_statistics() const;
 
+    /**
+     * @brief Measure recall@k of int8 case scoring against the float embeddings
+     * The result is cached for get_case_statistics().
+     * @return recall in [0, 1]
+     */
+    double measure_embedding_recall(size_t k = 10);
+
     /**
      * @brief Export case base for analysis or backup
      * @param domain Optional domain filter
@@ -233,6 +242,16 @@ private:
     std::unordered_map<std::string, ComplianceCase> case_base_;
     mutable std::mutex case_mutex_;
 
+    // Int8 codes of the unit-length case embeddings, used for scoring when
+    // quantization is enabled; each ComplianceCase keeps its float embedding
+    // for persistence and export
+    std::unordered_map<std::string, Int8Embedding> quantized_embeddings_;
+
+    // Last measure_embedding_recall() result; guarded by case_mutex_
+    std::optional<double> measured_recall_;
+    size_t measured_recall_k_ = 0;
+    size_t measured_recall_cases_ = 0;
+
     // Performance indexes
     std::unordered_map<std::string, std::vector<std::string>> domain_index_;
     std::unordered_map<std::string, std::vector<std::string>> tag_index_;
@@ -241,6 +260,7 @@ private:
     // Configuration
     bool enable_embeddings_;
     bool enable_persistence_;
+    VectorQuantization embedding_quantization_;
     size_t max_case_base_size_;
     double similarity_threshold_;
     std::chrono::hours case_retention_period_;
@@ -252,6 +272,13 @@ private:
      */
     std::vector<float> generate_case_embedding(const ComplianceCase& case_data);
 
+    /**
+     * @brief Cosine similarity between a case's embedding and a unit-length query
+     * @return nullopt if the case has no embedding
+     */
+    std::optional<float> case_embedding_similarity(const ComplianceCase& case_data,
+                                                   const std::vector<float>& unit_query) const;
+
     /**
      * @brief Extract features from case context
      * @param context Case context
@@ -0,0 +1,814 @@
+#include "http_server_core.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#include <sys/event.h>
+#include <sys/time.h>
+#define REGULENS_HTTP_KQUEUE 1
+#else
+#error "HttpServerCore requires epoll (Linux) or kqueue (macOS/BSD)"
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0  // SIGPIPE is suppressed per socket with SO_NOSIGPIPE instead
+#endif
+
+namespace regulens {
+
+namespace {
+
+constexpr uint64_t kListenerId = 0;
+constexpr uint64_t kWakeId = 1;
+constexpr size_t kReadChunk = 16 * 1024;
+constexpr int kMaxEvents = 128;
+
+// Readiness interest, independent of the platform poller
+constexpr uint32_t kReadable = 1;
+constexpr uint32_t kWritable = 2;
+
+struct PollEvent {
+    uint64_t id = 0;
+    bool readable = false;
+    bool writable = false;
+    bool error = false;  // socket error or hang-up with nothing left to read
+};
+
+/**
+ * Thin poller shim: level-triggered epoll on Linux, kqueue elsewhere. Both
+ * remove a descriptor's registrations when it is closed.
+ */
+#ifndef REGULENS_HTTP_KQUEUE
+
+int poller_create() {
+    return epoll_create1(EPOLL_CLOEXEC);
+}
+
+bool epoll_apply(int poller, int op, int fd, uint64_t id, uint32_t interest) {
+    epoll_event event{};
+    event.events = ((interest & kReadable) ? EPOLLIN : 0u) | ((interest & kWritable) ? EPOLLOUT : 0u);
+    event.data.u64 = id;
+    return epoll_ctl(poller, op, fd, &event) == 0;
+}
+
+bool poller_add(int poller, int fd, uint64_t id, uint32_t interest) {
+    return epoll_apply(poller, EPOLL_CTL_ADD, fd, id, interest);
+}
+
+bool poller_modify(int poller, int fd, uint64_t id, uint32_t, uint32_t new_interest) {
+    return epoll_apply(poller, EPOLL_CTL_MOD, fd, id, new_interest);
+}
+
+void poller_remove(int poller, int fd) {
+    epoll_ctl(poller, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int poller_wait(int poller, PollEvent* out, int max_events, int timeout_ms) {
+    epoll_event events[kMaxEvents];
+    int count = epoll_wait(poller, events, std::min(max_events, kMaxEvents), timeout_ms);
+    for (int i = 0; i < count; ++i) {
+        out[i].id = events[i].data.u64;
+        out[i].readable = (events[i].events & EPOLLIN) != 0;
+        out[i].writable = (events[i].events & EPOLLOUT) != 0;
+        out[i].error = (events[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+    }
+    return count;
+}
+
+bool wake_create(int& read_fd, int& write_fd) {
+    read_fd = write_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return read_fd >= 0;
+}
+
+void wake_signal(int write_fd) {
+    uint64_t one = 1;
+    [[maybe_unused]] ssize_t written = write(write_fd, &one, sizeof(one));
+}
+
+void wake_drain(int read_fd) {
+    uint64_t value = 0;
+    [[maybe_unused]] ssize_t drained = read(read_fd, &value, sizeof(value));
+}
+
+#else
+
+int poller_create() {
+    int kq = kqueue();
+    if (kq >= 0) {
+        fcntl(kq, F_SETFD, FD_CLOEXEC);
+    }
+    return kq;
+}
+
+bool poller_modify(int poller, int fd, uint64_t id, uint32_t old_interest, uint32_t new_interest) {
+    struct kevent changes[2];
+    int count = 0;
+    void* udata = reinterpret_cast<void*>(static_cast<uintptr_t>(id));
+    if ((old_interest ^ new_interest) & kReadable) {
+        EV_SET(&changes[count++], fd, EVFILT_READ,
+               (new_interest & kReadable) ? EV_ADD | EV_ENABLE : EV_DELETE, 0, 0, udata);
+    }
+    if ((old_interest ^ new_interest) & kWritable) {
+        EV_SET(&changes[count++], fd, EVFILT_WRITE,
+               (new_interest & kWritable) ? EV_ADD | EV_ENABLE : EV_DELETE, 0, 0, udata);
+    }
+    return count == 0 || kevent(poller, changes, count, nullptr, 0, nullptr) == 0;
+}
+
+bool poller_add(int poller, int fd, uint64_t id, uint32_t interest) {
+    return poller_modify(poller, fd, id, 0, interest);
+}
+
+void poller_remove(int, int) {
+    // close() drops the descriptor's filters
+}
+
+int poller_wait(int poller, PollEvent* out, int max_events, int timeout_ms) {
+    struct kevent events[kMaxEvents];
+    timespec timeout{timeout_ms / 1000, static_cast<long>(timeout_ms % 1000) * 1000000L};
+    int count = kevent(poller, nullptr, 0, events, std::min(max_events, kMaxEvents), &timeout);
+    for (int i = 0; i < count; ++i) {
+        out[i] = PollEvent{};
+        out[i].id = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(events[i].udata));
+        // EV_EOF on the read filter still has buffered data; recv() reports the close
+        out[i].readable = events[i].filter == EVFILT_READ;
+        out[i].writable = events[i].filter == EVFILT_WRITE;
+        out[i].error = (events[i].flags & EV_ERROR) != 0 ||
+                       (events[i].filter == EVFILT_WRITE && (events[i].flags & EV_EOF) != 0);
+    }
+    return count;
+}
+
+bool wake_create(int& read_fd, int& write_fd) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+        read_fd = write_fd = -1;
+        return false;
+    }
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    read_fd = fds[0];
+    write_fd = fds[1];
+    return true;
+}
+
+void wake_signal(int write_fd) {
+    char one = 1;
+    [[maybe_unused]] ssize_t written = write(write_fd, &one, sizeof(one));
+}
+
+void wake_drain(int read_fd) {
+    char buffer[64];
+    while (read(read_fd, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+#endif
+
+// Non-blocking, close-on-exec and (where MSG_NOSIGNAL is missing) SIGPIPE-free
+bool prepare_socket(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        return false;
+    }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+    return true;
+}
+
+bool iequals(const std::string& a, const std::string& b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+std::string to_lower(std::string value) {
+    for (auto& c : value) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return value;
+}
+
+std::string trim(const std::string& value) {
+    size_t start = value.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = value.find_last_not_of(" \t\r");
+    return value.substr(start, end - start + 1);
+}
+
+const char* reason_phrase(int status) {
+    switch (status) {
+        case 400: return "Bad Request";
+        case 408: return "Request Timeout";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        case 505: return "HTTP Version Not Supported";
+        default: return "Error";
+    }
+}
+
+} // namespace
+
+std::string HttpServerRequest::header(const std::string& name) const {
+    for (const auto& [key, value] : headers) {
+        if (iequals(key, name)) {
+            return value;
+        }
+    }
+    return "";
+}
+
+HttpRequestParser::Status HttpRequestParser::next(HttpServerRequest& request) {
+    // Tolerate stray CRLFs between pipelined requests (RFC 9112 2.2)
+    size_t start = 0;
+    while (start + 1 < buffer_.size() && buffer_[start] == '\r' && buffer_[start + 1] == '\n') {
+        start += 2;
+    }
+    if (start > 0) {
+        buffer_.erase(0, start);
+        header_scan_offset_ = 0;
+    }
+    if (buffer_.empty()) {
+        return Status::NEED_MORE;
+    }
+
+    size_t header_end = buffer_.find("\r\n\r\n", header_scan_offset_);
+    if (header_end == std::string::npos) {
+        if (buffer_.size() > max_header_bytes_) {
+            return fail(431);
+        }
+        header_scan_offset_ = buffer_.size() >= 3 ? buffer_.size() - 3 : 0;
+        return Status::NEED_MORE;
+    }
+    if (header_end > max_header_bytes_) {
+        return fail(431);
+    }
+    header_scan_offset_ = header_end;
+
+    HttpServerRequest parsed;
+
+    // Request line
+    size_t line_end = buffer_.find("\r\n");
+    std::string request_line = buffer_.substr(0, line_end);
+    size_t first_space = request_line.find(' ');
+    size_t second_space = first_space == std::string::npos ? std::string::npos : request_line.find(' ', first_space + 1);
+    if (first_space == std::string::npos || second_space == std::string::npos) {
+        return fail(400);
+    }
+    parsed.method = request_line.substr(0, first_space);
+    parsed.target = request_line.substr(first_space + 1, second_space - first_space - 1);
+    parsed.version = request_line.substr(second_space + 1);
+    if (parsed.method.empty() || parsed.target.empty()) {
+        return fail(400);
+    }
+    if (parsed.version != "HTTP/1.1" && parsed.version != "HTTP/1.0") {
+        return fail(505);
+    }
+
+    // Header fields
+    size_t content_length = 0;
+    bool seen_content_length = false;
+    std::string connection_header;
+    size_t pos = line_end + 2;
+    while (pos < header_end) {
+        size_t next_line = buffer_.find("\r\n", pos);
+        std::string line = buffer_.substr(pos, next_line - pos);
+        pos = next_line + 2;
+
+        size_t colon = line.find(':');
+        if (colon == std::string::npos || colon == 0) {
+            return fail(400);
+        }
+        std::string name = line.substr(0, colon);
+        std::string value = trim(line.substr(colon + 1));
+
+        if (iequals(name, "Content-Length")) {
+            // A repeated Content-Length, even an identical one, is a request smuggling vector
+            if (seen_content_length) {
+                return fail(400);
+            }
+            seen_content_length = true;
+            if (value.empty() || !std::all_of(value.begin(), value.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                return fail(400);
+            }
+            if (value.size() > 12 || std::stoull(value) > max_body_bytes_) {
+                return fail(413);
+            }
+            content_length = static_cast<size_t>(std::stoull(value));
+        } else if (iequals(name, "Transfer-Encoding") && !iequals(value, "identity")) {
+            return fail(501);  // chunked request bodies are not accepted
+        } else if (iequals(name, "Connection")) {
+            connection_header = to_lower(value);
+        }
+
+        parsed.headers.emplace_back(std::move(name), std::move(value));
+    }
+
+    size_t total = header_end + 4 + content_length;
+    if (buffer_.size() < total) {
+        return Status::NEED_MORE;
+    }
+
+    parsed.body = buffer_.substr(header_end + 4, content_length);
+    buffer_.erase(0, total);
+    header_scan_offset_ = 0;
+
+    if (parsed.version == "HTTP/1.0") {
+        parsed.keep_alive = connection_header.find("keep-alive") != std::string::npos;
+    } else {
+        parsed.keep_alive = connection_header.find("close") == std::string::npos;
+    }
+
+    request = std::move(parsed);
+    return Status::COMPLETE;
+}
+
+HttpServerCore::HttpServerCore(HttpServerOptions options, Handler handler)
+    : options_(options), handler_(std::move(handler)) {
+    if (options_.worker_threads == 0) {
+        options_.worker_threads = std::max(2u, std::thread::hardware_concurrency());
+    }
+    options_.max_pipelined_requests = std::max<size_t>(1, options_.max_pipelined_requests);
+}
+
+HttpServerCore::~HttpServerCore() {
+    stop();
+}
+
+bool HttpServerCore::start(int port) {
+    if (running_) {
+        return true;
+    }
+
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0 || !prepare_socket(listen_fd_)) {
+        error_message_ = "Failed to create socket: " + std::string(std::strerror(errno));
+        if (listen_fd_ >= 0) close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    int opt = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd_, options_.listen_backlog) < 0) {
+        error_message_ = "Failed to bind/listen on port " + std::to_string(port) + ": " + std::strerror(errno);
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    poll_fd_ = poller_create();
+    bool wake_ok = wake_create(wake_fd_, wake_write_fd_);
+    if (poll_fd_ < 0 || !wake_ok ||
+        !poller_add(poll_fd_, listen_fd_, kListenerId, kReadable) ||
+        !poller_add(poll_fd_, wake_fd_, kWakeId, kReadable)) {
+        error_message_ = "Failed to create event poller: " + std::string(std::strerror(errno));
+        close_poller_fds();
+        return false;
+    }
+
+    running_ = true;
+    for (size_t i = 0; i < options_.worker_threads; ++i) {
+        workers_.emplace_back(&HttpServerCore::worker_loop, this);
+    }
+    io_thread_ = std::thread(&HttpServerCore::io_loop, this);
+    return true;
+}
+
+void HttpServerCore::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    wake_signal(wake_write_fd_);
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+
+    ready_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    ready_.clear();
+
+    close_poller_fds();
+}
+
+void HttpServerCore::close_poller_fds() {
+    if (wake_write_fd_ >= 0 && wake_write_fd_ != wake_fd_) close(wake_write_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+    if (poll_fd_ >= 0) close(poll_fd_);
+    if (listen_fd_ >= 0) close(listen_fd_);
+    wake_fd_ = wake_write_fd_ = poll_fd_ = listen_fd_ = -1;
+}
+
+void HttpServerCore::io_loop() {
+    PollEvent events[kMaxEvents];
+    auto last_sweep = std::chrono::steady_clock::now();
+
+    while (running_) {
+        int count = poller_wait(poll_fd_, events, kMaxEvents, 1000);
+        if (count < 0) {
+            if (errno != EINTR) {
+                log_error("Event poller wait failed: " + std::string(std::strerror(errno)));
+            }
+            continue;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            uint64_t id = events[i].id;
+            if (id == kListenerId) {
+                accept_connections();
+                continue;
+            }
+            if (id == kWakeId) {
+                wake_drain(wake_fd_);
+                continue;
+            }
+
+            ConnectionPtr conn = find_connection(id);
+            if (!conn) {
+                continue;
+            }
+
+            if (events[i].error) {
+                std::lock_guard<std::mutex> lock(conn->mutex);
+                close_locked(*conn);
+                continue;
+            }
+            if (events[i].writable) {
+                on_writable(conn);
+            }
+            if (events[i].readable) {
+                on_readable(conn);
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_sweep >= std::chrono::seconds(1)) {
+            sweep_idle_connections();
+            last_sweep = now;
+        }
+    }
+
+    // Shutting down: drop every connection
+    std::unordered_map<uint64_t, ConnectionPtr> remaining;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        remaining.swap(connections_);
+    }
+    for (auto& [id, conn] : remaining) {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        close_locked(*conn);
+    }
+}
+
+void HttpServerCore::accept_connections() {
+    while (true) {
+        sockaddr_in client_addr{};
+        socklen_t client_len = sizeof(client_addr);
+        int fd = accept(listen_fd_, reinterpret_cast<sockaddr*>(&client_addr), &client_len);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                log_error("accept failed: " + std::string(std::strerror(errno)));
+            }
+            return;
+        }
+        if (!prepare_socket(fd)) {
+            close(fd);
+            continue;
+        }
+
+        if (connection_count_.load(std::memory_order_relaxed) >= options_.max_connections) {
+            std::string busy = simple_response(503, reason_phrase(503), false);
+            [[maybe_unused]] ssize_t sent = send(fd, busy.data(), busy.size(), MSG_NOSIGNAL);
+            close(fd);
+            continue;
+        }
+
+        int nodelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+
+        auto conn = std::make_shared<Connection>(options_.max_header_bytes, options_.max_body_bytes);
+        conn->fd = fd;
+        conn->last_activity = std::chrono::steady_clock::now();
+        char ip[INET_ADDRSTRLEN] = {0};
+        if (inet_ntop(AF_INET, &client_addr.sin_addr, ip, sizeof(ip))) {
+            conn->client_ip = ip;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            conn->id = next_connection_id_++;
+            connections_[conn->id] = conn;
+            // Counted as soon as it is visible, since close_locked() uncounts it
+            connection_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        conn->interest = kReadable;
+        if (!poller_add(poll_fd_, fd, conn->id, kReadable)) {
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            close_locked(*conn);
+        }
+    }
+}
+
+void HttpServerCore::on_readable(const ConnectionPtr& conn) {
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->closed || conn->close_after_write || conn->read_closed) {
+        return;
+    }
+
+    char buffer[kReadChunk];
+    bool peer_closed = false;
+    while (true) {
+        ssize_t n = recv(conn->fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            conn->parser.feed(buffer, static_cast<size_t>(n));
+            if (conn->parser.buffered_bytes() > options_.max_header_bytes + options_.max_body_bytes) {
+                break;  // parse what we have before reading more
+            }
+            continue;
+        }
+        if (n == 0) {
+            peer_closed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            close_locked(*conn);
+            return;
+        }
+        break;
+    }
+    conn->last_activity = std::chrono::steady_clock::now();
+
+    parse_pending_locked(*conn);
+
+    if (peer_closed) {
+        // Half-closed clients still get answers to what they sent
+        conn->read_closed = true;
+        if (conn->pending.empty() && conn->parse_error_status == 0 && !conn->processing &&
+            conn->out_offset >= conn->out.size()) {
+            close_locked(*conn);
+            return;
+        }
+    }
+
+    if ((!conn->pending.empty() || conn->parse_error_status != 0) && !conn->processing) {
+        conn->processing = true;
+        schedule(conn);
+    }
+    update_interest_locked(*conn);
+}
+
+void HttpServerCore::parse_pending_locked(Connection& conn) {
+    while (conn.pending.size() < options_.max_pipelined_requests && !conn.close_after_write) {
+        HttpServerRequest request;
+        auto status = conn.parser.next(request);
+        if (status == HttpRequestParser::Status::NEED_MORE) {
+            return;
+        }
+        if (status == HttpRequestParser::Status::ERROR) {
+            // Answered after everything already queued, then the connection closes
+            conn.parse_error_status = conn.parser.error_status();
+            conn.close_after_write = true;
+            return;
+        }
+
+        request.client_ip = conn.client_ip;
+        if (++conn.requests_served >= options_.max_requests_per_connection) {
+            request.keep_alive = false;
+        }
+        if (!request.keep_alive) {
+            conn.close_after_write = true;  // ignore anything pipelined after it
+        }
+        conn.pending.push_back(std::move(request));
+    }
+}
+
+void HttpServerCore::on_writable(const ConnectionPtr& conn) {
+    std::lock_guard<std::mutex> lock(conn->mutex);
+    if (conn->closed) {
+        return;
+    }
+    flush_locked(*conn);
+    if (!conn->closed) {
+        update_interest_locked(*conn);
+    }
+}
+
+void HttpServerCore::sweep_idle_connections() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<ConnectionPtr> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        snapshot.reserve(connections_.size());
+        for (auto& [id, conn] : connections_) {
+            snapshot.push_back(conn);
+        }
+    }
+
+    std::vector<uint64_t> closed_ids;
+    for (auto& conn : snapshot) {
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        bool idle = !conn->processing && conn->pending.empty() && conn->out_offset >= conn->out.size();
+        if (!conn->closed && idle && now - conn->last_activity > options_.keep_alive_timeout) {
+            close_locked(*conn);
+        }
+        if (conn->closed) {
+            closed_ids.push_back(conn->id);
+        }
+    }
+
+    if (!closed_ids.empty()) {
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        for (auto id : closed_ids) {
+            connections_.erase(id);
+        }
+    }
+}
+
+void HttpServerCore::schedule(const ConnectionPtr& conn) {
+    {
+        std::lock_guard<std::mutex> lock(ready_mutex_);
+        ready_.push_back(conn);
+    }
+    ready_cv_.notify_one();
+}
+
+void HttpServerCore::worker_loop() {
+    while (true) {
+        ConnectionPtr conn;
+        {
+            std::unique_lock<std::mutex> lock(ready_mutex_);
+            ready_cv_.wait(lock, [this]() { return !running_ || !ready_.empty(); });
+            if (!running_) {
+                return;
+            }
+            conn = std::move(ready_.front());
+            ready_.pop_front();
+        }
+        process_connection(conn);
+    }
+}
+
+void HttpServerCore::process_connection(const ConnectionPtr& conn) {
+    // Requests of one connection run one at a time so responses keep pipeline order
+    while (true) {
+        HttpServerRequest request;
+        {
+            std::lock_guard<std::mutex> lock(conn->mutex);
+            if (!conn->closed && conn->pending.empty() && conn->parse_error_status != 0) {
+                int status = conn->parse_error_status;
+                conn->parse_error_status = 0;
+                conn->out += simple_response(status, reason_phrase(status), false);
+            }
+            if (conn->closed || conn->pending.empty()) {
+                conn->processing = false;
+                if (!conn->closed) {
+                    flush_locked(*conn);
+                    if (!conn->closed) {
+                        update_interest_locked(*conn);
+                    }
+                }
+                return;
+            }
+            request = std::move(conn->pending.front());
+            conn->pending.pop_front();
+            // Requests that arrived while the queue was full are already buffered
+            parse_pending_locked(*conn);
+            update_interest_locked(*conn);
+        }
+
+        std::string response;
+        try {
+            response = handler_(request);
+        } catch (const std::exception& e) {
+            log_error("Unhandled exception in request handler: " + std::string(e.what()));
+            response = simple_response(500, reason_phrase(500), request.keep_alive);
+        }
+
+        std::lock_guard<std::mutex> lock(conn->mutex);
+        if (conn->closed) {
+            conn->processing = false;
+            return;
+        }
+        conn->out += response;
+        conn->last_activity = std::chrono::steady_clock::now();
+        flush_locked(*conn);
+    }
+}
+
+void HttpServerCore::flush_locked(Connection& conn) {
+    while (conn.out_offset < conn.out.size()) {
+        ssize_t n = send(conn.fd, conn.out.data() + conn.out_offset, conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.out_offset += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            update_interest_locked(conn);  // finish when writable
+            return;
+        }
+        close_locked(conn);
+        return;
+    }
+
+    conn.out.clear();
+    conn.out_offset = 0;
+    bool finished = conn.close_after_write || conn.read_closed;
+    if (finished && conn.pending.empty() && conn.parse_error_status == 0 && !conn.processing) {
+        close_locked(conn);
+    }
+}
+
+void HttpServerCore::update_interest_locked(Connection& conn) {
+    if (conn.closed) {
+        return;
+    }
+
+    uint32_t wanted = 0;
+    if (!conn.close_after_write && !conn.read_closed && conn.pending.size() < options_.max_pipelined_requests) {
+        wanted |= kReadable;
+    }
+    if (conn.out_offset < conn.out.size()) {
+        wanted |= kWritable;
+    }
+    if (wanted == conn.interest) {
+        return;
+    }
+
+    if (poller_modify(poll_fd_, conn.fd, conn.id, conn.interest, wanted)) {
+        conn.interest = wanted;
+    }
+}
+
+void HttpServerCore::close_locked(Connection& conn) {
+    if (conn.closed) {
+        return;
+    }
+    conn.closed = true;
+    conn.pending.clear();
+    poller_remove(poll_fd_, conn.fd);
+    close(conn.fd);
+    connection_count_.fetch_sub(1, std::memory_order_relaxed);
+    // The map entry is dropped by the next idle sweep
+}
+
+HttpServerCore::ConnectionPtr HttpServerCore::find_connection(uint64_t id) {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    auto it = connections_.find(id);
+    return it != connections_.end() ? it->second : nullptr;
+}
+
+std::string HttpServerCore::simple_response(int status, const std::string& reason, bool keep_alive) {
+    std::string body = reason + "\n";
+    return "HTTP/1.1 " + std::to_string(status) + " " + reason + "\r\n"
+           "Content-Type: text/plain\r\n"
+           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+           "Connection: " + (keep_alive ? "keep-alive" : "close") + "\r\n\r\n" + body;
+}
+
+void HttpServerCore::log_error(const std::string& message) const {
+    if (log_error_) {
+        log_error_(message);
+    }
+}
+
+} // namespace regulens
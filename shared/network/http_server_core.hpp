@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace regulens {
+
+/**
+ * @brief One parsed HTTP/1.x request as seen by the server core
+ */
+struct HttpServerRequest {
+    std::string method;
+    std::string target;       // path plus optional "?query", as sent
+    std::string version;      // "HTTP/1.1" or "HTTP/1.0"
+    std::vector<std::pair<std::string, std::string>> headers;  // original case, in order
+    std::string body;
+    std::string client_ip;
+    bool keep_alive = true;   // whether the connection stays open after this response
+
+    // Case-insensitive header lookup; empty if absent
+    std::string header(const std::string& name) const;
+};
+
+/**
+ * @brief Incremental HTTP/1.x request parser
+ *
+ * Bytes are fed as they arrive; complete requests are taken off the front so
+ * pipelined requests in one read are all recovered, in order.
+ */
+class HttpRequestParser {
+public:
+    enum class Status { NEED_MORE, COMPLETE, ERROR };
+
+    HttpRequestParser(size_t max_header_bytes, size_t max_body_bytes)
+        : max_header_bytes_(max_header_bytes), max_body_bytes_(max_body_bytes) {}
+
+    void feed(const char* data, size_t length) { buffer_.append(data, length); }
+
+    /**
+     * @brief Extract the next complete request from the buffer
+     * On ERROR, error_status() holds the HTTP status to answer with.
+     */
+    Status next(HttpServerRequest& request);
+
+    int error_status() const { return error_status_; }
+    size_t buffered_bytes() const { return buffer_.size(); }
+
+private:
+    std::string buffer_;
+    size_t header_scan_offset_ = 0;  // where to resume looking for the blank line
+    size_t max_header_bytes_;
+    size_t max_body_bytes_;
+    int error_status_ = 400;
+
+    Status fail(int status) { error_status_ = status; return Status::ERROR; }
+};
+
+struct HttpServerOptions {
+    size_t worker_threads = 0;                  // 0 = hardware concurrency
+    int listen_backlog = 512;
+    size_t max_connections = 10000;
+    size_t max_pipelined_requests = 32;         // per connection; reading pauses beyond this
+    size_t max_header_bytes = 64 * 1024;
+    size_t max_body_bytes = 10 * 1024 * 1024;
+    std::chrono::seconds keep_alive_timeout{15};
+    size_t max_requests_per_connection = 1000;
+};
+
+/**
+ * @brief Event-driven HTTP/1.1 server core (epoll on Linux, kqueue on macOS/BSD)
+ *
+ * One I/O thread owns the listening socket and all client sockets; parsed
+ * requests run on a fixed worker pool. Connections are kept alive and
+ * pipelined requests are answered strictly in order, one at a time per
+ * connection. The request handler returns the fully serialized response.
+ */
+class HttpServerCore {
+public:
+    using Handler = std::function<std::string(const HttpServerRequest&)>;
+    using LogFunction = std::function<void(const std::string&)>;
+
+    HttpServerCore(HttpServerOptions options, Handler handler);
+    ~HttpServerCore();
+
+    HttpServerCore(const HttpServerCore&) = delete;
+    HttpServerCore& operator=(const HttpServerCore&) = delete;
+
+    // Binds and starts serving; false (with error_message set) if the port cannot be bound
+    bool start(int port);
+    void stop();
+    bool is_running() const { return running_.load(); }
+
+    void set_error_logger(LogFunction log) { log_error_ = std::move(log); }
+    const std::string& error_message() const { return error_message_; }
+
+    size_t active_connections() const { return connection_count_.load(std::memory_order_relaxed); }
+
+    // Minimal response for protocol-level failures (bad request, payload too large, ...)
+    static std::string simple_response(int status, const std::string& reason, bool keep_alive);
+
+private:
+    struct Connection {
+        uint64_t id = 0;
+        int fd = -1;
+        std::string client_ip;
+        std::mutex mutex;
+        HttpRequestParser parser;
+        std::deque<HttpServerRequest> pending;
+        std::string out;
+        size_t out_offset = 0;
+        size_t requests_served = 0;
+        int parse_error_status = 0;      // answered once pending drains, then the connection closes
+        uint32_t interest = 0;           // readiness (kReadable/kWritable) currently registered
+        bool processing = false;         // a worker is draining pending
+        bool close_after_write = false;  // stop reading; close once out is flushed
+        bool read_closed = false;        // peer half-closed; answer what was sent, then close
+        bool closed = false;
+        std::chrono::steady_clock::time_point last_activity;
+
+        Connection(size_t max_header_bytes, size_t max_body_bytes)
+            : parser(max_header_bytes, max_body_bytes) {}
+    };
+    using ConnectionPtr = std::shared_ptr<Connection>;
+
+    HttpServerOptions options_;
+    Handler handler_;
+    LogFunction log_error_;
+    std::string error_message_;
+
+    int listen_fd_ = -1;
+    int poll_fd_ = -1;        // epoll on Linux, kqueue on macOS/BSD
+    int wake_fd_ = -1;        // read end of the stop wake-up (eventfd or pipe)
+    int wake_write_fd_ = -1;  // same fd as wake_fd_ for eventfd
+    std::atomic<bool> running_{false};
+    std::thread io_thread_;
+
+    std::unordered_map<uint64_t, ConnectionPtr> connections_;  // I/O thread + close paths
+    std::mutex connections_mutex_;
+    uint64_t next_connection_id_ = 2;  // 0 = listener, 1 = wake fd
+    std::atomic<size_t> connection_count_{0};
+
+    // Worker pool
+    std::vector<std::thread> workers_;
+    std::deque<ConnectionPtr> ready_;
+    std::mutex ready_mutex_;
+    std::condition_variable ready_cv_;
+
+    void io_loop();
+    void close_poller_fds();
+    void accept_connections();
+    void on_readable(const ConnectionPtr& conn);
+    void on_writable(const ConnectionPtr& conn);
+    void sweep_idle_connections();
+
+    void worker_loop();
+    void process_connection(const ConnectionPtr& conn);
+    void schedule(const ConnectionPtr& conn);
+
+    // Caller holds conn->mutex
+    void parse_pending_locked(Connection& conn);
+    void flush_locked(Connection& conn);
+    void update_interest_locked(Connection& conn);
+    void close_locked(Connection& conn);
+
+    ConnectionPtr find_connection(uint64_t id);
+    void log_error(const std::string& message) const;
+};
+
+} // namespace regulens
@@ -4,12 +4,12 @@
  */
 
 #include "advanced_rule_engine.hpp"
+#include "fraud_result_writer.hpp"
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <iomanip>
 #include <random>
-#include <regex>
 #include <sstream>
 
 #include <fmt/format.h>
@@ -31,6 +31,20 @@ int safe_string_to_int(const std::string& value, int default_value = 0) {
     return static_cast<int>(parsed);
 }
 
+nlohmann::json safe_parse_json_string(const std::string& payload,
+                                      const nlohmann::json& fallback = nlohmann::json::object()) {
+    if (payload.empty()) {
+        return fallback;
+    }
+    try {
+        return nlohmann::json::parse(payload);
+    } catch (...) {
+        return fallback;
+    }
+}
+
+} // namespace
+
 std::string to_string(RuleExecutionResult result) {
     switch (result) {
         case RuleExecutionResult::PASS: return "PASS";
@@ -52,42 +66,6 @@ std::string to_string(FraudRiskLevel level) {
     return "UNKNOWN";
 }
 
-nlohmann::json serialize_rule_result(const RuleExecutionResultDetail& detail) {
-    nlohmann::json payload = {
-        {"rule_id", detail.rule_id},
-        {"rule_name", detail.rule_name},
-        {"result", to_string(detail.result)},
-        {"confidence_score", detail.confidence_score},
-        {"risk_level", to_string(detail.risk_level)},
-        {"rule_output", detail.rule_output},
-        {"error_message", detail.error_message},
-        {"execution_time_ms", detail.execution_time.count()},
-        {"triggered_conditions", detail.triggered_conditions}
-    };
-
-    nlohmann::json risk_factors_json = nlohmann::json::object();
-    for (const auto& [factor, value] : detail.risk_factors) {
-        risk_factors_json[factor] = value;
-    }
-    payload["risk_factors"] = std::move(risk_factors_json);
-
-    return payload;
-}
-
-nlohmann::json safe_parse_json_string(const std::string& payload,
-                                      const nlohmann::json& fallback = nlohmann::json::object()) {
-    if (payload.empty()) {
-        return fallback;
-    }
-    try {
-        return nlohmann::json::parse(payload);
-    } catch (...) {
-        return fallback;
-    }
-}
-
-} // namespace
-
 AdvancedRuleEngine::AdvancedRuleEngine(
     std::shared_ptr<PostgreSQLConnection> db_conn,
     std::shared_ptr<StructuredLogger> logger,
@@ -104,6 +82,10 @@ AdvancedRuleEngine::AdvancedRuleEngine(
 
     // Load configuration
     load_configuration();
+    if (parallel_evaluation_) {
+        set_parallel_evaluation(true);
+    }
+    result_writer_ = std::make_unique<FraudResultWriter>(db_conn_, logger_, load_result_writer_config());
 
     // Initialize rule cache
     reload_rules();
@@ -128,11 +110,27 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_rule(
     const RuleDefinition& rule,
     const RuleExecutionContext& context,
     RuleExecutionMode mode
+) {
+    return run_rule(rule, context, nullptr);
+}
+
+RuleExecutionResultDetail AdvancedRuleEngine::run_rule(
+    const RuleDefinition& rule,
+    const RuleExecutionContext& context,
+    const PatternScanResult* pattern_scan,
+    const std::atomic<bool>* cancelled,
+    bool record_metrics
 ) {
     RuleExecutionResultDetail result;
     result.rule_id = rule.rule_id;
     result.rule_name = rule.name;
 
+    if (cancelled && cancelled->load(std::memory_order_acquire)) {
+        result.result = RuleExecutionResult::SKIPPED;
+        result.error_message = "Evaluation cancelled";
+        return result;
+    }
+
     auto start_time = std::chrono::high_resolution_clock::now();
 
     try {
@@ -161,9 +159,9 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_rule(
         } else if (rule.rule_type == "SCORING") {
             result = execute_scoring_rule(rule, context);
         } else if (rule.rule_type == "PATTERN") {
-            result = execute_pattern_rule(rule, context);
+            result = execute_pattern_rule(rule, context, pattern_scan);
         } else if (rule.rule_type == "MACHINE_LEARNING") {
-            result = execute_ml_rule(rule, context);
+            result = execute_ml_rule(rule, context, cancelled);
         } else {
             result.result = RuleExecutionResult::ERROR;
             result.error_message = "Unknown rule type: " + rule.rule_type;
@@ -187,12 +185,11 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_rule(
     }
 
     auto end_time = std::chrono::high_resolution_clock::now();
-    result.execution_time = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    result.execution_time = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
 
     // Update performance metrics
-    if (enable_performance_monitoring_) {
-        update_rule_metrics(rule.rule_id, result);
-        record_execution_time(rule.rule_id, result.execution_time);
+    if (record_metrics && enable_performance_monitoring_) {
+        update_rule_metrics(rule, result);
     }
 
     return result;
@@ -210,36 +207,60 @@ FraudDetectionResult AdvancedRuleEngine::evaluate_transaction(
 
     try {
         // Determine which rules to execute
-        std::vector<RuleDefinition> rules_to_execute;
+        RuleEvaluationPlan plan;
+        plan.snapshot = get_rule_snapshot();
         if (rule_ids.empty()) {
-            // Execute all active rules
-            rules_to_execute = get_active_rules();
+            // Execute all active rules, already sorted by priority in the snapshot
+            plan.rules.reserve(plan.snapshot->rules.size());
+            for (const auto& rule : plan.snapshot->rules) {
+                plan.rules.push_back(&rule);
+            }
         } else {
             // Execute specified rules
             for (const auto& rule_id : rule_ids) {
                 auto rule_opt = get_rule(rule_id);
                 if (rule_opt) {
-                    rules_to_execute.push_back(*rule_opt);
+                    plan.requested_rules.push_back(std::move(*rule_opt));
                 }
             }
+            for (const auto& rule : plan.requested_rules) {
+                plan.rules.push_back(&rule);
+            }
+
+            // Sort rules by priority (highest first)
+            std::stable_sort(plan.rules.begin(), plan.rules.end(),
+                     [](const RuleDefinition* a, const RuleDefinition* b) {
+                         return static_cast<int>(a->priority) > static_cast<int>(b->priority);
+                     });
+        }
+
+        // Match every indexed regex pattern against the transaction in one pass
+        const auto& pattern_index = plan.snapshot->pattern_index;
+        if (pattern_index && pattern_index->pattern_count() > 0) {
+            plan.pattern_scan = pattern_index->scan(context.transaction_data);
         }
 
-        // Sort rules by priority (highest first)
-        std::sort(rules_to_execute.begin(), rules_to_execute.end(),
-                 [](const RuleDefinition& a, const RuleDefinition& b) {
-                     return static_cast<int>(a.priority) > static_cast<int>(b.priority);
-                 });
+        std::shared_ptr<RuleExecutionPool> pool;
+        if (parallel_evaluation_ && plan.rules.size() > 1) {
+            std::lock_guard<std::mutex> lock(snapshot_mutex_);
+            pool = execution_pool_;
+        }
 
-        // Execute rules
-        for (const auto& rule : rules_to_execute) {
-            auto rule_result = execute_rule(rule, context);
-            result.rule_results.push_back(rule_result);
+        std::vector<RuleExecutionResultDetail> rule_results = pool
+            ? execute_rules_parallel(std::move(plan), context, pool)
+            : execute_rules_sequential(plan, context);
 
-            // Aggregate findings
+        // Aggregate findings
+        const bool early_exit = early_exit_on_critical_.load();
+        bool short_circuited = false;
+        for (const auto& rule_result : rule_results) {
+            if (early_exit && is_critical_failure(rule_result)) {
+                short_circuited = true;
+            }
             if (rule_result.result == RuleExecutionResult::FAIL) {
                 result.is_fraudulent = true;
-                result.aggregated_findings[rule.rule_id] = {
-                    {"rule_name", rule.name},
+                result.aggregated_findings[rule_result.rule_id] = {
+                    {"rule_name", rule_result.rule_name},
                     {"confidence", rule_result.confidence_score},
                     {"risk_level", static_cast<int>(rule_result.risk_level)},
                     {"output", rule_result.rule_output},
@@ -247,10 +268,12 @@ FraudDetectionResult AdvancedRuleEngine::evaluate_transaction(
                 };
             }
         }
+        result.rule_results = std::move(rule_results);
 
         // Calculate overall risk score and level
         result.fraud_score = calculate_aggregated_risk_score(result.rule_results);
-        result.overall_risk = determine_overall_risk_level(result.rule_results);
+        result.overall_risk = short_circuited ? FraudRiskLevel::CRITICAL
+                                              : determine_overall_risk_level(result.rule_results);
         result.recommendation = generate_fraud_recommendation(result);
 
         // Store results
@@ -281,6 +304,163 @@ FraudDetectionResult AdvancedRuleEngine::evaluate_transaction(
     return result;
 }
 
+std::vector<RuleExecutionResultDetail> AdvancedRuleEngine::execute_rules_sequential(
+    const RuleEvaluationPlan& plan,
+    const RuleExecutionContext& context
+) {
+    const PatternScanResult* pattern_scan = plan.pattern_scan ? &*plan.pattern_scan : nullptr;
+
+    std::vector<RuleExecutionResultDetail> results;
+    results.reserve(plan.rules.size());
+
+    const bool early_exit = early_exit_on_critical_.load();
+    bool short_circuited = false;
+    for (const auto* rule : plan.rules) {
+        if (short_circuited) {
+            results.push_back(make_short_circuit_result(*rule));
+            continue;
+        }
+
+        results.push_back(run_rule(*rule, context, pattern_scan));
+        if (early_exit && is_critical_failure(results.back())) {
+            short_circuited = true;
+        }
+    }
+
+    return results;
+}
+
+/**
+ * State shared between evaluate_transaction and its pool tasks. Owned through
+ * a shared_ptr so tasks abandoned on timeout or early exit can still finish
+ * safely after the caller has returned; `cancelled` tells those tasks to stop
+ * at their next checkpoint instead of holding a pool thread.
+ */
+struct AdvancedRuleEngine::ParallelRuleEvaluation {
+    RuleEvaluationPlan plan;
+    RuleExecutionContext context;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::optional<RuleExecutionResultDetail>> results;
+    size_t settled = 0;
+    bool short_circuited = false;
+    std::atomic<bool> cancelled{false};
+};
+
+std::vector<RuleExecutionResultDetail> AdvancedRuleEngine::execute_rules_parallel(
+    RuleEvaluationPlan plan,
+    const RuleExecutionContext& context,
+    const std::shared_ptr<RuleExecutionPool>& pool
+) {
+    auto evaluation = std::make_shared<ParallelRuleEvaluation>();
+    evaluation->plan = std::move(plan);
+    evaluation->context = context;
+
+    const size_t rule_count = evaluation->plan.rules.size();
+    evaluation->results.resize(rule_count);
+
+    const bool early_exit = early_exit_on_critical_.load();
+    const auto timeout = execution_timeout_.load();
+    // One deadline for the batch, so rules still queued behind a saturated pool time out too
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    for (size_t i = 0; i < rule_count; ++i) {
+        pool->submit([this, evaluation, i, early_exit]() {
+            const RuleDefinition& rule = *evaluation->plan.rules[i];
+            {
+                std::lock_guard<std::mutex> lock(evaluation->mutex);
+                if (evaluation->results[i] || evaluation->short_circuited) {
+                    return; // settled by the caller before this task started
+                }
+            }
+
+            const auto& pattern_scan = evaluation->plan.pattern_scan;
+            auto rule_result = run_rule(rule, evaluation->context, pattern_scan ? &*pattern_scan : nullptr,
+                                        &evaluation->cancelled, false);
+
+            {
+                std::lock_guard<std::mutex> lock(evaluation->mutex);
+                if (evaluation->results[i]) {
+                    return; // already reported, and recorded, as TIMEOUT
+                }
+                if (enable_performance_monitoring_) {
+                    update_rule_metrics(rule, rule_result);
+                }
+                if (early_exit && is_critical_failure(rule_result)) {
+                    evaluation->short_circuited = true;
+                    evaluation->cancelled.store(true, std::memory_order_release);
+                }
+                evaluation->results[i] = std::move(rule_result);
+                evaluation->settled++;
+            }
+            evaluation->cv.notify_all();
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(evaluation->mutex);
+    while (evaluation->settled < rule_count) {
+        const bool expired = std::chrono::steady_clock::now() >= deadline;
+
+        for (size_t i = 0; i < rule_count; ++i) {
+            if (evaluation->results[i]) {
+                continue;
+            }
+            const RuleDefinition& rule = *evaluation->plan.rules[i];
+
+            if (evaluation->short_circuited) {
+                evaluation->results[i] = make_short_circuit_result(rule);
+                evaluation->settled++;
+            } else if (expired) {
+                // Running or still queued: either way it missed the batch deadline
+                RuleExecutionResultDetail timed_out;
+                timed_out.rule_id = rule.rule_id;
+                timed_out.rule_name = rule.name;
+                timed_out.result = RuleExecutionResult::TIMEOUT;
+                timed_out.error_message = fmt::format("Rule execution exceeded timeout of {}ms", timeout.count());
+                timed_out.execution_time = timeout;
+                if (enable_performance_monitoring_) {
+                    update_rule_metrics(rule, timed_out);
+                }
+                evaluation->results[i] = std::move(timed_out);
+                evaluation->settled++;
+
+                if (logger_) {
+                    logger_->warn(fmt::format("Rule '{}' timed out for transaction {}",
+                                              rule.rule_id, evaluation->context.transaction_id));
+                }
+            }
+        }
+
+        if (evaluation->settled < rule_count) {
+            evaluation->cv.wait_until(lock, deadline);
+        }
+    }
+    // Anything still running has been reported as TIMEOUT or SKIPPED
+    evaluation->cancelled.store(true, std::memory_order_release);
+
+    std::vector<RuleExecutionResultDetail> results;
+    results.reserve(rule_count);
+    for (auto& rule_result : evaluation->results) {
+        results.push_back(std::move(*rule_result));
+    }
+    return results;
+}
+
+bool AdvancedRuleEngine::is_critical_failure(const RuleExecutionResultDetail& result) const {
+    return result.result == RuleExecutionResult::FAIL && result.risk_level == FraudRiskLevel::CRITICAL;
+}
+
+RuleExecutionResultDetail AdvancedRuleEngine::make_short_circuit_result(const RuleDefinition& rule) const {
+    RuleExecutionResultDetail result;
+    result.rule_id = rule.rule_id;
+    result.rule_name = rule.name;
+    result.result = RuleExecutionResult::SKIPPED;
+    result.error_message = "Short-circuited by critical rule failure";
+    result.execution_time = std::chrono::microseconds(0);
+    return result;
+}
+
 RuleExecutionResultDetail AdvancedRuleEngine::execute_validation_rule(
     const RuleDefinition& rule,
     const RuleExecutionContext& context
@@ -290,27 +470,32 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_validation_rule(
     result.rule_name = rule.name;
 
     try {
-        const auto& logic = rule.rule_logic;
-        if (!logic.contains("conditions")) {
+        auto program = get_compiled_program(rule);
+        if (!program->is_valid()) {
+            result.result = RuleExecutionResult::ERROR;
+            result.error_message = std::string("Validation rule execution error: ") + program->compile_error();
+            return result;
+        }
+        if (!program->has_conditions()) {
             result.result = RuleExecutionResult::ERROR;
             result.error_message = "Validation rule missing conditions";
             return result;
         }
 
-        const auto& conditions = logic["conditions"];
+        const auto& conditions = program->conditions();
         bool all_conditions_met = true;
         std::vector<std::string> failed_conditions;
 
         for (const auto& condition : conditions) {
-            bool condition_met = evaluate_condition(condition, context.transaction_data);
+            bool condition_met = condition.evaluate(context.transaction_data);
             if (!condition_met) {
                 all_conditions_met = false;
-                if (condition.contains("description")) {
-                    failed_conditions.push_back(condition["description"]);
+                if (condition.has_description) {
+                    failed_conditions.push_back(condition.description);
                 }
             } else {
                 result.triggered_conditions.push_back(
-                    condition.value("description", "Condition met")
+                    condition.has_description ? condition.description : "Condition met"
                 );
             }
         }
@@ -346,37 +531,22 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_scoring_rule(
     result.rule_name = rule.name;
 
     try {
-        const auto& logic = rule.rule_logic;
+        auto program = get_compiled_program(rule);
+        if (!program->is_valid()) {
+            result.result = RuleExecutionResult::ERROR;
+            result.error_message = std::string("Scoring rule execution error: ") + program->compile_error();
+            return result;
+        }
+
         double score = 0.0;
         std::unordered_map<std::string, double> risk_factors;
 
-        if (logic.contains("scoring_factors")) {
-            const auto& factors = logic["scoring_factors"];
-
-            for (const auto& factor : factors) {
-                std::string field = factor["field"];
-                double weight = factor.value("weight", 1.0);
-                std::string operation = factor.value("operation", "exists");
-
-                // Extract field value
-                auto field_value = extract_field_value(context.transaction_data, field);
-
-                double factor_score = 0.0;
-                if (operation == "exists" && !field_value.is_null()) {
-                    factor_score = weight;
-                } else if (operation == "value" && field_value.is_number()) {
-                    factor_score = field_value.get<double>() * weight;
-                } else if (operation == "threshold") {
-                    double threshold = factor.value("threshold", 0.0);
-                    if (field_value.is_number() && field_value.get<double>() > threshold) {
-                        factor_score = weight;
-                    }
-                }
+        for (const auto& factor : program->scoring_factors()) {
+            double factor_score = factor.evaluate(context.transaction_data);
 
-                score += factor_score;
-                if (factor_score > 0) {
-                    risk_factors[field] = factor_score;
-                }
+            score += factor_score;
+            if (factor_score > 0) {
+                risk_factors[factor.field.str()] = factor_score;
             }
         }
 
@@ -384,7 +554,7 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_scoring_rule(
         score = normalize_risk_score(score);
 
         // Determine if rule fails based on threshold
-        double threshold = logic.value("threshold", 0.5);
+        double threshold = program->scoring_threshold();
         result.result = (score >= threshold) ? RuleExecutionResult::FAIL : RuleExecutionResult::PASS;
 
         result.rule_output = {
@@ -405,58 +575,46 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_scoring_rule(
 
 RuleExecutionResultDetail AdvancedRuleEngine::execute_pattern_rule(
     const RuleDefinition& rule,
-    const RuleExecutionContext& context
+    const RuleExecutionContext& context,
+    const PatternScanResult* pattern_scan
 ) {
     RuleExecutionResultDetail result;
     result.rule_id = rule.rule_id;
     result.rule_name = rule.name;
 
     try {
-        const auto& logic = rule.rule_logic;
+        auto program = get_compiled_program(rule);
+        if (!program->is_valid()) {
+            result.result = RuleExecutionResult::ERROR;
+            result.error_message = std::string("Pattern rule execution error: ") + program->compile_error();
+            return result;
+        }
+
+        // Regex hits come from the shared scan when it was built from this rule version
+        bool use_scan = pattern_scan && pattern_scan->covers(program.get());
+
         bool pattern_matched = false;
         std::vector<std::string> matched_patterns;
 
-        if (logic.contains("patterns")) {
-            const auto& patterns = logic["patterns"];
-
-            for (const auto& pattern : patterns) {
-                std::string pattern_type = pattern["type"];
-
-                if (pattern_type == "regex") {
-                    std::string field = pattern["field"];
-                    std::string regex_pattern = pattern["pattern"];
-
-                    auto field_value = extract_field_value(context.transaction_data, field);
-                    if (field_value.is_string()) {
-                        try {
-                            std::regex compiled_pattern(regex_pattern);
-                            std::string value_str = field_value.get<std::string>();
-                            if (std::regex_match(value_str, compiled_pattern)) {
-                                pattern_matched = true;
-                                matched_patterns.push_back("Regex pattern on field '" + field + "'");
-                            }
-                        } catch (const std::exception& ex) {
-                            if (logger_) {
-                                logger_->warn(fmt::format(
-                                    "Invalid regex '{}' for pattern rule '{}': {}",
-                                    regex_pattern,
-                                    rule.rule_id,
-                                    ex.what()));
-                            }
-                        }
-                    }
-                } else if (pattern_type == "value_list") {
-                    std::string field = pattern["field"];
-                    const auto& values = pattern["values"];
-
-                    auto field_value = extract_field_value(context.transaction_data, field);
-                    for (const auto& allowed_value : values) {
-                        if (field_value == allowed_value) {
-                            pattern_matched = true;
-                            matched_patterns.push_back("Value list match on field '" + field + "'");
-                            break;
-                        }
-                    }
+        const auto& patterns = program->patterns();
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            const auto& pattern = patterns[i];
+
+            if (pattern.type == PatternType::REGEX) {
+                if (!pattern.regex) {
+                    continue; // invalid regex, reported when the rule was compiled
+                }
+
+                bool matched = use_scan ? pattern_scan->matched(program.get(), i)
+                                        : pattern.matches(context.transaction_data);
+                if (matched) {
+                    pattern_matched = true;
+                    matched_patterns.push_back("Regex pattern on field '" + pattern.field.str() + "'");
+                }
+            } else if (pattern.type == PatternType::VALUE_LIST) {
+                if (pattern.matches(context.transaction_data)) {
+                    pattern_matched = true;
+                    matched_patterns.push_back("Value list match on field '" + pattern.field.str() + "'");
                 }
             }
         }
@@ -482,7 +640,8 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_pattern_rule(
 
 RuleExecutionResultDetail AdvancedRuleEngine::execute_ml_rule(
     const RuleDefinition& rule,
-    const RuleExecutionContext& context
+    const RuleExecutionContext& context,
+    const std::atomic<bool>* cancelled
 ) {
     RuleExecutionResultDetail result;
     result.rule_id = rule.rule_id;
@@ -521,6 +680,13 @@ RuleExecutionResultDetail AdvancedRuleEngine::execute_ml_rule(
             {"rule_parameters", rule.parameters}
         };
 
+        // The LLM round trip dominates; skip it once the evaluation has moved on
+        if (cancelled && cancelled->load(std::memory_order_acquire)) {
+            result.result = RuleExecutionResult::SKIPPED;
+            result.error_message = "Evaluation cancelled";
+            return result;
+        }
+
         // Use LLM to perform ML-based fraud risk assessment
         auto llm_response = llm_interface_->assess_risk(ml_analysis_data, model_type);
 
@@ -643,23 +809,16 @@ std::optional<RuleDefinition> AdvancedRuleEngine::get_rule(const std::string& ru
     // Load from database
     auto rule_opt = load_rule(rule_id);
     if (rule_opt) {
+        compile_rule(*rule_opt);
         rule_cache_[rule_id] = *rule_opt;
+        rebuild_rule_snapshot();
     }
 
     return rule_opt;
 }
 
 std::vector<RuleDefinition> AdvancedRuleEngine::get_active_rules() {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
-
-    std::vector<RuleDefinition> active_rules;
-    for (const auto& [id, rule] : rule_cache_) {
-        if (rule.is_active) {
-            active_rules.push_back(rule);
-        }
-    }
-
-    return active_rules;
+    return get_rule_snapshot()->rules;
 }
 
 void AdvancedRuleEngine::reload_rules() {
@@ -669,9 +828,11 @@ void AdvancedRuleEngine::reload_rules() {
         rule_cache_.clear();
         auto active_rules = load_active_rules();
 
-        for (const auto& rule : active_rules) {
-            rule_cache_[rule.rule_id] = rule;
+        for (auto& rule : active_rules) {
+            compile_rule(rule);
+            rule_cache_[rule.rule_id] = std::move(rule);
         }
+        rebuild_rule_snapshot();
 
         if (logger_) {
             logger_->info(fmt::format("Reloaded {} active rules into cache", rule_cache_.size()));
@@ -757,65 +918,6 @@ bool AdvancedRuleEngine::validate_rule_definition(const RuleDefinition& rule) {
     return true;
 }
 
-nlohmann::json AdvancedRuleEngine::extract_field_value(const nlohmann::json& data, const std::string& field_path) {
-    try {
-        // Simple dot notation support (e.g., "user.amount")
-        std::stringstream ss(field_path);
-        std::string field;
-        nlohmann::json current = data;
-
-        while (std::getline(ss, field, '.')) {
-            if (current.contains(field)) {
-                current = current[field];
-            } else {
-                return nullptr;
-            }
-        }
-
-        return current;
-
-    } catch (const std::exception&) {
-        return nullptr;
-    }
-}
-
-bool AdvancedRuleEngine::evaluate_condition(const nlohmann::json& condition, const nlohmann::json& data) {
-    try {
-        std::string field = condition["field"];
-        std::string operator_str = condition["operator"];
-
-        auto field_value = extract_field_value(data, field);
-        if (field_value.is_null()) {
-            return false;
-        }
-
-        if (operator_str == "equals") {
-            return field_value == condition["value"];
-        } else if (operator_str == "not_equals") {
-            return field_value != condition["value"];
-        } else if (operator_str == "greater_than") {
-            if (field_value.is_number() && condition["value"].is_number()) {
-                return field_value.get<double>() > condition["value"].get<double>();
-            }
-        } else if (operator_str == "less_than") {
-            if (field_value.is_number() && condition["value"].is_number()) {
-                return field_value.get<double>() < condition["value"].get<double>();
-            }
-        } else if (operator_str == "contains") {
-            if (field_value.is_string() && condition["value"].is_string()) {
-                return field_value.get<std::string>().find(condition["value"].get<std::string>()) != std::string::npos;
-            }
-        } else if (operator_str == "exists") {
-            return !field_value.is_null();
-        }
-
-        return false;
-
-    } catch (const std::exception&) {
-        return false;
-    }
-}
-
 double AdvancedRuleEngine::calculate_rule_confidence(const RuleDefinition& rule, const RuleExecutionResultDetail& result) {
     // Base confidence on rule priority and execution result
     double base_confidence = 0.5;
@@ -915,26 +1017,26 @@ std::optional<RuleDefinition> AdvancedRuleEngine::load_rule(const std::string& r
         )";
 
         std::vector<std::string> params = {rule_id};
-        auto result = db_conn_->execute_query(query, params);
+        auto result = db_conn_->execute_query_view(query, params);
 
-        if (result.rows.empty()) {
+        if (!result.ok() || result.empty()) {
             return std::nullopt;
         }
 
-        const auto& row = result.rows[0];
+        const auto row = result[0];
         RuleDefinition rule;
 
-        rule.rule_id = row.at("rule_id");
-        rule.name = row.at("name");
-        rule.description = row.at("description");
-        rule.priority = static_cast<RulePriority>(safe_string_to_int(row.at("priority"), static_cast<int>(RulePriority::MEDIUM)));
-        rule.rule_type = row.at("rule_type");
-        rule.rule_logic = nlohmann::json::parse(row.at("rule_logic"));
-        rule.parameters = nlohmann::json::parse(row.at("parameters"));
-        rule.input_fields = nlohmann::json::parse(row.at("input_fields")).get<std::vector<std::string>>();
-        rule.output_fields = nlohmann::json::parse(row.at("output_fields")).get<std::vector<std::string>>();
-        rule.is_active = (row.at("is_active") == "true");
-        rule.created_by = row.at("created_by");
+        rule.rule_id = row.get_string("rule_id");
+        rule.name = row.get_string("name");
+        rule.description = row.get_string("description");
+        rule.priority = static_cast<RulePriority>(row.get_int("priority").value_or(static_cast<int>(RulePriority::MEDIUM)));
+        rule.rule_type = row.get_string("rule_type");
+        rule.rule_logic = nlohmann::json::parse(row.get("rule_logic"));
+        rule.parameters = nlohmann::json::parse(row.get("parameters"));
+        rule.input_fields = nlohmann::json::parse(row.get("input_fields")).get<std::vector<std::string>>();
+        rule.output_fields = nlohmann::json::parse(row.get("output_fields")).get<std::vector<std::string>>();
+        rule.is_active = row.get_bool("is_active").value_or(false);
+        rule.created_by = row.get_string("created_by");
 
         return rule;
 
@@ -1005,35 +1107,8 @@ std::vector<RuleDefinition> AdvancedRuleEngine::load_active_rules() {
 
 bool AdvancedRuleEngine::store_fraud_detection_result(const FraudDetectionResult& result) {
     try {
-        if (!db_conn_) return false;
-
-        std::string query = R"(
-            INSERT INTO fraud_detection_results (
-                transaction_id, is_fraudulent, overall_risk, fraud_score,
-                rule_results, aggregated_findings, detection_time, processing_duration,
-                recommendation
-            ) VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9)
-        )";
-
-        nlohmann::json rule_results_json = nlohmann::json::array();
-        for (const auto& detail : result.rule_results) {
-            rule_results_json.push_back(serialize_rule_result(detail));
-        }
-
-        std::vector<std::string> params = {
-            result.transaction_id,
-            result.is_fraudulent ? "true" : "false",
-            std::to_string(static_cast<int>(result.overall_risk)),
-            std::to_string(result.fraud_score),
-            rule_results_json.dump(),
-            result.aggregated_findings.dump(),
-            std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
-                result.detection_time.time_since_epoch()).count()),
-            result.processing_duration,
-            result.recommendation
-        };
-
-        return db_conn_->execute_command(query, params);
+        if (!result_writer_) return false;
+        return result_writer_->submit(result);
 
     } catch (const std::exception& e) {
         if (logger_) {
@@ -1043,34 +1118,212 @@ bool AdvancedRuleEngine::store_fraud_detection_result(const FraudDetectionResult
     }
 }
 
-void AdvancedRuleEngine::update_rule_metrics(const std::string& rule_id, const RuleExecutionResultDetail& result) {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+void AdvancedRuleEngine::flush_pending_results() {
+    if (result_writer_) {
+        result_writer_->flush();
+    }
+}
 
-    auto& metrics = metrics_cache_[rule_id];
+void AdvancedRuleEngine::update_rule_metrics(const RuleDefinition& rule, const RuleExecutionResultDetail& result) {
+    // Cached rules carry their counters; ad-hoc rules fall back to a shared-lock lookup
+    auto counters = rule.metrics_counters ? rule.metrics_counters : metrics_registry_.counters_for(rule.rule_id);
+    counters->record(static_cast<int>(result.result), result.execution_time, result.confidence_score);
+}
+
+RulePerformanceMetrics AdvancedRuleEngine::build_rule_metrics(
+    const std::string& rule_id,
+    const RuleMetricsSnapshot& snapshot
+) const {
+    RulePerformanceMetrics metrics;
     metrics.rule_id = rule_id;
-    metrics.total_executions++;
+    metrics.total_executions = static_cast<int>(snapshot.total_executions);
+    metrics.successful_executions = static_cast<int>(snapshot.passes);
+    metrics.failed_executions = static_cast<int>(snapshot.failures);
+    metrics.fraud_detections = static_cast<int>(snapshot.failures);
+    metrics.timeouts = static_cast<int>(snapshot.timeouts);
+
+    if (snapshot.total_executions > 0) {
+        const auto executions = static_cast<double>(snapshot.total_executions);
+        metrics.average_execution_time_ms = static_cast<double>(snapshot.total_execution_time_us) / executions / 1000.0;
+        metrics.average_confidence_score = snapshot.total_confidence / executions;
+    }
+    metrics.p50_execution_time_us = snapshot.percentile_us(50.0);
+    metrics.p95_execution_time_us = snapshot.percentile_us(95.0);
+    metrics.p99_execution_time_us = snapshot.percentile_us(99.0);
+    metrics.max_execution_time_us = static_cast<double>(snapshot.max_execution_time_us);
+    metrics.last_execution = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::microseconds(snapshot.last_execution_us)));
+
+    if (snapshot.errors > 0) {
+        metrics.error_counts[to_string(RuleExecutionResult::ERROR)] = static_cast<int>(snapshot.errors);
+    }
+    if (snapshot.timeouts > 0) {
+        metrics.error_counts[to_string(RuleExecutionResult::TIMEOUT)] = static_cast<int>(snapshot.timeouts);
+    }
+
+    return metrics;
+}
 
-    if (result.result == RuleExecutionResult::PASS) {
-        metrics.successful_executions++;
-    } else if (result.result == RuleExecutionResult::FAIL) {
-        metrics.failed_executions++;
-        metrics.fraud_detections++;
+RulePerformanceMetrics AdvancedRuleEngine::get_rule_metrics(const std::string& rule_id) {
+    auto counters = metrics_registry_.find(rule_id);
+    if (!counters) {
+        RulePerformanceMetrics empty;
+        empty.rule_id = rule_id;
+        return empty;
     }
+    return build_rule_metrics(rule_id, counters->snapshot());
+}
 
-    metrics.average_confidence_score = (metrics.average_confidence_score + result.confidence_score) / 2.0;
-    metrics.last_execution = std::chrono::system_clock::now();
+std::vector<RulePerformanceMetrics> AdvancedRuleEngine::get_all_rule_metrics() {
+    std::vector<RulePerformanceMetrics> all_metrics;
+    for (const auto& [rule_id, counters] : metrics_registry_.all()) {
+        all_metrics.push_back(build_rule_metrics(rule_id, counters->snapshot()));
+    }
+    return all_metrics;
 }
 
-void AdvancedRuleEngine::record_execution_time(const std::string& rule_id, std::chrono::milliseconds duration) {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
+void AdvancedRuleEngine::reset_rule_metrics(const std::string& rule_id) {
+    metrics_registry_.reset(rule_id);
+}
 
-    auto& metrics = metrics_cache_[rule_id];
-    metrics.average_execution_time_ms = (metrics.average_execution_time_ms + duration.count()) / 2.0;
+void AdvancedRuleEngine::compile_rule(RuleDefinition& rule) {
+    rule.compiled_program = CompiledRuleProgram::compile(rule.rule_type, rule.rule_logic);
+    rule.metrics_counters = metrics_registry_.counters_for(rule.rule_id);
+    if (!logger_) {
+        return;
+    }
+    if (!rule.compiled_program->is_valid()) {
+        logger_->warn(fmt::format("Rule '{}' failed to compile: {}",
+                                  rule.rule_id, rule.compiled_program->compile_error()));
+    }
+    for (const auto& pattern : rule.compiled_program->patterns()) {
+        if (pattern.type == PatternType::REGEX && !pattern.regex) {
+            logger_->warn(fmt::format("Invalid regex '{}' for pattern rule '{}': {}",
+                                      pattern.regex_source, rule.rule_id, pattern.regex_error));
+        }
+    }
+}
+
+std::shared_ptr<const CompiledRuleProgram> AdvancedRuleEngine::get_compiled_program(const RuleDefinition& rule) {
+    if (rule.compiled_program && rule.compiled_program->rule_type() == rule.rule_type) {
+        return rule.compiled_program;
+    }
+    // Ad-hoc rules (e.g. test executions) that never entered the cache
+    return CompiledRuleProgram::compile(rule.rule_type, rule.rule_logic);
 }
 
 void AdvancedRuleEngine::cache_rule(const RuleDefinition& rule) {
+    RuleDefinition compiled_rule = rule;
+    compile_rule(compiled_rule);
+
     std::lock_guard<std::mutex> lock(cache_mutex_);
-    rule_cache_[rule.rule_id] = rule;
+    rule_cache_[rule.rule_id] = std::move(compiled_rule);
+    rebuild_rule_snapshot();
+}
+
+void AdvancedRuleEngine::rebuild_rule_snapshot() {
+    auto snapshot = std::make_shared<ActiveRuleSnapshot>();
+
+    std::vector<std::shared_ptr<const CompiledRuleProgram>> pattern_programs;
+    for (const auto& [id, rule] : rule_cache_) {
+        if (!rule.is_active) {
+            continue;
+        }
+        snapshot->rules.push_back(rule);
+        if (rule.rule_type == "PATTERN" && rule.compiled_program) {
+            pattern_programs.push_back(rule.compiled_program);
+        }
+    }
+
+    // Highest priority first; rule_id keeps the order stable across rebuilds
+    std::sort(snapshot->rules.begin(), snapshot->rules.end(),
+              [](const RuleDefinition& a, const RuleDefinition& b) {
+                  if (a.priority != b.priority) {
+                      return static_cast<int>(a.priority) > static_cast<int>(b.priority);
+                  }
+                  return a.rule_id < b.rule_id;
+              });
+    snapshot->pattern_index = PatternRuleIndex::build(pattern_programs);
+
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    rule_snapshot_ = std::move(snapshot);
+}
+
+std::shared_ptr<const ActiveRuleSnapshot> AdvancedRuleEngine::get_rule_snapshot() {
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if (!rule_snapshot_) {
+        rule_snapshot_ = std::make_shared<ActiveRuleSnapshot>();
+    }
+    return rule_snapshot_;
+}
+
+void AdvancedRuleEngine::set_execution_timeout(std::chrono::milliseconds timeout) {
+    execution_timeout_ = timeout;
+}
+
+void AdvancedRuleEngine::set_max_parallel_executions(int max_parallel) {
+    const int workers = std::max(1, max_parallel);
+    max_parallel_executions_ = workers;
+    if (parallel_evaluation_) {
+        // In-flight evaluations keep the previous pool alive until they finish
+        auto pool = std::make_shared<RuleExecutionPool>(static_cast<size_t>(workers));
+        std::lock_guard<std::mutex> lock(snapshot_mutex_);
+        execution_pool_ = std::move(pool);
+    }
+}
+
+void AdvancedRuleEngine::set_parallel_evaluation(bool enabled) {
+    parallel_evaluation_ = enabled;
+    std::lock_guard<std::mutex> lock(snapshot_mutex_);
+    if (enabled && !execution_pool_) {
+        execution_pool_ = std::make_shared<RuleExecutionPool>(
+            static_cast<size_t>(std::max(1, max_parallel_executions_.load())));
+    }
+}
+
+void AdvancedRuleEngine::set_early_exit_on_critical(bool enabled) {
+    early_exit_on_critical_ = enabled;
+}
+
+FraudResultWriterConfig AdvancedRuleEngine::load_result_writer_config() {
+    FraudResultWriterConfig writer_config;
+
+    try {
+        if (config_manager_) {
+            auto mode_opt = config_manager_->get_config("rule_engine.result_persistence_mode");
+            if (mode_opt && mode_opt->value.is_string()) {
+                writer_config.mode = FraudResultWriter::parse_mode(mode_opt->value.get<std::string>());
+            }
+
+            auto batch_opt = config_manager_->get_config("rule_engine.result_flush_batch_size");
+            if (batch_opt && batch_opt->value.is_number()) {
+                writer_config.flush_batch_size = static_cast<size_t>(batch_opt->value.get<double>());
+            }
+
+            auto interval_opt = config_manager_->get_config("rule_engine.result_flush_interval_ms");
+            if (interval_opt && interval_opt->value.is_number()) {
+                writer_config.flush_interval = std::chrono::milliseconds(
+                    static_cast<long long>(interval_opt->value.get<double>()));
+            }
+
+            auto capacity_opt = config_manager_->get_config("rule_engine.result_queue_capacity");
+            if (capacity_opt && capacity_opt->value.is_number()) {
+                writer_config.queue_capacity = static_cast<size_t>(capacity_opt->value.get<double>());
+            }
+
+            auto attempts_opt = config_manager_->get_config("rule_engine.result_max_write_attempts");
+            if (attempts_opt && attempts_opt->value.is_number()) {
+                writer_config.max_write_attempts = static_cast<size_t>(attempts_opt->value.get<double>());
+            }
+        }
+    } catch (const std::exception& e) {
+        if (logger_) {
+            logger_->warn(fmt::format("Failed to load fraud result persistence configuration: {}", e.what()));
+        }
+    }
+
+    return writer_config;
 }
 
 void AdvancedRuleEngine::load_configuration() {
@@ -1094,6 +1347,17 @@ void AdvancedRuleEngine::load_configuration() {
             if (monitoring_opt && monitoring_opt->value.is_boolean()) {
                 enable_performance_monitoring_ = monitoring_opt->value.get<bool>();
             }
+
+            // Load parallel evaluation settings
+            auto parallel_opt = config_manager_->get_config("rule_engine.parallel_evaluation");
+            if (parallel_opt && parallel_opt->value.is_boolean()) {
+                parallel_evaluation_ = parallel_opt->value.get<bool>();
+            }
+
+            auto early_exit_opt = config_manager_->get_config("rule_engine.early_exit_on_critical");
+            if (early_exit_opt && early_exit_opt->value.is_boolean()) {
+                early_exit_on_critical_ = early_exit_opt->value.get<bool>();
+            }
         }
     } catch (const std::exception& e) {
         if (logger_) {
@@ -6,6 +6,7 @@
 #ifndef ADVANCED_RULE_ENGINE_HPP
 #define ADVANCED_RULE_ENGINE_HPP
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <memory>
@@ -18,6 +19,10 @@
 #include "../logging/structured_logger.hpp"
 #include "../config/dynamic_config_manager.hpp"
 #include "../agentic_brain/llm_interface.hpp"
+#include "compiled_rule_program.hpp"
+#include "pattern_rule_index.hpp"
+#include "rule_execution_pool.hpp"
+#include "rule_metrics_registry.hpp"
 
 namespace regulens {
 
@@ -50,6 +55,9 @@ enum class FraudRiskLevel {
     CRITICAL
 };
 
+std::string to_string(RuleExecutionResult result);
+std::string to_string(FraudRiskLevel level);
+
 struct RuleExecutionContext {
     std::string transaction_id;
     std::string user_id;
@@ -70,7 +78,7 @@ struct RuleExecutionResultDetail {
     FraudRiskLevel risk_level = FraudRiskLevel::LOW;
     nlohmann::json rule_output;
     std::string error_message;
-    std::chrono::milliseconds execution_time;
+    std::chrono::microseconds execution_time{0};
     std::vector<std::string> triggered_conditions;
     std::unordered_map<std::string, double> risk_factors;
 };
@@ -103,6 +111,11 @@ struct RuleDefinition {
     std::string created_by;
     std::chrono::system_clock::time_point created_at;
     std::chrono::system_clock::time_point updated_at;
+
+    // Compiled form of rule_logic, attached when the rule enters the cache
+    std::shared_ptr<const CompiledRuleProgram> compiled_program;
+    // Lock-free performance counters, attached together with the compiled program
+    std::shared_ptr<RuleMetricsCounters> metrics_counters;
 };
 
 struct RulePerformanceMetrics {
@@ -112,12 +125,31 @@ struct RulePerformanceMetrics {
     int failed_executions = 0;
     int fraud_detections = 0;
     int false_positives = 0;
+    int timeouts = 0;
     double average_execution_time_ms = 0.0;
+    double p50_execution_time_us = 0.0;
+    double p95_execution_time_us = 0.0;
+    double p99_execution_time_us = 0.0;
+    double max_execution_time_us = 0.0;
     double average_confidence_score = 0.0;
     std::chrono::system_clock::time_point last_execution;
     std::unordered_map<std::string, int> error_counts;
 };
 
+/**
+ * @brief Immutable view of the active rule set shared between evaluations
+ *
+ * Rebuilt whenever the rule cache changes; evaluate_transaction reads it
+ * without copying or re-sorting rules.
+ */
+struct ActiveRuleSnapshot {
+    std::vector<RuleDefinition> rules; // active rules, highest priority first
+    std::shared_ptr<const PatternRuleIndex> pattern_index;
+};
+
+class FraudResultWriter;
+struct FraudResultWriterConfig;
+
 class AdvancedRuleEngine {
 public:
     AdvancedRuleEngine(
@@ -175,6 +207,9 @@ public:
     void optimize_rule_execution(); // Optimize rule execution order
     void set_execution_timeout(std::chrono::milliseconds timeout);
     void set_max_parallel_executions(int max_parallel);
+    void set_parallel_evaluation(bool enabled); // Fan rules out over the execution pool
+    void set_early_exit_on_critical(bool enabled); // Stop once a CRITICAL failure forces BLOCK
+    void flush_pending_results(); // Wait for write-behind fraud results to reach the database
 
     // Risk scoring and aggregation
     double calculate_aggregated_risk_score(const std::vector<RuleExecutionResultDetail>& results);
@@ -189,15 +224,57 @@ private:
 
     // In-memory rule cache
     std::unordered_map<std::string, RuleDefinition> rule_cache_;
-    std::unordered_map<std::string, RulePerformanceMetrics> metrics_cache_;
     std::mutex cache_mutex_;
 
+    // Per-rule sharded atomic counters; never guarded by cache_mutex_
+    RuleMetricsRegistry metrics_registry_;
+
+    // Sorted active rules and PATTERN index, rebuilt with the cache
+    std::shared_ptr<const ActiveRuleSnapshot> rule_snapshot_;
+    std::mutex snapshot_mutex_;
+
     // Execution configuration
-    std::chrono::milliseconds execution_timeout_ = std::chrono::milliseconds(5000);
-    int max_parallel_executions_ = 10;
+    // Read by pool threads while setters may run, hence atomic
+    std::atomic<std::chrono::milliseconds> execution_timeout_{std::chrono::milliseconds(5000)};
+    std::atomic<int> max_parallel_executions_{10};
     bool enable_performance_monitoring_ = true;
+    std::atomic<bool> parallel_evaluation_{false};
+    std::atomic<bool> early_exit_on_critical_{false};
 
     // Rule execution methods
+    struct RuleEvaluationPlan {
+        std::shared_ptr<const ActiveRuleSnapshot> snapshot;
+        std::vector<RuleDefinition> requested_rules;
+        std::vector<const RuleDefinition*> rules;
+        std::optional<PatternScanResult> pattern_scan;
+    };
+    struct ParallelRuleEvaluation;
+
+    std::vector<RuleExecutionResultDetail> execute_rules_sequential(
+        const RuleEvaluationPlan& plan,
+        const RuleExecutionContext& context
+    );
+
+    std::vector<RuleExecutionResultDetail> execute_rules_parallel(
+        RuleEvaluationPlan plan,
+        const RuleExecutionContext& context,
+        const std::shared_ptr<RuleExecutionPool>& pool
+    );
+
+    bool is_critical_failure(const RuleExecutionResultDetail& result) const;
+    RuleExecutionResultDetail make_short_circuit_result(const RuleDefinition& rule) const;
+
+    // cancelled, when set, is polled before and between the expensive steps of a rule.
+    // record_metrics false leaves recording to the caller (parallel evaluation, which
+    // records TIMEOUT instead for a rule that finishes after its deadline).
+    RuleExecutionResultDetail run_rule(
+        const RuleDefinition& rule,
+        const RuleExecutionContext& context,
+        const PatternScanResult* pattern_scan,
+        const std::atomic<bool>* cancelled = nullptr,
+        bool record_metrics = true
+    );
+
     RuleExecutionResultDetail execute_validation_rule(
         const RuleDefinition& rule,
         const RuleExecutionContext& context
@@ -210,20 +287,20 @@ private:
 
     RuleExecutionResultDetail execute_pattern_rule(
         const RuleDefinition& rule,
-        const RuleExecutionContext& context
+        const RuleExecutionContext& context,
+        const PatternScanResult* pattern_scan = nullptr
     );
 
     RuleExecutionResultDetail execute_ml_rule(
         const RuleDefinition& rule,
-        const RuleExecutionContext& context
+        const RuleExecutionContext& context,
+        const std::atomic<bool>* cancelled = nullptr
     );
 
     // Utility methods
     std::string generate_rule_id();
     std::string generate_transaction_id();
     bool validate_rule_definition(const RuleDefinition& rule);
-    nlohmann::json extract_field_value(const nlohmann::json& data, const std::string& field_path);
-    bool evaluate_condition(const nlohmann::json& condition, const nlohmann::json& data);
     double calculate_rule_confidence(const RuleDefinition& rule, const RuleExecutionResultDetail& result);
 
     // Risk calculation helpers
@@ -240,14 +317,27 @@ private:
     bool store_fraud_detection_result(const FraudDetectionResult& result);
 
     // Performance tracking
-    void update_rule_metrics(const std::string& rule_id, const RuleExecutionResultDetail& result);
-    void record_execution_time(const std::string& rule_id, std::chrono::milliseconds duration);
+    void update_rule_metrics(const RuleDefinition& rule, const RuleExecutionResultDetail& result);
+    RulePerformanceMetrics build_rule_metrics(const std::string& rule_id, const RuleMetricsSnapshot& snapshot) const;
+
+    // Rule compilation
+    void compile_rule(RuleDefinition& rule);
+    std::shared_ptr<const CompiledRuleProgram> get_compiled_program(const RuleDefinition& rule);
 
     // Cache management
     void cache_rule(const RuleDefinition& rule);
+    void rebuild_rule_snapshot(); // caller holds cache_mutex_
+    std::shared_ptr<const ActiveRuleSnapshot> get_rule_snapshot();
     void invalidate_rule_cache(const std::string& rule_id = "");
     void cleanup_expired_cache_entries();
     void load_configuration();
+    FraudResultWriterConfig load_result_writer_config();
+
+    // Write-behind persistence of fraud detection results
+    std::unique_ptr<FraudResultWriter> result_writer_;
+
+    // Declared last so workers are joined before the members their tasks use
+    std::shared_ptr<RuleExecutionPool> execution_pool_;
 };
 
 } // namespace regulens
@@ -514,7 +514,8 @@ nlohmann::json AdvancedRuleEngineAPIHandlers::format_execution_result(const Rule
         {"confidence_score", result.confidence_score},
         {"risk_level", risk_level_to_string(result.risk_level)},
         {"rule_output", result.rule_output},
-        {"execution_time_ms", result.execution_time.count()},
+        {"execution_time_ms", static_cast<double>(result.execution_time.count()) / 1000.0},
+        {"execution_time_us", result.execution_time.count()},
         {"triggered_conditions", result.triggered_conditions},
         {"error_message", result.error_message}
     };
@@ -0,0 +1,236 @@
+/**
+ * Compiled Rule Program Implementation
+ * Pre-compiled representation of rule_logic used by AdvancedRuleEngine
+ */
+
+#include "compiled_rule_program.hpp"
+#include <sstream>
+
+namespace regulens {
+
+FieldPath::FieldPath(const std::string& dotted_path) : path_(dotted_path) {
+    // Same splitting semantics as the interpreted dot-notation lookup
+    std::stringstream ss(dotted_path);
+    std::string segment;
+    while (std::getline(ss, segment, '.')) {
+        segments_.push_back(segment);
+    }
+}
+
+const nlohmann::json* FieldPath::resolve(const nlohmann::json& data) const {
+    const nlohmann::json* current = &data;
+    for (const auto& segment : segments_) {
+        if (!current->is_object()) {
+            return nullptr;
+        }
+        auto it = current->find(segment);
+        if (it == current->end()) {
+            return nullptr;
+        }
+        current = &(*it);
+    }
+    return current->is_null() ? nullptr : current;
+}
+
+ConditionOperator parse_condition_operator(const std::string& op) {
+    if (op == "equals") return ConditionOperator::EQUALS;
+    if (op == "not_equals") return ConditionOperator::NOT_EQUALS;
+    if (op == "greater_than") return ConditionOperator::GREATER_THAN;
+    if (op == "less_than") return ConditionOperator::LESS_THAN;
+    if (op == "contains") return ConditionOperator::CONTAINS;
+    if (op == "exists") return ConditionOperator::EXISTS;
+    return ConditionOperator::UNKNOWN;
+}
+
+ScoringOperation parse_scoring_operation(const std::string& operation) {
+    if (operation == "exists") return ScoringOperation::EXISTS;
+    if (operation == "value") return ScoringOperation::VALUE;
+    if (operation == "threshold") return ScoringOperation::THRESHOLD;
+    return ScoringOperation::UNKNOWN;
+}
+
+PatternType parse_pattern_type(const std::string& type) {
+    if (type == "regex") return PatternType::REGEX;
+    if (type == "value_list") return PatternType::VALUE_LIST;
+    return PatternType::UNKNOWN;
+}
+
+bool CompiledCondition::evaluate(const nlohmann::json& data) const {
+    if (!valid) {
+        return false;
+    }
+
+    const nlohmann::json* field_value = field.resolve(data);
+    if (!field_value) {
+        return false;
+    }
+
+    switch (op) {
+        case ConditionOperator::EQUALS:
+            return *field_value == operand;
+        case ConditionOperator::NOT_EQUALS:
+            return *field_value != operand;
+        case ConditionOperator::GREATER_THAN:
+            return operand_is_number && field_value->is_number() &&
+                   field_value->get<double>() > numeric_operand;
+        case ConditionOperator::LESS_THAN:
+            return operand_is_number && field_value->is_number() &&
+                   field_value->get<double>() < numeric_operand;
+        case ConditionOperator::CONTAINS:
+            return operand_is_string && field_value->is_string() &&
+                   field_value->get_ref<const std::string&>().find(string_operand) != std::string::npos;
+        case ConditionOperator::EXISTS:
+            return true;
+        case ConditionOperator::UNKNOWN:
+            return false;
+    }
+    return false;
+}
+
+double CompiledScoringFactor::evaluate(const nlohmann::json& data) const {
+    const nlohmann::json* field_value = field.resolve(data);
+
+    switch (operation) {
+        case ScoringOperation::EXISTS:
+            return field_value ? weight : 0.0;
+        case ScoringOperation::VALUE:
+            return (field_value && field_value->is_number()) ? field_value->get<double>() * weight : 0.0;
+        case ScoringOperation::THRESHOLD:
+            return (field_value && field_value->is_number() && field_value->get<double>() > threshold) ? weight : 0.0;
+        case ScoringOperation::UNKNOWN:
+            return 0.0;
+    }
+    return 0.0;
+}
+
+bool CompiledPattern::matches(const nlohmann::json& data) const {
+    const nlohmann::json* field_value = field.resolve(data);
+
+    switch (type) {
+        case PatternType::REGEX:
+            return regex && field_value && field_value->is_string() &&
+                   std::regex_match(field_value->get_ref<const std::string&>(), *regex);
+        case PatternType::VALUE_LIST: {
+            static const nlohmann::json null_value;
+            const nlohmann::json& value = field_value ? *field_value : null_value;
+            for (const auto& candidate : values) {
+                if (value == candidate) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        case PatternType::UNKNOWN:
+            return false;
+    }
+    return false;
+}
+
+std::shared_ptr<const CompiledRuleProgram> CompiledRuleProgram::compile(
+    const std::string& rule_type,
+    const nlohmann::json& rule_logic
+) {
+    auto program = std::make_shared<CompiledRuleProgram>();
+    program->rule_type_ = rule_type;
+
+    try {
+        if (rule_type == "VALIDATION") {
+            program->compile_validation(rule_logic);
+        } else if (rule_type == "SCORING") {
+            program->compile_scoring(rule_logic);
+        } else if (rule_type == "PATTERN") {
+            program->compile_patterns(rule_logic);
+        }
+    } catch (const std::exception& e) {
+        program->compile_error_ = e.what();
+    }
+
+    return program;
+}
+
+void CompiledRuleProgram::compile_validation(const nlohmann::json& logic) {
+    if (!logic.is_object() || !logic.contains("conditions")) {
+        return;
+    }
+    has_conditions_ = true;
+
+    for (const auto& condition : logic["conditions"]) {
+        CompiledCondition compiled;
+
+        if (condition.is_object()) {
+            auto desc_it = condition.find("description");
+            if (desc_it != condition.end()) {
+                compiled.has_description = true;
+                compiled.description = desc_it->is_string() ? desc_it->get<std::string>() : desc_it->dump();
+            }
+
+            auto field_it = condition.find("field");
+            auto op_it = condition.find("operator");
+            if (field_it != condition.end() && field_it->is_string() &&
+                op_it != condition.end() && op_it->is_string()) {
+                compiled.field = FieldPath(field_it->get<std::string>());
+                compiled.op = parse_condition_operator(op_it->get<std::string>());
+                compiled.operand = condition.value("value", nlohmann::json());
+                compiled.operand_is_number = compiled.operand.is_number();
+                if (compiled.operand_is_number) {
+                    compiled.numeric_operand = compiled.operand.get<double>();
+                }
+                compiled.operand_is_string = compiled.operand.is_string();
+                if (compiled.operand_is_string) {
+                    compiled.string_operand = compiled.operand.get<std::string>();
+                }
+                compiled.valid = true;
+            }
+        }
+
+        conditions_.push_back(std::move(compiled));
+    }
+}
+
+void CompiledRuleProgram::compile_scoring(const nlohmann::json& logic) {
+    if (logic.contains("scoring_factors")) {
+        for (const auto& factor : logic["scoring_factors"]) {
+            CompiledScoringFactor compiled;
+            compiled.field = FieldPath(factor.at("field").get<std::string>());
+            compiled.weight = factor.value("weight", 1.0);
+            compiled.operation = parse_scoring_operation(factor.value("operation", "exists"));
+            if (compiled.operation == ScoringOperation::THRESHOLD) {
+                compiled.threshold = factor.value("threshold", 0.0);
+            }
+            scoring_factors_.push_back(std::move(compiled));
+        }
+    }
+
+    scoring_threshold_ = logic.value("threshold", 0.5);
+}
+
+void CompiledRuleProgram::compile_patterns(const nlohmann::json& logic) {
+    if (!logic.contains("patterns")) {
+        return;
+    }
+
+    for (const auto& pattern : logic["patterns"]) {
+        CompiledPattern compiled;
+        compiled.type = parse_pattern_type(pattern.at("type").get<std::string>());
+
+        if (compiled.type == PatternType::REGEX) {
+            compiled.field = FieldPath(pattern.at("field").get<std::string>());
+            compiled.regex_source = pattern.at("pattern").get<std::string>();
+            try {
+                compiled.regex = std::make_shared<const std::regex>(compiled.regex_source);
+            } catch (const std::regex_error& e) {
+                // Invalid regexes never match, mirroring the interpreted behaviour
+                compiled.regex_error = e.what();
+            }
+        } else if (compiled.type == PatternType::VALUE_LIST) {
+            compiled.field = FieldPath(pattern.at("field").get<std::string>());
+            for (const auto& value : pattern.at("values")) {
+                compiled.values.push_back(value);
+            }
+        }
+
+        patterns_.push_back(std::move(compiled));
+    }
+}
+
+} // namespace regulens
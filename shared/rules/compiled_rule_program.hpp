@@ -0,0 +1,160 @@
+/**
+ * Compiled Rule Program
+ * Pre-compiled representation of rule_logic used by AdvancedRuleEngine
+ *
+ * Rules are compiled once when they enter the rule cache so that evaluation
+ * does not re-interpret the rule_logic JSON, split field paths or compare
+ * operator strings for every transaction.
+ */
+
+#ifndef COMPILED_RULE_PROGRAM_HPP
+#define COMPILED_RULE_PROGRAM_HPP
+
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+namespace regulens {
+
+/**
+ * @brief Dot-notation field path split once at compile time
+ *
+ * Resolution walks the transaction JSON by pointer and never copies
+ * intermediate subtrees.
+ */
+class FieldPath {
+public:
+    FieldPath() = default;
+    explicit FieldPath(const std::string& dotted_path);
+
+    /**
+     * @brief Resolve the path against a JSON document
+     * @return Pointer into data, or nullptr if the path is missing or null
+     */
+    const nlohmann::json* resolve(const nlohmann::json& data) const;
+
+    const std::string& str() const { return path_; }
+
+private:
+    std::string path_;
+    std::vector<std::string> segments_;
+};
+
+enum class ConditionOperator {
+    EQUALS,
+    NOT_EQUALS,
+    GREATER_THAN,
+    LESS_THAN,
+    CONTAINS,
+    EXISTS,
+    UNKNOWN
+};
+
+enum class PatternType {
+    REGEX,
+    VALUE_LIST,
+    UNKNOWN
+};
+
+enum class ScoringOperation {
+    EXISTS,
+    VALUE,
+    THRESHOLD,
+    UNKNOWN
+};
+
+struct CompiledCondition {
+    FieldPath field;
+    ConditionOperator op = ConditionOperator::UNKNOWN;
+    nlohmann::json operand;
+    double numeric_operand = 0.0;
+    bool operand_is_number = false;
+    std::string string_operand;
+    bool operand_is_string = false;
+    std::string description;
+    bool has_description = false;
+    bool valid = false; // false when field/operator were malformed; never matches
+
+    bool evaluate(const nlohmann::json& data) const;
+};
+
+struct CompiledScoringFactor {
+    FieldPath field;
+    ScoringOperation operation = ScoringOperation::EXISTS;
+    double weight = 1.0;
+    double threshold = 0.0;
+
+    double evaluate(const nlohmann::json& data) const;
+};
+
+struct CompiledPattern {
+    PatternType type = PatternType::UNKNOWN;
+    FieldPath field;
+
+    // REGEX patterns: compiled once per rule version; null when the regex is invalid
+    std::string regex_source;
+    std::shared_ptr<const std::regex> regex;
+    std::string regex_error;
+
+    // VALUE_LIST patterns
+    std::vector<nlohmann::json> values;
+
+    bool matches(const nlohmann::json& data) const;
+};
+
+/**
+ * @brief Immutable compiled form of a rule's rule_logic
+ *
+ * Shared between all copies of a RuleDefinition; safe to evaluate
+ * concurrently from multiple threads.
+ */
+class CompiledRuleProgram {
+public:
+    static std::shared_ptr<const CompiledRuleProgram> compile(
+        const std::string& rule_type,
+        const nlohmann::json& rule_logic
+    );
+
+    const std::string& rule_type() const { return rule_type_; }
+
+    // Non-empty when rule_logic could not be compiled; evaluation reports ERROR
+    const std::string& compile_error() const { return compile_error_; }
+    bool is_valid() const { return compile_error_.empty(); }
+
+    // VALIDATION rules
+    bool has_conditions() const { return has_conditions_; }
+    const std::vector<CompiledCondition>& conditions() const { return conditions_; }
+
+    // SCORING rules
+    const std::vector<CompiledScoringFactor>& scoring_factors() const { return scoring_factors_; }
+    double scoring_threshold() const { return scoring_threshold_; }
+
+    // PATTERN rules
+    const std::vector<CompiledPattern>& patterns() const { return patterns_; }
+
+private:
+    std::string rule_type_;
+    std::string compile_error_;
+
+    bool has_conditions_ = false;
+    std::vector<CompiledCondition> conditions_;
+
+    std::vector<CompiledScoringFactor> scoring_factors_;
+    double scoring_threshold_ = 0.5;
+
+    std::vector<CompiledPattern> patterns_;
+
+    void compile_validation(const nlohmann::json& logic);
+    void compile_scoring(const nlohmann::json& logic);
+    void compile_patterns(const nlohmann::json& logic);
+};
+
+ConditionOperator parse_condition_operator(const std::string& op);
+ScoringOperation parse_scoring_operation(const std::string& operation);
+PatternType parse_pattern_type(const std::string& type);
+
+} // namespace regulens
+
+#endif // COMPILED_RULE_PROGRAM_HPP
@@ -0,0 +1,324 @@
+/**
+ * Fraud Result Writer Implementation
+ * Write-behind persistence of fraud detection results
+ */
+
+#include "fraud_result_writer.hpp"
+#include <algorithm>
+
+#include <fmt/format.h>
+
+namespace regulens {
+
+namespace {
+
+// fraud_detection_results columns per row; PostgreSQL caps a statement at 65535 parameters
+constexpr size_t kParamsPerRow = 9;
+constexpr size_t kMaxRowsPerStatement = 1000;
+
+nlohmann::json serialize_rule_result(const RuleExecutionResultDetail& detail) {
+    nlohmann::json payload = {
+        {"rule_id", detail.rule_id},
+        {"rule_name", detail.rule_name},
+        {"result", to_string(detail.result)},
+        {"confidence_score", detail.confidence_score},
+        {"risk_level", to_string(detail.risk_level)},
+        {"rule_output", detail.rule_output},
+        {"error_message", detail.error_message},
+        {"execution_time_ms", static_cast<double>(detail.execution_time.count()) / 1000.0},
+        {"execution_time_us", detail.execution_time.count()},
+        {"triggered_conditions", detail.triggered_conditions}
+    };
+
+    nlohmann::json risk_factors_json = nlohmann::json::object();
+    for (const auto& [factor, value] : detail.risk_factors) {
+        risk_factors_json[factor] = value;
+    }
+    payload["risk_factors"] = std::move(risk_factors_json);
+
+    return payload;
+}
+
+std::string build_insert_statement(size_t rows) {
+    std::string query = R"(
+            INSERT INTO fraud_detection_results (
+                transaction_id, is_fraudulent, overall_risk, fraud_score,
+                rule_results, aggregated_findings, detection_time, processing_duration,
+                recommendation
+            ) VALUES )";
+
+    size_t param = 1;
+    for (size_t row = 0; row < rows; ++row) {
+        query += row == 0 ? "(" : ", (";
+        for (size_t column = 0; column < kParamsPerRow; ++column) {
+            if (column > 0) {
+                query += ", ";
+            }
+            query += "$" + std::to_string(param++);
+        }
+        query += ")";
+    }
+    return query;
+}
+
+} // namespace
+
+FraudResultWriter::FraudResultWriter(
+    std::shared_ptr<PostgreSQLConnection> db_conn,
+    std::shared_ptr<StructuredLogger> logger,
+    FraudResultWriterConfig config
+) : db_conn_(std::move(db_conn)), logger_(std::move(logger)), config_(config) {
+    config_.flush_batch_size = std::clamp<size_t>(config_.flush_batch_size, 1, kMaxRowsPerStatement);
+    config_.queue_capacity = std::max(config_.queue_capacity, config_.flush_batch_size);
+    config_.max_write_attempts = std::max<size_t>(config_.max_write_attempts, 1);
+
+    if (config_.mode != ResultDurabilityMode::SYNCHRONOUS) {
+        writer_thread_ = std::thread(&FraudResultWriter::writer_loop, this);
+    }
+}
+
+FraudResultWriter::~FraudResultWriter() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        stopping_ = true;
+    }
+    queue_cv_.notify_all();
+    space_cv_.notify_all();
+
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+}
+
+bool FraudResultWriter::submit(const FraudDetectionResult& result) {
+    if (config_.mode == ResultDurabilityMode::SYNCHRONOUS) {
+        for (size_t attempt = 1; attempt <= config_.max_write_attempts; ++attempt) {
+            if (write_batch({&result}).empty()) {
+                return true;
+            }
+            if (attempt < config_.max_write_attempts) {
+                results_retried_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        results_failed_.fetch_add(1, std::memory_order_relaxed);
+        if (logger_) {
+            logger_->error(fmt::format("Giving up on fraud detection result for transaction {} after {} attempts",
+                                       result.transaction_id, config_.max_write_attempts));
+        }
+        return false;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex_);
+        if (queue_.size() >= config_.queue_capacity) {
+            if (config_.mode == ResultDurabilityMode::BEST_EFFORT) {
+                results_dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            // Backpressure: hold the caller until the writer frees space
+            space_cv_.wait(lock, [this]() {
+                return stopping_ || queue_.size() < config_.queue_capacity;
+            });
+            if (stopping_) {
+                results_dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        queue_.push_back(PendingResult{result, 0});
+        enqueued_sequence_++;
+        if (queue_.size() < config_.flush_batch_size) {
+            return true; // the interval timer will pick it up
+        }
+    }
+    queue_cv_.notify_one();
+    return true;
+}
+
+void FraudResultWriter::flush() {
+    if (config_.mode == ResultDurabilityMode::SYNCHRONOUS) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    const uint64_t target = enqueued_sequence_;
+    queue_cv_.notify_one();
+    drained_cv_.wait(lock, [this, target]() {
+        return written_sequence_ >= target || !writer_thread_.joinable();
+    });
+}
+
+void FraudResultWriter::writer_loop() {
+    while (true) {
+        std::vector<PendingResult> batch;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            queue_cv_.wait_for(lock, config_.flush_interval, [this]() {
+                return stopping_ || queue_.size() >= config_.flush_batch_size;
+            });
+
+            if (queue_.empty()) {
+                if (stopping_) {
+                    break;
+                }
+                continue;
+            }
+
+            size_t count = std::min(queue_.size(), config_.flush_batch_size);
+            batch.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+        space_cv_.notify_all();
+
+        std::vector<const FraudDetectionResult*> rows;
+        rows.reserve(batch.size());
+        for (const auto& pending : batch) {
+            rows.push_back(&pending.result);
+        }
+        std::vector<size_t> failed = write_batch(rows);
+
+        // Failed rows go back on the queue until they run out of attempts;
+        // only settled rows advance the sequence flush() waits on
+        size_t settled = batch.size();
+        std::vector<PendingResult> retries;
+        for (size_t index : failed) {
+            auto& pending = batch[index];
+            if (++pending.attempts < config_.max_write_attempts) {
+                retries.push_back(std::move(pending));
+                continue;
+            }
+            results_failed_.fetch_add(1, std::memory_order_relaxed);
+            if (logger_) {
+                logger_->error(fmt::format(
+                    "Giving up on fraud detection result for transaction {} after {} attempts",
+                    pending.result.transaction_id, pending.attempts));
+            }
+        }
+        settled -= retries.size();
+        results_retried_.fetch_add(retries.size(), std::memory_order_relaxed);
+
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex_);
+            written_sequence_ += settled;
+            for (auto& pending : retries) {
+                queue_.push_back(std::move(pending)); // already admitted, so not bounded by capacity
+            }
+            if (!retries.empty()) {
+                // Back off before retrying so an unavailable database is not hammered
+                queue_cv_.wait_for(lock, config_.flush_interval, [this]() { return stopping_; });
+            }
+        }
+        drained_cv_.notify_all();
+    }
+
+    drained_cv_.notify_all();
+}
+
+bool FraudResultWriter::write_rows(const std::vector<const FraudDetectionResult*>& rows) {
+    if (!db_conn_ || rows.empty()) {
+        return false;
+    }
+
+    try {
+        std::vector<std::string> params;
+        params.reserve(rows.size() * kParamsPerRow);
+        for (const auto* result : rows) {
+            append_params(*result, params);
+        }
+
+        if (db_conn_->execute_command(build_insert_statement(rows.size()), params)) {
+            results_written_.fetch_add(rows.size(), std::memory_order_relaxed);
+            batches_written_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    } catch (const std::exception& e) {
+        if (logger_) {
+            logger_->error(fmt::format("Insert of {} fraud detection results failed: {}",
+                                       rows.size(), e.what()));
+        }
+    }
+    return false;
+}
+
+std::vector<size_t> FraudResultWriter::write_batch(const std::vector<const FraudDetectionResult*>& batch) {
+    if (write_rows(batch)) {
+        return {};
+    }
+    if (batch.size() == 1) {
+        return {0};
+    }
+
+    // Isolate the offending rows so one bad result does not lose the whole batch
+    std::vector<size_t> failed;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (!write_rows({batch[i]})) {
+            failed.push_back(i);
+        }
+    }
+    if (logger_ && !failed.empty()) {
+        logger_->warn(fmt::format("{} of {} fraud detection results failed to insert", failed.size(), batch.size()));
+    }
+    return failed;
+}
+
+void FraudResultWriter::append_params(const FraudDetectionResult& result, std::vector<std::string>& params) {
+    nlohmann::json rule_results_json = nlohmann::json::array();
+    for (const auto& detail : result.rule_results) {
+        rule_results_json.push_back(serialize_rule_result(detail));
+    }
+
+    params.push_back(result.transaction_id);
+    params.push_back(result.is_fraudulent ? "true" : "false");
+    params.push_back(std::to_string(static_cast<int>(result.overall_risk)));
+    params.push_back(std::to_string(result.fraud_score));
+    params.push_back(rule_results_json.dump());
+    params.push_back(result.aggregated_findings.dump());
+    params.push_back(std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+        result.detection_time.time_since_epoch()).count()));
+    params.push_back(result.processing_duration);
+    params.push_back(result.recommendation);
+}
+
+nlohmann::json FraudResultWriter::get_stats() const {
+    size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queued = queue_.size();
+    }
+
+    std::string mode_name = "write_behind";
+    if (config_.mode == ResultDurabilityMode::SYNCHRONOUS) {
+        mode_name = "synchronous";
+    } else if (config_.mode == ResultDurabilityMode::BEST_EFFORT) {
+        mode_name = "best_effort";
+    }
+
+    return {
+        {"mode", mode_name},
+        {"queued", queued},
+        {"queue_capacity", config_.queue_capacity},
+        {"flush_batch_size", config_.flush_batch_size},
+        {"flush_interval_ms", config_.flush_interval.count()},
+        {"results_written", results_written_.load()},
+        {"results_failed", results_failed_.load()},
+        {"results_retried", results_retried_.load()},
+        {"max_write_attempts", config_.max_write_attempts},
+        {"results_dropped", results_dropped_.load()},
+        {"batches_written", batches_written_.load()}
+    };
+}
+
+ResultDurabilityMode FraudResultWriter::parse_mode(const std::string& mode) {
+    if (mode == "synchronous" || mode == "SYNCHRONOUS") {
+        return ResultDurabilityMode::SYNCHRONOUS;
+    }
+    if (mode == "best_effort" || mode == "BEST_EFFORT") {
+        return ResultDurabilityMode::BEST_EFFORT;
+    }
+    return ResultDurabilityMode::WRITE_BEHIND;
+}
+
+} // namespace regulens
@@ -0,0 +1,107 @@
+/**
+ * Fraud Result Writer
+ * Write-behind persistence of fraud detection results
+ *
+ * evaluate_transaction hands finished results to the writer, which
+ * serializes them and inserts them into fraud_detection_results in
+ * multi-row batches on a background thread, so database round trips no
+ * longer land on scoring latency.
+ */
+
+#ifndef FRAUD_RESULT_WRITER_HPP
+#define FRAUD_RESULT_WRITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "advanced_rule_engine.hpp"
+
+namespace regulens {
+
+enum class ResultDurabilityMode {
+    SYNCHRONOUS,   // Insert inline before evaluate_transaction returns
+    WRITE_BEHIND,  // Queue and batch; block callers when the queue is full
+    BEST_EFFORT    // Queue and batch; drop new results when the queue is full
+};
+
+struct FraudResultWriterConfig {
+    ResultDurabilityMode mode = ResultDurabilityMode::WRITE_BEHIND;
+    size_t flush_batch_size = 200;
+    std::chrono::milliseconds flush_interval = std::chrono::milliseconds(250);
+    size_t queue_capacity = 10000;
+    size_t max_write_attempts = 3; // rows still failing after this many attempts are counted as failed
+};
+
+class FraudResultWriter {
+public:
+    FraudResultWriter(
+        std::shared_ptr<PostgreSQLConnection> db_conn,
+        std::shared_ptr<StructuredLogger> logger,
+        FraudResultWriterConfig config = {}
+    );
+
+    ~FraudResultWriter(); // Drains the queue before returning
+
+    FraudResultWriter(const FraudResultWriter&) = delete;
+    FraudResultWriter& operator=(const FraudResultWriter&) = delete;
+
+    /**
+     * @brief Persist a result according to the configured durability mode
+     * @return false if the result was dropped or (in SYNCHRONOUS mode) failed to insert
+     */
+    bool submit(const FraudDetectionResult& result);
+
+    /**
+     * @brief Block until every result queued so far has been written
+     */
+    void flush();
+
+    ResultDurabilityMode mode() const { return config_.mode; }
+    nlohmann::json get_stats() const;
+
+    static ResultDurabilityMode parse_mode(const std::string& mode);
+
+private:
+    std::shared_ptr<PostgreSQLConnection> db_conn_;
+    std::shared_ptr<StructuredLogger> logger_;
+    FraudResultWriterConfig config_;
+
+    struct PendingResult {
+        FraudDetectionResult result;
+        size_t attempts = 0;
+    };
+
+    std::deque<PendingResult> queue_;
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;     // wakes the writer thread
+    std::condition_variable space_cv_;     // wakes producers blocked on a full queue
+    std::condition_variable drained_cv_;   // wakes flush() callers
+    bool stopping_ = false;
+    uint64_t enqueued_sequence_ = 0;
+    uint64_t written_sequence_ = 0;
+
+    std::atomic<uint64_t> results_written_{0};
+    std::atomic<uint64_t> results_failed_{0};
+    std::atomic<uint64_t> results_retried_{0};
+    std::atomic<uint64_t> results_dropped_{0};
+    std::atomic<uint64_t> batches_written_{0};
+
+    std::thread writer_thread_;
+
+    void writer_loop();
+    // Returns the indices of rows that still failed after single-row isolation
+    std::vector<size_t> write_batch(const std::vector<const FraudDetectionResult*>& batch);
+    bool write_rows(const std::vector<const FraudDetectionResult*>& rows);
+    static void append_params(const FraudDetectionResult& result, std::vector<std::string>& params);
+};
+
+} // namespace regulens
+
+#endif // FRAUD_RESULT_WRITER_HPP
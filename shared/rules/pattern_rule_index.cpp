@@ -0,0 +1,382 @@
+/**
+ * Pattern Rule Index Implementation
+ * Multi-pattern matcher over all active PATTERN rules
+ */
+
+#include "pattern_rule_index.hpp"
+#include <algorithm>
+#include <cctype>
+#include <deque>
+
+namespace regulens {
+
+std::shared_ptr<const PatternRuleIndex> PatternRuleIndex::build(
+    const std::vector<std::shared_ptr<const CompiledRuleProgram>>& programs
+) {
+    auto index = std::make_shared<PatternRuleIndex>();
+
+    for (const auto& program : programs) {
+        if (!program || program->rule_type() != "PATTERN" || !program->is_valid()) {
+            continue;
+        }
+
+        index->programs_.push_back(program);
+        index->indexed_programs_.insert(program.get());
+
+        const auto& patterns = program->patterns();
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            const auto& pattern = patterns[i];
+            if (pattern.type != PatternType::REGEX || !pattern.regex) {
+                continue;
+            }
+
+            auto [it, inserted] = index->groups_.try_emplace(pattern.field.str());
+            auto& group = it->second;
+            if (inserted) {
+                group.field = pattern.field;
+            }
+
+            Entry entry{program.get(), i, pattern.regex.get(), -1};
+            std::string literal = required_literal(pattern.regex_source);
+            if (!literal.empty()) {
+                auto existing = std::find(group.literals.begin(), group.literals.end(), literal);
+                entry.literal = static_cast<int32_t>(existing - group.literals.begin());
+                if (existing == group.literals.end()) {
+                    group.literals.push_back(std::move(literal));
+                }
+            }
+            group.entries.push_back(entry);
+            index->pattern_count_++;
+        }
+    }
+
+    for (auto& [field, group] : index->groups_) {
+        if (!group.literals.empty()) {
+            group.automaton.build(group.literals);
+        }
+    }
+
+    return index;
+}
+
+PatternScanResult PatternRuleIndex::scan(const nlohmann::json& data) const {
+    PatternScanResult result;
+    result.indexed_programs_ = &indexed_programs_;
+    std::vector<char> found;
+
+    for (const auto& [field, group] : groups_) {
+        const nlohmann::json* field_value = group.field.resolve(data);
+        if (!field_value || !field_value->is_string()) {
+            continue;
+        }
+        const auto& value = field_value->get_ref<const std::string&>();
+
+        // One pass finds every required literal; a pattern whose literal is absent cannot match
+        found.assign(group.literals.size(), 0);
+        if (!group.automaton.empty()) {
+            group.automaton.scan(value, found);
+        }
+
+        for (const auto& entry : group.entries) {
+            if (entry.literal >= 0 && !found[static_cast<size_t>(entry.literal)]) {
+                continue;
+            }
+            if (std::regex_match(value, *entry.regex)) {
+                result.matches_[entry.program].insert(entry.pattern_index);
+            }
+        }
+    }
+
+    return result;
+}
+
+namespace {
+
+// Index just past the ']' closing the class opened at source[open]
+size_t skip_class(const std::string& source, size_t open) {
+    size_t i = open + 1;
+    if (i < source.size() && source[i] == '^') {
+        ++i;
+    }
+    if (i < source.size() && source[i] == ']') {
+        ++i;  // a leading ']' is literal
+    }
+    while (i < source.size() && source[i] != ']') {
+        i += source[i] == '\\' ? 2 : 1;
+    }
+    return std::min(source.size(), i + 1);
+}
+
+// Index just past the ')' closing the group opened at source[open]
+size_t skip_group(const std::string& source, size_t open) {
+    int depth = 0;
+    size_t i = open;
+    while (i < source.size()) {
+        char c = source[i];
+        if (c == '\\') {
+            i += 2;
+            continue;
+        }
+        if (c == '[') {
+            i = skip_class(source, i);
+            continue;
+        }
+        if (c == '(') {
+            depth++;
+        } else if (c == ')' && --depth == 0) {
+            return i + 1;
+        }
+        ++i;
+    }
+    return source.size();
+}
+
+int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Value of the count hex digits at source[at], or -1 if they are not all there
+int hex_value(const std::string& source, size_t at, size_t count) {
+    if (at + count > source.size()) {
+        return -1;
+    }
+    int value = 0;
+    for (size_t i = at; i < at + count; ++i) {
+        int digit = hex_digit(source[i]);
+        if (digit < 0) {
+            return -1;
+        }
+        value = value * 16 + digit;
+    }
+    return value;
+}
+
+// Decode the escape starting at source[i] == '\\'; end receives the index just past it.
+// True when the escape always matches the one byte stored in literal; false for
+// classes, assertions, back-references and anything else that is not a known byte.
+bool decode_escape(const std::string& source, size_t i, char& literal, size_t& end) {
+    char escaped = source[i + 1];
+    end = i + 2;
+
+    if (!std::isalnum(static_cast<unsigned char>(escaped))) {
+        literal = escaped;
+        return true;
+    }
+
+    switch (escaped) {
+        case 'n': literal = '\n'; return true;
+        case 't': literal = '\t'; return true;
+        case 'r': literal = '\r'; return true;
+        case 'f': literal = '\f'; return true;
+        case 'v': literal = '\v'; return true;
+        case 'x': {
+            int value = hex_value(source, i + 2, 2);
+            if (value < 0) {
+                return false;
+            }
+            end = i + 4;
+            literal = static_cast<char>(value);
+            return true;
+        }
+        case 'u': {
+            int value = hex_value(source, i + 2, 4);
+            if (value < 0) {
+                return false;
+            }
+            end = i + 6;
+            // Above ASCII the matched bytes depend on the regex's character encoding
+            literal = static_cast<char>(value);
+            return value < 0x80;
+        }
+        case 'c':
+            // A control escape; libstdc++ matches the letter itself rather than
+            // the control character, so neither is safe to require
+            if (i + 2 < source.size() && std::isalpha(static_cast<unsigned char>(source[i + 2]))) {
+                end = i + 3;
+            }
+            return false;
+        case 'k':
+            if (i + 2 < source.size() && source[i + 2] == '<') {
+                size_t close = source.find('>', i + 3);
+                end = close == std::string::npos ? source.size() : close + 1;
+            }
+            return false;
+        default:
+            // Back-reference digits all belong to the escape
+            if (escaped >= '1' && escaped <= '9') {
+                while (end < source.size() && std::isdigit(static_cast<unsigned char>(source[end]))) {
+                    end++;
+                }
+            }
+            return false;
+    }
+}
+
+bool has_top_level_alternation(const std::string& source) {
+    for (size_t i = 0; i < source.size();) {
+        char c = source[i];
+        if (c == '\\') {
+            i += 2;
+        } else if (c == '[') {
+            i = skip_class(source, i);
+        } else if (c == '(') {
+            i = skip_group(source, i);
+        } else if (c == '|') {
+            return true;
+        } else {
+            ++i;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+std::string PatternRuleIndex::required_literal(const std::string& regex_source) {
+    if (has_top_level_alternation(regex_source)) {
+        return {};
+    }
+
+    // Walk the top-level sequence; runs of plain characters are literals every
+    // match contains. Groups, classes, wildcards and optional atoms end a run.
+    std::string best;
+    std::string run;
+    auto end_run = [&]() {
+        if (run.size() > best.size()) {
+            best = run;
+        }
+        run.clear();
+    };
+
+    const std::string& source = regex_source;
+    size_t i = 0;
+    while (i < source.size()) {
+        char c = source[i];
+        bool is_literal = false;
+        char literal = 0;
+        size_t next = i + 1;
+
+        if (c == '\\') {
+            if (i + 1 >= source.size()) {
+                break;
+            }
+            is_literal = decode_escape(source, i, literal, next);
+        } else if (c == '[') {
+            next = skip_class(source, i);
+        } else if (c == '(') {
+            next = skip_group(source, i);
+        } else if (c != '.' && c != '^' && c != '$' && c != '*' && c != '+' && c != '?' && c != '{') {
+            is_literal = true;
+            literal = c;
+        }
+
+        // Quantifier applying to the atom
+        size_t min_repeat = 1;
+        bool quantified = false;
+        if (next < source.size()) {
+            char q = source[next];
+            if (q == '*' || q == '?') {
+                min_repeat = 0;
+                quantified = true;
+                next++;
+            } else if (q == '+') {
+                quantified = true;
+                next++;
+            } else if (q == '{') {
+                size_t close = source.find('}', next);
+                if (close != std::string::npos) {
+                    min_repeat = 0;
+                    for (size_t d = next + 1; d < close && std::isdigit(static_cast<unsigned char>(source[d])); ++d) {
+                        min_repeat = min_repeat * 10 + static_cast<size_t>(source[d] - '0');
+                    }
+                    quantified = true;
+                    next = close + 1;
+                }
+            }
+            if (quantified && next < source.size() && source[next] == '?') {
+                next++;  // lazy
+            }
+        }
+
+        if (is_literal && !quantified) {
+            run += literal;
+        } else if (is_literal && min_repeat >= 1) {
+            // Present at least once, but the repetition breaks contiguity with what follows
+            run += literal;
+            end_run();
+        } else {
+            end_run();
+        }
+        i = next;
+    }
+    end_run();
+
+    return best;
+}
+
+// LiteralAutomaton
+
+void PatternRuleIndex::LiteralAutomaton::build(const std::vector<std::string>& literals) {
+    std::array<int32_t, 256> empty_row;
+    empty_row.fill(-1);
+    transitions_.assign(1, empty_row);
+    outputs_.assign(1, {});
+
+    // Trie of all literals
+    for (size_t i = 0; i < literals.size(); ++i) {
+        size_t state = 0;
+        for (unsigned char c : literals[i]) {
+            if (transitions_[state][c] < 0) {
+                transitions_[state][c] = static_cast<int32_t>(transitions_.size());
+                transitions_.push_back(empty_row);
+                outputs_.emplace_back();
+            }
+            state = static_cast<size_t>(transitions_[state][c]);
+        }
+        outputs_[state].push_back(static_cast<uint32_t>(i));
+    }
+
+    // Breadth-first failure links, folded into a complete transition table
+    std::vector<int32_t> failure(transitions_.size(), 0);
+    std::deque<int32_t> queue;
+    for (int c = 0; c < 256; ++c) {
+        int32_t next = transitions_[0][static_cast<size_t>(c)];
+        if (next < 0) {
+            transitions_[0][static_cast<size_t>(c)] = 0;
+        } else {
+            queue.push_back(next);
+        }
+    }
+    while (!queue.empty()) {
+        auto state = static_cast<size_t>(queue.front());
+        queue.pop_front();
+        auto fallback = static_cast<size_t>(failure[state]);
+        for (size_t c = 0; c < 256; ++c) {
+            int32_t next = transitions_[state][c];
+            if (next < 0) {
+                transitions_[state][c] = transitions_[fallback][c];
+                continue;
+            }
+            failure[static_cast<size_t>(next)] = transitions_[fallback][c];
+            const auto& inherited = outputs_[static_cast<size_t>(transitions_[fallback][c])];
+            auto& outputs = outputs_[static_cast<size_t>(next)];
+            outputs.insert(outputs.end(), inherited.begin(), inherited.end());
+            queue.push_back(next);
+        }
+    }
+}
+
+void PatternRuleIndex::LiteralAutomaton::scan(std::string_view text, std::vector<char>& found) const {
+    size_t state = 0;
+    for (unsigned char c : text) {
+        state = static_cast<size_t>(transitions_[state][c]);
+        for (uint32_t literal : outputs_[state]) {
+            found[literal] = 1;
+        }
+    }
+}
+
+} // namespace regulens
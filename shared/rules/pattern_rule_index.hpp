@@ -0,0 +1,117 @@
+/**
+ * Pattern Rule Index
+ * Multi-pattern matcher over all active PATTERN rules
+ *
+ * Regex patterns of every active PATTERN rule are grouped by the field they
+ * inspect. For each pattern the longest literal every match must contain is
+ * extracted from its source, and a field's literals are compiled into one
+ * Aho-Corasick automaton. Each field is resolved once per transaction and
+ * scanned once by that automaton; a regex only runs when its literal is
+ * present (or when it has none). Most transactions match no pattern at all,
+ * so the common case is a single linear byte scan per field.
+ */
+
+#ifndef PATTERN_RULE_INDEX_HPP
+#define PATTERN_RULE_INDEX_HPP
+
+#include <memory>
+#include <array>
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "compiled_rule_program.hpp"
+
+namespace regulens {
+
+/**
+ * @brief Regex matches of one transaction against a PatternRuleIndex
+ */
+class PatternScanResult {
+public:
+    bool covers(const CompiledRuleProgram* program) const {
+        return indexed_programs_ && indexed_programs_->count(program) > 0;
+    }
+
+    bool matched(const CompiledRuleProgram* program, size_t pattern_index) const {
+        auto it = matches_.find(program);
+        return it != matches_.end() && it->second.count(pattern_index) > 0;
+    }
+
+private:
+    friend class PatternRuleIndex;
+
+    const std::unordered_set<const CompiledRuleProgram*>* indexed_programs_ = nullptr;
+    std::unordered_map<const CompiledRuleProgram*, std::unordered_set<size_t>> matches_;
+};
+
+/**
+ * @brief Immutable index of regex patterns for a set of compiled PATTERN rules
+ *
+ * Built whenever the active rule set changes; safe to scan concurrently.
+ */
+class PatternRuleIndex {
+public:
+    static std::shared_ptr<const PatternRuleIndex> build(
+        const std::vector<std::shared_ptr<const CompiledRuleProgram>>& programs
+    );
+
+    /**
+     * @brief Match all indexed regex patterns against a transaction
+     * @note The result references this index and must not outlive it
+     */
+    PatternScanResult scan(const nlohmann::json& data) const;
+
+    size_t pattern_count() const { return pattern_count_; }
+    size_t field_count() const { return groups_.size(); }
+
+    /**
+     * @brief Longest literal that every match of an ECMAScript regex must contain
+     * @return Empty when no such literal can be proven (alternation, classes only, ...)
+     */
+    static std::string required_literal(const std::string& regex_source);
+
+private:
+    /**
+     * @brief Aho-Corasick automaton reporting which of a set of literals occur in a string
+     */
+    class LiteralAutomaton {
+    public:
+        void build(const std::vector<std::string>& literals);
+        bool empty() const { return transitions_.empty(); }
+        // found[i] is set when literal i occurs in text; found must have one slot per literal
+        void scan(std::string_view text, std::vector<char>& found) const;
+
+    private:
+        std::vector<std::array<int32_t, 256>> transitions_;  // complete DFA after build
+        std::vector<std::vector<uint32_t>> outputs_;         // literals ending at each state
+    };
+
+    struct Entry {
+        const CompiledRuleProgram* program;
+        size_t pattern_index;
+        const std::regex* regex;
+        int32_t literal;  // index into FieldGroup::literals, -1 when the pattern has none
+    };
+
+    struct FieldGroup {
+        FieldPath field;
+        std::vector<Entry> entries;
+        std::vector<std::string> literals;
+        LiteralAutomaton automaton;
+    };
+
+    // Keeps the programs (and therefore their regexes) alive for the index lifetime
+    std::vector<std::shared_ptr<const CompiledRuleProgram>> programs_;
+    std::unordered_set<const CompiledRuleProgram*> indexed_programs_;
+    std::unordered_map<std::string, FieldGroup> groups_;
+    size_t pattern_count_ = 0;
+};
+
+} // namespace regulens
+
+#endif // PATTERN_RULE_INDEX_HPP
@@ -0,0 +1,102 @@
+/**
+ * Rule Execution Pool Implementation
+ * Fixed-size work-stealing thread pool for parallel rule evaluation
+ */
+
+#include "rule_execution_pool.hpp"
+
+namespace regulens {
+
+RuleExecutionPool::RuleExecutionPool(size_t num_workers) {
+    if (num_workers == 0) {
+        num_workers = 1;
+    }
+
+    queues_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    workers_.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers_.emplace_back(&RuleExecutionPool::worker_loop, this, i);
+    }
+}
+
+RuleExecutionPool::~RuleExecutionPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_cv_.notify_all();
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void RuleExecutionPool::submit(std::function<void()> task) {
+    size_t index = next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Publish under wake_mutex_ so a worker about to sleep cannot miss it
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        pending_tasks_.fetch_add(1, std::memory_order_release);
+    }
+    wake_cv_.notify_one();
+}
+
+bool RuleExecutionPool::try_pop(size_t index, std::function<void()>& task) {
+    // Own queue first (FIFO keeps priority order), then steal from the back of others
+    {
+        auto& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        auto& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RuleExecutionPool::worker_loop(size_t index) {
+    while (true) {
+        std::function<void()> task;
+        if (try_pop(index, task)) {
+            pending_tasks_.fetch_sub(1, std::memory_order_acq_rel);
+            try {
+                task();
+            } catch (...) {
+                // Tasks report their own failures; never let one take down a worker
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cv_.wait(lock, [this]() {
+            return stopping_ || pending_tasks_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_ && pending_tasks_.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+    }
+}
+
+} // namespace regulens
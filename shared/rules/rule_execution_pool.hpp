@@ -0,0 +1,57 @@
+/**
+ * Rule Execution Pool
+ * Fixed-size work-stealing thread pool for parallel rule evaluation
+ *
+ * Each worker owns a deque; submissions are distributed round-robin and an
+ * idle worker steals from the back of its siblings' deques, so one slow rule
+ * (e.g. an LLM-backed MACHINE_LEARNING rule) does not hold up the rules
+ * queued behind it on the same worker.
+ */
+
+#ifndef RULE_EXECUTION_POOL_HPP
+#define RULE_EXECUTION_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace regulens {
+
+class RuleExecutionPool {
+public:
+    explicit RuleExecutionPool(size_t num_workers);
+    ~RuleExecutionPool();
+
+    RuleExecutionPool(const RuleExecutionPool&) = delete;
+    RuleExecutionPool& operator=(const RuleExecutionPool&) = delete;
+
+    void submit(std::function<void()> task);
+    size_t size() const { return workers_.size(); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<size_t> pending_tasks_{0};
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    bool stopping_ = false;
+
+    void worker_loop(size_t index);
+    bool try_pop(size_t index, std::function<void()>& task);
+};
+
+} // namespace regulens
+
+#endif // RULE_EXECUTION_POOL_HPP
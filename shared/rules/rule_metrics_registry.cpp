@@ -0,0 +1,178 @@
+/**
+ * Rule Metrics Registry Implementation
+ * Lock-free per-rule performance counters for AdvancedRuleEngine
+ */
+
+#include "rule_metrics_registry.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <mutex>
+
+namespace regulens {
+
+int LatencyBuckets::index_for(uint64_t micros) {
+    if (micros < static_cast<uint64_t>(kLinearBuckets)) {
+        return static_cast<int>(micros);
+    }
+
+    int exponent = 63 - std::countl_zero(micros);
+    if (exponent > kMaxExponent) {
+        return kBucketCount - 1;
+    }
+
+    int sub_bucket = static_cast<int>((micros >> (exponent - kSubBucketBits)) & (kSubBuckets - 1));
+    return kLinearBuckets + (exponent - 4) * kSubBuckets + sub_bucket;
+}
+
+uint64_t LatencyBuckets::upper_bound(int index) {
+    if (index < kLinearBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+
+    int exponent = (index - kLinearBuckets) / kSubBuckets + 4;
+    uint64_t sub_bucket = static_cast<uint64_t>((index - kLinearBuckets) % kSubBuckets);
+    return ((static_cast<uint64_t>(kSubBuckets) + sub_bucket + 1) << (exponent - kSubBucketBits)) - 1;
+}
+
+double RuleMetricsSnapshot::percentile_us(double percentile) const {
+    uint64_t samples = 0;
+    for (auto count : latency_histogram) {
+        samples += count;
+    }
+    if (samples == 0) {
+        return 0.0;
+    }
+
+    auto rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(samples)));
+    rank = std::clamp<uint64_t>(rank, 1, samples);
+
+    uint64_t cumulative = 0;
+    for (int i = 0; i < LatencyBuckets::kBucketCount; ++i) {
+        cumulative += latency_histogram[static_cast<size_t>(i)];
+        if (cumulative >= rank) {
+            return static_cast<double>(std::min(LatencyBuckets::upper_bound(i), max_execution_time_us));
+        }
+    }
+    return static_cast<double>(max_execution_time_us);
+}
+
+size_t RuleMetricsCounters::shard_index() {
+    static std::atomic<size_t> next_thread_index{0};
+    thread_local size_t index = next_thread_index.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    return index;
+}
+
+void RuleMetricsCounters::record(int result_kind,
+                                 std::chrono::microseconds execution_time,
+                                 double confidence_score) {
+    auto& shard = shards_[shard_index()];
+    const auto micros = static_cast<uint64_t>(std::max<int64_t>(0, execution_time.count()));
+
+    if (result_kind >= 0 && result_kind < static_cast<int>(shard.results.size())) {
+        shard.results[static_cast<size_t>(result_kind)].fetch_add(1, std::memory_order_relaxed);
+    }
+    shard.total_execution_time_us.fetch_add(micros, std::memory_order_relaxed);
+    shard.confidence_micros.fetch_add(
+        static_cast<uint64_t>(std::llround(std::clamp(confidence_score, 0.0, 1.0) * 1e6)),
+        std::memory_order_relaxed);
+    shard.latency[static_cast<size_t>(LatencyBuckets::index_for(micros))].fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current_max = shard.max_execution_time_us.load(std::memory_order_relaxed);
+    while (micros > current_max &&
+           !shard.max_execution_time_us.compare_exchange_weak(current_max, micros, std::memory_order_relaxed)) {
+    }
+
+    shard.last_execution_us.store(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count(),
+        std::memory_order_relaxed);
+}
+
+RuleMetricsSnapshot RuleMetricsCounters::snapshot() const {
+    RuleMetricsSnapshot merged;
+    uint64_t confidence_micros = 0;
+
+    for (const auto& shard : shards_) {
+        merged.passes += shard.results[kPass].load(std::memory_order_relaxed);
+        merged.failures += shard.results[kFail].load(std::memory_order_relaxed);
+        merged.errors += shard.results[kError].load(std::memory_order_relaxed);
+        merged.timeouts += shard.results[kTimeout].load(std::memory_order_relaxed);
+        merged.skipped += shard.results[kSkipped].load(std::memory_order_relaxed);
+        merged.total_execution_time_us += shard.total_execution_time_us.load(std::memory_order_relaxed);
+        merged.max_execution_time_us = std::max(merged.max_execution_time_us,
+                                                shard.max_execution_time_us.load(std::memory_order_relaxed));
+        merged.last_execution_us = std::max(merged.last_execution_us,
+                                            shard.last_execution_us.load(std::memory_order_relaxed));
+        confidence_micros += shard.confidence_micros.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < merged.latency_histogram.size(); ++i) {
+            merged.latency_histogram[i] += shard.latency[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    merged.total_executions = merged.passes + merged.failures + merged.errors + merged.timeouts + merged.skipped;
+    merged.total_confidence = static_cast<double>(confidence_micros) / 1e6;
+    return merged;
+}
+
+void RuleMetricsCounters::reset() {
+    for (auto& shard : shards_) {
+        for (auto& counter : shard.results) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+        shard.total_execution_time_us.store(0, std::memory_order_relaxed);
+        shard.max_execution_time_us.store(0, std::memory_order_relaxed);
+        shard.confidence_micros.store(0, std::memory_order_relaxed);
+        shard.last_execution_us.store(0, std::memory_order_relaxed);
+        for (auto& bucket : shard.latency) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::shared_ptr<RuleMetricsCounters> RuleMetricsRegistry::counters_for(const std::string& rule_id) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        auto it = counters_.find(rule_id);
+        if (it != counters_.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& counters = counters_[rule_id];
+    if (!counters) {
+        counters = std::make_shared<RuleMetricsCounters>();
+    }
+    return counters;
+}
+
+std::shared_ptr<RuleMetricsCounters> RuleMetricsRegistry::find(const std::string& rule_id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = counters_.find(rule_id);
+    return it != counters_.end() ? it->second : nullptr;
+}
+
+std::vector<std::pair<std::string, std::shared_ptr<RuleMetricsCounters>>> RuleMetricsRegistry::all() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return {counters_.begin(), counters_.end()};
+}
+
+void RuleMetricsRegistry::reset(const std::string& rule_id) {
+    // Counters are zeroed in place so handles cached on rules stay valid
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (rule_id.empty()) {
+        for (auto& [id, counters] : counters_) {
+            counters->reset();
+        }
+        return;
+    }
+
+    auto it = counters_.find(rule_id);
+    if (it != counters_.end()) {
+        it->second->reset();
+    }
+}
+
+} // namespace regulens
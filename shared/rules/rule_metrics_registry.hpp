@@ -0,0 +1,116 @@
+/**
+ * Rule Metrics Registry
+ * Lock-free per-rule performance counters for AdvancedRuleEngine
+ *
+ * Every rule owns a small set of cache-line aligned shards of relaxed atomic
+ * counters plus a log-linear (HDR-style) latency histogram. Evaluation
+ * threads write to the shard picked by their thread index and never take a
+ * lock; shards are merged only when metrics are read.
+ */
+
+#ifndef RULE_METRICS_REGISTRY_HPP
+#define RULE_METRICS_REGISTRY_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace regulens {
+
+/**
+ * @brief Log-linear latency bucketing in microseconds
+ *
+ * Values below 16us get exact buckets; above that every power of two is
+ * split into 8 sub-buckets, giving ~12.5% worst-case relative error up to
+ * roughly 70 minutes.
+ */
+struct LatencyBuckets {
+    static constexpr int kLinearBuckets = 16;
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 32;
+    static constexpr int kBucketCount = kLinearBuckets + (kMaxExponent - 4 + 1) * kSubBuckets;
+
+    static int index_for(uint64_t micros);
+    static uint64_t upper_bound(int index);
+};
+
+/**
+ * @brief Merged view of a rule's counters at read time
+ */
+struct RuleMetricsSnapshot {
+    uint64_t total_executions = 0;
+    uint64_t passes = 0;
+    uint64_t failures = 0;
+    uint64_t errors = 0;
+    uint64_t timeouts = 0;
+    uint64_t skipped = 0;
+    uint64_t total_execution_time_us = 0;
+    uint64_t max_execution_time_us = 0;
+    double total_confidence = 0.0;
+    int64_t last_execution_us = 0; // system_clock microseconds since epoch
+    std::array<uint64_t, LatencyBuckets::kBucketCount> latency_histogram{};
+
+    double percentile_us(double percentile) const;
+};
+
+/**
+ * @brief Sharded atomic counters for one rule
+ */
+class RuleMetricsCounters {
+public:
+    static constexpr size_t kShardCount = 8;
+
+    void record(int result_kind, std::chrono::microseconds execution_time, double confidence_score);
+    RuleMetricsSnapshot snapshot() const;
+    void reset();
+
+    // Result kinds, matching RuleExecutionResult ordering
+    static constexpr int kPass = 0;
+    static constexpr int kFail = 1;
+    static constexpr int kError = 2;
+    static constexpr int kTimeout = 3;
+    static constexpr int kSkipped = 4;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, 5> results{};
+        std::atomic<uint64_t> total_execution_time_us{0};
+        std::atomic<uint64_t> max_execution_time_us{0};
+        std::atomic<uint64_t> confidence_micros{0}; // confidence * 1e6, fixed point
+        std::atomic<int64_t> last_execution_us{0};
+        std::array<std::atomic<uint64_t>, LatencyBuckets::kBucketCount> latency{};
+    };
+
+    std::array<Shard, kShardCount> shards_;
+
+    static size_t shard_index();
+};
+
+/**
+ * @brief Registry mapping rule ids to their counters
+ *
+ * Lookups take a shared lock only; the engine additionally caches the
+ * counters handle on cached rules so the hot path skips the map entirely.
+ */
+class RuleMetricsRegistry {
+public:
+    std::shared_ptr<RuleMetricsCounters> counters_for(const std::string& rule_id);
+    std::shared_ptr<RuleMetricsCounters> find(const std::string& rule_id) const;
+    std::vector<std::pair<std::string, std::shared_ptr<RuleMetricsCounters>>> all() const;
+    void reset(const std::string& rule_id = "");
+
+private:
+    mutable std::shared_mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<RuleMetricsCounters>> counters_;
+};
+
+} // namespace regulens
+
+#endif // RULE_METRICS_REGISTRY_HPP
@@ -163,27 +163,37 @@ std::optional<std::string> AccessControlService::resolve_internal_user_id(const
     return std::nullopt;
 }
 
-std::optional<AccessControlService::UserContext> AccessControlService::get_user_context(const std::string& user_id) const {
+AccessControlService::PrincipalCache& AccessControlService::principal_cache() {
+    static PrincipalCache cache;
+    return cache;
+}
+
+std::shared_ptr<const AccessControlService::UserContext> AccessControlService::get_user_context(const std::string& user_id) const {
     if (user_id.empty()) {
-        return std::nullopt;
+        return nullptr;
     }
 
+    auto& cache = principal_cache();
     const auto now = std::chrono::steady_clock::now();
     {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
-        auto it = user_cache_.find(user_id);
-        if (it != user_cache_.end() && it->second.expiry > now) {
+        std::shared_lock<std::shared_mutex> lock(cache.mutex);
+        auto it = cache.contexts.find(user_id);
+        if (it != cache.contexts.end() && it->second->expiry > now) {
             return it->second;
         }
     }
 
-    auto context = load_user_context(user_id);
+    auto loaded = load_user_context(user_id);
+    std::shared_ptr<const UserContext> context;
+    if (loaded) {
+        context = std::make_shared<const UserContext>(std::move(*loaded));
+    }
     {
-        std::lock_guard<std::mutex> lock(cache_mutex_);
+        std::unique_lock<std::shared_mutex> lock(cache.mutex);
         if (context) {
-            user_cache_[user_id] = *context;
+            cache.contexts[user_id] = context;
         } else {
-            user_cache_.erase(user_id);
+            cache.contexts.erase(user_id);
         }
     }
 
@@ -500,8 +510,9 @@ bool AccessControlService::is_conversation_facilitator(const std::string& user_i
 }
 
 void AccessControlService::invalidate_user(const std::string& user_id) {
-    std::lock_guard<std::mutex> lock(cache_mutex_);
-    user_cache_.erase(user_id);
+    auto& cache = principal_cache();
+    std::unique_lock<std::shared_mutex> lock(cache.mutex);
+    cache.contexts.erase(user_id);
 }
 
 } // namespace regulens
@@ -4,6 +4,7 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -107,13 +108,24 @@ private:
         std::chrono::steady_clock::time_point expiry;
     };
 
-    std::optional<UserContext> get_user_context(const std::string& user_id) const;
+    std::shared_ptr<const UserContext> get_user_context(const std::string& user_id) const;
     std::optional<UserContext> load_user_context(const std::string& user_id) const;
     std::optional<std::string> resolve_internal_user_id(const std::string& user_id) const;
     bool table_exists(const std::string& table_name) const;
     bool has_column(const std::string& table_name, const std::string& column_name) const;
     void refresh_schema_metadata() const;
 
+    /**
+     * @brief Process-wide user contexts keyed by user id. Every handler owns its own
+     *        AccessControlService; sharing the contexts means a principal is loaded once
+     *        per TTL and every permission check reads the same immutable copy.
+     */
+    struct PrincipalCache {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<const UserContext>> contexts;
+    };
+    static PrincipalCache& principal_cache();
+
     std::optional<ConversationAccess> get_conversation_access(const std::string& conversation_id) const;
     std::optional<ConversationAccess> load_conversation_access(const std::string& conversation_id) const;
 
@@ -127,7 +139,6 @@ private:
     std::chrono::minutes cache_ttl_;
 
     mutable std::mutex cache_mutex_;
-    mutable std::unordered_map<std::string, UserContext> user_cache_;
     mutable std::unordered_map<std::string, ConversationAccess> conversation_cache_;
 
     mutable std::mutex schema_mutex_;
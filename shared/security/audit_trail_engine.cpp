@@ -6,11 +6,23 @@
 #include "audit_trail_engine.hpp"
 #include "../logging/logger.hpp"
 #include <algorithm>
+#include <cctype>
+#include <set>
 #include <uuid/uuid.h>
 
 namespace regulens {
 namespace security {
 
+namespace {
+
+bool contains_ignore_case(const std::string& haystack, const std::string& needle) {
+  auto it = std::search(haystack.begin(), haystack.end(), needle.begin(), needle.end(),
+    [](unsigned char a, unsigned char b) { return std::tolower(a) == std::tolower(b); });
+  return it != haystack.end();
+}
+
+}  // namespace
+
 AuditTrailEngine::AuditTrailEngine() {
   auto logger = logging::get_logger("audit_trail");
   logger->info("AuditTrailEngine initialized");
@@ -42,6 +54,15 @@ std::string AuditTrailEngine::record_change(const ChangeRecord& change) {
   
   changes_.push_back(rec);
   
+  // Index by time and by entity; changed_at is "now", so these are appends unless the clock stepped back
+  auto later = [&](std::chrono::system_clock::time_point t, size_t p) { return t < changes_[p].changed_at; };
+  changes_by_time_.insert(
+    std::upper_bound(changes_by_time_.begin(), changes_by_time_.end(), rec.changed_at, later),
+    changes_.size() - 1);
+  auto& positions = timelines_[{rec.entity_type, rec.entity_id}].changes;
+  positions.insert(std::upper_bound(positions.begin(), positions.end(), rec.changed_at, later),
+                   changes_.size() - 1);
+  
   logger->info("Change recorded: {} -> {} ({})", 
               rec.entity_id, rec.entity_name, static_cast<int>(rec.operation));
   
@@ -120,19 +141,20 @@ std::vector<ChangeRecord> AuditTrailEngine::get_entity_history(
   std::vector<ChangeRecord> result;
   auto cutoff_time = std::chrono::system_clock::now() - std::chrono::hours(24 * days);
   
-  for (const auto& change : changes_) {
-    if (change.entity_id != entity_id || change.entity_type != entity_type) continue;
-    if (change.changed_at < cutoff_time) continue;
-    
-    result.push_back(change);
-    if (result.size() >= limit) break;
+  auto timeline = timelines_.find({entity_type, entity_id});
+  if (timeline == timelines_.end()) {
+    return result;
   }
   
-  // Sort by timestamp descending
-  std::sort(result.begin(), result.end(),
-    [](const ChangeRecord& a, const ChangeRecord& b) {
-      return a.changed_at > b.changed_at;
-    });
+  // Newest first, back to the cutoff
+  const auto& positions = timeline->second.changes;
+  auto first = std::lower_bound(positions.begin(), positions.end(), cutoff_time,
+    [&](size_t p, std::chrono::system_clock::time_point t) { return changes_[p].changed_at < t; });
+  
+  for (auto it = positions.end(); it != first && result.size() < static_cast<size_t>(limit);) {
+    --it;
+    result.push_back(changes_[*it]);
+  }
   
   return result;
 }
@@ -199,34 +221,61 @@ bool AuditTrailEngine::create_snapshot(const EntitySnapshot& snapshot) {
   
   std::lock_guard<std::mutex> lock(audit_lock_);
   
-  auto snap = snapshot;
+  StoredSnapshot stored{snapshot, json(), 0};
+  auto& snap = stored.header;
   
   uuid_t id;
   uuid_generate(id);
   char id_str[37];
   uuid_unparse(id, id_str);
   snap.snapshot_id = id_str;
+  if (snap.created_at == std::chrono::system_clock::time_point{}) {
+    snap.created_at = std::chrono::system_clock::now();
+  }
   
-  // Find version number
-  int max_version = 0;
-  for (const auto& [sid, s] : snapshots_) {
-    if (s.entity_id == snapshot.entity_id && s.entity_type == snapshot.entity_type) {
-      max_version = std::max(max_version, s.version_number);
+  EntityKey key{snapshot.entity_type, snapshot.entity_id};
+  auto& timeline = timelines_[key];
+  size_t position = timeline.snapshots.size();
+  snap.version_number = static_cast<int>(position) + 1;
+  snap.entity_state = json();
+  
+  // Store a patch against the previous version; a full keyframe every
+  // SNAPSHOT_KEYFRAME_INTERVAL versions, or when the patch is no smaller
+  bool keyframe = position == 0 ||
+                  position - timeline.snapshots.back().keyframe >= SNAPSHOT_KEYFRAME_INTERVAL;
+  if (!keyframe) {
+    json patch = calculate_diff(timeline.latest_state, snapshot.entity_state);
+    if (patch.dump().size() < snapshot.entity_state.dump().size()) {
+      stored.state_or_patch = std::move(patch);
+      stored.keyframe = timeline.snapshots.back().keyframe;
+    } else {
+      keyframe = true;
     }
   }
-  snap.version_number = max_version + 1;
+  if (keyframe) {
+    stored.state_or_patch = snapshot.entity_state;
+    stored.keyframe = position;
+  }
+  timeline.latest_state = snapshot.entity_state;
+  
+  auto at = std::upper_bound(timeline.snapshots_by_time.begin(), timeline.snapshots_by_time.end(),
+                             snap.created_at,
+    [](std::chrono::system_clock::time_point t, const auto& entry) { return t < entry.first; });
+  timeline.snapshots_by_time.insert(at, {snap.created_at, position});
   
-  snapshots_[snap.snapshot_id] = snap;
-  logger->info("Snapshot created: {} (v{})", snap.entity_id, snap.version_number);
+  snapshot_index_[snap.snapshot_id] = {key, position};
+  logger->info("Snapshot created: {} (v{}{})", snap.entity_id, snap.version_number,
+              keyframe ? ", keyframe" : "");
+  timeline.snapshots.push_back(std::move(stored));
   return true;
 }
 
 std::optional<EntitySnapshot> AuditTrailEngine::get_snapshot(const std::string& snapshot_id) {
   std::lock_guard<std::mutex> lock(audit_lock_);
   
-  auto it = snapshots_.find(snapshot_id);
-  if (it != snapshots_.end()) {
-    return it->second;
+  auto it = snapshot_index_.find(snapshot_id);
+  if (it != snapshot_index_.end()) {
+    return materialize_snapshot(timelines_.at(it->second.entity), it->second.position);
   }
   
   return std::nullopt;
@@ -240,18 +289,25 @@ std::vector<EntitySnapshot> AuditTrailEngine::get_entity_versions(
   
   std::vector<EntitySnapshot> result;
   
-  for (const auto& [sid, snapshot] : snapshots_) {
-    if (snapshot.entity_id != entity_id || snapshot.entity_type != entity_type) continue;
-    
-    result.push_back(snapshot);
-    if (result.size() >= limit) break;
+  auto timeline = timelines_.find({entity_type, entity_id});
+  if (timeline == timelines_.end() || limit <= 0) {
+    return result;
   }
   
-  std::sort(result.begin(), result.end(),
-    [](const EntitySnapshot& a, const EntitySnapshot& b) {
-      return a.version_number > b.version_number;
-    });
+  // Newest versions, rebuilt in one forward pass from the oldest one's keyframe
+  const auto& snapshots = timeline->second.snapshots;
+  size_t first = snapshots.size() - std::min(snapshots.size(), static_cast<size_t>(limit));
+  json state;
+  for (size_t i = snapshots[first].keyframe; i < snapshots.size(); ++i) {
+    state = snapshots[i].keyframe == i ? snapshots[i].state_or_patch
+                                       : state.patch(snapshots[i].state_or_patch);
+    if (i >= first) {
+      result.push_back(snapshots[i].header);
+      result.back().entity_state = state;
+    }
+  }
   
+  std::reverse(result.begin(), result.end());
   return result;
 }
 
@@ -261,20 +317,18 @@ json AuditTrailEngine::get_entity_at_point_in_time(
     std::chrono::system_clock::time_point timestamp) {
   std::lock_guard<std::mutex> lock(audit_lock_);
   
-  // Find most recent snapshot before timestamp
-  EntitySnapshot* best_snapshot = nullptr;
-  
-  for (auto& [sid, snapshot] : snapshots_) {
-    if (snapshot.entity_id != entity_id || snapshot.entity_type != entity_type) continue;
-    if (snapshot.created_at > timestamp) continue;
-    
-    if (!best_snapshot || snapshot.created_at > best_snapshot->created_at) {
-      best_snapshot = &snapshot;
-    }
+  auto timeline = timelines_.find({entity_type, entity_id});
+  if (timeline == timelines_.end()) {
+    return json::object();
   }
   
-  if (best_snapshot) {
-    return best_snapshot->entity_state;
+  // Most recent snapshot at or before timestamp
+  const auto& by_time = timeline->second.snapshots_by_time;
+  auto after = std::upper_bound(by_time.begin(), by_time.end(), timestamp,
+    [](std::chrono::system_clock::time_point t, const auto& entry) { return t < entry.first; });
+  
+  if (after != by_time.begin()) {
+    return reconstruct_state(timeline->second, std::prev(after)->second);
   }
   
   return json::object();
@@ -519,18 +573,52 @@ AuditTrailEngine::AuditStats AuditTrailEngine::get_audit_statistics(int days) {
   return stats;
 }
 
-// Private helpers
-json AuditTrailEngine::calculate_diff(const json& old_val, const json& new_val) {
-  json diff = json::object();
+// Search & Discovery
+std::vector<ChangeRecord> AuditTrailEngine::search_changes(
+    const std::string& search_term,
+    int days) {
+  std::lock_guard<std::mutex> lock(audit_lock_);
   
-  if (old_val == new_val) {
-    return diff;
-  }
+  std::vector<ChangeRecord> result;
+  auto cutoff_time = std::chrono::system_clock::now() - std::chrono::hours(24 * days);
   
-  diff["old"] = old_val;
-  diff["new"] = new_val;
+  // The window is a suffix of the time index, newest last
+  auto first = std::lower_bound(changes_by_time_.begin(), changes_by_time_.end(), cutoff_time,
+    [&](size_t p, std::chrono::system_clock::time_point t) { return changes_[p].changed_at < t; });
+  
+  for (auto it = changes_by_time_.end(); it != first;) {
+    const auto& change = changes_[*--it];
+    if (search_term.empty() ||
+        contains_ignore_case(change.entity_id, search_term) ||
+        contains_ignore_case(change.entity_name, search_term) ||
+        contains_ignore_case(change.user_id, search_term) ||
+        contains_ignore_case(change.change_reason, search_term)) {
+      result.push_back(change);
+    }
+  }
   
-  return diff;
+  return result;
+}
+
+// Private helpers
+json AuditTrailEngine::calculate_diff(const json& old_val, const json& new_val) {
+  // RFC 6902 patch turning old_val into new_val; empty when they are equal
+  return json::diff(old_val, new_val);
+}
+
+json AuditTrailEngine::reconstruct_state(const EntityTimeline& timeline, size_t position) const {
+  const auto& snapshots = timeline.snapshots;
+  json state = snapshots[snapshots[position].keyframe].state_or_patch;
+  for (size_t i = snapshots[position].keyframe + 1; i <= position; ++i) {
+    state = state.patch(snapshots[i].state_or_patch);
+  }
+  return state;
+}
+
+EntitySnapshot AuditTrailEngine::materialize_snapshot(const EntityTimeline& timeline, size_t position) const {
+  EntitySnapshot snapshot = timeline.snapshots[position].header;
+  snapshot.entity_state = reconstruct_state(timeline, position);
+  return snapshot;
 }
 
 bool AuditTrailEngine::validate_rollback(const std::string& change_id) {
@@ -8,6 +8,8 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <mutex>
 #include <nlohmann/json.hpp>
 #include <chrono>
 #include <optional>
@@ -240,8 +242,32 @@ public:
   bool load_from_database();
 
 private:
-  std::vector<ChangeRecord> changes_;
-  std::map<std::string, EntitySnapshot> snapshots_;
+  using EntityKey = std::pair<EntityType, std::string>;
+
+  // Snapshot stored as a patch against the previous version, or in full as a keyframe
+  struct StoredSnapshot {
+    EntitySnapshot header;  // entity_state left empty
+    json state_or_patch;
+    size_t keyframe;        // position of the keyframe this version is rebuilt from
+  };
+
+  // Per-entity history, each index ordered by time so lookups are binary searches
+  struct EntityTimeline {
+    std::vector<size_t> changes;                 // positions in changes_, by changed_at
+    std::vector<StoredSnapshot> snapshots;       // by version_number
+    std::vector<std::pair<std::chrono::system_clock::time_point, size_t>> snapshots_by_time;
+    json latest_state;                           // state of the newest version, for diffing
+  };
+
+  struct SnapshotLocation {
+    EntityKey entity;
+    size_t position;
+  };
+
+  std::vector<ChangeRecord> changes_;  // append order; changed_at can go back if the clock steps
+  std::vector<size_t> changes_by_time_;  // positions in changes_, by changed_at
+  std::map<EntityKey, EntityTimeline> timelines_;
+  std::unordered_map<std::string, SnapshotLocation> snapshot_index_;
   std::vector<RollbackRequest> rollback_requests_;
   std::vector<ChangeBatch> change_batches_;
   std::vector<ComplianceEvidence> compliance_evidence_;
@@ -250,12 +276,16 @@ private:
 
   // Internal helpers
   json calculate_diff(const json& old_val, const json& new_val);
+  json reconstruct_state(const EntityTimeline& timeline, size_t position) const;
+  EntitySnapshot materialize_snapshot(const EntityTimeline& timeline, size_t position) const;
   bool validate_rollback(const std::string& change_id);
   std::vector<std::string> find_dependent_changes(const std::string& change_id);
   ImpactLevel assess_impact(
       EntityType entity_type,
       ChangeOperation operation,
       const json& changes);
+
+  static constexpr size_t SNAPSHOT_KEYFRAME_INTERVAL = 16;  // bounds patches applied per lookup
 };
 
 }  // namespace security
@@ -4,14 +4,55 @@
  */
 
 #include "data_encryption.hpp"
+#include "pii_scanner.hpp"
 #include "../logging/logger.hpp"
-#include <regex>
 #include <algorithm>
 #include <uuid/uuid.h>
 
 namespace regulens {
 namespace security {
 
+namespace {
+
+void mask_strings_in_place(json& value, const PIIScanner& scanner, uint32_t types) {
+  if (value.is_string()) {
+    value = scanner.mask(value.get_ref<const std::string&>(), types);
+  } else if (value.is_object() || value.is_array()) {
+    for (auto& element : value) {
+      mask_strings_in_place(element, scanner, types);
+    }
+  }
+}
+
+void collect_pii(const json& value, const PIIScanner& scanner, const std::string& path, json& found) {
+  if (value.is_string()) {
+    const auto& text = value.get_ref<const std::string&>();
+    uint32_t reported = 0;
+    for (const auto& match : scanner.scan(text)) {
+      uint32_t bit = PIIScanner::type_bit(match.pii_type);
+      if (reported & bit) {
+        continue;
+      }
+      reported |= bit;
+      found.push_back({
+        {"type", static_cast<int>(match.pii_type)},
+        {"value", text},
+        {"path", path}
+      });
+    }
+  } else if (value.is_object()) {
+    for (const auto& [key, element] : value.items()) {
+      collect_pii(element, scanner, path + "/" + key, found);
+    }
+  } else if (value.is_array()) {
+    for (size_t i = 0; i < value.size(); ++i) {
+      collect_pii(value[i], scanner, path + "/" + std::to_string(i), found);
+    }
+  }
+}
+
+}  // namespace
+
 DataEncryptionEngine::DataEncryptionEngine() {
   auto logger = logging::get_logger("encryption");
   logger->info("DataEncryptionEngine initialized");
@@ -152,8 +193,6 @@ std::vector<EncryptionKey> DataEncryptionEngine::get_all_active_keys() {
 
 // PII Detection & Masking
 json DataEncryptionEngine::detect_pii(const json& data) {
-  std::lock_guard<std::mutex> lock(encryption_lock_);
-  
   return scan_json_for_pii(data);
 }
 
@@ -162,40 +201,17 @@ json DataEncryptionEngine::mask_pii(
     const std::vector<PIIType>& pii_types) {
   auto logger = logging::get_logger("encryption");
   
-  std::lock_guard<std::mutex> lock(encryption_lock_);
+  auto scanner = get_pii_scanner();
   
   json masked_data = data;
-  
-  if (data.is_string()) {
-    std::string value = data.get<std::string>();
-    
-    for (const auto& [pii_type, pattern] : pii_patterns_) {
-      if (!pii_types.empty() && 
-          std::find(pii_types.begin(), pii_types.end(), pii_type) == pii_types.end()) {
-        continue;
-      }
-      
-      std::regex pii_regex(pattern.regex_pattern);
-      value = std::regex_replace(value, pii_regex, pattern.mask_format);
-    }
-    
-    return value;
-  }
+  mask_strings_in_place(masked_data, *scanner, PIIScanner::type_mask(pii_types));
   
   logger->debug("PII masked in data");
   return masked_data;
 }
 
 std::string DataEncryptionEngine::mask_value(const std::string& value, PIIType pii_type) {
-  auto it = pii_patterns_.find(pii_type);
-  if (it == pii_patterns_.end()) {
-    return value;
-  }
-  
-  const auto& pattern = it->second;
-  std::regex pii_regex(pattern.regex_pattern);
-  
-  return std::regex_replace(value, pii_regex, pattern.mask_format);
+  return get_pii_scanner()->mask(value, PIIScanner::type_bit(pii_type));
 }
 
 bool DataEncryptionEngine::register_pii_pattern(const PIIMaskingPattern& pattern) {
@@ -204,7 +220,21 @@ bool DataEncryptionEngine::register_pii_pattern(const PIIMaskingPattern& pattern
   std::lock_guard<std::mutex> lock(encryption_lock_);
   
   pii_patterns_[pattern.pii_type] = pattern;
-  logger->info("PII pattern registered for type: {}", static_cast<int>(pattern.pii_type));
+  
+  std::vector<PIIMaskingPattern> patterns;
+  patterns.reserve(pii_patterns_.size());
+  for (const auto& [type, registered] : pii_patterns_) {
+    patterns.push_back(registered);
+  }
+  auto scanner = std::make_shared<const PIIScanner>(patterns);
+  for (const auto& error : scanner->compile_errors()) {
+    logger->error("{}", error);
+  }
+  pii_scanner_ = std::move(scanner);
+  
+  logger->info("PII pattern registered for type: {} ({} compiled, {} via std::regex)",
+               static_cast<int>(pattern.pii_type), pii_scanner_->compiled_pattern_count(),
+               pii_scanner_->fallback_pattern_count());
   
   return true;
 }
@@ -325,31 +355,26 @@ bool DataEncryptionEngine::load_from_database() {
 }
 
 // Private helpers
+std::shared_ptr<const PIIScanner> DataEncryptionEngine::get_pii_scanner() {
+  std::lock_guard<std::mutex> lock(encryption_lock_);
+  
+  if (!pii_scanner_) {
+    pii_scanner_ = std::make_shared<const PIIScanner>(std::vector<PIIMaskingPattern>{});
+  }
+  return pii_scanner_;
+}
+
 json DataEncryptionEngine::scan_json_for_pii(const json& data) {
   json pii_found = json::array();
   
-  if (data.is_string()) {
-    std::string value = data.get<std::string>();
-    
-    for (const auto& [pii_type, pattern] : pii_patterns_) {
-      if (matches_pii_pattern(value, pii_type)) {
-        pii_found.push_back({
-          {"type", static_cast<int>(pii_type)},
-          {"value", value}
-        });
-      }
-    }
-  }
+  auto scanner = get_pii_scanner();
+  collect_pii(data, *scanner, "", pii_found);
   
   return pii_found;
 }
 
 bool DataEncryptionEngine::matches_pii_pattern(const std::string& value, PIIType pii_type) {
-  auto it = pii_patterns_.find(pii_type);
-  if (it == pii_patterns_.end()) return false;
-  
-  std::regex pattern_regex(it->second.regex_pattern);
-  return std::regex_search(value, pattern_regex);
+  return get_pii_scanner()->contains(value, pii_type);
 }
 
 }  // namespace security
@@ -8,6 +8,9 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <chrono>
 #include <nlohmann/json.hpp>
 
 namespace regulens {
@@ -36,6 +39,8 @@ enum class PIIType {
   CUSTOM
 };
 
+class PIIScanner;
+
 // Encryption mode
 enum class EncryptionMode {
   AES_256_GCM,
@@ -108,6 +113,7 @@ public:
   std::vector<EncryptionKey> get_all_active_keys();
 
   // PII Detection & Masking
+  // Every string in data (nested objects and arrays included) is scanned once for all registered patterns
   json detect_pii(const json& data);
   
   json mask_pii(
@@ -162,6 +168,7 @@ public:
 private:
   std::map<std::string, EncryptionKey> encryption_keys_;
   std::map<PIIType, PIIMaskingPattern> pii_patterns_;
+  std::shared_ptr<const PIIScanner> pii_scanner_;  // Rebuilt on registration; scans run on a snapshot without the lock
   std::vector<GDPRConsent> gdpr_consents_;
   std::vector<DataRetentionPolicy> retention_policies_;
   std::map<std::string, DataClassificationLevel> data_classifications_;
@@ -170,6 +177,7 @@ private:
 
   // Internal helpers
   std::string generate_random_bytes(int length);
+  std::shared_ptr<const PIIScanner> get_pii_scanner();
   json scan_json_for_pii(const json& data);
   bool matches_pii_pattern(const std::string& value, PIIType pii_type);
 };
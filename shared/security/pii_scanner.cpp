@@ -0,0 +1,834 @@
+/**
+ * PII Scanner Implementation
+ * Pattern parser, NFA compiler and Pike VM
+ */
+
+#include "pii_scanner.hpp"
+#include <algorithm>
+#include <cctype>
+
+namespace regulens {
+namespace security {
+
+namespace {
+
+using ByteSet = std::array<bool, 256>;
+
+bool is_word_byte(unsigned char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+bool at_word_boundary(std::string_view text, size_t pos) {
+  bool before = pos > 0 && is_word_byte(static_cast<unsigned char>(text[pos - 1]));
+  bool after = pos < text.size() && is_word_byte(static_cast<unsigned char>(text[pos]));
+  return before != after;
+}
+
+void add_range(ByteSet& set, unsigned char from, unsigned char to) {
+  for (unsigned c = from; c <= to; ++c) {
+    set[c] = true;
+  }
+}
+
+void add_set(ByteSet& set, const ByteSet& other, bool negate) {
+  for (size_t c = 0; c < 256; ++c) {
+    if (other[c] != negate) {
+      set[c] = true;
+    }
+  }
+}
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// $& and $$ are expanded by append_mask; anything else needs capture groups
+bool mask_needs_regex(const std::string& mask_format) {
+  for (size_t i = 0; i + 1 < mask_format.size(); ++i) {
+    if (mask_format[i] == '$') {
+      char next = mask_format[i + 1];
+      if (next == '$' || next == '&') {
+        ++i;
+        continue;
+      }
+      if ((next >= '0' && next <= '9') || next == '`' || next == '\'') {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Per-thread VM buffers, reused across calls and scanners
+struct VMScratch {
+  struct Thread {
+    uint32_t pc;
+    size_t start;
+  };
+  std::vector<Thread> current;
+  std::vector<Thread> next;
+  std::vector<uint64_t> marks;
+  std::vector<uint32_t> stack;
+  uint64_t generation = 0;
+};
+
+VMScratch& vm_scratch() {
+  thread_local VMScratch scratch;
+  return scratch;
+}
+
+}  // namespace
+
+// Pattern syntax tree
+struct PIIScanner::Node {
+  enum class Kind { CLASS, CONCAT, ALTERNATE, REPEAT, ASSERT };
+
+  Kind kind = Kind::CONCAT;
+  ByteSet chars{};
+  Op assertion = Op::WORD_BOUNDARY;
+  std::vector<Node> children;
+  int min = 1;
+  int max = 1;  // -1 = unbounded
+  bool greedy = true;
+};
+
+class PIIScanner::Parser {
+public:
+  explicit Parser(std::string_view pattern) : pattern_(pattern) {}
+
+  bool parse(Node& root, std::string& error) {
+    if (!parse_alternation(root) || pos_ != pattern_.size()) {
+      error = error_.empty() ? "unexpected '" + std::string(1, pattern_[pos_]) + "'" : error_;
+      return false;
+    }
+    return true;
+  }
+
+private:
+  bool fail(const std::string& message) {
+    if (error_.empty()) {
+      error_ = message + " at offset " + std::to_string(pos_);
+    }
+    return false;
+  }
+
+  bool at_end() const { return pos_ >= pattern_.size(); }
+  char peek() const { return pattern_[pos_]; }
+
+  bool parse_alternation(Node& out) {
+    out.kind = Node::Kind::ALTERNATE;
+    out.children.emplace_back();
+    if (!parse_concat(out.children.back())) {
+      return false;
+    }
+    while (!at_end() && peek() == '|') {
+      ++pos_;
+      out.children.emplace_back();
+      if (!parse_concat(out.children.back())) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool parse_concat(Node& out) {
+    out.kind = Node::Kind::CONCAT;
+    while (!at_end() && peek() != '|' && peek() != ')') {
+      Node atom;
+      if (!parse_atom(atom) || !parse_quantifier(atom, out)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool parse_atom(Node& atom) {
+    char c = pattern_[pos_++];
+    switch (c) {
+      case '(': {
+        if (!at_end() && peek() == '?') {
+          if (pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] == ':') {
+            pos_ += 2;
+          } else {
+            return fail("lookaround is not supported");
+          }
+        }
+        if (!parse_alternation(atom)) {
+          return false;
+        }
+        if (at_end() || peek() != ')') {
+          return fail("missing ')'");
+        }
+        ++pos_;
+        return true;
+      }
+      case '[':
+        return parse_class(atom);
+      case '.':
+        atom.kind = Node::Kind::CLASS;
+        atom.chars.fill(true);
+        atom.chars['\n'] = false;
+        atom.chars['\r'] = false;
+        return true;
+      case '^':
+        atom.kind = Node::Kind::ASSERT;
+        atom.assertion = Op::TEXT_START;
+        return true;
+      case '$':
+        atom.kind = Node::Kind::ASSERT;
+        atom.assertion = Op::TEXT_END;
+        return true;
+      case '\\':
+        return parse_escape(atom);
+      case '*':
+      case '+':
+      case '?':
+      case '{':
+        return fail("nothing to repeat");
+      default:
+        atom.kind = Node::Kind::CLASS;
+        atom.chars[static_cast<unsigned char>(c)] = true;
+        return true;
+    }
+  }
+
+  bool parse_escape(Node& atom) {
+    if (at_end()) {
+      return fail("trailing '\\'");
+    }
+    char c = peek();
+    if (c == 'b' || c == 'B') {
+      ++pos_;
+      atom.kind = Node::Kind::ASSERT;
+      atom.assertion = c == 'b' ? Op::WORD_BOUNDARY : Op::NOT_WORD_BOUNDARY;
+      return true;
+    }
+    atom.kind = Node::Kind::CLASS;
+    return parse_class_escape(atom.chars);
+  }
+
+  // Escapes valid both inside and outside [...]; adds the escaped bytes to set
+  bool parse_class_escape(ByteSet& set) {
+    char c = pattern_[pos_++];
+    ByteSet shorthand{};
+    switch (c) {
+      case 'd': case 'D':
+        add_range(shorthand, '0', '9');
+        add_set(set, shorthand, c == 'D');
+        return true;
+      case 'w': case 'W':
+        for (size_t b = 0; b < 256; ++b) shorthand[b] = is_word_byte(static_cast<unsigned char>(b));
+        add_set(set, shorthand, c == 'W');
+        return true;
+      case 's': case 'S':
+        for (unsigned char b : {' ', '\t', '\n', '\v', '\f', '\r'}) shorthand[b] = true;
+        add_set(set, shorthand, c == 'S');
+        return true;
+      case 't': set['\t'] = true; return true;
+      case 'n': set['\n'] = true; return true;
+      case 'r': set['\r'] = true; return true;
+      case 'f': set['\f'] = true; return true;
+      case 'v': set['\v'] = true; return true;
+      case '0': set[0] = true; return true;
+      case 'x': {
+        if (pos_ + 2 > pattern_.size() || hex_value(pattern_[pos_]) < 0 || hex_value(pattern_[pos_ + 1]) < 0) {
+          return fail("malformed \\x escape");
+        }
+        set[static_cast<size_t>(hex_value(pattern_[pos_]) * 16 + hex_value(pattern_[pos_ + 1]))] = true;
+        pos_ += 2;
+        return true;
+      }
+      default:
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+          return fail(std::string("escape \\") + c + " is not supported");
+        }
+        set[static_cast<unsigned char>(c)] = true;
+        return true;
+    }
+  }
+
+  bool parse_class(Node& atom) {
+    atom.kind = Node::Kind::CLASS;
+    bool negate = !at_end() && peek() == '^';
+    if (negate) {
+      ++pos_;
+    }
+
+    ByteSet set{};
+    while (!at_end() && peek() != ']') {
+      ByteSet item{};
+      int low = -1;
+      if (peek() == '\\') {
+        ++pos_;
+        if (at_end()) {
+          return fail("trailing '\\'");
+        }
+        if (peek() == 'b') {
+          ++pos_;
+          low = '\b';
+        } else {
+          if (!parse_class_escape(item)) {
+            return false;
+          }
+          if (std::count(item.begin(), item.end(), true) == 1) {
+            low = static_cast<int>(std::find(item.begin(), item.end(), true) - item.begin());
+          }
+        }
+      } else {
+        low = static_cast<unsigned char>(pattern_[pos_++]);
+      }
+
+      // a-z range; a trailing '-' is literal
+      if (low >= 0 && pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']') {
+        ++pos_;
+        int high;
+        if (peek() == '\\') {
+          ++pos_;
+          ByteSet end_item{};
+          if (at_end() || !parse_class_escape(end_item) || std::count(end_item.begin(), end_item.end(), true) != 1) {
+            return fail("invalid range end");
+          }
+          high = static_cast<int>(std::find(end_item.begin(), end_item.end(), true) - end_item.begin());
+        } else {
+          high = static_cast<unsigned char>(pattern_[pos_++]);
+        }
+        if (high < low) {
+          return fail("range out of order");
+        }
+        add_range(set, static_cast<unsigned char>(low), static_cast<unsigned char>(high));
+      } else if (low >= 0) {
+        set[static_cast<size_t>(low)] = true;
+      } else {
+        add_set(set, item, false);
+      }
+    }
+
+    if (at_end()) {
+      return fail("missing ']'");
+    }
+    ++pos_;
+
+    for (size_t c = 0; c < 256; ++c) {
+      atom.chars[c] = set[c] != negate;
+    }
+    return true;
+  }
+
+  bool parse_quantifier(Node& atom, Node& concat) {
+    int min = 1;
+    int max = 1;
+    if (!at_end()) {
+      char c = peek();
+      if (c == '*') {
+        min = 0; max = -1; ++pos_;
+      } else if (c == '+') {
+        min = 1; max = -1; ++pos_;
+      } else if (c == '?') {
+        min = 0; max = 1; ++pos_;
+      } else if (c == '{') {
+        ++pos_;
+        if (!parse_number(min)) {
+          return fail("malformed {n,m} quantifier");
+        }
+        max = min;
+        if (!at_end() && peek() == ',') {
+          ++pos_;
+          max = -1;
+          if (!at_end() && peek() != '}' && !parse_number(max)) {
+            return fail("malformed {n,m} quantifier");
+          }
+        }
+        if (at_end() || peek() != '}' || (max >= 0 && max < min)) {
+          return fail("malformed {n,m} quantifier");
+        }
+        ++pos_;
+      }
+    }
+
+    if (min == 1 && max == 1) {
+      concat.children.push_back(std::move(atom));
+      return true;
+    }
+    if (atom.kind == Node::Kind::ASSERT) {
+      return fail("nothing to repeat");
+    }
+
+    Node repeat;
+    repeat.kind = Node::Kind::REPEAT;
+    repeat.min = min;
+    repeat.max = max;
+    if (!at_end() && peek() == '?') {
+      repeat.greedy = false;
+      ++pos_;
+    }
+    repeat.children.push_back(std::move(atom));
+    concat.children.push_back(std::move(repeat));
+    return true;
+  }
+
+  bool parse_number(int& value) {
+    size_t start = pos_;
+    value = 0;
+    while (!at_end() && peek() >= '0' && peek() <= '9' && value < 100000) {
+      value = value * 10 + (peek() - '0');
+      ++pos_;
+    }
+    return pos_ > start;
+  }
+
+  std::string_view pattern_;
+  size_t pos_ = 0;
+  std::string error_;
+};
+
+PIIScanner::PIIScanner(const std::vector<PIIMaskingPattern>& patterns) {
+  for (const auto& pattern : patterns) {
+    Node root;
+    std::string error;
+    Parser parser(pattern.regex_pattern);
+    bool compiled = !mask_needs_regex(pattern.mask_format) && parser.parse(root, error);
+
+    if (compiled) {
+      size_t program_size = program_.size();
+      size_t class_count = classes_.size();
+      uint32_t start = static_cast<uint32_t>(program_.size());
+
+      compile_node(root);
+      emit(Op::MATCH, 0, static_cast<uint32_t>(compiled_.size()));
+
+      if (program_.size() > MAX_PROGRAM_SIZE) {
+        program_.resize(program_size);
+        classes_.resize(class_count);
+        compiled = false;
+      } else {
+        CompiledPattern entry{pattern.pii_type, pattern.mask_format, start, compute_first_bytes(start), {}};
+        collect_required(root, entry.required);
+        compiled_.push_back(std::move(entry));
+      }
+    }
+
+    if (!compiled) {
+      try {
+        fallback_.push_back({pattern.pii_type, std::regex(pattern.regex_pattern, std::regex::optimize),
+                             pattern.mask_format});
+      } catch (const std::regex_error& e) {
+        compile_errors_.push_back("PII pattern " + std::to_string(static_cast<int>(pattern.pii_type)) +
+                                  " is invalid: " + e.what());
+      }
+    }
+  }
+}
+
+uint32_t PIIScanner::type_mask(const std::vector<PIIType>& types) {
+  if (types.empty()) {
+    return ALL_TYPES;
+  }
+  uint32_t mask = 0;
+  for (auto type : types) {
+    mask |= type_bit(type);
+  }
+  return mask;
+}
+
+uint32_t PIIScanner::emit(Op op, uint32_t x, uint32_t y) {
+  program_.push_back({op, x, y});
+  return static_cast<uint32_t>(program_.size() - 1);
+}
+
+void PIIScanner::compile_node(const Node& node) {
+  if (program_.size() > MAX_PROGRAM_SIZE) {
+    return;
+  }
+
+  switch (node.kind) {
+    case Node::Kind::CLASS:
+      classes_.push_back(node.chars);
+      emit(Op::CHAR_CLASS, 0, static_cast<uint32_t>(classes_.size() - 1));
+      break;
+
+    case Node::Kind::ASSERT:
+      emit(node.assertion);
+      break;
+
+    case Node::Kind::CONCAT:
+      for (const auto& child : node.children) {
+        compile_node(child);
+      }
+      break;
+
+    case Node::Kind::ALTERNATE: {
+      std::vector<uint32_t> exits;
+      for (size_t i = 0; i < node.children.size(); ++i) {
+        if (i + 1 < node.children.size()) {
+          uint32_t split = emit(Op::SPLIT);
+          program_[split].x = split + 1;
+          compile_node(node.children[i]);
+          exits.push_back(emit(Op::JUMP));
+          program_[split].y = static_cast<uint32_t>(program_.size());
+        } else {
+          compile_node(node.children[i]);
+        }
+      }
+      for (uint32_t exit : exits) {
+        program_[exit].x = static_cast<uint32_t>(program_.size());
+      }
+      break;
+    }
+
+    case Node::Kind::REPEAT: {
+      const Node& child = node.children.front();
+      for (int i = 0; i < node.min && program_.size() <= MAX_PROGRAM_SIZE; ++i) {
+        compile_node(child);
+      }
+
+      std::vector<uint32_t> splits;
+      if (node.max < 0) {
+        uint32_t loop = emit(Op::SPLIT);
+        compile_node(child);
+        emit(Op::JUMP, loop);
+        splits.push_back(loop);
+      } else {
+        for (int i = node.min; i < node.max && program_.size() <= MAX_PROGRAM_SIZE; ++i) {
+          splits.push_back(emit(Op::SPLIT));
+          compile_node(child);
+        }
+      }
+
+      uint32_t end = static_cast<uint32_t>(program_.size());
+      for (uint32_t split : splits) {
+        program_[split].x = node.greedy ? split + 1 : end;
+        program_[split].y = node.greedy ? end : split + 1;
+      }
+      break;
+    }
+  }
+}
+
+PIIScanner::ByteMask PIIScanner::compute_first_bytes(uint32_t start) const {
+  // Bytes that can be consumed first from start; assertions are assumed to pass
+  ByteMask first_bytes;
+  std::vector<bool> visited(program_.size(), false);
+  std::vector<uint32_t> stack = {start};
+  while (!stack.empty()) {
+    uint32_t pc = stack.back();
+    stack.pop_back();
+    if (visited[pc]) {
+      continue;
+    }
+    visited[pc] = true;
+
+    const Inst& inst = program_[pc];
+    switch (inst.op) {
+      case Op::CHAR_CLASS:
+        for (size_t c = 0; c < 256; ++c) {
+          if (classes_[inst.y][c]) first_bytes.set(c);
+        }
+        break;
+      case Op::MATCH:
+        break;
+      case Op::JUMP:
+        stack.push_back(inst.x);
+        break;
+      case Op::SPLIT:
+        stack.push_back(inst.x);
+        stack.push_back(inst.y);
+        break;
+      default:
+        stack.push_back(pc + 1);
+        break;
+    }
+  }
+  return first_bytes;
+}
+
+void PIIScanner::collect_required(const Node& node, std::vector<ByteMask>& required) {
+  switch (node.kind) {
+    case Node::Kind::CLASS: {
+      ByteMask mask;
+      for (size_t c = 0; c < 256; ++c) {
+        if (node.chars[c]) mask.set(c);
+      }
+      // Classes that almost any byte satisfies filter nothing
+      if (mask.count() < 128 &&
+          std::find(required.begin(), required.end(), mask) == required.end()) {
+        required.push_back(mask);
+      }
+      break;
+    }
+    case Node::Kind::CONCAT:
+      for (const auto& child : node.children) {
+        collect_required(child, required);
+      }
+      break;
+    case Node::Kind::REPEAT:
+      if (node.min > 0) {
+        collect_required(node.children.front(), required);
+      }
+      break;
+    case Node::Kind::ALTERNATE:
+      // Only an unconditional branch is known to be taken
+      if (node.children.size() == 1) {
+        collect_required(node.children.front(), required);
+      }
+      break;
+    case Node::Kind::ASSERT:
+      break;
+  }
+}
+
+PIIScanner::SearchPlan PIIScanner::plan_for(std::string_view text, uint32_t types) const {
+  SearchPlan plan;
+  if (compiled_.empty()) {
+    return plan;
+  }
+
+  ByteMask present;
+  for (unsigned char c : text) {
+    present.set(c);
+  }
+
+  for (size_t i = 0; i < compiled_.size(); ++i) {
+    const auto& pattern = compiled_[i];
+    if (!(types & type_bit(pattern.pii_type))) {
+      continue;
+    }
+    bool possible = std::all_of(pattern.required.begin(), pattern.required.end(),
+                                [&](const ByteMask& required) { return (required & present).any(); });
+    if (possible) {
+      plan.patterns.push_back(static_cast<uint32_t>(i));
+      plan.first_bytes |= pattern.first_bytes;
+    }
+  }
+  return plan;
+}
+
+bool PIIScanner::find(std::string_view text, size_t from, const SearchPlan& plan, PIIMatch& match,
+                      uint32_t& pattern) const {
+  if (plan.patterns.empty()) {
+    return false;
+  }
+
+  VMScratch& vm = vm_scratch();
+  if (vm.marks.size() < program_.size()) {
+    vm.marks.resize(program_.size(), 0);
+  }
+
+  // Epsilon closure of pc at pos, appended in priority order; a pc already on the list is skipped
+  auto add_thread = [&](std::vector<VMScratch::Thread>& list, uint64_t generation,
+                        uint32_t pc0, size_t start, size_t pos) {
+    vm.stack.clear();
+    vm.stack.push_back(pc0);
+    while (!vm.stack.empty()) {
+      uint32_t pc = vm.stack.back();
+      vm.stack.pop_back();
+      if (vm.marks[pc] == generation) {
+        continue;
+      }
+      vm.marks[pc] = generation;
+
+      const Inst& inst = program_[pc];
+      switch (inst.op) {
+        case Op::JUMP:
+          vm.stack.push_back(inst.x);
+          break;
+        case Op::SPLIT:
+          vm.stack.push_back(inst.y);
+          vm.stack.push_back(inst.x);
+          break;
+        case Op::WORD_BOUNDARY:
+          if (at_word_boundary(text, pos)) vm.stack.push_back(pc + 1);
+          break;
+        case Op::NOT_WORD_BOUNDARY:
+          if (!at_word_boundary(text, pos)) vm.stack.push_back(pc + 1);
+          break;
+        case Op::TEXT_START:
+          if (pos == 0) vm.stack.push_back(pc + 1);
+          break;
+        case Op::TEXT_END:
+          if (pos == text.size()) vm.stack.push_back(pc + 1);
+          break;
+        case Op::CHAR_CLASS:
+        case Op::MATCH:
+          list.push_back({pc, start});
+          break;
+      }
+    }
+  };
+
+  const size_t n = text.size();
+  bool matched = false;
+  vm.current.clear();
+  uint64_t current_generation = ++vm.generation;
+
+  for (size_t pos = from; pos <= n; ++pos) {
+    if (!matched) {
+      if (vm.current.empty()) {
+        while (pos < n && !plan.first_bytes[static_cast<unsigned char>(text[pos])]) {
+          ++pos;
+        }
+        if (pos >= n) {
+          break;
+        }
+      }
+      // Started last, so threads from earlier starts keep priority (leftmost wins);
+      // among patterns starting here, registration order decides
+      for (uint32_t index : plan.patterns) {
+        add_thread(vm.current, current_generation, compiled_[index].start, pos, pos);
+      }
+    }
+    if (vm.current.empty()) {
+      if (matched) {
+        break;
+      }
+      current_generation = ++vm.generation;  // Nothing started here; try the next position
+      continue;
+    }
+
+    vm.next.clear();
+    uint64_t next_generation = ++vm.generation;
+    for (const auto& thread : vm.current) {
+      const Inst& inst = program_[thread.pc];
+      if (inst.op == Op::MATCH) {
+        // Empty matches carry no PII; like match_not_null, lower-priority threads may still match
+        if (thread.start != pos) {
+          match = {compiled_[inst.y].pii_type, thread.start, pos};
+          pattern = inst.y;
+          matched = true;
+          break;  // Lower-priority threads lose to this match
+        }
+        continue;
+      }
+      if (pos < n && classes_[inst.y][static_cast<unsigned char>(text[pos])]) {
+        add_thread(vm.next, next_generation, thread.pc + 1, thread.start, pos + 1);
+      }
+    }
+    vm.current.swap(vm.next);
+    current_generation = next_generation;
+  }
+
+  return matched;
+}
+
+void PIIScanner::scan_compiled(std::string_view text, uint32_t types, std::vector<PIIMatch>& matches,
+                               std::vector<uint32_t>* patterns) const {
+  SearchPlan plan = plan_for(text, types);
+  PIIMatch match{};
+  uint32_t pattern = 0;
+  size_t from = 0;
+  while (from < text.size() && find(text, from, plan, match, pattern)) {
+    matches.push_back(match);
+    if (patterns) {
+      patterns->push_back(pattern);
+    }
+    from = match.end;
+  }
+}
+
+std::vector<PIIMatch> PIIScanner::scan(std::string_view text, uint32_t types) const {
+  std::vector<PIIMatch> matches;
+  scan_compiled(text, types, matches);
+
+  if (!fallback_.empty()) {
+    std::string subject(text);
+    for (const auto& pattern : fallback_) {
+      if (!(types & type_bit(pattern.pii_type))) {
+        continue;
+      }
+      for (auto it = std::sregex_iterator(subject.begin(), subject.end(), pattern.regex);
+           it != std::sregex_iterator(); ++it) {
+        size_t begin = static_cast<size_t>(it->position());
+        size_t end = begin + static_cast<size_t>(it->length());
+        bool overlaps = std::any_of(matches.begin(), matches.end(), [&](const PIIMatch& m) {
+          return begin < m.end && m.begin < end;
+        });
+        if (end > begin && !overlaps) {
+          matches.push_back({pattern.pii_type, begin, end});
+        }
+      }
+    }
+    std::sort(matches.begin(), matches.end(),
+              [](const PIIMatch& a, const PIIMatch& b) { return a.begin < b.begin; });
+  }
+
+  return matches;
+}
+
+bool PIIScanner::contains(std::string_view text, PIIType type) const {
+  PIIMatch match{};
+  uint32_t pattern = 0;
+  if (find(text, 0, plan_for(text, type_bit(type)), match, pattern)) {
+    return true;
+  }
+  for (const auto& fallback : fallback_) {
+    if (fallback.pii_type == type &&
+        std::regex_search(text.begin(), text.end(), fallback.regex)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string PIIScanner::mask(std::string_view text, uint32_t types, std::vector<PIIMatch>* found) const {
+  std::vector<PIIMatch> matches;
+  std::vector<uint32_t> patterns;
+  scan_compiled(text, types, matches, &patterns);
+
+  std::string masked;
+  if (matches.empty()) {
+    masked.assign(text);
+  } else {
+    masked.reserve(text.size());
+    size_t last = 0;
+    for (size_t i = 0; i < matches.size(); ++i) {
+      const auto& match = matches[i];
+      masked.append(text.substr(last, match.begin - last));
+      append_mask(masked, compiled_[patterns[i]].mask_format, text.substr(match.begin, match.end - match.begin));
+      last = match.end;
+    }
+    masked.append(text.substr(last));
+  }
+
+  // Fallback patterns run over the compiled pass's output, as the per-pattern masking did
+  for (const auto& pattern : fallback_) {
+    if (!(types & type_bit(pattern.pii_type))) {
+      continue;
+    }
+    if (found) {
+      for (auto it = std::sregex_iterator(masked.begin(), masked.end(), pattern.regex);
+           it != std::sregex_iterator(); ++it) {
+        matches.push_back({pattern.pii_type, static_cast<size_t>(it->position()),
+                           static_cast<size_t>(it->position() + it->length())});
+      }
+    }
+    masked = std::regex_replace(masked, pattern.regex, pattern.mask_format);
+  }
+
+  if (found) {
+    *found = std::move(matches);
+  }
+  return masked;
+}
+
+void PIIScanner::append_mask(std::string& out, const std::string& mask_format, std::string_view matched) {
+  for (size_t i = 0; i < mask_format.size(); ++i) {
+    if (mask_format[i] == '$' && i + 1 < mask_format.size()) {
+      if (mask_format[i + 1] == '&') {
+        out.append(matched);
+        ++i;
+        continue;
+      }
+      if (mask_format[i + 1] == '$') {
+        out.push_back('$');
+        ++i;
+        continue;
+      }
+    }
+    out.push_back(mask_format[i]);
+  }
+}
+
+}  // namespace security
+}  // namespace regulens
@@ -0,0 +1,125 @@
+/**
+ * PII Scanner - compiled multi-pattern PII detection
+ *
+ * All registered PIIMaskingPatterns are compiled once into a single NFA
+ * program (one alternative per pattern, in registration order) and run as a
+ * Pike VM: every pattern advances in lock-step over each byte, so a string is
+ * scanned once however many PII types are registered, in time linear in its
+ * length. Before a string is scanned, patterns needing a byte it does not
+ * contain (the '@' of an email, the digits of an SSN) are left out, and a
+ * first-byte table of the remaining ones skips text where none can start.
+ * Empty matches are never reported.
+ *
+ * Supported syntax is the ECMAScript subset PII patterns use: literals,
+ * escapes (\d \w \s and negations, \b \B), classes, groups, alternation,
+ * greedy and lazy quantifiers, ^ and $. Patterns outside it (lookaround,
+ * backreferences, $n in the mask) fall back to a precompiled std::regex.
+ */
+
+#pragma once
+
+#include "data_encryption.hpp"
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace regulens {
+namespace security {
+
+struct PIIMatch {
+  PIIType pii_type;
+  size_t begin;
+  size_t end;
+};
+
+class PIIScanner {
+public:
+  explicit PIIScanner(const std::vector<PIIMaskingPattern>& patterns);
+
+  // Bit per PIIType; ALL_TYPES selects every registered pattern
+  static constexpr uint32_t ALL_TYPES = 0xFFFFFFFFu;
+  static uint32_t type_bit(PIIType type) { return 1u << static_cast<uint32_t>(type); }
+  static uint32_t type_mask(const std::vector<PIIType>& types);
+
+  // Leftmost, non-overlapping matches in text order
+  std::vector<PIIMatch> scan(std::string_view text, uint32_t types = ALL_TYPES) const;
+  bool contains(std::string_view text, PIIType type) const;
+
+  // Replace every match with its pattern's mask_format in one pass; found receives the matches
+  std::string mask(std::string_view text, uint32_t types = ALL_TYPES,
+                   std::vector<PIIMatch>* found = nullptr) const;
+
+  size_t compiled_pattern_count() const { return compiled_.size(); }
+  size_t fallback_pattern_count() const { return fallback_.size(); }
+  const std::vector<std::string>& compile_errors() const { return compile_errors_; }
+
+private:
+  enum class Op : uint8_t {
+    CHAR_CLASS,
+    SPLIT,      // try x, then y
+    JUMP,
+    MATCH,
+    WORD_BOUNDARY,
+    NOT_WORD_BOUNDARY,
+    TEXT_START,
+    TEXT_END
+  };
+
+  struct Inst {
+    Op op;
+    uint32_t x = 0;
+    uint32_t y = 0;  // SPLIT: second choice; CHAR_CLASS: class index; MATCH: pattern index
+  };
+
+  using ByteMask = std::bitset<256>;
+
+  struct CompiledPattern {
+    PIIType pii_type;
+    std::string mask_format;
+    uint32_t start;                 // First instruction
+    ByteMask first_bytes;           // Bytes a non-empty match can start with
+    std::vector<ByteMask> required; // Every match contains a byte from each
+  };
+
+  // Patterns worth running over one string, in priority order
+  struct SearchPlan {
+    std::vector<uint32_t> patterns;
+    ByteMask first_bytes;
+  };
+
+  struct FallbackPattern {
+    PIIType pii_type;
+    std::regex regex;
+    std::string mask_format;
+  };
+
+  struct Node;
+  class Parser;
+
+  void compile_node(const Node& node);
+  uint32_t emit(Op op, uint32_t x = 0, uint32_t y = 0);
+  ByteMask compute_first_bytes(uint32_t start) const;
+  static void collect_required(const Node& node, std::vector<ByteMask>& required);
+
+  SearchPlan plan_for(std::string_view text, uint32_t types) const;
+  // Leftmost-first match starting at or after from; false if none
+  bool find(std::string_view text, size_t from, const SearchPlan& plan, PIIMatch& match, uint32_t& pattern) const;
+  void scan_compiled(std::string_view text, uint32_t types, std::vector<PIIMatch>& matches,
+                     std::vector<uint32_t>* patterns = nullptr) const;
+  static void append_mask(std::string& out, const std::string& mask_format, std::string_view matched);
+
+  std::vector<Inst> program_;
+  std::vector<std::array<bool, 256>> classes_;
+  std::vector<CompiledPattern> compiled_;
+  std::vector<FallbackPattern> fallback_;
+  std::vector<std::string> compile_errors_;
+
+  static constexpr size_t MAX_PROGRAM_SIZE = 20000;  // bounds {n,m} expansion per pattern
+};
+
+}  // namespace security
+}  // namespace regulens
@@ -11,19 +11,8 @@
 #include <fstream>
 #include <regex>
 #include <cstring>
-#include <netinet/in.h>
-#include <unistd.h>
-#include <fcntl.h>
-#include <sys/socket.h>
-#include <arpa/inet.h>
 #include <chrono>
 
-#ifdef __APPLE__
-#include <sys/event.h>
-#include <sys/time.h>
-#else
-#include <sys/epoll.h>
-#endif
 #include "../config/configuration_manager.hpp"
 #include "../metrics/metrics_collector.hpp"
 #include "../api_config/api_endpoint_config.hpp"
@@ -35,7 +24,7 @@
 namespace regulens {
 
 WebUIServer::WebUIServer(int port)
-    : port_(port), running_(false) {
+    : port_(port), running_(false), route_table_(std::make_shared<const RouteTable>()) {
 }
 
 WebUIServer::~WebUIServer() {
@@ -49,9 +38,6 @@ bool WebUIServer::start() {
     }
 
     try {
-        running_ = true;
-        server_thread_ = std::thread(&WebUIServer::server_loop, this);
-
         // Initialize API endpoint configuration for systematic endpoint management
         std::string config_path = "shared/api_config/api_endpoints_config.json";
         if (!APIEndpointConfig::get_instance().initialize(config_path, logger_)) {
@@ -91,6 +77,19 @@ bool WebUIServer::start() {
             return false;
         }
 
+        server_core_ = std::make_unique<HttpServerCore>(
+            server_options_,
+            [this](const HttpServerRequest& request) { return handle_connection_request(request); });
+        server_core_->set_error_logger([this](const std::string& message) {
+            if (logger_) logger_->error("Web UI server: " + message);
+        });
+        if (!server_core_->start(port_)) {
+            if (logger_) logger_->error(server_core_->error_message());
+            server_core_.reset();
+            return false;
+        }
+        running_ = true;
+
         if (logger_) {
             logger_->info("Web UI server started on port " + std::to_string(port_));
             logger_->info("API endpoint configuration loaded successfully");
@@ -111,8 +110,9 @@ void WebUIServer::stop() {
 
     running_ = false;
 
-    if (server_thread_.joinable()) {
-        server_thread_.join();
+    if (server_core_) {
+        server_core_->stop();
+        server_core_.reset();
     }
 
     if (logger_) {
@@ -124,6 +124,7 @@ void WebUIServer::add_route(const std::string& method, const std::string& path,
     std::lock_guard<std::mutex> lock(routes_mutex_);
     std::string key = method + " " + path;
     routes_[key] = handler;
+    rebuild_route_table();
 
     if (logger_) {
         logger_->debug("Added route: {} {}", method, path);
@@ -133,192 +134,47 @@ void WebUIServer::add_route(const std::string& method, const std::string& path,
 void WebUIServer::add_static_route(const std::string& path_prefix, const std::string& static_dir) {
     std::lock_guard<std::mutex> lock(routes_mutex_);
     static_routes_[path_prefix] = static_dir;
+    rebuild_route_table();
 
     if (logger_) {
         logger_->debug("Added static route: {} -> {}", path_prefix, static_dir);
     }
 }
 
-WebUIServer::ServerStats WebUIServer::get_stats() const {
-    std::lock_guard<std::mutex> lock(stats_mutex_);
-    return stats_;
-}
-
-void WebUIServer::server_loop() {
-    // Create socket
-    int server_fd = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_fd < 0) {
-        if (logger_) logger_->error("Failed to create socket");
-        running_ = false;
-        return;
-    }
-
-    // Set socket options
-    int opt = 1;
-    setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-
-    // Bind to port
-    sockaddr_in address{};
-    address.sin_family = AF_INET;
-    address.sin_addr.s_addr = INADDR_ANY;
-    address.sin_port = htons(port_);
-
-    if (bind(server_fd, (sockaddr*)&address, sizeof(address)) < 0) {
-        if (logger_) logger_->error("Failed to bind to port " + std::to_string(port_));
-        close(server_fd);
-        running_ = false;
-        return;
-    }
-
-    // Listen
-    if (listen(server_fd, 10) < 0) {
-        if (logger_) logger_->error("Failed to listen on port " + std::to_string(port_));
-        close(server_fd);
-        running_ = false;
-        return;
-    }
-
-    if (logger_) logger_->info("Web UI server listening on port " + std::to_string(port_));
-
-    // Set non-blocking
-    fcntl(server_fd, F_SETFL, O_NONBLOCK);
-
-#ifdef __APPLE__
-    // kqueue implementation for macOS/BSD
-    int kq = kqueue();
-    if (kq == -1) {
-        if (logger_) logger_->error("Failed to create kqueue");
-        close(server_fd);
-        running_ = false;
-        return;
-    }
-
-    struct kevent change_event;
-    EV_SET(&change_event, server_fd, EVFILT_READ, EV_ADD, 0, 0, NULL);
-
-    if (kevent(kq, &change_event, 1, NULL, 0, NULL) == -1) {
-        if (logger_) logger_->error("Failed to add server socket to kqueue");
-        close(kq);
-        close(server_fd);
-        running_ = false;
-        return;
-    }
-
-    const int MAX_EVENTS = 32;
-    struct kevent events[MAX_EVENTS];
-
-    while (running_) {
-        struct timespec timeout = {1, 0}; // 1 second timeout
-        int nev = kevent(kq, NULL, 0, events, MAX_EVENTS, &timeout);
-
-        if (nev == -1) {
-            if (logger_) logger_->error("kqueue wait failed");
-            continue;
-        }
-
-        for (int i = 0; i < nev; ++i) {
-            if (events[i].ident == server_fd) {
-                // Accept new connections
-                sockaddr_in client_addr{};
-                socklen_t client_len = sizeof(client_addr);
-                int client_fd = accept(server_fd, (sockaddr*)&client_addr, &client_len);
-
-                if (client_fd >= 0) {
-                    // Set client socket to non-blocking
-                    fcntl(client_fd, F_SETFL, O_NONBLOCK);
-
-                    // Handle request in a separate thread
-                    std::thread([this, client_fd]() {
-                        handle_client(client_fd);
-                    }).detach();
-                }
-            }
-        }
-    }
-
-    close(kq);
-#else
-    // epoll implementation for Linux
-    int epoll_fd = epoll_create1(0);
-    if (epoll_fd == -1) {
-        if (logger_) logger_->error("Failed to create epoll instance");
-        close(server_fd);
-        running_ = false;
-        return;
-    }
-
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.fd = server_fd;
-
-    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server_fd, &event) == -1) {
-        if (logger_) logger_->error("Failed to add server socket to epoll");
-        close(epoll_fd);
-        close(server_fd);
-        running_ = false;
-        return;
-    }
-
-    const int MAX_EVENTS = 32;
-    struct epoll_event events[MAX_EVENTS];
-
-    while (running_) {
-        int nfds = epoll_wait(epoll_fd, events, MAX_EVENTS, 1000); // 1 second timeout
-
-        if (nfds == -1) {
-            if (logger_) logger_->error("epoll_wait failed");
-            continue;
-        }
-
-        for (int i = 0; i < nfds; ++i) {
-            if (events[i].data.fd == server_fd) {
-                // Accept new connections
-                sockaddr_in client_addr{};
-                socklen_t client_len = sizeof(client_addr);
-                int client_fd = accept(server_fd, (sockaddr*)&client_addr, &client_len);
-
-                if (client_fd >= 0) {
-                    // Set client socket to non-blocking
-                    fcntl(client_fd, F_SETFL, O_NONBLOCK);
-
-                    // Handle request in a separate thread
-                    std::thread([this, client_fd]() {
-                        handle_client(client_fd);
-                    }).detach();
-                }
-            }
+void WebUIServer::rebuild_route_table() {
+    // Caller holds routes_mutex_; readers keep whatever table they already loaded
+    auto table = std::make_shared<RouteTable>();
+    table->routes = routes_;
+    table->static_routes.assign(static_routes_.begin(), static_routes_.end());
+    for (const auto& [key, handler] : routes_) {
+        size_t space_pos = key.find(' ');
+        if (space_pos != std::string::npos) {
+            table->route_paths.insert(key.substr(space_pos + 1));
         }
     }
-
-    close(epoll_fd);
-#endif
-
-    close(server_fd);
+    route_table_.store(std::move(table));
 }
 
-void WebUIServer::handle_client(int client_fd) {
-    char buffer[8192];
-    std::string request_data;
-
-    // Read request
-    ssize_t bytes_read;
-    while ((bytes_read = read(client_fd, buffer, sizeof(buffer))) > 0) {
-        if (bytes_read > 0) {
-            request_data.append(buffer, static_cast<size_t>(bytes_read));
-        }
-        if (request_data.find("\r\n\r\n") != std::string::npos) break;
-    }
-
-    if (bytes_read < 0) {
-        close(client_fd);
-        return;
+WebUIServer::ServerStats WebUIServer::get_stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    ServerStats stats = stats_;
+    if (server_core_) {
+        stats.active_connections = server_core_->active_connections();
     }
+    return stats;
+}
 
-    // Parse and handle request
+std::string WebUIServer::handle_connection_request(const HttpServerRequest& raw_request) {
     auto start_time = std::chrono::steady_clock::now();
 
-    HTTPRequest request = parse_request(request_data);
-    HTTPResponse response = handle_request(request);
+    HTTPRequest request = parse_request(raw_request);
+    HTTPResponse response;
+    try {
+        response = handle_request(request);
+    } catch (const std::exception& e) {
+        if (logger_) logger_->error("Unhandled exception for " + request.method + " " + request.path + ": " + e.what());
+        response = handle_internal_error(request);
+    }
 
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
@@ -341,79 +197,51 @@ void WebUIServer::handle_client(int client_fd) {
         }
     }
 
-    // Send response
-    std::string response_str = serialize_response(response);
-    write(client_fd, response_str.c_str(), response_str.size());
-
-    close(client_fd);
+    return serialize_response(response, raw_request.keep_alive);
 }
 
-HTTPRequest WebUIServer::parse_request(const std::string& raw_request) {
+HTTPRequest WebUIServer::parse_request(const HttpServerRequest& raw_request) {
     HTTPRequest request;
-    std::istringstream iss(raw_request);
-    std::string line;
-
-    // Parse request line
-    if (std::getline(iss, line)) {
-        std::istringstream line_stream(line);
-        line_stream >> request.method >> request.path >> line; // Skip HTTP version
-
-        // Parse query string
-        size_t query_pos = request.path.find('?');
-        if (query_pos != std::string::npos) {
-            request.query_string = request.path.substr(query_pos + 1);
-            request.path = request.path.substr(0, query_pos);
-            request.params = parse_query_string(request.query_string);
-        }
+    request.method = raw_request.method;
+    request.path = raw_request.target;
+    request.body = raw_request.body;
+
+    // Parse query string
+    size_t query_pos = request.path.find('?');
+    if (query_pos != std::string::npos) {
+        request.query_string = request.path.substr(query_pos + 1);
+        request.path = request.path.substr(0, query_pos);
+        request.params = parse_query_string(request.query_string);
     }
 
-    // Parse headers
-    while (std::getline(iss, line) && !line.empty() && line != "\r") {
-        size_t colon_pos = line.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string header_name = line.substr(0, colon_pos);
-            std::string header_value = line.substr(colon_pos + 1);
-            // Trim whitespace
-            header_name.erase(header_name.find_last_not_of(" \t\r\n") + 1);
-            header_name.erase(0, header_name.find_first_not_of(" \t\r\n"));
-            header_value.erase(header_value.find_last_not_of(" \t\r\n") + 1);
-            header_value.erase(0, header_value.find_first_not_of(" \t\r\n"));
-            request.headers[header_name] = header_value;
-        }
+    for (const auto& [name, value] : raw_request.headers) {
+        request.headers[name] = value;
     }
 
-    // Parse body if present
-    std::getline(iss, request.body, '\0');
-
     return request;
 }
 
 HTTPResponse WebUIServer::handle_request(const HTTPRequest& request) {
-    std::lock_guard<std::mutex> lock(routes_mutex_);
+    // The snapshot keeps the handler alive even if routes change mid-request
+    std::shared_ptr<const RouteTable> table = route_table_.load();
 
     // Check for exact route match
     std::string route_key = request.method + " " + request.path;
-    auto route_it = routes_.find(route_key);
-    if (route_it != routes_.end()) {
+    auto route_it = table->routes.find(route_key);
+    if (route_it != table->routes.end()) {
         return route_it->second(request);
     }
 
     // Check for static file routes
-    for (const auto& [prefix, dir] : static_routes_) {
+    for (const auto& [prefix, dir] : table->static_routes) {
         if (request.path.find(prefix) == 0) {
             return serve_static_file(request.path, dir);
         }
     }
 
     // Check for method not allowed (same path, different method)
-    for (const auto& [key, handler] : routes_) {
-        size_t space_pos = key.find(' ');
-        if (space_pos != std::string::npos) {
-            std::string route_path = key.substr(space_pos + 1);
-            if (route_path == request.path) {
-                return handle_method_not_allowed(request);
-            }
-        }
+    if (table->route_paths.count(request.path) > 0) {
+        return handle_method_not_allowed(request);
     }
 
     return handle_not_found(request);
@@ -441,7 +269,7 @@ HTTPResponse WebUIServer::serve_static_file(const std::string& path, const std::
     return response;
 }
 
-std::string WebUIServer::serialize_response(const HTTPResponse& response) {
+std::string WebUIServer::serialize_response(const HTTPResponse& response, bool keep_alive) {
     std::ostringstream oss;
 
     // Status line
@@ -449,14 +277,16 @@ std::string WebUIServer::serialize_response(const HTTPResponse& response) {
 
     // Headers
     for (const auto& [key, value] : response.headers) {
+        if (key == "Content-Length" || key == "Connection") continue;  // framing is set below
         oss << key << ": " << value << "\r\n";
     }
 
-    // Content headers
+    // Content headers; Content-Length is always sent so keep-alive clients can frame the body
     if (!response.body.empty()) {
         oss << "Content-Type: " << response.content_type << "\r\n";
-        oss << "Content-Length: " << response.body.size() << "\r\n";
     }
+    oss << "Content-Length: " << response.body.size() << "\r\n";
+    oss << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n";
 
     oss << "\r\n" << response.body;
 
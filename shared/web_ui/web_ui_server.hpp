@@ -7,11 +7,12 @@
  *
  * Key Features:
  * - Production-grade HTTP server with proper error handling
+ * - Event-driven I/O with keep-alive and pipelining on a fixed worker pool
  * - REST API endpoints for all system components
  * - HTML dashboards for visual testing
  * - Real-time updates via WebSocket/Server-Sent Events
  * - Security headers and input validation
- * - Thread-safe request handling
+ * - Thread-safe request handling with a lock-free route table
  */
 
 #pragma once
@@ -19,12 +20,15 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <functional>
 #include <thread>
 #include <atomic>
 #include <mutex>
 #include <condition_variable>
 #include "../network/http_client.hpp"
+#include "../network/http_server_core.hpp"
 #include "../logging/structured_logger.hpp"
 
 namespace regulens {
@@ -77,7 +81,9 @@ using RequestHandler = std::function<HTTPResponse(const HTTPRequest&)>;
  * @brief Production-grade web UI server
  *
  * Implements a complete HTTP server for testing all Regulens features
- * with proper threading, security, and error handling.
+ * with proper threading, security, and error handling. Connection handling
+ * is delegated to HttpServerCore; routes are looked up in an immutable
+ * snapshot so handlers never run under a lock.
  */
 class WebUIServer {
 public:
@@ -103,6 +109,10 @@ public:
     void set_logger(std::shared_ptr<StructuredLogger> logger) {
         logger_ = logger;
     }
+    // Takes effect on the next start()
+    void set_server_options(const HttpServerOptions& options) {
+        server_options_ = options;
+    }
 
     // Server statistics
     struct ServerStats {
@@ -117,29 +127,38 @@ private:
     // Server configuration
     int port_;
     std::atomic<bool> running_;
-    std::thread server_thread_;
+    HttpServerOptions server_options_;
+    std::unique_ptr<HttpServerCore> server_core_;
 
     // Components
     std::shared_ptr<ConfigurationManager> config_manager_;
     std::shared_ptr<MetricsCollector> metrics_collector_;
     std::shared_ptr<StructuredLogger> logger_;
 
-    // Route storage
+    // Immutable view of the routes read by request threads
+    struct RouteTable {
+        std::unordered_map<std::string, RequestHandler> routes;            // "METHOD path"
+        std::vector<std::pair<std::string, std::string>> static_routes;    // prefix -> directory
+        std::unordered_set<std::string> route_paths;                       // for 405 detection
+    };
+
+    // Route storage; writers rebuild route_table_ under routes_mutex_
     std::unordered_map<std::string, RequestHandler> routes_;
     std::unordered_map<std::string, std::string> static_routes_;
     mutable std::mutex routes_mutex_;
+    std::atomic<std::shared_ptr<const RouteTable>> route_table_;
 
     // Statistics
     mutable std::mutex stats_mutex_;
     ServerStats stats_;
 
     // Server implementation
-    void server_loop();
-    void handle_client(int client_fd);
+    std::string handle_connection_request(const HttpServerRequest& raw_request);
+    void rebuild_route_table();
     HTTPResponse handle_request(const HTTPRequest& request);
     HTTPResponse serve_static_file(const std::string& path, const std::string& static_dir);
-    HTTPRequest parse_request(const std::string& raw_request);
-    std::string serialize_response(const HTTPResponse& response);
+    HTTPRequest parse_request(const HttpServerRequest& raw_request);
+    std::string serialize_response(const HTTPResponse& response, bool keep_alive);
 
     // Utility methods
     std::string url_decode(const std::string& str);
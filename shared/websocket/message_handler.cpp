@@ -59,57 +59,7 @@ WebSocketMessage MessageHandler::parse_message(const std::string& raw_message) {
 }
 
 std::string MessageHandler::serialize_message(const WebSocketMessage& message) {
-  json j;
-  
-  j["message_id"] = message.message_id;
-  j["sender_id"] = message.sender_id;
-  j["recipient_id"] = message.recipient_id;
-  j["payload"] = message.payload;
-  j["requires_acknowledgment"] = message.requires_acknowledgment;
-  
-  switch (message.type) {
-    case MessageType::CONNECTION_ESTABLISHED:
-      j["type"] = "CONNECTION_ESTABLISHED";
-      break;
-    case MessageType::HEARTBEAT:
-      j["type"] = "HEARTBEAT";
-      break;
-    case MessageType::SUBSCRIBE:
-      j["type"] = "SUBSCRIBE";
-      break;
-    case MessageType::UNSUBSCRIBE:
-      j["type"] = "UNSUBSCRIBE";
-      break;
-    case MessageType::BROADCAST:
-      j["type"] = "BROADCAST";
-      break;
-    case MessageType::DIRECT_MESSAGE:
-      j["type"] = "DIRECT_MESSAGE";
-      break;
-    case MessageType::SESSION_UPDATE:
-      j["type"] = "SESSION_UPDATE";
-      break;
-    case MessageType::RULE_EVALUATION_RESULT:
-      j["type"] = "RULE_EVALUATION_RESULT";
-      break;
-    case MessageType::DECISION_ANALYSIS_RESULT:
-      j["type"] = "DECISION_ANALYSIS_RESULT";
-      break;
-    case MessageType::CONSENSUS_UPDATE:
-      j["type"] = "CONSENSUS_UPDATE";
-      break;
-    case MessageType::LEARNING_FEEDBACK:
-      j["type"] = "LEARNING_FEEDBACK";
-      break;
-    case MessageType::ALERT:
-      j["type"] = "ALERT";
-      break;
-    case MessageType::ERROR:
-      j["type"] = "ERROR";
-      break;
-  }
-  
-  return j.dump();
+  return encode_message(message);
 }
 
 bool MessageHandler::validate_message(const WebSocketMessage& message) {
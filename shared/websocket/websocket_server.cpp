@@ -9,10 +9,43 @@
 #include <uuid/uuid.h>
 #include <algorithm>
 #include <iostream>
+#include <unordered_set>
 
 namespace regulens {
 namespace websocket {
 
+const char* message_type_name(MessageType type) {
+  switch (type) {
+    case MessageType::CONNECTION_ESTABLISHED: return "CONNECTION_ESTABLISHED";
+    case MessageType::HEARTBEAT: return "HEARTBEAT";
+    case MessageType::SUBSCRIBE: return "SUBSCRIBE";
+    case MessageType::UNSUBSCRIBE: return "UNSUBSCRIBE";
+    case MessageType::BROADCAST: return "BROADCAST";
+    case MessageType::DIRECT_MESSAGE: return "DIRECT_MESSAGE";
+    case MessageType::SESSION_UPDATE: return "SESSION_UPDATE";
+    case MessageType::RULE_EVALUATION_RESULT: return "RULE_EVALUATION_RESULT";
+    case MessageType::DECISION_ANALYSIS_RESULT: return "DECISION_ANALYSIS_RESULT";
+    case MessageType::CONSENSUS_UPDATE: return "CONSENSUS_UPDATE";
+    case MessageType::LEARNING_FEEDBACK: return "LEARNING_FEEDBACK";
+    case MessageType::ALERT: return "ALERT";
+    case MessageType::ERROR: return "ERROR";
+  }
+  return "UNKNOWN";
+}
+
+std::string encode_message(const WebSocketMessage& message) {
+  json j;
+  
+  j["message_id"] = message.message_id;
+  j["sender_id"] = message.sender_id;
+  j["recipient_id"] = message.recipient_id;
+  j["payload"] = message.payload;
+  j["requires_acknowledgment"] = message.requires_acknowledgment;
+  j["type"] = message_type_name(message.type);
+  
+  return j.dump();
+}
+
 WebSocketServer::WebSocketServer(int port, int max_connections)
     : port_(port), max_connections_(max_connections) {
   auto logger = logging::get_logger("websocket_server");
@@ -83,6 +116,9 @@ void WebSocketServer::shutdown() {
   
   std::lock_guard<std::mutex> lock(pool_lock_);
   connection_pool_.clear();
+  
+  std::unique_lock<std::shared_mutex> channels_lock(channels_lock_);
+  channel_index_.clear();
 }
 
 std::shared_ptr<WebSocketConnection> WebSocketServer::create_connection(
@@ -115,7 +151,9 @@ bool WebSocketServer::add_connection(std::shared_ptr<WebSocketConnection> connec
   }
   
   connection->state = ConnectionState::CONNECTED;
-  connection_pool_[connection->connection_id] = ConnectionPoolEntry{connection, {}};
+  auto entry = std::make_shared<ConnectionPoolEntry>();
+  entry->connection = connection;
+  connection_pool_[connection->connection_id] = std::move(entry);
   
   logger->info("Connection added: {} for user {}", connection->connection_id, connection->user_id);
   
@@ -136,9 +174,10 @@ bool WebSocketServer::remove_connection(const std::string& connection_id) {
     return false;
   }
   
-  auto connection = it->second.connection;
+  auto connection = it->second->connection;
   connection->state = ConnectionState::DISCONNECTED;
   
+  drop_from_channel_index(connection);
   connection_pool_.erase(it);
   
   logger->info("Connection removed: {}", connection_id);
@@ -156,12 +195,35 @@ std::shared_ptr<WebSocketConnection> WebSocketServer::get_connection(
   
   auto it = connection_pool_.find(connection_id);
   if (it != connection_pool_.end()) {
-    return it->second.connection;
+    return it->second->connection;
   }
   
   return nullptr;
 }
 
+std::shared_ptr<ConnectionPoolEntry> WebSocketServer::get_entry(const std::string& connection_id) {
+  std::lock_guard<std::mutex> lock(pool_lock_);
+  
+  auto it = connection_pool_.find(connection_id);
+  if (it != connection_pool_.end()) {
+    return it->second;
+  }
+  
+  return nullptr;
+}
+
+std::vector<std::shared_ptr<ConnectionPoolEntry>> WebSocketServer::snapshot_entries() {
+  std::vector<std::shared_ptr<ConnectionPoolEntry>> entries;
+  
+  std::lock_guard<std::mutex> lock(pool_lock_);
+  entries.reserve(connection_pool_.size());
+  for (auto& [id, entry] : connection_pool_) {
+    entries.push_back(entry);
+  }
+  
+  return entries;
+}
+
 std::vector<std::shared_ptr<WebSocketConnection>> WebSocketServer::get_user_connections(
     const std::string& user_id) {
   std::vector<std::shared_ptr<WebSocketConnection>> result;
@@ -169,8 +231,8 @@ std::vector<std::shared_ptr<WebSocketConnection>> WebSocketServer::get_user_conn
   std::lock_guard<std::mutex> lock(pool_lock_);
   
   for (auto& [id, entry] : connection_pool_) {
-    if (entry.connection->user_id == user_id) {
-      result.push_back(entry.connection);
+    if (entry->connection->user_id == user_id) {
+      result.push_back(entry->connection);
     }
   }
   
@@ -187,8 +249,8 @@ int WebSocketServer::get_active_connection_count() {
   
   int count = 0;
   for (auto& [id, entry] : connection_pool_) {
-    if (entry.connection->state == ConnectionState::AUTHENTICATED ||
-        entry.connection->state == ConnectionState::CONNECTED) {
+    if (entry->connection->state == ConnectionState::AUTHENTICATED ||
+        entry->connection->state == ConnectionState::CONNECTED) {
       count++;
     }
   }
@@ -227,68 +289,141 @@ void WebSocketServer::handle_message(const WebSocketMessage& message,
 }
 
 void WebSocketServer::broadcast_message(const WebSocketMessage& message) {
-  std::lock_guard<std::mutex> lock(pool_lock_);
+  auto frame = std::make_shared<const std::string>(encode_message(message));
+  std::string coalesce_key = coalesce_key_for(message.type, "");
   
-  for (auto& [id, entry] : connection_pool_) {
-    if (entry.connection->state == ConnectionState::AUTHENTICATED) {
-      entry.queue_lock.lock();
-      entry.message_queue.push(message);
-      entry.queue_lock.unlock();
+  // Enqueue outside pool_lock_ so connects and disconnects are not held up by fan-out
+  for (auto& entry : snapshot_entries()) {
+    if (entry->connection->state == ConnectionState::AUTHENTICATED) {
+      enqueue_frame(*entry, frame, coalesce_key);
     }
   }
 }
 
 void WebSocketServer::send_to_connection(const std::string& connection_id,
                                         const WebSocketMessage& message) {
-  auto connection = get_connection(connection_id);
-  if (!connection) {
+  auto entry = get_entry(connection_id);
+  if (!entry) {
     return;
   }
   
-  auto it = connection_pool_.find(connection_id);
-  if (it != connection_pool_.end()) {
-    it->second.queue_lock.lock();
-    it->second.message_queue.push(message);
-    it->second.queue_lock.unlock();
-  }
+  enqueue_frame(*entry, std::make_shared<const std::string>(encode_message(message)), "");
 }
 
 void WebSocketServer::send_to_user(const std::string& user_id,
                                    const WebSocketMessage& message) {
   auto connections = get_user_connections(user_id);
+  if (connections.empty()) {
+    return;
+  }
   
+  auto frame = std::make_shared<const std::string>(encode_message(message));
   for (auto& connection : connections) {
-    send_to_connection(connection->connection_id, message);
+    if (auto entry = get_entry(connection->connection_id)) {
+      enqueue_frame(*entry, frame, "");
+    }
   }
 }
 
 void WebSocketServer::send_to_subscriptions(const std::vector<std::string>& subscriptions,
                                            const WebSocketMessage& message) {
-  std::lock_guard<std::mutex> lock(pool_lock_);
+  struct Recipient {
+    std::shared_ptr<ConnectionPoolEntry> entry;
+    const std::string* channel;
+  };
+  std::vector<Recipient> recipients;
   
-  for (auto& [id, entry] : connection_pool_) {
-    auto& conn_subs = entry.connection->subscriptions;
+  {
+    std::shared_lock<std::shared_mutex> lock(channels_lock_);
     
-    for (const auto& sub : subscriptions) {
-      if (std::find(conn_subs.begin(), conn_subs.end(), sub) != conn_subs.end()) {
-        entry.queue_lock.lock();
-        entry.message_queue.push(message);
-        entry.queue_lock.unlock();
-        break;
+    // A connection following several of the channels still gets the message once
+    std::unordered_set<const ConnectionPoolEntry*> seen;
+    for (const auto& channel : subscriptions) {
+      auto it = channel_index_.find(channel);
+      if (it == channel_index_.end()) {
+        continue;
+      }
+      for (auto& [id, entry] : it->second) {
+        if (subscriptions.size() == 1 || seen.insert(entry.get()).second) {
+          recipients.push_back({entry, &channel});
+        }
       }
     }
   }
+  
+  if (recipients.empty()) {
+    return;
+  }
+  
+  auto frame = std::make_shared<const std::string>(encode_message(message));
+  for (auto& recipient : recipients) {
+    enqueue_frame(*recipient.entry, frame, coalesce_key_for(message.type, *recipient.channel));
+  }
+}
+
+std::string WebSocketServer::coalesce_key_for(MessageType type, const std::string& scope) const {
+  // Events and deltas must all be delivered; only full states may supersede each other
+  if (state_snapshot_types_.count(type) == 0) {
+    return "";
+  }
+  return scope + ":" + message_type_name(type);
+}
+
+void WebSocketServer::enqueue_frame(ConnectionPoolEntry& entry, const Frame& frame,
+                                    const std::string& coalesce_key) {
+  bool dropped = false;
+  bool coalesced = false;
+  
+  {
+    std::lock_guard<std::mutex> lock(entry.queue_lock);
+    auto& queue = entry.message_queue;
+    
+    if (queue.size() >= static_cast<size_t>(std::max(1, message_queue_size_))) {
+      if (slow_consumer_policy_ == SlowConsumerPolicy::COALESCE && !coalesce_key.empty()) {
+        // The consumer is behind: a newer frame for the same key supersedes the queued one
+        for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+          if (it->coalesce_key == coalesce_key) {
+            it->frame = frame;
+            coalesced = true;
+            break;
+          }
+        }
+      }
+      
+      if (!coalesced) {
+        dropped = true;
+        entry.connection->messages_dropped++;
+        if (slow_consumer_policy_ != SlowConsumerPolicy::DROP_NEWEST) {
+          queue.pop_front();
+          queue.push_back({frame, coalesce_key});
+        }
+      }
+    } else {
+      queue.push_back({frame, coalesce_key});
+    }
+  }
+  
+  if (dropped || coalesced) {
+    std::lock_guard<std::mutex> stats_lock(stats_lock_);
+    if (dropped) total_messages_dropped_++;
+    if (coalesced) total_messages_coalesced_++;
+  }
 }
 
 bool WebSocketServer::subscribe(const std::string& connection_id, const std::string& channel) {
-  auto connection = get_connection(connection_id);
-  if (!connection) {
+  std::lock_guard<std::mutex> lock(pool_lock_);
+  
+  auto it = connection_pool_.find(connection_id);
+  if (it == connection_pool_.end()) {
     return false;
   }
   
-  auto& subs = connection->subscriptions;
+  std::unique_lock<std::shared_mutex> channels_lock(channels_lock_);
+  
+  auto& subs = it->second->connection->subscriptions;
   if (std::find(subs.begin(), subs.end(), channel) == subs.end()) {
     subs.push_back(channel);
+    channel_index_[channel][connection_id] = it->second;
   }
   
   return true;
@@ -300,26 +435,51 @@ bool WebSocketServer::unsubscribe(const std::string& connection_id, const std::s
     return false;
   }
   
+  std::unique_lock<std::shared_mutex> lock(channels_lock_);
+  
   auto& subs = connection->subscriptions;
   auto it = std::find(subs.begin(), subs.end(), channel);
-  if (it != subs.end()) {
-    subs.erase(it);
-    return true;
+  if (it == subs.end()) {
+    return false;
+  }
+  subs.erase(it);
+  
+  auto channel_it = channel_index_.find(channel);
+  if (channel_it != channel_index_.end()) {
+    channel_it->second.erase(connection_id);
+    if (channel_it->second.empty()) {
+      channel_index_.erase(channel_it);
+    }
   }
   
-  return false;
+  return true;
+}
+
+void WebSocketServer::drop_from_channel_index(const std::shared_ptr<WebSocketConnection>& connection) {
+  std::unique_lock<std::shared_mutex> lock(channels_lock_);
+  
+  for (const auto& channel : connection->subscriptions) {
+    auto it = channel_index_.find(channel);
+    if (it != channel_index_.end()) {
+      it->second.erase(connection->connection_id);
+      if (it->second.empty()) {
+        channel_index_.erase(it);
+      }
+    }
+  }
 }
 
 std::vector<std::shared_ptr<WebSocketConnection>> WebSocketServer::get_subscribers(
     const std::string& channel) {
   std::vector<std::shared_ptr<WebSocketConnection>> result;
   
-  std::lock_guard<std::mutex> lock(pool_lock_);
+  std::shared_lock<std::shared_mutex> lock(channels_lock_);
   
-  for (auto& [id, entry] : connection_pool_) {
-    auto& subs = entry.connection->subscriptions;
-    if (std::find(subs.begin(), subs.end(), channel) != subs.end()) {
-      result.push_back(entry.connection);
+  auto it = channel_index_.find(channel);
+  if (it != channel_index_.end()) {
+    result.reserve(it->second.size());
+    for (auto& [id, entry] : it->second) {
+      result.push_back(entry->connection);
     }
   }
   
@@ -398,9 +558,16 @@ WebSocketServer::ServerStats WebSocketServer::get_stats() {
   stats.authenticated_connections = 0;
   stats.total_messages_processed = total_messages_processed_;
   stats.total_messages_sent = total_messages_sent_;
+  stats.total_messages_dropped = total_messages_dropped_;
+  stats.total_messages_coalesced = total_messages_coalesced_;
+  
+  {
+    std::shared_lock<std::shared_mutex> channels_lock(channels_lock_);
+    stats.subscribed_channels = static_cast<int>(channel_index_.size());
+  }
   
   for (auto& [id, entry] : connection_pool_) {
-    if (entry.connection->state == ConnectionState::AUTHENTICATED) {
+    if (entry->connection->state == ConnectionState::AUTHENTICATED) {
       stats.authenticated_connections++;
     }
   }
@@ -427,6 +594,14 @@ void WebSocketServer::set_connection_timeout(int seconds) {
   connection_timeout_seconds_ = seconds;
 }
 
+void WebSocketServer::set_slow_consumer_policy(SlowConsumerPolicy policy) {
+  slow_consumer_policy_ = policy;
+}
+
+void WebSocketServer::set_state_snapshot_types(std::unordered_set<MessageType> types) {
+  state_snapshot_types_ = std::move(types);
+}
+
 void WebSocketServer::heartbeat_loop() {
   auto logger = logging::get_logger("websocket_server");
   
@@ -445,24 +620,30 @@ void WebSocketServer::heartbeat_loop() {
 void WebSocketServer::message_processing_loop() {
   auto logger = logging::get_logger("websocket_server");
   
+  std::deque<QueuedFrame> pending;
   while (processor_running_) {
     std::this_thread::sleep_for(std::chrono::milliseconds(100));
     
-    std::lock_guard<std::mutex> lock(pool_lock_);
-    
-    for (auto& [id, entry] : connection_pool_) {
-      entry.queue_lock.lock();
-      while (!entry.message_queue.empty()) {
-        auto msg = entry.message_queue.front();
-        entry.message_queue.pop();
-        entry.connection->messages_sent++;
-        
-        {
-          std::lock_guard<std::mutex> stats_lock(stats_lock_);
-          total_messages_sent_++;
+    uint64_t sent = 0;
+    for (auto& entry : snapshot_entries()) {
+      {
+        std::lock_guard<std::mutex> lock(entry->queue_lock);
+        pending.swap(entry->message_queue);
+      }
+      
+      // Written without holding any lock, so a slow socket only backs up its own queue
+      for (auto& queued : pending) {
+        if (!frame_sender || frame_sender(entry->connection, *queued.frame)) {
+          entry->connection->messages_sent++;
+          sent++;
         }
       }
-      entry.queue_lock.unlock();
+      pending.clear();
+    }
+    
+    if (sent > 0) {
+      std::lock_guard<std::mutex> stats_lock(stats_lock_);
+      total_messages_sent_ += sent;
     }
   }
   
@@ -486,10 +667,17 @@ void WebSocketServer::cleanup_dead_connections() {
   
   std::lock_guard<std::mutex> lock(pool_lock_);
   
+  auto now = std::chrono::system_clock::now();
   auto it = connection_pool_.begin();
   while (it != connection_pool_.end()) {
-    if (!is_connection_alive(it->first)) {
+    auto& connection = it->second->connection;
+    auto idle = std::chrono::duration_cast<std::chrono::seconds>(
+        now - connection->last_heartbeat).count();
+    
+    if (idle >= connection_timeout_seconds_) {
       logger->info("Removing inactive connection: {}", it->first);
+      connection->state = ConnectionState::DISCONNECTED;
+      drop_from_channel_index(connection);
       it = connection_pool_.erase(it);
     } else {
       ++it;
@@ -11,9 +11,12 @@
 #include <memory>
 #include <functional>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <condition_variable>
 #include <chrono>
 #include <nlohmann/json.hpp>
@@ -61,6 +64,7 @@ struct WebSocketConnection {
   int failed_pings = 0;
   uint64_t messages_sent = 0;
   uint64_t messages_received = 0;
+  uint64_t messages_dropped = 0;  // Shed by the slow consumer policy
 };
 
 // Real-time message structure
@@ -75,10 +79,30 @@ struct WebSocketMessage {
   std::string acknowledgment_id;
 };
 
+// Wire encoding of a message (JSON text)
+std::string encode_message(const WebSocketMessage& message);
+const char* message_type_name(MessageType type);
+
+// Encoded message, serialized once and shared by every recipient queue
+using Frame = std::shared_ptr<const std::string>;
+
+struct QueuedFrame {
+  Frame frame;
+  std::string coalesce_key;  // Empty = never coalesced
+};
+
+// What to do when a connection's queue is full
+enum class SlowConsumerPolicy {
+  DROP_OLDEST,  // Evict the oldest queued frame
+  DROP_NEWEST,  // Discard the incoming frame
+  COALESCE      // Replace a queued frame with the same key, else drop oldest; only applies
+                // to message types marked with set_state_snapshot_types()
+};
+
 // Connection pool entry
 struct ConnectionPoolEntry {
   std::shared_ptr<WebSocketConnection> connection;
-  std::queue<WebSocketMessage> message_queue;
+  std::deque<QueuedFrame> message_queue;  // Bounded by message_queue_size
   std::mutex queue_lock;
 };
 
@@ -89,6 +113,8 @@ using MessageHandler = std::function<void(const WebSocketMessage&, const std::sh
 using OnConnectHandler = std::function<void(const std::shared_ptr<WebSocketConnection>&)>;
 using OnDisconnectHandler = std::function<void(const std::shared_ptr<WebSocketConnection>&)>;
 using OnErrorHandler = std::function<void(const std::string&, const std::string&)>;
+// Writes one frame to the connection's socket; false counts as a failed send
+using FrameSender = std::function<bool(const std::shared_ptr<WebSocketConnection>&, const std::string&)>;
 
 class WebSocketServer {
 public:
@@ -118,6 +144,7 @@ public:
   void handle_message(const WebSocketMessage& message, const std::string& connection_id);
   
   // Broadcasting and messaging
+  // Each message is encoded once and the frame is shared by all recipients
   void broadcast_message(const WebSocketMessage& message);
   void send_to_connection(const std::string& connection_id, const WebSocketMessage& message);
   void send_to_user(const std::string& user_id, const WebSocketMessage& message);
@@ -146,6 +173,9 @@ public:
     int authenticated_connections;
     uint64_t total_messages_processed;
     uint64_t total_messages_sent;
+    uint64_t total_messages_dropped;
+    uint64_t total_messages_coalesced;
+    int subscribed_channels;
     double average_latency_ms;
     std::chrono::system_clock::time_point uptime;
   };
@@ -156,11 +186,16 @@ public:
   void set_message_queue_size(int size);
   void set_max_message_size(int bytes);
   void set_connection_timeout(int seconds);
+  void set_slow_consumer_policy(SlowConsumerPolicy policy);
+  // Types whose every message is a complete state, so a newer one may replace
+  // a queued one under COALESCE. Configure before start().
+  void set_state_snapshot_types(std::unordered_set<MessageType> types);
   
   // Event handlers
   void on_connect(OnConnectHandler handler) { connect_handler = handler; }
   void on_disconnect(OnDisconnectHandler handler) { disconnect_handler = handler; }
   void on_error(OnErrorHandler handler) { error_handler = handler; }
+  void on_send(FrameSender sender) { frame_sender = sender; }
 
 private:
   int port_;
@@ -168,8 +203,13 @@ private:
   bool is_running_ = false;
   
   // Connection pool
-  std::map<std::string, ConnectionPoolEntry> connection_pool_;
+  std::map<std::string, std::shared_ptr<ConnectionPoolEntry>> connection_pool_;
   std::mutex pool_lock_;
+
+  // Channel -> subscribed connections, so fan-out only visits subscribers.
+  // Also guards WebSocketConnection::subscriptions. Taken after pool_lock_, never before.
+  std::unordered_map<std::string, std::unordered_map<std::string, std::shared_ptr<ConnectionPoolEntry>>> channel_index_;
+  std::shared_mutex channels_lock_;
   
   // Message handlers
   std::map<MessageType, MessageHandler> message_handlers_;
@@ -179,6 +219,7 @@ private:
   OnConnectHandler connect_handler;
   OnDisconnectHandler disconnect_handler;
   OnErrorHandler error_handler;
+  FrameSender frame_sender;
   
   // Heartbeat management
   std::thread heartbeat_thread_;
@@ -191,6 +232,8 @@ private:
   std::thread message_processor_thread_;
   bool processor_running_ = false;
   int message_queue_size_ = 1000;
+  SlowConsumerPolicy slow_consumer_policy_ = SlowConsumerPolicy::DROP_OLDEST;
+  std::unordered_set<MessageType> state_snapshot_types_;
   int max_message_size_ = 1048576;  // 1MB
   
   // Connection timeout
@@ -201,6 +244,8 @@ private:
   // Statistics
   uint64_t total_messages_processed_ = 0;
   uint64_t total_messages_sent_ = 0;
+  uint64_t total_messages_dropped_ = 0;
+  uint64_t total_messages_coalesced_ = 0;
   std::mutex stats_lock_;
   
   // Internal methods
@@ -208,6 +253,11 @@ private:
   void message_processing_loop();
   void timeout_monitoring_loop();
   void cleanup_dead_connections();
+  std::shared_ptr<ConnectionPoolEntry> get_entry(const std::string& connection_id);
+  std::vector<std::shared_ptr<ConnectionPoolEntry>> snapshot_entries();
+  void enqueue_frame(ConnectionPoolEntry& entry, const Frame& frame, const std::string& coalesce_key);
+  std::string coalesce_key_for(MessageType type, const std::string& scope) const;
+  void drop_from_channel_index(const std::shared_ptr<WebSocketConnection>& connection);
   std::string generate_connection_id();
   bool validate_message(const WebSocketMessage& message);
 };
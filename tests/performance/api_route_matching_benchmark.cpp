@@ -0,0 +1,160 @@
+/**
+ * API Route Matching Benchmark
+ *
+ * Registers the real endpoint set (register_all_api_endpoints) and times
+ * APIRegistry::find_handler against the previous per-endpoint regex matcher
+ * for concrete request paths. No database is needed; handlers are never run.
+ *
+ * Usage: api_route_matching_benchmark [iterations]
+ */
+
+#include "../../shared/api_registry/api_registry.hpp"
+#include "../../shared/api_registry/api_endpoint_registrations.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace regulens;
+
+namespace {
+
+struct Probe {
+    std::string method;
+    std::string path;
+    std::string pattern;  // expected match, empty for a deliberate miss
+};
+
+// The matcher APIRegistry used before the route trie: one regex per endpoint per lookup
+bool regex_match_path(const std::string& pattern, const std::string& path) {
+    std::string regex_pattern = pattern;
+    std::regex param_regex("\\{([^}]+)\\}");
+    regex_pattern = std::regex_replace(regex_pattern, param_regex, "([^/]+)");
+    regex_pattern = std::regex_replace(regex_pattern, std::regex("\\."), "\\.");
+    std::regex compiled_pattern("^" + regex_pattern + "$");
+    std::smatch matches;
+    return std::regex_match(path, matches, compiled_pattern);
+}
+
+const APIEndpoint* regex_find(const std::unordered_map<std::string, std::vector<APIEndpoint>>& by_method,
+                              const std::unordered_map<std::string, const APIEndpoint*>& exact,
+                              const std::string& method, const std::string& path) {
+    auto exact_it = exact.find(method + ":" + path);
+    if (exact_it != exact.end()) {
+        return exact_it->second;
+    }
+    auto method_it = by_method.find(method);
+    if (method_it != by_method.end()) {
+        for (const auto& endpoint : method_it->second) {
+            if (regex_match_path(endpoint.path, path)) {
+                return &endpoint;
+            }
+        }
+    }
+    return nullptr;
+}
+
+std::string concrete_path(const std::string& pattern, size_t seed) {
+    std::string path;
+    size_t pos = 0;
+    while (pos < pattern.size()) {
+        size_t open = pattern.find('{', pos);
+        if (open == std::string::npos) {
+            path += pattern.substr(pos);
+            break;
+        }
+        size_t close = pattern.find('}', open);
+        path += pattern.substr(pos, open - pos);
+        path += "a1b2c3d4-" + std::to_string(seed);
+        pos = close + 1;
+    }
+    return path;
+}
+
+template <typename Fn>
+double time_ns_per_lookup(const std::vector<Probe>& probes, size_t iterations, Fn&& lookup) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (const auto& probe : probes) {
+            lookup(probe);
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / static_cast<double>(iterations * probes.size());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20;
+    if (iterations == 0) {
+        std::cerr << "usage: " << argv[0] << " [iterations]" << std::endl;
+        return 1;
+    }
+
+    auto& registry = APIRegistry::get_instance();
+    register_all_api_endpoints(nullptr);
+    std::vector<APIEndpoint> endpoints = registry.get_all_endpoints();
+
+    std::unordered_map<std::string, std::vector<APIEndpoint>> by_method;
+    for (const auto& endpoint : endpoints) {
+        by_method[endpoint.method].push_back(endpoint);
+    }
+    std::unordered_map<std::string, const APIEndpoint*> exact;
+    for (const auto& [method, list] : by_method) {
+        for (const auto& endpoint : list) {
+            exact[method + ":" + endpoint.path] = &endpoint;
+        }
+    }
+
+    // Parameterized requests are the ones that used to miss the exact lookup
+    std::vector<Probe> probes;
+    size_t parameterized = 0;
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        const auto& endpoint = endpoints[i];
+        if (endpoint.path.find('{') != std::string::npos) {
+            probes.push_back({endpoint.method, concrete_path(endpoint.path, i), endpoint.path});
+            ++parameterized;
+        }
+    }
+    probes.push_back({"GET", "/api/does/not/exist", ""});
+    probes.push_back({"DELETE", "/transactions/unknown/extra/segments", ""});
+
+    std::cout << "endpoints=" << endpoints.size() << " parameterized=" << parameterized
+              << " probes=" << probes.size() << " iterations=" << iterations << std::endl;
+
+    // Both matchers must resolve each probe to an endpoint with the same method and pattern shape
+    size_t disagreements = 0;
+    for (const auto& probe : probes) {
+        const APIEndpoint* old_match = regex_find(by_method, exact, probe.method, probe.path);
+        auto new_match = registry.find_handler(probe.method, probe.path);
+        bool old_found = old_match != nullptr;
+        bool new_found = new_match.has_value();
+        if (old_found != new_found || (probe.pattern.empty() && new_found)) {
+            ++disagreements;
+            std::cerr << "mismatch: " << probe.method << " " << probe.path << std::endl;
+        }
+    }
+
+    size_t sink = 0;
+    double regex_ns = time_ns_per_lookup(probes, iterations, [&](const Probe& probe) {
+        sink += regex_find(by_method, exact, probe.method, probe.path) != nullptr;
+    });
+    double trie_ns = time_ns_per_lookup(probes, iterations * 50, [&](const Probe& probe) {
+        std::unordered_map<std::string, std::string> params;
+        sink += registry.find_handler(probe.method, probe.path, params).has_value();
+    });
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "  regex per endpoint  " << std::setw(12) << regex_ns << " ns/lookup" << std::endl
+              << "  route trie          " << std::setw(12) << trie_ns << " ns/lookup" << std::endl
+              << std::setprecision(1)
+              << "  speedup             " << std::setw(12) << regex_ns / trie_ns << "x" << std::endl
+              << "  disagreements       " << std::setw(12) << disagreements << std::endl;
+
+    return sink == 0 || disagreements > 0 ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * PostgreSQL Pipeline Benchmark
+ *
+ * Compares one-round-trip-per-statement writes against pipelined
+ * execute_batch() for the audit-trail and ingestion write shapes.
+ * Requires a reachable PostgreSQL; connection settings come from the
+ * usual DB_HOST / DB_PORT / DB_NAME / DB_USER / DB_PASSWORD variables.
+ *
+ * Usage: postgresql_pipeline_benchmark [rows] [batch_size]
+ */
+
+#include "../../shared/database/postgresql_connection.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace regulens;
+
+namespace {
+
+std::string env_or(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? value : fallback;
+}
+
+struct Workload {
+    std::string name;
+    std::string table;
+    std::string create_sql;
+    std::string insert_sql;
+    std::function<std::vector<std::string>(size_t)> params_for;
+};
+
+std::vector<Workload> workloads() {
+    return {
+        {
+            "audit trail (decision_steps)",
+            "bench_decision_steps",
+            "CREATE TABLE bench_decision_steps ("
+            " step_id TEXT PRIMARY KEY, decision_id TEXT, event_type INT, description TEXT,"
+            " input_data JSONB, output_data JSONB, metadata JSONB, processing_time_us BIGINT,"
+            " confidence_impact DOUBLE PRECISION, timestamp BIGINT, agent_id TEXT)",
+            "INSERT INTO bench_decision_steps (step_id, decision_id, event_type, description,"
+            " input_data, output_data, metadata, processing_time_us, confidence_impact, timestamp, agent_id)"
+            " VALUES ($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11)",
+            [](size_t i) {
+                return std::vector<std::string>{
+                    "step-" + std::to_string(i), "decision-" + std::to_string(i / 8), std::to_string(i % 6),
+                    "Evaluated compliance rule set", R"({"amount": 1250.5, "currency": "EUR"})",
+                    R"({"score": 0.42})", R"({"source": "benchmark"})", std::to_string(120 + i % 50),
+                    "0.05", std::to_string(1700000000 + i), "agent-7"
+                };
+            }
+        },
+        {
+            "ingestion (data_records upsert)",
+            "bench_data_records",
+            "CREATE TABLE bench_data_records ("
+            " record_id TEXT PRIMARY KEY, source_id TEXT, quality_score INT, data_content JSONB)",
+            "INSERT INTO bench_data_records (record_id, source_id, quality_score, data_content)"
+            " VALUES ($1, $2, $3, $4::jsonb)"
+            " ON CONFLICT (record_id) DO UPDATE SET data_content = EXCLUDED.data_content",
+            [](size_t i) {
+                return std::vector<std::string>{
+                    "record-" + std::to_string(i), "source-" + std::to_string(i % 4), "3",
+                    R"({"field_a": "value", "field_b": 42, "nested": {"k": [1, 2, 3]}})"
+                };
+            }
+        }
+    };
+}
+
+double run_sequential(PostgreSQLConnection& db, const Workload& workload, size_t rows) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < rows; ++i) {
+        db.execute_command(workload.insert_sql, workload.params_for(i));
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double run_pipelined(PostgreSQLConnection& db, const Workload& workload, size_t rows,
+                     size_t batch_size, BatchMode mode) {
+    auto start = std::chrono::steady_clock::now();
+    StatementBatch batch;
+    for (size_t i = 0; i < rows; ++i) {
+        batch.add(workload.insert_sql, workload.params_for(i));
+        if (batch.size() == batch_size || i + 1 == rows) {
+            db.execute_batch(batch, mode);
+            batch.clear();
+        }
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const std::string& label, size_t rows, double seconds, double baseline) {
+    std::cout << "  " << std::left << std::setw(28) << label
+              << std::right << std::setw(10) << std::fixed << std::setprecision(0) << static_cast<double>(rows) / seconds << " rows/s"
+              << std::setw(9) << std::setprecision(2) << baseline / seconds << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    size_t batch_size = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+    if (rows == 0 || batch_size == 0) {
+        std::cerr << "usage: " << argv[0] << " [rows] [batch_size]" << std::endl;
+        return 1;
+    }
+
+    DatabaseConfig config;
+    config.host = env_or("DB_HOST", "localhost");
+    config.port = std::atoi(env_or("DB_PORT", "5432").c_str());
+    config.database = env_or("DB_NAME", "regulens_compliance");
+    config.user = env_or("DB_USER", "regulens_user");
+    config.password = env_or("DB_PASSWORD", "");
+    config.ssl_mode = env_or("DB_SSL_MODE", "false") == "true";
+    config.connections_per_instance = 1;
+
+    PostgreSQLConnection db(config);
+    if (!db.connect()) {
+        std::cerr << "Could not connect to PostgreSQL at " << config.host << ":" << config.port << std::endl;
+        return 1;
+    }
+
+    std::cout << "rows=" << rows << " batch_size=" << batch_size << std::endl;
+
+    for (const auto& workload : workloads()) {
+        auto reset_table = [&]() {
+            db.execute_command("DROP TABLE IF EXISTS " + workload.table);
+            db.execute_command(workload.create_sql);
+        };
+
+        std::cout << workload.name << std::endl;
+
+        reset_table();
+        double sequential = run_sequential(db, workload, rows);
+        report("sequential (autocommit)", rows, sequential, sequential);
+
+        reset_table();
+        db.begin_transaction();
+        double sequential_tx = run_sequential(db, workload, rows);
+        db.commit_transaction();
+        report("sequential (one tx)", rows, sequential_tx, sequential);
+
+        reset_table();
+        report("pipelined INDEPENDENT", rows,
+               run_pipelined(db, workload, rows, batch_size, BatchMode::INDEPENDENT), sequential);
+
+        reset_table();
+        report("pipelined ATOMIC", rows,
+               run_pipelined(db, workload, rows, batch_size, BatchMode::ATOMIC), sequential);
+
+        db.execute_command("DROP TABLE IF EXISTS " + workload.table);
+    }
+
+    db.disconnect();
+    return 0;
+}
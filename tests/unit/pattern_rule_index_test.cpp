@@ -0,0 +1,71 @@
+/**
+ * PatternRuleIndex Unit Tests
+ *
+ * The literal prefilter may only skip a regex when no match is possible, so
+ * every extracted literal is checked against strings the regex matches.
+ */
+
+#include <gtest/gtest.h>
+#include <regex>
+#include <string>
+#include <vector>
+#include "../../shared/rules/pattern_rule_index.hpp"
+
+namespace regulens::tests {
+
+namespace {
+
+struct LiteralCase {
+    std::string regex;
+    std::string required;   // expected required_literal
+    std::string matching;   // a string the regex matches in full
+};
+
+} // namespace
+
+TEST(PatternRuleIndexTest, RequiredLiteralOfPlainSequences) {
+    EXPECT_EQ(PatternRuleIndex::required_literal("wire transfer"), "wire transfer");
+    EXPECT_EQ(PatternRuleIndex::required_literal(".*OFAC.*"), "OFAC");
+    EXPECT_EQ(PatternRuleIndex::required_literal("ab[0-9]+cdef"), "cdef");
+    EXPECT_EQ(PatternRuleIndex::required_literal("abc?def"), "def");
+    EXPECT_EQ(PatternRuleIndex::required_literal("x+yz"), "yz");
+    EXPECT_EQ(PatternRuleIndex::required_literal("\\.exe$"), ".exe");
+}
+
+TEST(PatternRuleIndexTest, NoRequiredLiteralWhenUnprovable) {
+    EXPECT_EQ(PatternRuleIndex::required_literal("cash|wire"), "");
+    EXPECT_EQ(PatternRuleIndex::required_literal("[A-Z]{3}\\d+"), "");
+    EXPECT_EQ(PatternRuleIndex::required_literal("(abc)?"), "");
+    EXPECT_EQ(PatternRuleIndex::required_literal(""), "");
+}
+
+TEST(PatternRuleIndexTest, RequiredLiteralDecodesEscapes) {
+    const std::vector<LiteralCase> cases = {
+        {"\\x41BC", "ABC", "ABC"},
+        {".*\\x2d\\x2dref", "--ref", "id--ref"},
+        {"\\u0041BC", "ABC", "ABC"},
+        {"pay\\u002dout", "pay-out", "pay-out"},
+        {"a\\tb\\fc\\vd", "a\tb\fc\vd", "a\tb\fc\vd"},
+        {"\\x41+BC", "BC", "AAABC"},
+        {"(a)\\1bc", "bc", "aabc"},
+        {"x\\dy\\wzz", "zz", "x1yazz"},
+        {"\\bIBAN\\b.*", "IBAN", "IBAN DE00"},
+        {"\\0abc", "abc", std::string("\0abc", 4)},
+    };
+    for (const auto& c : cases) {
+        EXPECT_EQ(PatternRuleIndex::required_literal(c.regex), c.required) << c.regex;
+        ASSERT_TRUE(std::regex_match(c.matching, std::regex(c.regex))) << c.regex;
+        EXPECT_NE(c.matching.find(c.required), std::string::npos) << c.regex;
+    }
+}
+
+TEST(PatternRuleIndexTest, UncertainEscapesEndTheLiteral) {
+    // Which bytes é matches depends on the regex's encoding, so it cannot be required
+    EXPECT_EQ(PatternRuleIndex::required_literal("caf\\u00e9s"), "caf");
+    // Control escapes match differently across regex engines
+    EXPECT_EQ(PatternRuleIndex::required_literal("\\cJend"), "end");
+    // A truncated escape is not a literal, and what follows is not swallowed into one
+    EXPECT_EQ(PatternRuleIndex::required_literal("ab\\x4"), "ab");
+}
+
+} // namespace regulens::tests
@@ -0,0 +1,240 @@
+/**
+ * PIIScanner Unit Tests
+ *
+ * Checks the compiled scanner against the default DataEncryptionEngine
+ * patterns and against std::regex, which it replaces on the masking path.
+ */
+
+#include <gtest/gtest.h>
+#include <regex>
+#include <string>
+#include <vector>
+#include "../../shared/security/pii_scanner.hpp"
+
+namespace regulens::tests {
+
+using security::PIIMaskingPattern;
+using security::PIIMatch;
+using security::PIIScanner;
+using security::PIIType;
+
+namespace {
+
+// Same patterns DataEncryptionEngine registers by default, in PIIType order
+std::vector<PIIMaskingPattern> default_patterns() {
+    return {
+        {PIIType::SSN, R"(\b\d{3}-\d{2}-\d{4}\b)", "***-**-####", 4},
+        {PIIType::EMAIL, R"(\b[A-Za-z0-9._%+-]+@[A-Za-z0-9.-]+\.[A-Z|a-z]{2,}\b)", "***@***.com", 2},
+        {PIIType::PHONE, R"(\b(?:\+?1[-.\s]?)?\(?[0-9]{3}\)?[-.\s]?[0-9]{3}[-.\s]?[0-9]{4}\b)", "***-***-****", 4},
+    };
+}
+
+// The masking the scanner replaced: one std::regex_replace per pattern, in order
+std::string regex_mask(const std::vector<PIIMaskingPattern>& patterns, const std::string& text) {
+    std::string masked = text;
+    for (const auto& pattern : patterns) {
+        masked = std::regex_replace(masked, std::regex(pattern.regex_pattern), pattern.mask_format);
+    }
+    return masked;
+}
+
+std::string matched_text(const std::string& text, const PIIMatch& match) {
+    return text.substr(match.begin, match.end - match.begin);
+}
+
+} // namespace
+
+class PIIScannerTest : public ::testing::Test {
+protected:
+    PIIScanner scanner{default_patterns()};
+};
+
+TEST_F(PIIScannerTest, CompilesEveryDefaultPattern) {
+    EXPECT_EQ(scanner.compiled_pattern_count(), 3u);
+    EXPECT_EQ(scanner.fallback_pattern_count(), 0u);
+    EXPECT_TRUE(scanner.compile_errors().empty());
+}
+
+TEST_F(PIIScannerTest, MasksSSN) {
+    std::string text = "customer ssn 123-45-6789, verified";
+    auto matches = scanner.scan(text);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].pii_type, PIIType::SSN);
+    EXPECT_EQ(matched_text(text, matches[0]), "123-45-6789");
+    EXPECT_EQ(scanner.mask(text), "customer ssn ***-**-####, verified");
+    EXPECT_TRUE(scanner.contains(text, PIIType::SSN));
+    EXPECT_FALSE(scanner.contains(text, PIIType::EMAIL));
+}
+
+TEST_F(PIIScannerTest, MasksEmail) {
+    std::string text = "send to jane.doe+kyc@mail.example.co.uk now";
+    auto matches = scanner.scan(text);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].pii_type, PIIType::EMAIL);
+    EXPECT_EQ(matched_text(text, matches[0]), "jane.doe+kyc@mail.example.co.uk");
+    EXPECT_EQ(scanner.mask(text), "send to ***@***.com now");
+
+    EXPECT_TRUE(scanner.scan("user@example.c").empty());  // one-letter TLD
+    EXPECT_TRUE(scanner.scan("user@example").empty());
+    EXPECT_TRUE(scanner.scan("@example.com").empty());
+}
+
+TEST_F(PIIScannerTest, MasksPhoneFormats) {
+    const std::vector<std::string> phones = {
+        "555-123-4567", "555.123.4567", "555 123 4567", "5551234567", "1-555-123-4567",
+    };
+    for (const auto& phone : phones) {
+        std::string text = "call " + phone + " today";
+        auto matches = scanner.scan(text);
+        ASSERT_EQ(matches.size(), 1u) << phone;
+        EXPECT_EQ(matches[0].pii_type, PIIType::PHONE) << phone;
+        EXPECT_EQ(matched_text(text, matches[0]), phone);
+        EXPECT_EQ(scanner.mask(text), "call ***-***-**** today") << phone;
+    }
+}
+
+TEST_F(PIIScannerTest, WordBoundaries) {
+    // \b needs a word/non-word transition on both sides
+    EXPECT_TRUE(scanner.scan("x123-45-6789").empty());
+    EXPECT_TRUE(scanner.scan("123-45-6789x").empty());
+    EXPECT_TRUE(scanner.scan("1123-45-6789").empty());
+    EXPECT_TRUE(scanner.scan("123-45-67890").empty());
+    EXPECT_TRUE(scanner.scan("55512345678").empty());
+    EXPECT_EQ(scanner.scan("(123-45-6789)").size(), 1u);
+    EXPECT_EQ(scanner.scan("123-45-6789").size(), 1u);
+
+    // Before '(' or '+' there is no boundary after a space, so the match starts at the first digit
+    for (const std::string text : {"call (555) 123-4567", "call +1 555.987.6543", "id:123-45-6789."}) {
+        EXPECT_EQ(scanner.mask(text), regex_mask(default_patterns(), text)) << text;
+    }
+    EXPECT_EQ(scanner.mask("call (555) 123-4567"), "call (***-***-****");
+}
+
+TEST_F(PIIScannerTest, OverlappingMatchesResolveLeftmostThenByPriority) {
+    // SSN and EMAIL both start at 0; SSN is registered first and wins, and the
+    // rest of the address no longer forms an email
+    std::string text = "123-45-6789@example.com";
+    auto matches = scanner.scan(text);
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].pii_type, PIIType::SSN);
+    EXPECT_EQ(matches[0].begin, 0u);
+    EXPECT_EQ(matches[0].end, 11u);
+    EXPECT_EQ(scanner.mask(text), regex_mask(default_patterns(), text));
+
+    // The leftmost match wins even when a higher-priority pattern matches later
+    text = "jo@example.com 123-45-6789";
+    matches = scanner.scan(text);
+    ASSERT_EQ(matches.size(), 2u);
+    EXPECT_EQ(matches[0].pii_type, PIIType::EMAIL);
+    EXPECT_EQ(matches[1].pii_type, PIIType::SSN);
+
+    // Matches never overlap and come back in text order
+    text = "111-22-3333 444-55-6666 555-867-5309 a@b.io";
+    matches = scanner.scan(text);
+    ASSERT_EQ(matches.size(), 4u);
+    for (size_t i = 1; i < matches.size(); ++i) {
+        EXPECT_LE(matches[i - 1].end, matches[i].begin);
+    }
+    EXPECT_EQ(scanner.mask(text), "***-**-#### ***-**-#### ***-***-**** ***@***.com");
+}
+
+TEST_F(PIIScannerTest, TypeFilter) {
+    std::string text = "a@b.io 123-45-6789 555-123-4567";
+    auto matches = scanner.scan(text, PIIScanner::type_bit(PIIType::SSN));
+    ASSERT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0].pii_type, PIIType::SSN);
+
+    uint32_t types = PIIScanner::type_mask({PIIType::EMAIL, PIIType::PHONE});
+    EXPECT_EQ(scanner.mask(text, types), "***@***.com 123-45-6789 ***-***-****");
+    EXPECT_EQ(scanner.mask(text, PIIScanner::type_bit(PIIType::CREDIT_CARD)), text);
+}
+
+TEST_F(PIIScannerTest, MaskReportsMatches) {
+    std::vector<PIIMatch> found;
+    scanner.mask("ssn 123-45-6789", PIIScanner::ALL_TYPES, &found);
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].begin, 4u);
+    EXPECT_EQ(found[0].end, 15u);
+}
+
+TEST_F(PIIScannerTest, EmptyInput) {
+    EXPECT_TRUE(scanner.scan("").empty());
+    EXPECT_EQ(scanner.mask(""), "");
+    EXPECT_FALSE(scanner.contains("", PIIType::SSN));
+
+    PIIScanner empty_scanner(std::vector<PIIMaskingPattern>{});
+    EXPECT_TRUE(empty_scanner.scan("123-45-6789").empty());
+    EXPECT_EQ(empty_scanner.mask("123-45-6789"), "123-45-6789");
+}
+
+TEST_F(PIIScannerTest, HugeInputMatchesRegexMasking) {
+    const std::vector<std::string> fragments = {
+        "wire", "approved", "jane.doe@example.com", "123-45-6789", "(555) 123-4567", "+1 555.987.6543",
+        "ref#4471", "2024-03-17", "ops-team@bank.co.uk", "balance", "x123-45-6789", "1-800-555-0199",
+    };
+    std::string text;
+    for (size_t i = 0; text.size() < (1u << 20); ++i) {
+        text += fragments[(i * 7 + i / 5) % fragments.size()];
+        text.push_back(i % 11 == 0 ? '\n' : ' ');
+    }
+    EXPECT_EQ(scanner.mask(text), regex_mask(default_patterns(), text));
+}
+
+TEST_F(PIIScannerTest, HugeSingleMatchAndNearMiss) {
+    // Long runs stay linear: no backtracking, no recursion on match length
+    std::string local(1u << 20, 'a');
+    EXPECT_EQ(scanner.mask("to " + local + "@example.com"), "to ***@***.com");
+    EXPECT_TRUE(scanner.scan(local + "@example").empty());
+
+    std::string digits(1u << 20, '1');
+    EXPECT_TRUE(scanner.scan(digits).empty());
+}
+
+TEST(PIIScannerSyntaxTest, CustomPatternsAndMaskExpansion) {
+    PIIScanner scanner({
+        {PIIType::FINANCIAL_ACCOUNT, R"(\bACCT-\d{6,8}\b)", "[$&]", 0},
+        {PIIType::CUSTOM, R"(<[^>]+?>)", "$$", 0},
+    });
+    EXPECT_EQ(scanner.compiled_pattern_count(), 2u);
+    EXPECT_EQ(scanner.mask("ACCT-123456 ACCT-12345 <tag><x>"), "[ACCT-123456] ACCT-12345 $$");
+}
+
+TEST(PIIScannerFallbackTest, UnsupportedSyntaxFallsBackToRegex) {
+    std::vector<PIIMaskingPattern> patterns = {
+        {PIIType::SSN, R"(\b\d{3}-\d{2}-\d{4}\b)", "***-**-####", 4},
+        // Lookahead is outside the compiled subset; only the first group of a card number matches
+        {PIIType::CREDIT_CARD, R"(\b\d{4}(?= \d{4} \d{4} \d{4}\b))", "####", 0},
+        // A capture reference in the mask needs std::regex
+        {PIIType::FINANCIAL_ACCOUNT, R"(\b(IBAN)(\d+)\b)", "$1****", 0},
+    };
+    PIIScanner scanner(patterns);
+    EXPECT_EQ(scanner.compiled_pattern_count(), 1u);
+    EXPECT_EQ(scanner.fallback_pattern_count(), 2u);
+
+    std::string text = "card 4111 1111 1111 1111 ssn 123-45-6789 IBAN1234";
+    EXPECT_EQ(scanner.mask(text), regex_mask(patterns, text));
+    EXPECT_EQ(scanner.mask(text), "card #### 1111 1111 1111 ssn ***-**-#### IBAN****");
+    EXPECT_TRUE(scanner.contains(text, PIIType::CREDIT_CARD));
+    EXPECT_TRUE(scanner.contains(text, PIIType::FINANCIAL_ACCOUNT));
+    EXPECT_FALSE(scanner.contains("card 4111", PIIType::CREDIT_CARD));
+
+    // scan() merges fallback matches in text order and drops any that overlap a compiled match
+    auto matches = scanner.scan(text);
+    ASSERT_EQ(matches.size(), 3u);
+    EXPECT_EQ(matches[0].pii_type, PIIType::CREDIT_CARD);
+    EXPECT_EQ(matches[1].pii_type, PIIType::SSN);
+    EXPECT_EQ(matches[2].pii_type, PIIType::FINANCIAL_ACCOUNT);
+    for (size_t i = 1; i < matches.size(); ++i) {
+        EXPECT_LE(matches[i - 1].end, matches[i].begin);
+    }
+}
+
+TEST(PIIScannerFallbackTest, InvalidPatternIsReported) {
+    PIIScanner scanner({{PIIType::CUSTOM, "(unclosed", "*", 0}});
+    EXPECT_EQ(scanner.compiled_pattern_count(), 0u);
+    EXPECT_EQ(scanner.fallback_pattern_count(), 0u);
+    ASSERT_EQ(scanner.compile_errors().size(), 1u);
+    EXPECT_EQ(scanner.mask("(unclosed"), "(unclosed");
+}
+
+} // namespace regulens::tests
@@ -0,0 +1,173 @@
+/**
+ * RulePerformanceAnalyticsEngine Unit Tests
+ *
+ * Checks the incremental co-firing index against counts recomputed from the
+ * transaction history, and the redundancy and dead-rule thresholds.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "../../shared/analytics/rule_performance_analytics.hpp"
+
+namespace regulens::tests {
+
+using analytics::RulePerformanceAnalyticsEngine;
+
+namespace {
+
+std::string rule_name(int rule) {
+    return "r" + std::to_string(rule);
+}
+
+int rule_number(const nlohmann::json& id) {
+    return std::stoi(id.get<std::string>().substr(1));
+}
+
+// Executes every rule on each transaction; returns the fired sets of transactions that fired any
+std::vector<std::set<int>> run_transactions(RulePerformanceAnalyticsEngine& engine, int transactions, int rules,
+                                            const std::function<std::set<int>(std::mt19937&)>& fire) {
+    std::mt19937 rng(1);
+    std::vector<std::set<int>> history;
+    for (int t = 0; t < transactions; ++t) {
+        std::string transaction_id = "tx" + std::to_string(t);
+        std::set<int> fired = fire(rng);
+        for (int rule = 0; rule < rules; ++rule) {
+            engine.record_rule_execution(rule_name(rule), true, 0.1, transaction_id, fired.count(rule) > 0);
+        }
+        if (!fired.empty()) {
+            history.push_back(fired);
+        }
+    }
+    return history;
+}
+
+bool has_pair(const nlohmann::json& pairs, int a, int b) {
+    for (const auto& pair : pairs) {
+        int x = rule_number(pair["rule_id_1"]);
+        int y = rule_number(pair["rule_id_2"]);
+        if ((x == a && y == b) || (x == b && y == a)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+TEST(RulePerformanceAnalyticsTest, CoFiringCountsMatchWindowHistory) {
+    const size_t window = 500;
+    RulePerformanceAnalyticsEngine engine(window);
+    auto history = run_transactions(engine, 3000, 30, [](std::mt19937& rng) {
+        std::set<int> fired;
+        if (rng() % 4 == 0) {  // r0 and r1 always fire together
+            fired.insert(0);
+            fired.insert(1);
+        }
+        for (int rule = 2; rule < 30; ++rule) {
+            if (rng() % 10 == 0) {
+                fired.insert(rule);
+            }
+        }
+        return fired;
+    });
+    ASSERT_GE(history.size(), window);
+
+    auto pairs = engine.get_redundant_rules(0.0);
+    ASSERT_FALSE(pairs.empty());
+    for (const auto& pair : pairs) {
+        if (pair["source"] != "co_firing") {
+            continue;
+        }
+        int a = rule_number(pair["rule_id_1"]);
+        int b = rule_number(pair["rule_id_2"]);
+        int fires_a = 0;
+        int fires_b = 0;
+        int shared = 0;
+        for (size_t i = history.size() - window; i < history.size(); ++i) {
+            bool fired_a = history[i].count(a) > 0;
+            bool fired_b = history[i].count(b) > 0;
+            fires_a += fired_a;
+            fires_b += fired_b;
+            shared += fired_a && fired_b;
+        }
+        EXPECT_EQ(pair["overlapping_triggers"].get<int>(), shared);
+        EXPECT_NEAR(pair["similarity_score"].get<double>(),
+                    static_cast<double>(shared) / (fires_a + fires_b - shared), 1e-9);
+        EXPECT_NEAR(pair["containment"].get<double>(),
+                    static_cast<double>(shared) / std::min(fires_a, fires_b), 1e-9);
+    }
+
+    auto redundant = engine.get_redundant_rules(0.7);
+    ASSERT_EQ(redundant.size(), 1u);
+    EXPECT_TRUE(has_pair(redundant, 0, 1));
+    EXPECT_DOUBLE_EQ(redundant[0]["similarity_score"].get<double>(), 1.0);
+    EXPECT_FALSE(redundant[0].contains("subsumed_rule_id"));
+    EXPECT_EQ(engine.get_rule_stats().redundant_rule_pairs, 1);
+}
+
+TEST(RulePerformanceAnalyticsTest, ContainmentIsOptIn) {
+    RulePerformanceAnalyticsEngine engine(1000);
+    // r0 fires on most transactions; r1 only ever fires with it; r2 is independent of both
+    run_transactions(engine, 2000, 3, [](std::mt19937& rng) {
+        std::set<int> fired;
+        if (rng() % 10 != 0) {
+            fired.insert(0);
+            if (rng() % 20 == 0) {
+                fired.insert(1);
+            }
+        }
+        if (rng() % 20 == 0) {
+            fired.insert(2);
+        }
+        return fired;
+    });
+
+    // The broad rule contains every rarer one, but that alone is not redundancy
+    EXPECT_TRUE(engine.get_redundant_rules(0.7).empty());
+    EXPECT_EQ(engine.get_rule_stats().redundant_rule_pairs, 0);
+
+    auto contained = engine.get_redundant_rules(0.7, 1.0);
+    ASSERT_EQ(contained.size(), 1u);
+    EXPECT_TRUE(has_pair(contained, 0, 1));
+    EXPECT_EQ(contained[0]["subsumed_rule_id"], "r1");
+    EXPECT_LT(contained[0]["similarity_score"].get<double>(), 0.7);
+
+    // r2 is contained in r0 about as often as r0 fires, so a looser threshold admits it too
+    EXPECT_TRUE(has_pair(engine.get_redundant_rules(0.7, 0.8), 0, 2));
+}
+
+TEST(RulePerformanceAnalyticsTest, DeadRulesUseTheirOwnThreshold) {
+    // Dead-rule detection counts the rule's own executions, not the co-firing window
+    RulePerformanceAnalyticsEngine engine(100, 1000);
+    run_transactions(engine, 999, 2, [](std::mt19937&) { return std::set<int>{0}; });
+    EXPECT_TRUE(engine.get_dead_rules().empty());
+
+    run_transactions(engine, 1, 2, [](std::mt19937&) { return std::set<int>{0}; });
+    EXPECT_EQ(engine.get_dead_rules(), std::vector<std::string>{"r1"});
+    EXPECT_EQ(engine.get_rule_stats().dead_rules, std::vector<std::string>{"r1"});
+
+    // Firing once revives it
+    engine.record_rule_execution("r1", true, 0.1, "revive", true);
+    EXPECT_TRUE(engine.get_dead_rules().empty());
+}
+
+TEST(RulePerformanceAnalyticsTest, RuleInteractionsListEveryCoFiringPartner) {
+    RulePerformanceAnalyticsEngine engine(200);
+    run_transactions(engine, 400, 4, [](std::mt19937& rng) {
+        std::set<int> fired{0};
+        fired.insert(1 + static_cast<int>(rng() % 3));
+        return fired;
+    });
+
+    auto interactions = engine.get_rule_interactions("r0");
+    EXPECT_EQ(interactions.size(), 3u);
+    EXPECT_TRUE(engine.get_rule_interactions("missing").empty());
+}
+
+} // namespace regulens::tests